@@ -0,0 +1,106 @@
+/**
+ * @file       MultiScalarMul_bench.cpp
+ * @brief      Throughput of the multi-scalar multiplication on pallas and secp256k1
+ * @date       2024-03-19
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ * @details    Usage: MultiScalarMul_bench [min_log2_terms] [max_log2_terms] [num_threads]
+ *             Defaults to 2^10 up to 2^20 terms and the hardware concurrency for the parallel mode.
+ *             The naive sum of scalar multiplications is only timed up to 2^14 terms.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <nil/crypto3/algebra/curves/pallas.hpp>
+#include <nil/crypto3/algebra/curves/secp_k1.hpp>
+#include <nil/crypto3/algebra/random_element.hpp>
+
+#include "ProofSystem/MultiScalarMul.hpp"
+#include "ProofSystem/ParallelFor.hpp"
+
+using namespace nil::crypto3::algebra;
+
+namespace
+{
+    constexpr std::size_t MAX_NAIVE_LOG2_TERMS = 14;
+
+    template <typename Func>
+    double Seconds( Func &&func )
+    {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    }
+
+    template <typename CurveType>
+    void RunCurve( const std::string &curve_name, std::size_t min_log2, std::size_t max_log2, std::size_t num_threads )
+    {
+        using g1_value_type     = typename CurveType::template g1_type<>::value_type;
+        using scalar_value_type = typename CurveType::scalar_field_type::value_type;
+
+        // Consecutive multiples of a random point are as good as random points and much cheaper to make
+        const std::size_t              max_terms = std::size_t{ 1 } << max_log2;
+        std::vector<g1_value_type>     points( max_terms );
+        std::vector<scalar_value_type> scalars( max_terms );
+        const g1_value_type            step = random_element<typename CurveType::template g1_type<>>();
+        points[0]                           = step;
+        for ( std::size_t i = 1; i < max_terms; ++i )
+        {
+            points[i] = points[i - 1] + step;
+        }
+        for ( auto &scalar : scalars )
+        {
+            scalar = random_element<typename CurveType::scalar_field_type>();
+        }
+
+        for ( std::size_t log2_terms = min_log2; log2_terms <= max_log2; ++log2_terms )
+        {
+            const std::size_t terms = std::size_t{ 1 } << log2_terms;
+
+            g1_value_type serial_result;
+            g1_value_type parallel_result;
+            const double  serial_seconds   = Seconds( [&]() { serial_result = msm::MultiScalarMul( points.data(), scalars.data(), terms, 1 ); } );
+            const double  parallel_seconds = Seconds( [&]() { parallel_result = msm::MultiScalarMul( points.data(), scalars.data(), terms, num_threads ); } );
+
+            std::cout << std::setw( 10 ) << curve_name << "  2^" << std::setw( 2 ) << log2_terms << "  serial " << std::setw( 10 ) << std::fixed
+                      << std::setprecision( 4 ) << serial_seconds << " s  parallel " << std::setw( 10 ) << parallel_seconds << " s";
+            if ( log2_terms <= MAX_NAIVE_LOG2_TERMS )
+            {
+                g1_value_type naive_result = g1_value_type::zero();
+                const double  naive_seconds = Seconds(
+                    [&]()
+                    {
+                        for ( std::size_t i = 0; i < terms; ++i )
+                        {
+                            naive_result = naive_result + scalars[i] * points[i];
+                        }
+                    } );
+                std::cout << "  naive " << std::setw( 10 ) << naive_seconds << " s";
+                if ( naive_result.to_affine() != serial_result.to_affine() )
+                {
+                    std::cout << "  MISMATCH";
+                }
+            }
+            if ( parallel_result.to_affine() != serial_result.to_affine() )
+            {
+                std::cout << "  MISMATCH";
+            }
+            std::cout << std::endl;
+        }
+    }
+}
+
+int main( int argc, char *argv[] )
+{
+    const std::size_t min_log2    = argc > 1 ? std::strtoul( argv[1], nullptr, 10 ) : 10;
+    const std::size_t max_log2    = argc > 2 ? std::strtoul( argv[2], nullptr, 10 ) : 20;
+    const std::size_t num_threads = util::ResolveThreadCount( std::size_t{ 1 } << max_log2, argc > 3 ? std::strtoul( argv[3], nullptr, 10 ) : 0 );
+
+    std::cout << "Multi-scalar multiplication, " << num_threads << " threads in parallel mode" << std::endl;
+    RunCurve<curves::pallas>( "pallas", min_log2, max_log2, num_threads );
+    RunCurve<curves::secp256k1>( "secp256k1", min_log2, max_log2, num_threads );
+    return 0;
+}
@@ -0,0 +1,387 @@
+/**
+ * @file       ProofGeneration_bench.cpp
+ * @brief      Times the assignment and proving pipeline of the SGProofCircuits verifiers
+ * @date       2024-03-23
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ * @details    Usage: ProofGeneration_bench --assigner <path> --prover <path> [options]
+ *
+ *               --transaction-circuit <ranges>=<ir>   ValidateTransaction compiled with MAX_RANGES = ranges, repeatable
+ *               --compile-cmd <template>              Compiles the transaction circuit for each --ranges value, {ranges}
+ *                                                     and {output} are replaced by MAX_RANGES and the IR path
+ *               --ranges <list>                       MAX_RANGES values compiled with --compile-cmd, e.g. 4,8,16
+ *               --mpc-circuit <ir>                    MPCValidateTransaction compiled IR
+ *               --nodes <list>                        Requestor node counts for the MPC runs, default 4,11,32
+ *               --blocks <list>                       Requestor blocks per node for the MPC runs, default 10,100
+ *               --work-dir <dir>                      Inputs, circuits, tables and proofs, default ./proof_bench
+ *               --output <file>                       Results, one JSON object per line, default stdout
+ *
+ *             Every configuration runs the assigner and then the prover as child processes, so the
+ *             peak RSS of each stage is measured on its own. Nothing goes over the network.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <nil/crypto3/algebra/curves/pallas.hpp>
+
+#include "Requestor.hpp"
+
+using namespace nil::crypto3::algebra::curves;
+
+namespace
+{
+    using affine_type = typename pallas::template g1_type<coordinates::affine>::value_type;
+    using scalar_type = typename pallas::scalar_field_type::value_type;
+
+    constexpr std::size_t DEFAULT_TRANSACTION_BALANCE = 1000;
+    constexpr std::size_t DEFAULT_TRANSACTION_AMOUNT  = 500;
+
+    /**
+     * @brief       Outcome of one child process
+     */
+    struct StageResult
+    {
+        bool   ok          = false; ///< Exit status 0
+        double seconds     = 0.0;   ///< Wall clock time
+        long   peak_rss_kb = 0;     ///< Maximum resident set size of the child
+    };
+
+    /**
+     * @brief       Command line options
+     */
+    struct Options
+    {
+        std::string                        assigner;
+        std::string                        prover;
+        std::map<std::size_t, std::string> transaction_circuits;
+        std::string                        compile_cmd;
+        std::vector<std::size_t>           ranges;
+        std::string                        mpc_circuit;
+        std::vector<std::size_t>           nodes{ 4, 11, 32 };
+        std::vector<std::size_t>           blocks{ 10, 100 };
+        std::string                        work_dir = "proof_bench";
+        std::string                        output;
+    };
+
+    std::vector<std::size_t> ParseList( const std::string &list )
+    {
+        std::vector<std::size_t> values;
+        std::istringstream       stream( list );
+        std::string              item;
+        while ( std::getline( stream, item, ',' ) )
+        {
+            values.push_back( std::strtoul( item.c_str(), nullptr, 10 ) );
+        }
+        return values;
+    }
+
+    /**
+     * @brief       Runs a program and waits for it
+     * @param[in]   args Program and arguments
+     * @param[in]   log_path File receiving stdout and stderr
+     * @return      Exit status, time and peak memory
+     */
+    StageResult RunProcess( const std::vector<std::string> &args, const std::string &log_path )
+    {
+        StageResult result;
+        const auto  start = std::chrono::steady_clock::now();
+
+        const pid_t pid = fork();
+        if ( pid < 0 )
+        {
+            return result;
+        }
+        if ( pid == 0 )
+        {
+            const int log_fd = open( log_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+            if ( log_fd >= 0 )
+            {
+                dup2( log_fd, STDOUT_FILENO );
+                dup2( log_fd, STDERR_FILENO );
+                close( log_fd );
+            }
+            std::vector<char *> argv;
+            for ( const auto &arg : args )
+            {
+                argv.push_back( const_cast<char *>( arg.c_str() ) );
+            }
+            argv.push_back( nullptr );
+            execvp( argv[0], argv.data() );
+            _exit( 127 );
+        }
+
+        int           status = 0;
+        struct rusage usage  = {};
+        if ( wait4( pid, &status, 0, &usage ) < 0 )
+        {
+            return result;
+        }
+        result.seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+        result.ok      = WIFEXITED( status ) && WEXITSTATUS( status ) == 0;
+#ifdef __APPLE__
+        result.peak_rss_kb = usage.ru_maxrss / 1024;
+#else
+        result.peak_rss_kb = usage.ru_maxrss;
+#endif
+        return result;
+    }
+
+    long FileSize( const std::string &path )
+    {
+        struct stat info;
+        return stat( path.c_str(), &info ) == 0 ? static_cast<long>( info.st_size ) : -1;
+    }
+
+    std::string ReplaceAll( std::string text, const std::string &from, const std::string &to )
+    {
+        for ( std::size_t pos = text.find( from ); pos != std::string::npos; pos = text.find( from, pos + to.size() ) )
+        {
+            text.replace( pos, from.size(), to );
+        }
+        return text;
+    }
+
+    // Assigner input encoding of the circuit arguments
+    template <typename FieldValue>
+    std::string FieldJson( const FieldValue &value )
+    {
+        std::ostringstream stream;
+        stream << "{\"field\": \"" << value.data << "\"}";
+        return stream.str();
+    }
+
+    std::string IntJson( std::size_t value )
+    {
+        return "{\"int\": " + std::to_string( value ) + "}";
+    }
+
+    std::string CurveJson( const affine_type &point )
+    {
+        std::ostringstream stream;
+        stream << "{\"curve\": [\"" << point.X.data << "\", \"" << point.Y.data << "\"]}";
+        return stream.str();
+    }
+
+    void WriteInput( const std::string &path, const std::vector<std::string> &arguments )
+    {
+        std::ofstream file( path );
+        file << "[";
+        for ( std::size_t i = 0; i < arguments.size(); ++i )
+        {
+            file << ( i == 0 ? "" : ", " ) << arguments[i];
+        }
+        file << "]" << std::endl;
+    }
+
+    /**
+     * @brief       Same arguments as TransactionVerifierCircuit_test, with MAX_RANGES range bounds
+     */
+    void WriteTransactionInput( const std::string &path, std::size_t max_ranges )
+    {
+        const affine_type generator( 1, 2 );
+
+        std::ostringstream ranges;
+        ranges << "{\"array\": [";
+        for ( std::size_t i = 0; i < max_ranges; ++i )
+        {
+            ranges << ( i == 0 ? "" : ", " ) << FieldJson( scalar_type( 1000 * ( i + 1 ) ) );
+        }
+        ranges << "]}";
+
+        WriteInput( path, { IntJson( DEFAULT_TRANSACTION_BALANCE ), IntJson( DEFAULT_TRANSACTION_AMOUNT ), IntJson( DEFAULT_TRANSACTION_BALANCE ),
+                            IntJson( DEFAULT_TRANSACTION_AMOUNT ), CurveJson( generator * DEFAULT_TRANSACTION_BALANCE ),
+                            CurveJson( generator * DEFAULT_TRANSACTION_AMOUNT ),
+                            CurveJson( generator * ( DEFAULT_TRANSACTION_BALANCE - DEFAULT_TRANSACTION_AMOUNT ) ), CurveJson( generator ),
+                            ranges.str() } );
+    }
+
+    /**
+     * @brief       Same arguments as MPCVerifierCircuit_test, the nonces come from a Requestor of the given size
+     */
+    void WriteMPCInput( const std::string &path, std::size_t num_nodes, std::size_t num_blocks )
+    {
+        Requestor         requestor( num_nodes, num_blocks );
+        const auto        generator = requestor.getGenerator();
+        const scalar_type balance( DEFAULT_TRANSACTION_BALANCE );
+        const scalar_type amount( DEFAULT_TRANSACTION_AMOUNT );
+
+        WriteInput( path, { CurveJson( requestor.getTotalRandomSum() ), FieldJson( balance ), FieldJson( amount ), CurveJson( generator * balance ),
+                            CurveJson( generator * amount ), CurveJson( generator * ( balance - amount ) ), CurveJson( generator ),
+                            CurveJson( requestor.getFinalAggregate() ) } );
+    }
+
+    /**
+     * @brief       Assigns and proves one configuration and prints its JSON line
+     */
+    void RunPipeline( const Options &options, std::ostream &out, const std::string &name, const std::string &circuit_ir,
+                      const std::string &input_path, const std::string &config_json, const std::optional<StageResult> &compile )
+    {
+        const std::string prefix     = options.work_dir + "/" + name;
+        const std::string circuit    = prefix + ".crct";
+        const std::string table      = prefix + ".tbl";
+        const std::string proof      = prefix + ".proof";
+        const std::string empty_path = prefix + "_private.json";
+        WriteInput( empty_path, {} );
+
+        const StageResult witness =
+            RunProcess( { options.assigner, "-b", circuit_ir, "-p", input_path, "--private-input", empty_path, "-c", circuit, "-t", table, "-e", "pallas" },
+                        prefix + "_assigner.log" );
+        StageResult proving;
+        if ( witness.ok )
+        {
+            proving = RunProcess( { options.prover, "--circuit", circuit, "--assignment-table", table, "--proof", proof }, prefix + "_prover.log" );
+        }
+
+        out << "{\"circuit\": \"" << name << "\", " << config_json;
+        if ( compile )
+        {
+            out << ", \"compile_seconds\": " << compile->seconds << ", \"compile_peak_rss_kb\": " << compile->peak_rss_kb;
+        }
+        out << ", \"circuit_bytes\": " << FileSize( circuit ) << ", \"assignment_bytes\": " << FileSize( table )
+            << ", \"witness_seconds\": " << witness.seconds << ", \"witness_peak_rss_kb\": " << witness.peak_rss_kb
+            << ", \"proving_seconds\": " << proving.seconds << ", \"proving_peak_rss_kb\": " << proving.peak_rss_kb
+            << ", \"proof_bytes\": " << FileSize( proof ) << ", \"status\": \""
+            << ( !witness.ok ? "assigner_failed" : ( !proving.ok ? "prover_failed" : "ok" ) ) << "\"}" << std::endl;
+    }
+
+    bool ParseOptions( int argc, char *argv[], Options &options )
+    {
+        for ( int i = 1; i + 1 < argc; i += 2 )
+        {
+            const std::string key   = argv[i];
+            const std::string value = argv[i + 1];
+            if ( key == "--assigner" )
+            {
+                options.assigner = value;
+            }
+            else if ( key == "--prover" )
+            {
+                options.prover = value;
+            }
+            else if ( key == "--transaction-circuit" )
+            {
+                const auto separator = value.find( '=' );
+                if ( separator == std::string::npos )
+                {
+                    return false;
+                }
+                options.transaction_circuits[std::strtoul( value.substr( 0, separator ).c_str(), nullptr, 10 )] = value.substr( separator + 1 );
+            }
+            else if ( key == "--compile-cmd" )
+            {
+                options.compile_cmd = value;
+            }
+            else if ( key == "--ranges" )
+            {
+                options.ranges = ParseList( value );
+            }
+            else if ( key == "--mpc-circuit" )
+            {
+                options.mpc_circuit = value;
+            }
+            else if ( key == "--nodes" )
+            {
+                options.nodes = ParseList( value );
+            }
+            else if ( key == "--blocks" )
+            {
+                options.blocks = ParseList( value );
+            }
+            else if ( key == "--work-dir" )
+            {
+                options.work_dir = value;
+            }
+            else if ( key == "--output" )
+            {
+                options.output = value;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return ( argc % 2 ) == 1 && !options.assigner.empty() && !options.prover.empty();
+    }
+}
+
+int main( int argc, char *argv[] )
+{
+    Options options;
+    if ( !ParseOptions( argc, argv, options ) )
+    {
+        std::cerr << "Usage: " << argv[0] << " --assigner <path> --prover <path> [--transaction-circuit <ranges>=<ir>]... "
+                  << "[--compile-cmd <template> --ranges <list>] [--mpc-circuit <ir> --nodes <list> --blocks <list>] "
+                  << "[--work-dir <dir>] [--output <file>]" << std::endl;
+        return 1;
+    }
+    mkdir( options.work_dir.c_str(), 0755 );
+
+    std::ofstream output_file;
+    if ( !options.output.empty() )
+    {
+        output_file.open( options.output, std::ios::app );
+    }
+    std::ostream &out = options.output.empty() ? std::cout : output_file;
+
+    // MAX_RANGES is a compile time constant of the circuit, so each value is its own IR
+    std::map<std::size_t, std::optional<StageResult>> compiles;
+    for ( auto max_ranges : options.ranges )
+    {
+        if ( options.compile_cmd.empty() || options.transaction_circuits.count( max_ranges ) != 0 )
+        {
+            continue;
+        }
+        const std::string ir      = options.work_dir + "/transaction_r" + std::to_string( max_ranges ) + ".ll";
+        const std::string command = ReplaceAll( ReplaceAll( options.compile_cmd, "{ranges}", std::to_string( max_ranges ) ), "{output}", ir );
+
+        compiles[max_ranges] = RunProcess( { "/bin/sh", "-c", command }, options.work_dir + "/transaction_r" + std::to_string( max_ranges ) + "_compile.log" );
+        if ( compiles[max_ranges]->ok )
+        {
+            options.transaction_circuits[max_ranges] = ir;
+        }
+        else
+        {
+            std::cerr << "Compiling the circuit with MAX_RANGES = " << max_ranges << " failed" << std::endl;
+        }
+    }
+
+    for ( const auto &[max_ranges, circuit_ir] : options.transaction_circuits )
+    {
+        const std::string name  = "transaction_r" + std::to_string( max_ranges );
+        const std::string input = options.work_dir + "/" + name + "_public.json";
+        WriteTransactionInput( input, max_ranges );
+
+        const auto compile = compiles.find( max_ranges );
+        RunPipeline( options, out, name, circuit_ir, input, "\"max_ranges\": " + std::to_string( max_ranges ),
+                     compile != compiles.end() ? compile->second : std::nullopt );
+    }
+
+    if ( !options.mpc_circuit.empty() )
+    {
+        for ( auto num_nodes : options.nodes )
+        {
+            for ( auto num_blocks : options.blocks )
+            {
+                const std::string name  = "mpc_n" + std::to_string( num_nodes ) + "_b" + std::to_string( num_blocks );
+                const std::string input = options.work_dir + "/" + name + "_public.json";
+                WriteMPCInput( input, num_nodes, num_blocks );
+
+                RunPipeline( options, out, name, options.mpc_circuit, input,
+                             "\"nodes\": " + std::to_string( num_nodes ) + ", \"blocks\": " + std::to_string( num_blocks ), std::nullopt );
+            }
+        }
+    }
+    return 0;
+}
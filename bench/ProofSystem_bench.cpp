@@ -0,0 +1,757 @@
+/**
+ * @file       ProofSystem_bench.cpp
+ * @brief      Google Benchmark suite of the ProofSystem hot paths
+ * @date       2024-03-24
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ * @details    Run with --benchmark_out=<file> --benchmark_out_format=json for trend tracking, or build the
+ *             ProofSystem_bench_json target, which writes ProofSystem_bench.json in the build directory.
+ *             The first argument of each benchmark is the batch size, the second one, where present, the
+ *             number of worker threads of the API under test. Benchmarks marked ThreadRange run the same
+ *             loop on several benchmark threads, each with its own keys. Single threaded benchmarks of the
+ *             multiprecision paths report allocs_per_op, the calls to the global operator new per item;
+ *             configure with -DPROOFSYSTEM_ARENA_ALLOCATOR=OFF for the numbers without the arena.
+ */
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "ProofSystem/AsyncOperations.hpp"
+#include "ProofSystem/BitcoinKeyGenerator.hpp"
+#include "ProofSystem/Crypto3Util.hpp"
+#include "ProofSystem/ECDSABatchVerifier.hpp"
+#include "ProofSystem/ECElGamalKeyGenerator.hpp"
+#include "ProofSystem/ElGamalFixed.hpp"
+#include "ProofSystem/ElGamalKeyGenerator.hpp"
+#include "ProofSystem/ElGamalSerialization.hpp"
+#include "ProofSystem/EncryptedBalanceStore.hpp"
+#include "ProofSystem/EthereumKeyGenerator.hpp"
+#include "ProofSystem/KDFGenerator.hpp"
+#include "ProofSystem/PrimeNumbers.hpp"
+#include "ProofSystem/SecureRandom.hpp"
+#include "ProofSystem/util.hpp"
+
+using namespace KeyGenerator;
+using namespace bitcoin;
+using namespace ethereum;
+
+namespace
+{
+    std::atomic<std::uint64_t> global_allocations{ 0 }; ///< Calls to the global operator new
+}
+
+void *operator new( std::size_t size )
+{
+    global_allocations.fetch_add( 1, std::memory_order_relaxed );
+    if ( void *pointer = std::malloc( size == 0 ? 1 : size ) )
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete( void *pointer ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete( void *pointer, std::size_t ) noexcept
+{
+    std::free( pointer );
+}
+
+namespace
+{
+    constexpr std::uint64_t ADDITIVE_VALUE_LIMIT = 1000000; ///< Values decrypted through the BSGS table stay below this
+
+    std::vector<std::uint8_t> RandomBytes( std::size_t size, std::uint32_t seed )
+    {
+        std::mt19937              gen( seed );
+        std::vector<std::uint8_t> bytes( size );
+        for ( auto &byte : bytes )
+        {
+            byte = static_cast<std::uint8_t>( gen() );
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief       Ciphertext shaped values below the default prime, much faster to create than real encryptions
+     */
+    std::vector<ElGamal::CypherTextType> RandomCypherTexts( std::size_t count )
+    {
+        const cpp_int                   prime( ElGamal::SAFE_PRIME );
+        const std::vector<std::uint8_t> bytes = RandomBytes( count * 64, 23 );
+
+        std::vector<ElGamal::CypherTextType> cypher_texts;
+        cypher_texts.reserve( count );
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            cypher_texts.emplace_back( Crypto3Util::FixedBytesToCppInt( bytes.data() + i * 64, 32 ) % prime,
+                                       Crypto3Util::FixedBytesToCppInt( bytes.data() + i * 64 + 32, 32 ) % prime );
+        }
+        return cypher_texts;
+    }
+
+    void SetItems( benchmark::State &state, std::size_t items_per_iteration )
+    {
+        state.SetItemsProcessed( static_cast<int64_t>( state.iterations() * items_per_iteration ) );
+    }
+
+    /**
+     * @brief       Reports the global allocations per item made since allocations_before
+     */
+    void SetAllocations( benchmark::State &state, std::uint64_t allocations_before, std::size_t items_per_iteration )
+    {
+        const double items       = static_cast<double>( state.iterations() * items_per_iteration );
+        const double allocations = static_cast<double>( global_allocations.load() - allocations_before );
+
+        state.counters["allocs_per_op"] = benchmark::Counter( items > 0 ? allocations / items : 0.0 );
+    }
+}
+
+// ElGamal
+
+static void BM_ElGamalEncryptData( benchmark::State &state )
+{
+    const auto batch = static_cast<std::size_t>( state.range( 0 ) );
+    ElGamal    key_generator;
+    cpp_int    value = 0xbeadfeed;
+
+    for ( auto _ : state )
+    {
+        for ( std::size_t i = 0; i < batch; ++i )
+        {
+            benchmark::DoNotOptimize( ElGamal::EncryptData( key_generator.GetPublicKey(), value ) );
+        }
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_ElGamalEncryptData )->RangeMultiplier( 4 )->Range( 1, 64 )->ThreadRange( 1, 8 )->UseRealTime();
+
+static void BM_ElGamalEncryptDataAdditive( benchmark::State &state )
+{
+    const auto batch = static_cast<std::size_t>( state.range( 0 ) );
+    ElGamal    key_generator;
+
+    for ( auto _ : state )
+    {
+        for ( std::size_t i = 0; i < batch; ++i )
+        {
+            benchmark::DoNotOptimize( ElGamal::EncryptDataAdditive( key_generator.GetPublicKey(), cpp_int( i * 1000 ) ) );
+        }
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_ElGamalEncryptDataAdditive )->RangeMultiplier( 4 )->Range( 1, 64 )->ThreadRange( 1, 8 )->UseRealTime();
+
+static void BM_ElGamalDecryptDataAdditive( benchmark::State &state )
+{
+    const auto batch = static_cast<std::size_t>( state.range( 0 ) );
+    ElGamal    key_generator;
+
+    std::mt19937                                gen( 7 );
+    std::uniform_int_distribution<std::uint64_t> values( 0, ADDITIVE_VALUE_LIMIT );
+    std::vector<std::pair<cpp_int, cpp_int>>     cyphers;
+    for ( std::size_t i = 0; i < batch; ++i )
+    {
+        cyphers.push_back( ElGamal::EncryptDataAdditive( key_generator.GetPublicKey(), cpp_int( values( gen ) ) ) );
+    }
+
+    for ( auto _ : state )
+    {
+        for ( const auto &cypher : cyphers )
+        {
+            benchmark::DoNotOptimize( key_generator.DecryptDataAdditive( cypher ) );
+        }
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_ElGamalDecryptDataAdditive )->RangeMultiplier( 4 )->Range( 1, 64 )->UseRealTime();
+
+// One key and one baby step table for the whole process, decrypting from every benchmark thread at once
+static void BM_ElGamalDecryptDataAdditiveShared( benchmark::State &state )
+{
+    static const ElGamal shared_key_generator;
+
+    std::mt19937                                 gen( 11 + state.thread_index() );
+    std::uniform_int_distribution<std::uint64_t> values( 0, ADDITIVE_VALUE_LIMIT );
+    std::vector<std::pair<cpp_int, cpp_int>>     cyphers;
+    for ( std::size_t i = 0; i < 64; ++i )
+    {
+        cyphers.push_back( ElGamal::EncryptDataAdditive( shared_key_generator.GetPublicKey(), cpp_int( values( gen ) ) ) );
+    }
+
+    for ( auto _ : state )
+    {
+        for ( const auto &cypher : cyphers )
+        {
+            benchmark::DoNotOptimize( shared_key_generator.DecryptDataAdditive( cypher ) );
+        }
+    }
+    SetItems( state, cyphers.size() );
+}
+BENCHMARK( BM_ElGamalDecryptDataAdditiveShared )->ThreadRange( 1, 16 )->UseRealTime();
+
+// Same group as BM_ElGamalEncryptData, on the compile time parameters
+static void BM_ElGamalFixedEncryptData( benchmark::State &state )
+{
+    const auto           batch = static_cast<std::size_t>( state.range( 0 ) );
+    const ElGamalDefault key_generator;
+    const auto           value = ElGamalDefault::FromCppInt( 0xbeadfeed );
+
+    for ( auto _ : state )
+    {
+        for ( std::size_t i = 0; i < batch; ++i )
+        {
+            benchmark::DoNotOptimize( ElGamalDefault::EncryptData( key_generator.GetPublicKey(), value ) );
+        }
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_ElGamalFixedEncryptData )->RangeMultiplier( 4 )->Range( 1, 64 )->ThreadRange( 1, 8 )->UseRealTime();
+
+static void BM_ElGamalFixedDecryptData( benchmark::State &state )
+{
+    const auto           batch = static_cast<std::size_t>( state.range( 0 ) );
+    const ElGamalDefault key_generator;
+    const auto           cypher = ElGamalDefault::EncryptData( key_generator.GetPublicKey(), ElGamalDefault::FromCppInt( 0xbeadfeed ) );
+
+    for ( auto _ : state )
+    {
+        for ( std::size_t i = 0; i < batch; ++i )
+        {
+            benchmark::DoNotOptimize( ElGamalDefault::DecryptData( key_generator.GetPrivateKey(), cypher ) );
+        }
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_ElGamalFixedDecryptData )->RangeMultiplier( 4 )->Range( 1, 64 )->UseRealTime();
+
+static void BM_ElGamalEncryptDataChunked( benchmark::State &state )
+{
+    const auto bytes       = static_cast<std::size_t>( state.range( 0 ) );
+    const auto num_threads = static_cast<std::size_t>( state.range( 1 ) );
+    ElGamal    key_generator;
+    const auto data = RandomBytes( bytes, 11 );
+
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( ElGamal::EncryptDataChunked( key_generator.GetPublicKey(), data, num_threads ) );
+    }
+    state.SetBytesProcessed( static_cast<int64_t>( state.iterations() * bytes ) );
+}
+BENCHMARK( BM_ElGamalEncryptDataChunked )->ArgsProduct( { { 1 << 10, 1 << 14, 1 << 18 }, { 1, 2, 4, 8 } } )->UseRealTime();
+
+static void BM_ElGamalDecryptDataChunked( benchmark::State &state )
+{
+    const auto bytes       = static_cast<std::size_t>( state.range( 0 ) );
+    const auto num_threads = static_cast<std::size_t>( state.range( 1 ) );
+    ElGamal    key_generator;
+    const auto chunked = ElGamal::EncryptDataChunked( key_generator.GetPublicKey(), RandomBytes( bytes, 13 ), num_threads );
+
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( ElGamal::DecryptDataChunked( key_generator.GetPrivateKey(), chunked, num_threads ) );
+    }
+    state.SetBytesProcessed( static_cast<int64_t>( state.iterations() * bytes ) );
+}
+BENCHMARK( BM_ElGamalDecryptDataChunked )->ArgsProduct( { { 1 << 10, 1 << 14, 1 << 18 }, { 1, 2, 4, 8 } } )->UseRealTime();
+
+// Baby step giant step
+
+static void BM_BabyStepGiantStepBuild( benchmark::State &state )
+{
+    for ( auto _ : state )
+    {
+        PrimeNumbers::BabyStepGiantStep bsgs( cpp_int( ElGamal::SAFE_PRIME ), cpp_int( ElGamal::GENERATOR ) );
+        benchmark::DoNotOptimize( &bsgs );
+    }
+}
+BENCHMARK( BM_BabyStepGiantStepBuild )->Unit( benchmark::kMillisecond )->UseRealTime();
+
+static void BM_BabyStepGiantStepSolve( benchmark::State &state )
+{
+    const auto                      batch = static_cast<std::size_t>( state.range( 0 ) );
+    PrimeNumbers::BabyStepGiantStep bsgs( cpp_int( ElGamal::SAFE_PRIME ), cpp_int( ElGamal::GENERATOR ) );
+
+    std::mt19937                                gen( 17 );
+    std::uniform_int_distribution<std::uint64_t> values( 0, ADDITIVE_VALUE_LIMIT );
+    std::vector<cpp_int>                         targets;
+    for ( std::size_t i = 0; i < batch; ++i )
+    {
+        targets.push_back( powm( cpp_int( ElGamal::GENERATOR ), cpp_int( values( gen ) ), cpp_int( ElGamal::SAFE_PRIME ) ) );
+    }
+
+    const auto allocations = global_allocations.load();
+    for ( auto _ : state )
+    {
+        for ( const auto &target : targets )
+        {
+            benchmark::DoNotOptimize( bsgs.SolveECDLP( target ) );
+        }
+    }
+    SetItems( state, batch );
+    SetAllocations( state, allocations, batch );
+}
+BENCHMARK( BM_BabyStepGiantStepSolve )->RangeMultiplier( 4 )->Range( 1, 64 )->UseRealTime();
+
+// Modular arithmetic, allocation counts with and without the arena
+
+static void BM_ModInverseEuclideanDivision( benchmark::State &state )
+{
+    const cpp_int prime( ElGamal::SAFE_PRIME );
+    const cpp_int value = powm( cpp_int( ElGamal::GENERATOR ), cpp_int( 0xbeadfeed ), prime );
+
+    const auto allocations = global_allocations.load();
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( PrimeNumbers::ModInverseEuclideanDivision( value, prime ) );
+    }
+    SetItems( state, 1 );
+    SetAllocations( state, allocations, 1 );
+}
+BENCHMARK( BM_ModInverseEuclideanDivision );
+
+// Argument 0 takes the p = 3 mod 4 shortcut, argument 1 (the pallas base field) runs Tonelli-Shanks
+static void BM_SqrtMod( benchmark::State &state )
+{
+    const cpp_int prime = state.range( 0 ) == 0 ? cpp_int( ElGamal::SAFE_PRIME )
+                                                : cpp_int( "0x40000000000000000000000000000000224698fc094cf91b992d30ed00000001" );
+    const cpp_int root   = cpp_int( ElGamal::GENERATOR ) % prime;
+    const cpp_int square = ( root * root ) % prime;
+
+    const auto allocations = global_allocations.load();
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( PrimeNumbers::SqrtMod( square, prime ) );
+    }
+    SetItems( state, 1 );
+    SetAllocations( state, allocations, 1 );
+}
+BENCHMARK( BM_SqrtMod )->Arg( 0 )->Arg( 1 );
+
+static void BM_ElGamalRoundTripAllocations( benchmark::State &state )
+{
+    ElGamal key_generator;
+    cpp_int value = 0xbeadfeed;
+
+    const auto allocations = global_allocations.load();
+    for ( auto _ : state )
+    {
+        const auto cypher = ElGamal::EncryptData( key_generator.GetPublicKey(), value );
+        benchmark::DoNotOptimize( ElGamal::DecryptData<cpp_int>( key_generator.GetPrivateKey(), cypher ) );
+    }
+    SetItems( state, 1 );
+    SetAllocations( state, allocations, 1 );
+}
+BENCHMARK( BM_ElGamalRoundTripAllocations );
+
+// Serialization, reloading stored ciphertexts from decimal strings or from a mapped binary file
+
+static void BM_CypherTextDecimalParse( benchmark::State &state )
+{
+    const auto               count = static_cast<std::size_t>( state.range( 0 ) );
+    std::vector<std::string> decimal;
+    for ( const auto &cypher_text : RandomCypherTexts( count ) )
+    {
+        decimal.push_back( cypher_text.first.str() );
+        decimal.push_back( cypher_text.second.str() );
+    }
+
+    for ( auto _ : state )
+    {
+        std::vector<ElGamal::CypherTextType> cypher_texts;
+        cypher_texts.reserve( count );
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            cypher_texts.emplace_back( cpp_int( decimal[2 * i] ), cpp_int( decimal[2 * i + 1] ) );
+        }
+        benchmark::DoNotOptimize( cypher_texts.data() );
+    }
+    SetItems( state, count );
+}
+BENCHMARK( BM_CypherTextDecimalParse )->RangeMultiplier( 16 )->Range( 1 << 12, 1 << 20 )->Unit( benchmark::kMillisecond )->UseRealTime();
+
+// Second argument 0 only maps the file and touches one record, otherwise it's the ReadAll thread count
+static void BM_CypherTextMappedLoad( benchmark::State &state )
+{
+    const auto        count       = static_cast<std::size_t>( state.range( 0 ) );
+    const auto        num_threads = static_cast<std::size_t>( state.range( 1 ) );
+    const std::string path        = ( std::filesystem::temp_directory_path() / "ProofSystem_bench_cypher_texts.bin" ).string();
+    serialization::WriteCypherTextFile( path, ElGamal::Params( ElGamal::SAFE_PRIME, ElGamal::GENERATOR ), RandomCypherTexts( count ) );
+
+    for ( auto _ : state )
+    {
+        serialization::MappedCypherTexts mapped( path );
+        if ( num_threads == 0 )
+        {
+            benchmark::DoNotOptimize( mapped[count / 2] );
+        }
+        else
+        {
+            benchmark::DoNotOptimize( mapped.ReadAll( num_threads ) );
+        }
+    }
+    SetItems( state, count );
+    std::filesystem::remove( path );
+}
+BENCHMARK( BM_CypherTextMappedLoad )
+    ->ArgsProduct( { { 1 << 12, 1 << 16, 1 << 20 }, { 0, 1, 4 } } )
+    ->Unit( benchmark::kMillisecond )
+    ->UseRealTime();
+
+// One batch of deltas spread over a million accounts, journaled and synced before it's applied
+static void BM_BalanceStoreApplyDeltas( benchmark::State &state )
+{
+    constexpr std::size_t NUM_ACCOUNTS = 1 << 20;
+
+    const auto        batch       = static_cast<std::size_t>( state.range( 0 ) );
+    const auto        num_threads = static_cast<std::size_t>( state.range( 1 ) );
+    const std::string path        = ( std::filesystem::temp_directory_path() / "ProofSystem_bench_balances.bin" ).string();
+    ElGamal           key_generator;
+    {
+        std::filesystem::remove( path );
+        EncryptedBalanceStore store( path, key_generator.GetPublicKey().params );
+        store.Resize( NUM_ACCOUNTS );
+
+        const auto                                amount = ElGamal::EncryptDataAdditive( key_generator.GetPublicKey(), cpp_int( 1 ) );
+        std::mt19937_64                           gen( 29 );
+        std::vector<EncryptedBalanceStore::Delta> deltas;
+        for ( std::size_t i = 0; i < batch; ++i )
+        {
+            deltas.push_back( { gen() % NUM_ACCOUNTS, amount } );
+        }
+
+        for ( auto _ : state )
+        {
+            store.ApplyDeltas( deltas, num_threads );
+        }
+        SetItems( state, batch );
+    }
+    std::filesystem::remove( path );
+    std::filesystem::remove( path + EncryptedBalanceStore::JOURNAL_SUFFIX );
+}
+BENCHMARK( BM_BalanceStoreApplyDeltas )
+    ->ArgsProduct( { { 1 << 10, 1 << 14, 1 << 18 }, { 1, 4, 8 } } )
+    ->Unit( benchmark::kMillisecond )
+    ->UseRealTime();
+
+// EC ElGamal
+
+static void BM_ECElGamalKeyGenerator( benchmark::State &state )
+{
+    const auto batch = static_cast<std::size_t>( state.range( 0 ) );
+    for ( auto _ : state )
+    {
+        for ( std::size_t i = 0; i < batch; ++i )
+        {
+            ECElGamalKeyGenerator key_generator( cpp_int( 0x60cf347dbc59d31c1358c8e5cf5e45b822ab85b79cb32a9f3d98184779a9efc2_cppui256 ) + i );
+            benchmark::DoNotOptimize( &key_generator );
+        }
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_ECElGamalKeyGenerator )->RangeMultiplier( 4 )->Range( 1, 64 )->ThreadRange( 1, 8 )->UseRealTime();
+
+static void BM_ECElGamalEncryptDecrypt( benchmark::State &state )
+{
+    const auto            batch = static_cast<std::size_t>( state.range( 0 ) );
+    ECElGamalKeyGenerator key_generator( 0x60cf347dbc59d31c1358c8e5cf5e45b822ab85b79cb32a9f3d98184779a9efc2_cppui256 );
+
+    for ( auto _ : state )
+    {
+        for ( std::size_t i = 0; i < batch; ++i )
+        {
+            auto cypher = key_generator.EncryptData( cpp_int( 10000 + i ) );
+            benchmark::DoNotOptimize( key_generator.DecryptData( cypher ) );
+        }
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_ECElGamalEncryptDecrypt )->RangeMultiplier( 4 )->Range( 1, 64 )->ThreadRange( 1, 8 )->UseRealTime();
+
+// Batch of encryptions submitted to a worker pool, the submitting thread only waits on the futures
+static void BM_ECElGamalEncryptAsync( benchmark::State &state )
+{
+    const auto        batch = static_cast<std::size_t>( state.range( 0 ) );
+    async::WorkerPool pool( static_cast<std::size_t>( state.range( 1 ) ), batch );
+    auto key_generator = std::make_shared<ECElGamalKeyGenerator>( 0x60cf347dbc59d31c1358c8e5cf5e45b822ab85b79cb32a9f3d98184779a9efc2_cppui256 );
+
+    for ( auto _ : state )
+    {
+        std::vector<std::future<decltype( key_generator->EncryptData( 0 ) )>> cyphers;
+        cyphers.reserve( batch );
+        for ( std::size_t i = 0; i < batch; ++i )
+        {
+            cyphers.push_back( async::ECElGamalEncrypt( key_generator, cpp_int( 10000 + i ), {}, pool ) );
+        }
+        for ( auto &cypher : cyphers )
+        {
+            benchmark::DoNotOptimize( cypher.get() );
+        }
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_ECElGamalEncryptAsync )->ArgsProduct( { { 64, 1024 }, { 1, 2, 4, 8 } } )->UseRealTime();
+
+// KDF
+
+static void BM_KDFGeneratorRoundTrip( benchmark::State &state )
+{
+    const auto          batch = static_cast<std::size_t>( state.range( 0 ) );
+    BitcoinKeyGenerator prover_instance( "0110289C284E4665ADA21969A38525AC21B76D298CDBE6B28954EE3BD87E4628" );
+    BitcoinKeyGenerator sgnus_instance( "9903EB9091DA5DB623140763AC443A69348A8A2CC52DC88029ACB4DD716A74E8" );
+
+    for ( auto _ : state )
+    {
+        for ( std::size_t i = 0; i < batch; ++i )
+        {
+            KDFGenerator<bitcoin::policy_type> prover( prover_instance.get_private_key(), sgnus_instance.GetEntirePubValue() );
+            KDFGenerator<bitcoin::policy_type> revealer( sgnus_instance.get_private_key(), prover_instance.GetEntirePubValue() );
+
+            auto secret = prover.GenerateSharedSecret( prover_instance.get_private_key(), sgnus_instance.GetEntirePubValue() );
+            benchmark::DoNotOptimize(
+                revealer.GetNewKeyFromSecret( secret, prover_instance.GetEntirePubValue(), sgnus_instance.GetEntirePubValue() ) );
+        }
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_KDFGeneratorRoundTrip )->RangeMultiplier( 4 )->Range( 1, 16 )->ThreadRange( 1, 8 )->UseRealTime();
+
+// Address derivation
+
+static void BM_BitcoinDeriveAddress( benchmark::State &state )
+{
+    const auto batch   = static_cast<std::size_t>( state.range( 0 ) );
+    const auto entries = BitcoinKeyGenerator::GenerateBatch( batch, 1 );
+
+    std::vector<BitcoinKeyGenerator::PubKeyPair_t> x_y_values;
+    for ( const auto &entry : entries )
+    {
+        // DeriveAddress takes both coordinates least significant byte first
+        BitcoinKeyGenerator key_generator( entry.private_key );
+        x_y_values.push_back( BitcoinKeyGenerator::ExtractPubKeyFromField<BitcoinKeyGenerator::PubKeyPair_t>( key_generator.get_public_key() ) );
+    }
+
+    for ( auto _ : state )
+    {
+        for ( const auto &x_y_value : x_y_values )
+        {
+            benchmark::DoNotOptimize( BitcoinKeyGenerator::DeriveAddress( x_y_value.first, x_y_value.second ) );
+        }
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_BitcoinDeriveAddress )->RangeMultiplier( 8 )->Range( 1, 4096 )->UseRealTime();
+
+static void BM_BitcoinDeriveAddresses( benchmark::State &state )
+{
+    const auto batch   = static_cast<std::size_t>( state.range( 0 ) );
+    const auto entries = BitcoinKeyGenerator::GenerateBatch( batch, 1 );
+
+    std::vector<BitcoinKeyGenerator::CompressedPubKey_t> pub_keys;
+    for ( const auto &entry : entries )
+    {
+        pub_keys.push_back( entry.public_key );
+    }
+
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( BitcoinKeyGenerator::DeriveAddresses( pub_keys ) );
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_BitcoinDeriveAddresses )->RangeMultiplier( 8 )->Range( 1, 4096 )->UseRealTime();
+
+static void BM_EthereumDeriveAddress( benchmark::State &state )
+{
+    const auto batch   = static_cast<std::size_t>( state.range( 0 ) );
+    const auto entries = EthereumKeyGenerator::GenerateBatch( batch, 1 );
+
+    std::vector<std::vector<std::uint8_t>> x_y_values;
+    for ( const auto &entry : entries )
+    {
+        // DeriveAddress takes X and Y least significant byte first
+        x_y_values.emplace_back( entry.public_key.rbegin(), entry.public_key.rend() );
+    }
+
+    for ( auto _ : state )
+    {
+        for ( const auto &x_y_value : x_y_values )
+        {
+            benchmark::DoNotOptimize( EthereumKeyGenerator::DeriveAddress( x_y_value ) );
+        }
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_EthereumDeriveAddress )->RangeMultiplier( 8 )->Range( 1, 4096 )->UseRealTime();
+
+static void BM_EthereumDeriveAddresses( benchmark::State &state )
+{
+    const auto batch   = static_cast<std::size_t>( state.range( 0 ) );
+    const auto entries = EthereumKeyGenerator::GenerateBatch( batch, 1 );
+
+    std::vector<EthereumKeyGenerator::PubKeyBytes_t> pub_keys;
+    for ( const auto &entry : entries )
+    {
+        pub_keys.push_back( entry.public_key );
+    }
+
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( EthereumKeyGenerator::DeriveAddresses( pub_keys ) );
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_EthereumDeriveAddresses )->RangeMultiplier( 8 )->Range( 1, 4096 )->UseRealTime();
+
+// ECDSA verification
+
+namespace
+{
+    using BatchVerifier = ECDSABatchVerifier<ethereum::policy_type>;
+
+    std::vector<BatchVerifier::Entry_t> SignedEntries( std::size_t count, std::size_t num_signers )
+    {
+        std::vector<EthereumKeyGenerator>   signers( num_signers );
+        std::vector<BatchVerifier::Entry_t> entries;
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            const auto       &signer    = signers[i % signers.size()];
+            const std::string message   = "payload " + std::to_string( i );
+            auto              signature = BatchVerifier::SignRecoverable( message, signer.get_private_key() );
+            entries.push_back( BatchVerifier::MakeEntry( message, signature, signer.get_public_key() ) );
+        }
+        return entries;
+    }
+}
+
+// One signature at a time, without the signer tables
+static void BM_ECDSAVerifySingle( benchmark::State &state )
+{
+    const auto batch   = static_cast<std::size_t>( state.range( 0 ) );
+    const auto entries = SignedEntries( batch, 16 );
+
+    BatchVerifier::Verifier_t single_verifier( 1, 1000 );
+    for ( auto _ : state )
+    {
+        for ( const auto &entry : entries )
+        {
+            benchmark::DoNotOptimize( single_verifier.VerifyEncoded( entry.encoded_message, entry.signature.signature, entry.signer ) );
+        }
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_ECDSAVerifySingle )->RangeMultiplier( 4 )->Range( 16, 1024 )->UseRealTime();
+
+static void BM_ECDSAVerifyBatch( benchmark::State &state )
+{
+    const auto batch   = static_cast<std::size_t>( state.range( 0 ) );
+    const auto entries = SignedEntries( batch, 16 );
+
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( BatchVerifier::Verify( entries ) );
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_ECDSAVerifyBatch )->RangeMultiplier( 4 )->Range( 16, 1024 )->UseRealTime();
+
+// Key generation
+
+static void BM_BitcoinGenerateBatch( benchmark::State &state )
+{
+    const auto batch       = static_cast<std::size_t>( state.range( 0 ) );
+    const auto num_threads = static_cast<std::size_t>( state.range( 1 ) );
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( BitcoinKeyGenerator::GenerateBatch( batch, num_threads ) );
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_BitcoinGenerateBatch )->ArgsProduct( { { 64, 1024 }, { 1, 2, 4, 8 } } )->UseRealTime();
+
+static void BM_EthereumGenerateBatch( benchmark::State &state )
+{
+    const auto batch       = static_cast<std::size_t>( state.range( 0 ) );
+    const auto num_threads = static_cast<std::size_t>( state.range( 1 ) );
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( EthereumKeyGenerator::GenerateBatch( batch, num_threads ) );
+    }
+    SetItems( state, batch );
+}
+BENCHMARK( BM_EthereumGenerateBatch )->ArgsProduct( { { 64, 1024 }, { 1, 2, 4, 8 } } )->UseRealTime();
+
+// Random generation
+
+static void BM_RandomScalar( benchmark::State &state )
+{
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( csprng::RandomScalar<ecdsa_t::scalar_field_type>() );
+    }
+    SetItems( state, 1 );
+}
+BENCHMARK( BM_RandomScalar )->ThreadRange( 1, 16 )->UseRealTime();
+
+// The generator the key generators used before, one instance per benchmark thread
+static void BM_AlgebraicRandomDevice( benchmark::State &state )
+{
+    ecdsa_t::random_generator_type key_gen;
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( key_gen() );
+    }
+    SetItems( state, 1 );
+}
+BENCHMARK( BM_AlgebraicRandomDevice )->ThreadRange( 1, 16 )->UseRealTime();
+
+static void BM_GetRandomNumber( benchmark::State &state )
+{
+    const cpp_int prime( ElGamal::SAFE_PRIME );
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( PrimeNumbers::GetRandomNumber( prime ) );
+    }
+    SetItems( state, 1 );
+}
+BENCHMARK( BM_GetRandomNumber )->ThreadRange( 1, 16 )->UseRealTime();
+
+// Hex utilities
+
+static void BM_HexToString( benchmark::State &state )
+{
+    const auto bytes = static_cast<std::size_t>( state.range( 0 ) );
+    const auto data  = RandomBytes( bytes, 19 );
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( util::to_string( data ) );
+    }
+    state.SetBytesProcessed( static_cast<int64_t>( state.iterations() * bytes ) );
+}
+BENCHMARK( BM_HexToString )->RangeMultiplier( 8 )->Range( 32, 1 << 18 );
+
+static void BM_HexASCII2NumStr( benchmark::State &state )
+{
+    const auto        bytes = static_cast<std::size_t>( state.range( 0 ) );
+    const std::string hex   = util::to_string( RandomBytes( bytes, 23 ) );
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( util::HexASCII2NumStr<std::uint8_t>( hex ) );
+    }
+    state.SetBytesProcessed( static_cast<int64_t>( state.iterations() * bytes ) );
+}
+BENCHMARK( BM_HexASCII2NumStr )->RangeMultiplier( 8 )->Range( 32, 1 << 18 );
+
+BENCHMARK_MAIN();
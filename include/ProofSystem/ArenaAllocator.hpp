@@ -0,0 +1,174 @@
+/**
+ * @file       ArenaAllocator.hpp
+ * @brief      Per thread arena for the short lived multiprecision temporaries
+ * @date       2024-03-28
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _ARENA_ALLOCATOR_HPP_
+#define _ARENA_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Decides between the crypto3 and the boost multiprecision, the arena integers must follow the same choice
+#include "ProofSystem/PrimeNumbers.hpp"
+
+namespace arena
+{
+    /**
+     * @brief       Counters of the calling thread's arena
+     */
+    struct ArenaStats
+    {
+        std::uint64_t allocations; ///< Allocations served
+        std::uint64_t bytes;       ///< Bytes served
+        std::uint64_t blocks;      ///< Blocks obtained from the global allocator
+    };
+
+    /**
+     * @brief       Bump allocator made of reusable blocks
+     * @details     Allocation moves a pointer forward, freeing is a no-op except for the most recent
+     *              allocation, which is given back. @ref Scope rewinds everything else. Blocks are kept
+     *              for the lifetime of the thread and only come from the global allocator while the arena grows.
+     * @warning     Reassigning an arena integer usually frees its old limbs out of order, so a loop that
+     *              carries arena values from one pass to the next grows the arena on every pass. Open a
+     *              @ref Scope inside the loop and carry the values in regular integers instead.
+     */
+    class Arena
+    {
+    public:
+        static constexpr std::size_t BLOCK_SIZE = 64 * 1024;                   ///< Size of a regular block
+        static constexpr std::size_t ALIGNMENT  = alignof( std::max_align_t ); ///< Alignment of every allocation
+
+        /**
+         * @brief       Position in the arena, see @ref GetMark
+         */
+        struct Mark
+        {
+            std::size_t block;
+            std::size_t offset;
+        };
+
+        /**
+         * @brief       Returns the arena of the calling thread
+         */
+        static Arena &ThreadArena();
+
+        void *Allocate( std::size_t size );
+        void  Deallocate( void *pointer, std::size_t size ) noexcept;
+
+        [[nodiscard]] Mark GetMark() const
+        {
+            return Mark{ current_block, offset };
+        }
+
+        /**
+         * @brief       Releases everything allocated after the mark
+         */
+        void Rewind( const Mark &mark ) noexcept
+        {
+            current_block = mark.block;
+            offset        = mark.offset;
+        }
+
+        [[nodiscard]] const ArenaStats &GetStats() const
+        {
+            return stats;
+        }
+
+    private:
+        struct Block_t
+        {
+            std::unique_ptr<std::byte[]> data;
+            std::size_t                  size;
+        };
+
+        std::vector<Block_t> blocks;
+        std::size_t          current_block = 0; ///< Block being carved
+        std::size_t          offset        = 0; ///< First free byte of the current block
+        ArenaStats           stats{};
+    };
+
+    /**
+     * @brief       Rewinds the thread arena to where it was when the scope was opened
+     * @details     Declare it before the arena integers of an operation, and convert the results back to the
+     *              regular cpp_int before leaving. Arena values must not outlive the scope nor cross threads.
+     */
+    class Scope
+    {
+    public:
+        Scope() : arena( Arena::ThreadArena() ), mark( arena.GetMark() )
+        {
+        }
+
+        ~Scope()
+        {
+            arena.Rewind( mark );
+        }
+
+        Scope( const Scope & )            = delete;
+        Scope &operator=( const Scope & ) = delete;
+
+    private:
+        Arena            &arena;
+        const Arena::Mark mark;
+    };
+
+    /**
+     * @brief       Stateless allocator drawing from the calling thread's arena
+     */
+    template <typename T>
+    class Allocator
+    {
+    public:
+        using value_type = T;
+
+        Allocator() noexcept = default;
+
+        template <typename U>
+        Allocator( const Allocator<U> & ) noexcept
+        {
+        }
+
+        T *allocate( std::size_t count )
+        {
+            return static_cast<T *>( Arena::ThreadArena().Allocate( count * sizeof( T ) ) );
+        }
+
+        void deallocate( T *pointer, std::size_t count ) noexcept
+        {
+            Arena::ThreadArena().Deallocate( pointer, count * sizeof( T ) );
+        }
+
+        template <typename U>
+        bool operator==( const Allocator<U> & ) const noexcept
+        {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=( const Allocator<U> & ) const noexcept
+        {
+            return false;
+        }
+    };
+
+#ifdef _USE_CRYPTO3_
+    namespace mp = nil::crypto3::multiprecision;
+#else
+    namespace mp = boost::multiprecision;
+#endif
+    static_assert( std::is_same<mp::cpp_int, PrimeNumbers::cpp_int>::value, "Arena integers must use the backend of PrimeNumbers::cpp_int" );
+
+#ifdef PROOFSYSTEM_DISABLE_ARENA
+    using cpp_int = mp::cpp_int;
+#else
+    /// Unbounded signed integer with its limbs in the thread arena, only valid inside a @ref Scope
+    using cpp_int = mp::number<mp::cpp_int_backend<0, 0, mp::signed_magnitude, mp::unchecked, Allocator<mp::limb_type>>>;
+#endif
+}
+
+#endif
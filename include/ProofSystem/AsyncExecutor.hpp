@@ -0,0 +1,383 @@
+/**
+ * @file       AsyncExecutor.hpp
+ * @brief      Bounded worker pool running the expensive operations off the caller's thread
+ * @date       2024-03-31
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _ASYNC_EXECUTOR_HPP_
+#define _ASYNC_EXECUTOR_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#ifdef PROOFSYSTEM_ENABLE_COROUTINES
+#include <coroutine>
+#endif
+
+namespace async
+{
+    /**
+     * @brief       Result of an operation cancelled before it started, or that gave up on its token
+     */
+    class OperationCancelled : public std::runtime_error
+    {
+    public:
+        OperationCancelled() : std::runtime_error( "Operation cancelled" )
+        {
+        }
+    };
+
+    /**
+     * @brief       Thrown when a non blocking submission finds the queue at its capacity
+     */
+    class QueueFull : public std::runtime_error
+    {
+    public:
+        QueueFull() : std::runtime_error( "Worker pool queue is full" )
+        {
+        }
+    };
+
+    /**
+     * @brief       Read side of a cancellation flag, cheap to copy
+     * @details     A default constructed token is never cancelled. Operations that accept a token check it
+     *              before starting, long running ones may also poll it while they work.
+     */
+    class CancellationToken
+    {
+    public:
+        CancellationToken() = default;
+
+        [[nodiscard]] bool IsCancelled() const
+        {
+            return flag && flag->load( std::memory_order_acquire );
+        }
+
+        void ThrowIfCancelled() const
+        {
+            if ( IsCancelled() )
+            {
+                throw OperationCancelled();
+            }
+        }
+
+    private:
+        friend class CancellationSource;
+
+        explicit CancellationToken( std::shared_ptr<const std::atomic<bool>> cancel_flag ) : flag( std::move( cancel_flag ) )
+        {
+        }
+
+        std::shared_ptr<const std::atomic<bool>> flag;
+    };
+
+    /**
+     * @brief       Write side of a cancellation flag, hands out the tokens
+     */
+    class CancellationSource
+    {
+    public:
+        CancellationSource() : flag( std::make_shared<std::atomic<bool>>( false ) )
+        {
+        }
+
+        [[nodiscard]] CancellationToken GetToken() const
+        {
+            return CancellationToken( flag );
+        }
+
+        void Cancel()
+        {
+            flag->store( true, std::memory_order_release );
+        }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> flag;
+    };
+
+    /**
+     * @brief       Fixed set of worker threads fed by a bounded FIFO queue
+     * @details     The bound is the backpressure: @ref Submit waits for room, @ref TrySubmit and the coroutine
+     *              @ref Schedule fail right away, so an event loop thread never blocks on a busy pool.
+     *              Tasks are callables taking either nothing or a const @ref CancellationToken &. A task whose
+     *              token is cancelled before it starts completes with @ref OperationCancelled without running.
+     *              Destruction stops accepting work, runs what is already queued and joins the workers.
+     */
+    class WorkerPool
+    {
+    public:
+        static constexpr std::size_t DEFAULT_QUEUE_CAPACITY = 1024; ///< Tasks waiting in the queue before it's full
+
+        /**
+         * @brief       Starts the workers
+         * @param[in]   num_threads: Number of workers, 0 to use the hardware concurrency
+         * @param[in]   queue_capacity: Tasks that can wait for a worker, at least 1
+         */
+        explicit WorkerPool( std::size_t num_threads = 0, std::size_t queue_capacity = DEFAULT_QUEUE_CAPACITY );
+        ~WorkerPool();
+
+        WorkerPool( const WorkerPool & )            = delete;
+        WorkerPool &operator=( const WorkerPool & ) = delete;
+
+        /**
+         * @brief       Pool shared by the asynchronous operations of the library
+         * @return      The instance, with one worker per hardware thread
+         */
+        static WorkerPool &Instance();
+
+        [[nodiscard]] std::size_t GetThreadCount() const
+        {
+            return workers.size();
+        }
+
+        /**
+         * @brief       Number of tasks waiting for a worker
+         */
+        [[nodiscard]] std::size_t GetQueueSize() const;
+
+        /**
+         * @brief       Queues a task, waiting for room if the queue is full
+         * @param[in]   func: Task to run
+         * @param[in]   token: Cancellation token of the task
+         * @return      Future of the task result, holding its exception if it threw
+         */
+        template <typename Func>
+        auto Submit( Func &&func, CancellationToken token = {} )
+        {
+            auto [job, future] = MakeJob( std::forward<Func>( func ), std::move( token ) );
+            Enqueue( std::move( job ), true );
+            return std::move( future );
+        }
+
+        /**
+         * @brief       Queues a task unless the queue is full
+         * @param[in]   func: Task to run
+         * @param[in]   token: Cancellation token of the task
+         * @return      Future of the task result, std::nullopt if the queue is full
+         */
+        template <typename Func>
+        auto TrySubmit( Func &&func, CancellationToken token = {} )
+        {
+            auto [job, future] = MakeJob( std::forward<Func>( func ), std::move( token ) );
+            using Future_t     = decltype( future );
+            return Enqueue( std::move( job ), false ) ? std::optional<Future_t>( std::move( future ) ) : std::optional<Future_t>();
+        }
+
+#ifdef PROOFSYSTEM_ENABLE_COROUTINES
+        template <typename Func>
+        class ScheduleAwaitable;
+
+        /**
+         * @brief       Awaitable running a task on the pool, the awaiting coroutine resumes on the worker
+         * @param[in]   func: Task to run, kept in the coroutine frame until it completes
+         * @param[in]   token: Cancellation token of the task
+         * @return      An awaitable producing the task result
+         * @warning     co_await throws @ref QueueFull if the queue is full
+         */
+        template <typename Func>
+        ScheduleAwaitable<std::decay_t<Func>> Schedule( Func &&func, CancellationToken token = {} )
+        {
+            return ScheduleAwaitable<std::decay_t<Func>>( *this, std::forward<Func>( func ), std::move( token ) );
+        }
+#endif
+
+    private:
+        /**
+         * @brief       Move only type erased task
+         */
+        class Job
+        {
+        public:
+            template <typename Func, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, Job>>>
+            explicit Job( Func &&func ) : callable( std::make_unique<Holder<std::decay_t<Func>>>( std::forward<Func>( func ) ) )
+            {
+            }
+
+            void operator()()
+            {
+                callable->Run();
+            }
+
+        private:
+            struct Base
+            {
+                virtual ~Base()    = default;
+                virtual void Run() = 0;
+            };
+
+            template <typename Func>
+            struct Holder : Base
+            {
+                explicit Holder( Func &&stored ) : func( std::move( stored ) )
+                {
+                }
+
+                explicit Holder( const Func &stored ) : func( stored )
+                {
+                }
+
+                void Run() override
+                {
+                    func();
+                }
+
+                Func func;
+            };
+
+            std::unique_ptr<Base> callable;
+        };
+
+        /**
+         * @brief       Calls a task with its token when it takes one
+         */
+        template <typename Func>
+        static decltype( auto ) Invoke( Func &func, const CancellationToken &token )
+        {
+            if constexpr ( std::is_invocable_v<Func &, const CancellationToken &> )
+            {
+                return func( token );
+            }
+            else
+            {
+                return func();
+            }
+        }
+
+        template <typename Func>
+        using Result_t = decltype( Invoke( std::declval<std::decay_t<Func> &>(), std::declval<const CancellationToken &>() ) );
+
+        template <typename Func>
+        static std::pair<Job, std::future<Result_t<Func>>> MakeJob( Func &&func, CancellationToken token )
+        {
+            using Return_t = Result_t<Func>;
+
+            std::promise<Return_t> promise;
+            auto                   future = promise.get_future();
+            Job job( [func = std::forward<Func>( func ), token = std::move( token ), promise = std::move( promise )]() mutable
+                     {
+                         try
+                         {
+                             token.ThrowIfCancelled();
+                             if constexpr ( std::is_void_v<Return_t> )
+                             {
+                                 Invoke( func, token );
+                                 promise.set_value();
+                             }
+                             else
+                             {
+                                 promise.set_value( Invoke( func, token ) );
+                             }
+                         }
+                         catch ( ... )
+                         {
+                             promise.set_exception( std::current_exception() );
+                         }
+                     } );
+            return { std::move( job ), std::move( future ) };
+        }
+
+        /**
+         * @brief       Adds a job to the queue
+         * @param[in]   job: Job to run
+         * @param[in]   wait: If the call waits for room when the queue is full
+         * @return      false if the queue was full and @p wait is false
+         * @warning     Throws if the pool is shutting down
+         */
+        bool Enqueue( Job job, bool wait );
+        void WorkerLoop();
+
+        const std::size_t        capacity;   ///< Maximum number of queued jobs
+        std::deque<Job>          queue;      ///< Jobs waiting for a worker
+        mutable std::mutex       mutex;      ///< Protects the queue and the stop flag
+        std::condition_variable  not_empty;  ///< Signals the workers
+        std::condition_variable  not_full;   ///< Signals the blocked submitters
+        bool                     stopping;   ///< Set by the destructor
+        std::vector<std::thread> workers;
+    };
+
+#ifdef PROOFSYSTEM_ENABLE_COROUTINES
+    template <typename Func>
+    class WorkerPool::ScheduleAwaitable
+    {
+        using Return_t = Result_t<Func>;
+        using Value_t  = std::conditional_t<std::is_void_v<Return_t>, std::monostate, Return_t>;
+
+    public:
+        ScheduleAwaitable( WorkerPool &worker_pool, Func task, CancellationToken task_token ) :
+            pool( worker_pool ),       //
+            func( std::move( task ) ), //
+            token( std::move( task_token ) )
+        {
+        }
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend( std::coroutine_handle<> handle )
+        {
+            // The awaitable lives in the suspended frame, the job can point at it until it resumes the frame
+            Job job( [this, handle]()
+                     {
+                         try
+                         {
+                             token.ThrowIfCancelled();
+                             if constexpr ( std::is_void_v<Return_t> )
+                             {
+                                 Invoke( func, token );
+                                 result.emplace();
+                             }
+                             else
+                             {
+                                 result.emplace( Invoke( func, token ) );
+                             }
+                         }
+                         catch ( ... )
+                         {
+                             error = std::current_exception();
+                         }
+                         handle.resume();
+                     } );
+            if ( !pool.Enqueue( std::move( job ), false ) )
+            {
+                throw QueueFull();
+            }
+        }
+
+        Return_t await_resume()
+        {
+            if ( error )
+            {
+                std::rethrow_exception( error );
+            }
+            if constexpr ( !std::is_void_v<Return_t> )
+            {
+                return std::move( *result );
+            }
+        }
+
+    private:
+        WorkerPool            &pool;
+        Func                   func;
+        CancellationToken      token;
+        std::optional<Value_t> result;
+        std::exception_ptr     error;
+    };
+#endif
+}
+
+#endif
@@ -0,0 +1,157 @@
+/**
+ * @file       AsyncOperations.hpp
+ * @brief      Asynchronous versions of the expensive ProofSystem operations
+ * @date       2024-03-31
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _ASYNC_OPERATIONS_HPP_
+#define _ASYNC_OPERATIONS_HPP_
+
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "ProofSystem/AsyncExecutor.hpp"
+#include "ProofSystem/ECElGamalKeyGenerator.hpp"
+#include "ProofSystem/ElGamalKeyGenerator.hpp"
+#include "ProofSystem/KDFGenerator.hpp"
+#include "ProofSystem/PrimeNumbers.hpp"
+
+namespace async
+{
+    /**
+     * @brief       Tasks of the expensive operations, for @ref WorkerPool::Submit, @ref WorkerPool::TrySubmit or
+     *              co_await @ref WorkerPool::Schedule
+     * @details     Arguments are copied into the task and shared objects are held by shared_ptr, so nothing
+     *              dangles while the task waits in the queue.
+     */
+    namespace operations
+    {
+        inline auto CreateGeneratorParams()
+        {
+            return []() { return KeyGenerator::ElGamal::CreateGeneratorParams(); };
+        }
+
+        inline auto BuildBabyStepGiantStep( PrimeNumbers::cpp_int prime, PrimeNumbers::cpp_int generator )
+        {
+            return [prime = std::move( prime ), generator = std::move( generator )]()
+            { return std::make_shared<const PrimeNumbers::BabyStepGiantStep>( prime, generator ); };
+        }
+
+        template <typename PolicyType>
+        auto GenerateSharedSecret( std::shared_ptr<KDFGenerator<PolicyType>> kdf, ecdsa_t::pubkey::ext_private_key<PolicyType> own_prvt_key,
+                                   std::string other_party_key )
+        {
+            return [kdf = std::move( kdf ), own_prvt_key = std::move( own_prvt_key ), other_party_key = std::move( other_party_key )]()
+            { return kdf->GenerateSharedSecret( own_prvt_key, other_party_key ); };
+        }
+
+        template <typename PolicyType>
+        auto GetNewKeyFromSecret( std::shared_ptr<KDFGenerator<PolicyType>> kdf, std::string signed_secret, std::string signer_pubkey,
+                                  std::string verifier_pubkey )
+        {
+            return [kdf = std::move( kdf ), signed_secret = std::move( signed_secret ), signer_pubkey = std::move( signer_pubkey ),
+                    verifier_pubkey = std::move( verifier_pubkey )]()
+            { return kdf->GetNewKeyFromSecret( signed_secret, signer_pubkey, verifier_pubkey ); };
+        }
+
+        inline auto ECElGamalEncrypt( std::shared_ptr<ECElGamalKeyGenerator> key_generator, PrimeNumbers::cpp_int data )
+        {
+            return [key_generator = std::move( key_generator ), data = std::move( data )]() { return key_generator->EncryptData( data ); };
+        }
+    }
+
+    namespace detail
+    {
+        /**
+         * @brief       Queues a task without ever blocking the caller
+         * @warning     Throws @ref QueueFull if the queue is full
+         */
+        template <typename Func>
+        auto SubmitOrThrow( WorkerPool &pool, Func &&func, CancellationToken token )
+        {
+            auto future = pool.TrySubmit( std::forward<Func>( func ), std::move( token ) );
+            if ( !future )
+            {
+                throw QueueFull();
+            }
+            return std::move( *future );
+        }
+    }
+
+    /**
+     * @brief       Creates new ElGamal parameters, seconds of safe prime search, on a worker
+     * @param[in]   token: Cancellation token, checked before the search starts
+     * @param[in]   pool: Pool running the task
+     * @return      Future of the parameters
+     * @warning     The wrappers of this file never block, they throw @ref QueueFull when the pool is saturated
+     */
+    inline auto CreateGeneratorParams( CancellationToken token = {}, WorkerPool &pool = WorkerPool::Instance() )
+    {
+        return detail::SubmitOrThrow( pool, operations::CreateGeneratorParams(), std::move( token ) );
+    }
+
+    /**
+     * @brief       Builds a baby step giant step table on a worker
+     * @details     The table is immutable once built, the shared_ptr can be handed to every decrypting thread.
+     * @param[in]   prime: Prime of the group
+     * @param[in]   generator: Generator of the group
+     * @param[in]   token: Cancellation token, checked before the table is built
+     * @param[in]   pool: Pool running the task
+     * @return      Future of the table
+     */
+    inline auto BuildBabyStepGiantStep( PrimeNumbers::cpp_int prime, PrimeNumbers::cpp_int generator, CancellationToken token = {},
+                                        WorkerPool &pool = WorkerPool::Instance() )
+    {
+        return detail::SubmitOrThrow( pool, operations::BuildBabyStepGiantStep( std::move( prime ), std::move( generator ) ), std::move( token ) );
+    }
+
+    /**
+     * @brief       Signs and encrypts a KDF secret on a worker, see @ref KDFGenerator::GenerateSharedSecret
+     * @param[in]   kdf: Generator, kept alive until the task completes
+     * @param[in]   own_prvt_key: Key to sign the secret
+     * @param[in]   other_party_key: Public key of the other party
+     * @param[in]   token: Cancellation token, checked before the secret is generated
+     * @param[in]   pool: Pool running the task
+     * @return      Future of the secret
+     */
+    template <typename PolicyType>
+    auto GenerateSharedSecret( std::shared_ptr<KDFGenerator<PolicyType>> kdf, ecdsa_t::pubkey::ext_private_key<PolicyType> own_prvt_key,
+                               std::string other_party_key, CancellationToken token = {}, WorkerPool &pool = WorkerPool::Instance() )
+    {
+        return detail::SubmitOrThrow( pool,
+                                      operations::GenerateSharedSecret( std::move( kdf ), std::move( own_prvt_key ), std::move( other_party_key ) ),
+                                      std::move( token ) );
+    }
+
+    /**
+     * @brief       Verifies a KDF secret and extracts its key on a worker, see @ref KDFGenerator::GetNewKeyFromSecret
+     * @return      Future of the derived key, holding the verification error if any
+     */
+    template <typename PolicyType>
+    auto GetNewKeyFromSecret( std::shared_ptr<KDFGenerator<PolicyType>> kdf, std::string signed_secret, std::string signer_pubkey,
+                              std::string verifier_pubkey, CancellationToken token = {}, WorkerPool &pool = WorkerPool::Instance() )
+    {
+        return detail::SubmitOrThrow( pool,
+                                      operations::GetNewKeyFromSecret( std::move( kdf ), std::move( signed_secret ), std::move( signer_pubkey ),
+                                                                       std::move( verifier_pubkey ) ),
+                                      std::move( token ) );
+    }
+
+    /**
+     * @brief       EC ElGamal encryption on a worker
+     * @param[in]   key_generator: Key to encrypt with, kept alive until the task completes
+     * @param[in]   data: Value to encrypt
+     * @param[in]   token: Cancellation token, checked before the encryption
+     * @param[in]   pool: Pool running the task
+     * @return      Future of the ciphertext
+     */
+    inline auto ECElGamalEncrypt( std::shared_ptr<ECElGamalKeyGenerator> key_generator, PrimeNumbers::cpp_int data, CancellationToken token = {},
+                                  WorkerPool &pool = WorkerPool::Instance() )
+    {
+        return detail::SubmitOrThrow( pool, operations::ECElGamalEncrypt( std::move( key_generator ), std::move( data ) ), std::move( token ) );
+    }
+}
+
+#endif
@@ -9,6 +9,7 @@
 #ifndef BITCOIN_KEY_GENERATOR_HPP
 #define BITCOIN_KEY_GENERATOR_HPP
 
+#include <array>
 #include <string>
 #include <vector>
 #include <memory>
@@ -29,7 +30,19 @@ namespace bitcoin
     class BitcoinKeyGenerator
     {
     public:
-        using PubKeyPair_t = std::pair<std::vector<std::uint8_t>, std::vector<std::uint8_t>>;
+        using PubKeyPair_t       = std::pair<std::vector<std::uint8_t>, std::vector<std::uint8_t>>;
+        using CompressedPubKey_t = ECDSAPublicKey::Compressed_t; ///< SEC1 compressed public key, parity prefix then X big endian
+        using Hash160_t          = std::array<std::uint8_t, 20>; ///< RIPEMD-160 of the SHA-256 of a public key
+
+        /**
+         * @brief       Key pair and address produced by @ref GenerateBatch
+         */
+        struct BatchEntry_t
+        {
+            scalar_field_value_type private_key; ///< Private key scalar
+            CompressedPubKey_t      public_key;  ///< SEC1 compressed public key
+            Hash160_t               hash160;     ///< Address payload, see @ref EncodeAddress
+        };
 
         /**
          * @brief       Constructs a new randomly generated Bitcoin key and address
@@ -97,8 +110,53 @@ namespace bitcoin
          * @param[in]   pub_key_vect: The vector representation of the X coordinate of public key
          * @return      Bitcoin base58 address
          * @warning     The LSB is the 0 index and the MSB is the 31th.
+         * @warning     Y is unknown here, so the compressed prefix is guessed from the parity of X.
+         *              The address is wrong for about half of the keys.
+         */
+        [[deprecated( "Y is needed for the compressed prefix, pass both coordinates" )]] static std::string
+        DeriveAddress( const std::vector<std::uint8_t> &pub_key_vect );
+        /**
+         * @brief       Derive the bitcoin address from the coordinates of the public key
+         * @param[in]   x_vect: The vector representation of the X coordinate of public key
+         * @param[in]   y_vect: The vector representation of the Y coordinate of public key
+         * @return      Bitcoin base58 address
+         * @warning     The LSB is the 0 index and the MSB is the 31th, as in @ref PubKeyPair_t.
+         */
+        static std::string DeriveAddress( const std::vector<std::uint8_t> &x_vect, const std::vector<std::uint8_t> &y_vect );
+        /**
+         * @brief       Derive the hash160 of many compressed public keys, several keys per hash call
+         * @param[in]   pub_keys: Compressed public keys
+         * @return      One hash160 per key, in the same order
+         */
+        static std::vector<Hash160_t> DeriveHash160s( const std::vector<CompressedPubKey_t> &pub_keys );
+        /**
+         * @brief       Derive the hash160 of many compressed public keys into caller owned storage
+         * @param[in]   pub_keys: Pointer to the first public key
+         * @param[in]   count: Number of public keys
+         * @param[out]  hashes: Destination of @p count hashes
+         */
+        static void DeriveHash160s( const CompressedPubKey_t *pub_keys, std::size_t count, Hash160_t *hashes );
+        /**
+         * @brief       Derive the main network base58 addresses of many compressed public keys
+         * @param[in]   pub_keys: Compressed public keys
+         * @return      One address per key, in the same order
+         */
+        static std::vector<std::string> DeriveAddresses( const std::vector<CompressedPubKey_t> &pub_keys );
+        /**
+         * @brief       Encodes a hash160 as a main network base58check address
+         * @param[in]   hash160: Hash of the public key
+         * @return      Bitcoin base58 address
+         */
+        static std::string EncodeAddress( const Hash160_t &hash160 );
+        /**
+         * @brief       Generates many random key pairs with their addresses
+         * @param[in]   count: Number of key pairs
+         * @param[in]   num_threads: Number of threads, 0 to use the hardware concurrency
+         * @return      Contiguous key pairs and address hashes
+         * @details     Uses a precomputed table of multiples of G, one field inversion per block of keys
+         *              for the affine conversion and multi-lane hashing for the addresses.
          */
-        static std::string DeriveAddress( const std::vector<std::uint8_t> &pub_key_vect );
+        static std::vector<BatchEntry_t> GenerateBatch( std::size_t count, std::size_t num_threads = 0 );
 
         /**
          * @brief       Create the ECDSA key pair
@@ -107,7 +165,6 @@ namespace bitcoin
         static std::shared_ptr<pubkey::ext_private_key<policy_type>> CreateKeys();
 
     private:
-        static random_generator_type                          key_gen; ///< Bitcoin random key generator
         std::shared_ptr<pubkey::ext_private_key<policy_type>> privkey; ///< The ECDSA private key
         std::shared_ptr<pubkey::public_key<policy_type>>      pubkey;  ///< The ECDSA public key
         
@@ -120,12 +177,11 @@ namespace bitcoin
 
             /**
              * @brief       Implements the calculation for the public key value used for bitcoin
-             * @return      The compressed X key data in string form
+             * @return      The SEC1 compressed key in string form
              */
             std::string CalcPubkeyUsedValue() const override
             {
-                const std::string compressed_byte_id = ( ( X_vect.front() % 2 ) ? "03" : "02" );
-                return ( compressed_byte_id + X );
+                return ToHex( GetCompressed().begin(), GetCompressed().end() );
             }
         };
 
@@ -136,6 +192,7 @@ namespace bitcoin
         static constexpr std::uint8_t PARITY_EVEN_ID      = 2; ///< If even, the compressed address is prepend this
         static constexpr std::uint8_t PARITY_ODD_ID       = 3; ///< If odd, the compressed address is prepend this
         static constexpr std::uint8_t CHECKSUM_SIZE_BYTES = 4; ///< Number of used checksum bytes
+        static constexpr std::size_t  BATCH_BLOCK_SIZE    = 256; ///< Keys hashed per intermediate digest buffer
 
         /**
          * @brief       Derive the bitcoin address from own key
@@ -6,6 +6,10 @@
  */
 #ifndef _CRYPTO3_UTIL_HPP_
 #define _CRYPTO3_UTIL_HPP_
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
 #include <nil/crypto3/multiprecision/cpp_int.hpp>
 
 struct Crypto3Util
@@ -32,6 +36,67 @@ struct Crypto3Util
         }
         return bytes;
     }
+    /**
+     * @brief       Writes a number as a fixed width big endian byte sequence
+     * @param[in]   big_num The number to be written, must fit in @p width bytes
+     * @param[out]  out Destination with at least @p width bytes
+     * @param[in]   width Number of bytes to write, the number is left padded with zeroes
+     */
+    static void CppIntToFixedBytes( const nil::crypto3::multiprecision::cpp_int &big_num, std::uint8_t *out, std::size_t width )
+    {
+        nil::crypto3::multiprecision::cpp_int remaining = big_num;
+        for ( std::size_t i = width; i > 0; --i )
+        {
+            out[i - 1] = static_cast<uint8_t>( remaining & 0xFF );
+            remaining >>= 8;
+        }
+        if ( remaining != 0 )
+        {
+            throw std::out_of_range( "Number does not fit in the fixed width" );
+        }
+    }
+    /**
+     * @brief       Reads a fixed width big endian byte sequence
+     * @param[in]   in Source with at least @p width bytes
+     * @param[in]   width Number of bytes to read
+     * @return      The number represented by the bytes
+     */
+    static nil::crypto3::multiprecision::cpp_int FixedBytesToCppInt( const std::uint8_t *in, std::size_t width )
+    {
+        nil::crypto3::multiprecision::cpp_int retval;
+        for ( std::size_t i = 0; i < width; ++i )
+        {
+            retval = ( retval << 8 ) | in[i];
+        }
+        return retval;
+    }
+    /**
+     * @brief       Writes a number as a fixed width little endian byte sequence
+     * @param[in]   big_num The number to be written, must be positive and fit in @p width bytes
+     * @param[out]  out Destination with at least @p width bytes
+     * @param[in]   width Number of bytes to write, the number is right padded with zeroes
+     */
+    static void CppIntToFixedBytesLE( const nil::crypto3::multiprecision::cpp_int &big_num, std::uint8_t *out, std::size_t width )
+    {
+        if ( big_num < 0 || ( big_num != 0 && msb( big_num ) >= width * 8 ) )
+        {
+            throw std::out_of_range( "Number does not fit in the fixed width" );
+        }
+        std::uint8_t *end = export_bits( big_num, out, 8, false );
+        std::fill( end, out + width, 0 );
+    }
+    /**
+     * @brief       Reads a fixed width little endian byte sequence
+     * @param[in]   in Source with at least @p width bytes
+     * @param[in]   width Number of bytes to read
+     * @return      The number represented by the bytes
+     */
+    static nil::crypto3::multiprecision::cpp_int FixedBytesLEToCppInt( const std::uint8_t *in, std::size_t width )
+    {
+        nil::crypto3::multiprecision::cpp_int retval;
+        import_bits( retval, in, in + width, 8, false );
+        return retval;
+    }
 };
 
 #endif
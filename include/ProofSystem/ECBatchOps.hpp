@@ -0,0 +1,361 @@
+/**
+ * @file       ECBatchOps.hpp
+ * @brief      Elliptic curve helpers for bulk key generation
+ * @date       2024-03-08
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _EC_BATCH_OPS_HPP_
+#define _EC_BATCH_OPS_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <nil/crypto3/algebra/marshalling.hpp>
+#include <nil/crypto3/multiprecision/cpp_int.hpp>
+
+#include "ProofSystem/util.hpp"
+
+namespace ecbatch
+{
+#ifdef _USE_CRYPTO3_
+    using cpp_int = nil::crypto3::multiprecision::cpp_int;
+#else
+    using cpp_int = boost::multiprecision::cpp_int;
+#endif
+
+    /**
+     * @brief       Inverts many field elements with a single field inversion (Montgomery's trick)
+     * @param[in,out] values Elements to invert, zeroes are left untouched
+     * @param[in]   count Number of elements
+     * @tparam      FieldValue Field element type
+     */
+    template <typename FieldValue>
+    void BatchInvert( FieldValue *values, std::size_t count )
+    {
+        if ( count == 0 )
+        {
+            return;
+        }
+        std::vector<FieldValue> prefix( count );
+
+        FieldValue accumulated = FieldValue::one();
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            prefix[i] = accumulated;
+            if ( !values[i].is_zero() )
+            {
+                accumulated = accumulated * values[i];
+            }
+        }
+
+        FieldValue inverse = accumulated.inversed();
+        for ( std::size_t i = count; i > 0; --i )
+        {
+            if ( values[i - 1].is_zero() )
+            {
+                continue;
+            }
+            const FieldValue original = values[i - 1];
+            values[i - 1]             = inverse * prefix[i - 1];
+            inverse                   = inverse * original;
+        }
+    }
+
+    /**
+     * @brief       Converts Jacobian points to affine ones sharing a single field inversion
+     * @param[in]   points Jacobian points (x = X/Z^2, y = Y/Z^3)
+     * @param[in]   count Number of points
+     * @param[out]  affine Destination of @p count affine points, the point at infinity maps to AffinePoint::zero()
+     * @tparam      JacobianPoint Point type with public X, Y and Z coordinates
+     * @tparam      AffinePoint Affine point type constructible from ( x, y )
+     */
+    template <typename JacobianPoint, typename AffinePoint>
+    void BatchToAffine( const JacobianPoint *points, std::size_t count, AffinePoint *affine )
+    {
+        using FieldValue = decltype( points->Z );
+
+        std::vector<FieldValue> z_inverses( count );
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            z_inverses[i] = points[i].Z;
+        }
+        BatchInvert( z_inverses.data(), count );
+
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            if ( points[i].Z.is_zero() )
+            {
+                affine[i] = AffinePoint::zero();
+                continue;
+            }
+            const FieldValue z_inverse_squared = z_inverses[i].squared();
+            affine[i] = AffinePoint( points[i].X * z_inverse_squared, points[i].Y * z_inverse_squared * z_inverses[i] );
+        }
+    }
+
+    /**
+     * @brief       Size of a serialized field element
+     * @return      Number of bytes needed to hold FieldType::number_bits
+     * @tparam      FieldType Field of the element
+     */
+    template <typename FieldType>
+    constexpr std::size_t FieldElementSize()
+    {
+        return ( FieldType::number_bits + 7 ) / 8;
+    }
+
+    /**
+     * @brief       Writes a field element as fixed width big endian bytes
+     * @param[in]   value Field element
+     * @param[out]  out Destination of @ref FieldElementSize bytes
+     * @tparam      FieldType Field of the element
+     */
+    template <typename FieldType>
+    void FieldElementToBigEndian( const typename FieldType::value_type &value, std::uint8_t *out )
+    {
+        std::array<std::uint8_t, FieldElementSize<FieldType>()> bytes;
+        nil::marshalling::bincode::field<FieldType>::template field_element_to_bytes<typename decltype( bytes )::iterator>( value, bytes.begin(),
+                                                                                                                            bytes.end() );
+        // Same convention as the key generators: least significant byte first after the adjustment
+        util::AdjustEndianess( bytes );
+        std::reverse_copy( bytes.begin(), bytes.end(), out );
+    }
+
+    /**
+     * @brief       Reads a field element from fixed width big endian bytes
+     * @param[in]   in Source of @ref FieldElementSize bytes
+     * @param[out]  value Parsed field element
+     * @return      false if the bytes encode a number that is not smaller than the modulus
+     * @tparam      FieldType Field of the element
+     */
+    template <typename FieldType>
+    bool FieldElementFromBigEndian( const std::uint8_t *in, typename FieldType::value_type &value )
+    {
+        std::array<std::uint8_t, FieldElementSize<FieldType>()> bytes;
+        std::reverse_copy( in, in + bytes.size(), bytes.begin() );
+        util::AdjustEndianess( bytes );
+        value = nil::marshalling::bincode::field<FieldType>::template field_element_from_bytes<typename decltype( bytes )::iterator>( bytes.begin(),
+                                                                                                                                     bytes.end() )
+                    .second;
+
+        // The parser reduces modulo p, so a non canonical encoding does not survive the round trip
+        std::array<std::uint8_t, FieldElementSize<FieldType>()> canonical;
+        FieldElementToBigEndian<FieldType>( value, canonical.data() );
+        return std::equal( canonical.begin(), canonical.end(), in );
+    }
+
+    /**
+     * @brief       Draws a random 128 bit weight for a batched check
+     * @param[in]   rng 64 bit random generator, e.g. csprng::ThreadRng()
+     * @return      A non zero scalar
+     * @details     Never zero, a zero weight would drop its equation from the combined check.
+     * @tparam      FieldType Scalar field of the weight
+     */
+    template <typename FieldType, typename Rng>
+    typename FieldType::value_type RandomWeight( Rng &rng )
+    {
+        cpp_int weight = 0;
+        for ( int i = 0; i < 2; ++i )
+        {
+            weight = ( weight << 64 ) | cpp_int( rng() );
+        }
+        return typename FieldType::value_type( weight == 0 ? cpp_int( 1 ) : weight );
+    }
+
+    /**
+     * @brief       Precomputed multiples of a fixed point for fast scalar multiplications
+     * @details     Holds d * 16^w * base for every 4 bit window w and digit d, so a multiplication
+     *              is one addition per window and no doublings.
+     * @tparam      G1Value Curve point type
+     */
+    template <typename G1Value>
+    class FixedBaseTable
+    {
+    public:
+        static constexpr std::size_t WINDOW_BITS = 4;                  ///< Bits of scalar consumed per table lookup
+        static constexpr std::size_t WINDOW_SIZE = 1u << WINDOW_BITS;  ///< Entries per window
+
+        /**
+         * @brief       Builds the table
+         * @param[in]   base Fixed point
+         * @param[in]   scalar_bits Maximum size of the scalars in bits
+         */
+        FixedBaseTable( const G1Value &base, std::size_t scalar_bits ) :
+            num_windows( ( scalar_bits + WINDOW_BITS - 1 ) / WINDOW_BITS ), //
+            table( num_windows * WINDOW_SIZE )
+        {
+            G1Value window_base = base;
+            for ( std::size_t window = 0; window < num_windows; ++window )
+            {
+                G1Value *row = &table[window * WINDOW_SIZE];
+                row[0]       = G1Value::zero();
+                for ( std::size_t digit = 1; digit < WINDOW_SIZE; ++digit )
+                {
+                    row[digit] = row[digit - 1] + window_base;
+                }
+                window_base = row[WINDOW_SIZE - 1] + window_base;
+            }
+        }
+
+        /**
+         * @brief       Multiplies the fixed point by a scalar
+         * @param[in]   scalar Field element whose integral value has at most scalar_bits bits
+         * @return      scalar * base
+         * @details     Every window is added, a zero digit adding the identity, and each entry is read with
+         *              @ref SelectEntry, so the loop schedule and the table reads follow a fixed pattern.
+         * @warning     Not constant time: the Jacobian addition of crypto3 takes shortcuts for the identity and
+         *              for equal operands, and the scalar is exported through cpp_int. Don't rely on it to hide
+         *              private keys from timing or cache side channels.
+         * @tparam      ScalarValue Scalar field element type
+         */
+        template <typename ScalarValue>
+        G1Value Mul( const ScalarValue &scalar ) const
+        {
+            const auto bytes = ScalarBytes( scalar );
+
+            G1Value result = G1Value::zero();
+            for ( std::size_t window = 0; window < num_windows; ++window )
+            {
+                result = result + SelectEntry( &table[window * WINDOW_SIZE], GetDigit( bytes, window ) );
+            }
+            return result;
+        }
+
+        /**
+         * @brief       Computes first_scalar * first_base + second_scalar * second_base in a single pass
+         * @param[in]   first Table of the first point
+         * @param[in]   first_scalar Multiplier of the first point
+         * @param[in]   second Table of the second point
+         * @param[in]   second_scalar Multiplier of the second point
+         * @return      Sum of both products
+         * @details     Both scalars are walked window by window with one accumulator (Shamir's trick),
+         *              which saves the final addition and the second scalar decomposition pass. Same
+         *              window schedule, and the same timing caveats, as @ref Mul.
+         * @tparam      FirstScalar Scalar field element type of the first multiplier
+         * @tparam      SecondScalar Scalar field element type of the second multiplier
+         */
+        template <typename FirstScalar, typename SecondScalar>
+        static G1Value DoubleMul( const FixedBaseTable &first, const FirstScalar &first_scalar, const FixedBaseTable &second,
+                                  const SecondScalar &second_scalar )
+        {
+            const auto first_bytes  = ScalarBytes( first_scalar );
+            const auto second_bytes = ScalarBytes( second_scalar );
+
+            const std::size_t num_windows = std::max( first.num_windows, second.num_windows );
+
+            G1Value result = G1Value::zero();
+            for ( std::size_t window = 0; window < num_windows; ++window )
+            {
+                // The table sizes are public, only the digits are secret
+                if ( window < first.num_windows )
+                {
+                    result = result + SelectEntry( &first.table[window * WINDOW_SIZE], GetDigit( first_bytes, window ) );
+                }
+                if ( window < second.num_windows )
+                {
+                    result = result + SelectEntry( &second.table[window * WINDOW_SIZE], GetDigit( second_bytes, window ) );
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief       Returns the number of points held
+         * @return      Windows times entries per window
+         */
+        std::size_t Size() const
+        {
+            return table.size();
+        }
+
+    private:
+        static_assert( WINDOW_BITS == 4, "Digits are read as nibbles of the scalar bytes" );
+
+        /**
+         * @brief       Fixed width big endian bytes of a scalar, the same length for every value
+         */
+        template <typename ScalarValue>
+        static std::array<std::uint8_t, FieldElementSize<typename ScalarValue::field_type>()> ScalarBytes( const ScalarValue &scalar )
+        {
+            std::array<std::uint8_t, FieldElementSize<typename ScalarValue::field_type>()> bytes;
+            FieldElementToBigEndian<typename ScalarValue::field_type>( scalar, bytes.data() );
+            return bytes;
+        }
+
+        /**
+         * @brief       Digit of a window, 0 past the scalar bytes
+         */
+        template <std::size_t NUM_BYTES>
+        static std::size_t GetDigit( const std::array<std::uint8_t, NUM_BYTES> &bytes, std::size_t window )
+        {
+            if ( window / 2 >= NUM_BYTES )
+            {
+                return 0;
+            }
+            return ( bytes[NUM_BYTES - 1 - window / 2] >> ( WINDOW_BITS * ( window % 2 ) ) ) & ( WINDOW_SIZE - 1 );
+        }
+
+        /**
+         * @brief       Reads row[digit], touching every entry of the row in the same order whatever the digit
+         * @details     The digit only picks between two local copies, with an index computed without branches,
+         *              so the entries read don't reveal it. The point arithmetic around it is not constant time.
+         */
+        static G1Value SelectEntry( const G1Value *row, std::size_t digit )
+        {
+            G1Value selected = row[0];
+            for ( std::size_t entry = 1; entry < WINDOW_SIZE; ++entry )
+            {
+                const G1Value     options[2] = { selected, row[entry] };
+                const std::size_t is_digit   = ( ( entry ^ digit ) - 1 ) >> ( 8 * sizeof( std::size_t ) - 1 ); // 1 only if entry == digit
+                selected                     = options[is_digit];
+            }
+            return selected;
+        }
+
+        std::size_t          num_windows; ///< Number of scalar windows
+        std::vector<G1Value> table;       ///< Row w holds the multiples of 16^w * base
+    };
+
+    /**
+     * @brief       Table of multiples of the curve generator
+     * @return      The table, built once per curve and shared by every caller and thread
+     * @tparam      CurveType Curve of the generator
+     */
+    template <typename CurveType>
+    const FixedBaseTable<typename CurveType::template g1_type<>::value_type> &GeneratorTable()
+    {
+        using g1_value_type = typename CurveType::template g1_type<>::value_type;
+
+        static const FixedBaseTable<g1_value_type> generator_table( g1_value_type::one(), CurveType::scalar_field_type::number_bits );
+        return generator_table;
+    }
+
+    /**
+     * @brief       Computes private_key * G for many keys and returns them in affine form
+     * @param[in]   private_keys Scalars to multiply the curve generator by
+     * @param[in]   count Number of scalars
+     * @param[out]  public_keys Destination of @p count affine points
+     * @tparam      CurveType Curve of the keys
+     * @details     Uses the shared @ref GeneratorTable.
+     */
+    template <typename CurveType>
+    void GeneratorMulBatch( const typename CurveType::scalar_field_type::value_type *private_keys, std::size_t count,
+                            typename CurveType::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type *public_keys )
+    {
+        using g1_value_type = typename CurveType::template g1_type<>::value_type;
+
+        const auto &generator_table = GeneratorTable<CurveType>();
+
+        std::vector<g1_value_type> points( count );
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            points[i] = generator_table.Mul( private_keys[i] );
+        }
+        BatchToAffine( points.data(), count, public_keys );
+    }
+}
+
+#endif
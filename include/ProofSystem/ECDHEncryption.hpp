@@ -16,6 +16,7 @@
 #include "ProofSystem/Encryption.hpp"
 #include "ProofSystem/ext_private_key.hpp"
 #include "ProofSystem/ECDSATypes.hpp"
+#include "ProofSystem/Metrics.hpp"
 #include "ProofSystem/util.hpp"
 
 /**
@@ -73,6 +74,8 @@ public:
     {
         using namespace nil::crypto3::hashes;
 
+        PROOFSYSTEM_SCOPED_TIMER( "ecdh_setup_seconds" );
+
         auto new_point = own_key * foreign_key;
 
         nil::marshalling::bincode::field<ecdsa_t::base_field_type>::field_element_to_bytes<std::array<std::uint8_t, 32>::iterator>(
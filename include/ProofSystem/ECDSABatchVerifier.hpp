@@ -0,0 +1,326 @@
+/**
+ * @file       ECDSABatchVerifier.hpp
+ * @brief      Batch verification of ECDSA signatures
+ * @date       2024-03-18
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _ECDSA_BATCH_VERIFIER_HPP_
+#define _ECDSA_BATCH_VERIFIER_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <nil/crypto3/pubkey/algorithm/sign.hpp>
+
+#include "ProofSystem/ECDSAVerifier.hpp"
+#include "ProofSystem/ECBatchOps.hpp"
+#include "ProofSystem/ECPointCodec.hpp"
+#include "ProofSystem/MultiScalarMul.hpp"
+#include "ProofSystem/SecureRandom.hpp"
+#include "ProofSystem/ext_private_key.hpp"
+
+/**
+ * @brief       Outcome counters of @ref ECDSABatchVerifier::Verify
+ */
+struct ECDSABatchStats
+{
+    std::size_t signatures;    ///< Signatures in the batch
+    std::size_t invalid;       ///< Signatures that failed
+    std::size_t batch_checks;  ///< Multi-scalar checks evaluated, including the bisection ones
+    std::size_t single_checks; ///< Signatures verified one by one
+    double      seconds;       ///< Time spent in Verify
+
+    double SignaturesPerSecond() const
+    {
+        return seconds > 0 ? static_cast<double>( signatures ) / seconds : 0.0;
+    }
+};
+
+/**
+ * @brief       Verifies many ECDSA signatures with one multi-scalar multiplication
+ * @details     A signature ( r, s ) over e by Q is valid iff R = u1 * G + u2 * Q with u1 = e / s,
+ *              u2 = r / s and x( R ) = r. When the signer publishes which of the two points with that
+ *              x is R (the recovery id), all the equations can be checked at once with random 128 bit
+ *              weights z_i:
+ *
+ *                  ( sum z_i * u1_i ) * G + sum ( z_i * u2_i ) * Q_i - sum z_i * R_i = 0
+ *
+ *              The sum is a single Pippenger multi-scalar multiplication, with the terms of repeated
+ *              signer keys merged. A failed batch is split in halves until the invalid signatures are
+ *              isolated; small groups, and signatures without a recovery id, use the single verifier.
+ * @tparam      PolicyType ECDSA policy
+ */
+template <typename PolicyType>
+class ECDSABatchVerifier
+{
+public:
+    using Verifier_t              = ECDSAVerifier<PolicyType>;
+    using public_key_type         = typename Verifier_t::public_key_type;
+    using SignatureType           = typename Verifier_t::SignatureType;
+    using curve_type              = typename Verifier_t::curve_type;
+    using scalar_field_type       = typename Verifier_t::scalar_field_type;
+    using scalar_field_value_type = typename Verifier_t::scalar_field_value_type;
+    using g1_value_type           = typename Verifier_t::g1_value_type;
+
+    static constexpr int         UNKNOWN_RECOVERY_ID = -1; ///< The signature is checked on the single path
+    static constexpr std::size_t SINGLE_CHECK_SIZE   = 4;  ///< Groups this small are not bisected any further
+
+    /**
+     * @brief       Signature with the information needed to recover R
+     */
+    struct RecoverableSignature_t
+    {
+        SignatureType signature;   ///< ( r, s ) pair
+        int           recovery_id; ///< Bit 0: R.y is odd, bit 1: R.x = r + n. UNKNOWN_RECOVERY_ID if not known
+    };
+
+    /**
+     * @brief       One (message, signature, key) triple to verify
+     */
+    struct Entry_t
+    {
+        scalar_field_value_type encoded_message; ///< Message representative e, see ECDSAVerifier::EncodeMessage
+        RecoverableSignature_t  signature;       ///< Signature and recovery id
+        g1_value_type           signer;          ///< Public key of the signer
+    };
+
+    /**
+     * @brief       Builds an entry from a message
+     * @param[in]   message Signed data
+     * @param[in]   signature Signature, with or without recovery id
+     * @param[in]   signer Public key of the signer
+     * @return      The entry
+     */
+    template <typename MessageRange>
+    static Entry_t MakeEntry( const MessageRange &message, const RecoverableSignature_t &signature, const public_key_type &signer )
+    {
+        return Entry_t{ Verifier_t::EncodeMessage( message ), signature, signer.pubkey_data() };
+    }
+
+    /**
+     * @brief       Signs a message and reports the recovery id along with the signature
+     * @param[in]   message Data to sign
+     * @param[in]   private_key Signer key
+     * @return      Signature usable on the batch path
+     * @details     The nonce k = ( e + r * d ) / s is recovered from the signature, so the parity of R = k * G
+     *              is known whatever normalization the signer applied to s.
+     */
+    template <typename MessageRange>
+    static RecoverableSignature_t SignRecoverable( const MessageRange &message, const nil::crypto3::pubkey::ext_private_key<PolicyType> &private_key )
+    {
+        const SignatureType           signature = nil::crypto3::sign<PolicyType>( message, private_key );
+        const scalar_field_value_type nonce =
+            ( Verifier_t::EncodeMessage( message ) + signature.first * private_key.private_key_data() ) * signature.second.inversed();
+        const auto nonce_point = ecbatch::GeneratorTable<curve_type>().Mul( nonce ).to_affine();
+
+        std::array<std::uint8_t, Codec::COORDINATE_SIZE> y_bytes;
+        ecbatch::FieldElementToBigEndian<typename curve_type::base_field_type>( nonce_point.Y, y_bytes.data() );
+
+        int recovery_id = ( y_bytes.back() % 2 ) != 0 ? 1 : 0;
+        if ( static_cast<ecbatch::cpp_int>( nonce_point.X.data ) >= ScalarModulus() )
+        {
+            recovery_id |= 2;
+        }
+        return RecoverableSignature_t{ signature, recovery_id };
+    }
+
+    /**
+     * @brief       Verifies every entry
+     * @param[in]   entries Triples to check
+     * @param[out]  stats Optional counters and throughput
+     * @return      One flag per entry, true if its signature is valid
+     */
+    static std::vector<bool> Verify( const std::vector<Entry_t> &entries, ECDSABatchStats *stats = nullptr )
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        ECDSABatchStats   local_stats{ entries.size(), 0, 0, 0, 0.0 };
+        std::vector<bool> valid( entries.size(), false );
+
+        std::vector<Prepared_t>  prepared;
+        std::vector<std::size_t> single_path;
+        Prepare( entries, prepared, single_path );
+
+        for ( auto index : single_path )
+        {
+            valid[index] = VerifySingle( entries[index] );
+            ++local_stats.single_checks;
+        }
+        if ( !prepared.empty() )
+        {
+            CheckRange( entries, prepared, 0, prepared.size(), valid, local_stats );
+        }
+
+        for ( bool entry_valid : valid )
+        {
+            local_stats.invalid += entry_valid ? 0 : 1;
+        }
+        local_stats.seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+        if ( stats != nullptr )
+        {
+            *stats = local_stats;
+        }
+        return valid;
+    }
+
+private:
+    using Codec = ecpoint::PointCodec<curve_type>;
+
+    /**
+     * @brief       Batch path data of an entry
+     */
+    struct Prepared_t
+    {
+        std::size_t             index;      ///< Position in the entries
+        std::size_t             signer_id;  ///< Same value for entries with the same key
+        g1_value_type           nonce;      ///< Recovered R
+        scalar_field_value_type u1_weight;  ///< z * e / s
+        scalar_field_value_type u2_weight;  ///< z * r / s
+        scalar_field_value_type weight;     ///< z
+    };
+
+    static const ecbatch::cpp_int &ScalarModulus()
+    {
+        static const ecbatch::cpp_int modulus = static_cast<ecbatch::cpp_int>( scalar_field_type::modulus );
+        return modulus;
+    }
+
+    static bool RecoverNonce( const RecoverableSignature_t &signature, g1_value_type &nonce )
+    {
+        if ( signature.recovery_id < 0 || signature.recovery_id > 3 || signature.signature.first.is_zero() ||
+             signature.signature.second.is_zero() )
+        {
+            return false;
+        }
+        ecbatch::cpp_int x_value = static_cast<ecbatch::cpp_int>( signature.signature.first.data );
+        if ( ( signature.recovery_id & 2 ) != 0 )
+        {
+            x_value += ScalarModulus();
+        }
+        if ( x_value >= static_cast<ecbatch::cpp_int>( curve_type::base_field_type::modulus ) )
+        {
+            return false;
+        }
+
+        typename Codec::Compressed_t compressed;
+        compressed[0] = ( signature.recovery_id & 1 ) != 0 ? Codec::PARITY_ODD_ID : Codec::PARITY_EVEN_ID;
+        ecbatch::FieldElementToBigEndian<typename curve_type::base_field_type>( typename curve_type::base_field_type::value_type( x_value ),
+                                                                               compressed.data() + 1 );
+        try
+        {
+            nonce = Codec::Decompress( compressed.data() );
+        }
+        catch ( const std::runtime_error & )
+        {
+            return false;
+        }
+        return true;
+    }
+
+    static void Prepare( const std::vector<Entry_t> &entries, std::vector<Prepared_t> &prepared, std::vector<std::size_t> &single_path )
+    {
+        std::unordered_map<std::string, std::size_t> signer_ids;
+
+        std::vector<scalar_field_value_type> s_inverses;
+        for ( std::size_t i = 0; i < entries.size(); ++i )
+        {
+            Prepared_t item;
+            item.index = i;
+            if ( entries[i].signer.is_zero() || !RecoverNonce( entries[i].signature, item.nonce ) )
+            {
+                single_path.push_back( i );
+                continue;
+            }
+            typename Codec::Compressed_t compressed;
+            Codec::Compress( entries[i].signer, compressed.data() );
+            item.signer_id = signer_ids.emplace( std::string( compressed.begin(), compressed.end() ), signer_ids.size() ).first->second;
+            item.weight    = ecbatch::RandomWeight<scalar_field_type>( csprng::ThreadRng() );
+
+            prepared.push_back( item );
+            s_inverses.push_back( entries[i].signature.signature.second );
+        }
+
+        ecbatch::BatchInvert( s_inverses.data(), s_inverses.size() );
+        for ( std::size_t i = 0; i < prepared.size(); ++i )
+        {
+            const auto &signature  = entries[prepared[i].index].signature.signature;
+            const auto  weighted_w = prepared[i].weight * s_inverses[i];
+
+            prepared[i].u1_weight = entries[prepared[i].index].encoded_message * weighted_w;
+            prepared[i].u2_weight = signature.first * weighted_w;
+        }
+    }
+
+    static bool VerifySingle( const Entry_t &entry )
+    {
+        return Verifier_t::Instance().VerifyEncoded( entry.encoded_message, entry.signature.signature, entry.signer );
+    }
+
+    static bool BatchEquationHolds( const std::vector<Entry_t> &entries, const std::vector<Prepared_t> &prepared, std::size_t begin,
+                                    std::size_t end )
+    {
+        std::vector<g1_value_type>           points;
+        std::vector<scalar_field_value_type> scalars;
+        points.reserve( 2 * ( end - begin ) + 1 );
+        scalars.reserve( 2 * ( end - begin ) + 1 );
+
+        points.push_back( g1_value_type::one() );
+        scalars.push_back( scalar_field_value_type::zero() );
+
+        std::unordered_map<std::size_t, std::size_t> signer_slots;
+        for ( std::size_t i = begin; i < end; ++i )
+        {
+            scalars[0] = scalars[0] + prepared[i].u1_weight;
+
+            auto slot = signer_slots.emplace( prepared[i].signer_id, points.size() );
+            if ( slot.second )
+            {
+                points.push_back( entries[prepared[i].index].signer );
+                scalars.push_back( prepared[i].u2_weight );
+            }
+            else
+            {
+                scalars[slot.first->second] = scalars[slot.first->second] + prepared[i].u2_weight;
+            }
+
+            points.push_back( prepared[i].nonce );
+            scalars.push_back( -prepared[i].weight );
+        }
+        return msm::MultiScalarMul( points, scalars ).is_zero();
+    }
+
+    static void CheckRange( const std::vector<Entry_t> &entries, const std::vector<Prepared_t> &prepared, std::size_t begin, std::size_t end,
+                            std::vector<bool> &valid, ECDSABatchStats &stats )
+    {
+        if ( end - begin <= SINGLE_CHECK_SIZE )
+        {
+            for ( std::size_t i = begin; i < end; ++i )
+            {
+                valid[prepared[i].index] = VerifySingle( entries[prepared[i].index] );
+                ++stats.single_checks;
+            }
+            return;
+        }
+
+        ++stats.batch_checks;
+        if ( BatchEquationHolds( entries, prepared, begin, end ) )
+        {
+            for ( std::size_t i = begin; i < end; ++i )
+            {
+                valid[prepared[i].index] = true;
+            }
+            return;
+        }
+        const std::size_t middle = begin + ( end - begin ) / 2;
+        CheckRange( entries, prepared, begin, middle, valid, stats );
+        CheckRange( entries, prepared, middle, end, valid, stats );
+    }
+};
+
+#endif
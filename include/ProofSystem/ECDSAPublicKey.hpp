@@ -4,6 +4,12 @@
  * @date       2023-12-26
  * @author     Henrique A. Klein (henryaklein@gmail.com)
  */
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include "ProofSystem/util.hpp"
@@ -13,21 +19,45 @@
 
 /**
  * @brief       Base class to organize public key values of ECDSA
+ * @details     Holds the affine point once, as big endian coordinates. The text and compressed
+ *              encodings are only built the first time they are asked for, then cached.
  */
 class ECDSAPublicKey
 {
 public:
+    static constexpr std::size_t COORDINATE_SIZE = 32; ///< Size of a secp256k1 coordinate in bytes
+
+    using Coordinate_t   = std::array<std::uint8_t, COORDINATE_SIZE>;     ///< Big endian coordinate
+    using Uncompressed_t = std::array<std::uint8_t, 2 * COORDINATE_SIZE>; ///< X and Y big endian, without prefix
+    using Compressed_t   = std::array<std::uint8_t, 1 + COORDINATE_SIZE>; ///< SEC1 parity prefix then X big endian
+
+    static constexpr std::uint8_t PARITY_EVEN_ID = 2; ///< SEC1 prefix of a point with even Y
+    static constexpr std::uint8_t PARITY_ODD_ID  = 3; ///< SEC1 prefix of a point with odd Y
+
+    /**
+     * @brief       Constructs a new ECDSAPublicKey object from a normalized affine point
+     * @param[in]   x_coord Big endian X coordinate
+     * @param[in]   y_coord Big endian Y coordinate
+     */
+    ECDSAPublicKey( const Coordinate_t &x_coord, const Coordinate_t &y_coord )
+    {
+        std::copy( x_coord.begin(), x_coord.end(), uncompressed.begin() );
+        std::copy( y_coord.begin(), y_coord.end(), uncompressed.begin() + COORDINATE_SIZE );
+    }
     /**
      * @brief       Constructs a new ECDSAPublicKey object
-     * @param[in]   X_data vector representing the X coordinate of the public key. 
-     * @param[in]   Y_data vector representing the Y coordinate of the public key.
+     * @param[in]   X_data vector representing the X coordinate of the public key, LSB first
+     * @param[in]   Y_data vector representing the Y coordinate of the public key, LSB first
      */
-    ECDSAPublicKey( std::vector<std::uint8_t> X_data, std::vector<std::uint8_t> Y_data ) :
-        X( util::to_string( X_data ) ), //
-        Y( util::to_string( Y_data ) ), //
-        X_vect( std::move( X_data ) ),  //
-        Y_vect( std::move( Y_data ) )
+    [[deprecated( "Use the big endian Coordinate_t constructor" )]] ECDSAPublicKey( const std::vector<std::uint8_t> &X_data,
+                                                                                   const std::vector<std::uint8_t> &Y_data )
     {
+        if ( X_data.size() != COORDINATE_SIZE || Y_data.size() != COORDINATE_SIZE )
+        {
+            throw std::runtime_error( "Public key coordinates must be 32 bytes each" );
+        }
+        std::reverse_copy( X_data.begin(), X_data.end(), uncompressed.begin() );
+        std::reverse_copy( Y_data.begin(), Y_data.end(), uncompressed.begin() + COORDINATE_SIZE );
     }
     /**
      * @brief       Virtual destructor to prevent memory leak
@@ -36,31 +66,142 @@ public:
     {
     }
 
-    const std::string               X;      ///< String representation of X coordinate
-    const std::string               Y;      ///< String representation of Y coordinate
-    const std::vector<std::uint8_t> X_vect; ///< Vector representation of X coordinate
-    const std::vector<std::uint8_t> Y_vect; ///< Vector representation of Y coordinate
+    /**
+     * @brief       Returns the X and Y coordinates, big endian
+     * @return      The 64 bytes of the uncompressed point
+     */
+    [[nodiscard]] const Uncompressed_t &GetUncompressed() const
+    {
+        return uncompressed;
+    }
+    /**
+     * @brief       Returns the SEC1 compressed form of the point
+     * @return      Parity prefix of Y followed by X
+     */
+    [[nodiscard]] const Compressed_t &GetCompressed() const
+    {
+        std::call_once( compressed_once,
+                        [this]()
+                        {
+                            compressed[0] = IsYOdd() ? PARITY_ODD_ID : PARITY_EVEN_ID;
+                            std::copy( uncompressed.begin(), uncompressed.begin() + COORDINATE_SIZE, compressed.begin() + 1 );
+                        } );
+        return compressed;
+    }
+    /**
+     * @brief       Returns the SEC1 compressed form of the point as text
+     * @return      66 lowercase hex digits, 02 or 03 followed by X
+     */
+    [[nodiscard]] std::string GetCompressedKey() const
+    {
+        const auto &compressed_key = GetCompressed();
+        return ToHex( compressed_key.begin(), compressed_key.end() );
+    }
+    /**
+     * @brief       Tells the parity of the Y coordinate
+     * @return      true if Y is odd
+     */
+    [[nodiscard]] bool IsYOdd() const
+    {
+        return ( uncompressed.back() % 2 ) != 0;
+    }
+    /**
+     * @brief       Returns the hexadecimal X coordinate
+     * @return      Lowercase hex, most significant digit first
+     */
+    [[nodiscard]] const std::string &GetX() const
+    {
+        MaterializeHex();
+        return x_hex;
+    }
+    /**
+     * @brief       Returns the hexadecimal Y coordinate
+     * @return      Lowercase hex, most significant digit first
+     */
+    [[nodiscard]] const std::string &GetY() const
+    {
+        MaterializeHex();
+        return y_hex;
+    }
+
+    /**
+     * @brief       String representation of X coordinate
+     */
+    [[deprecated( "Use GetX" )]] const std::string &X() const
+    {
+        return GetX();
+    }
+    /**
+     * @brief       String representation of Y coordinate
+     */
+    [[deprecated( "Use GetY" )]] const std::string &Y() const
+    {
+        return GetY();
+    }
+    /**
+     * @brief       Vector representation of X coordinate, LSB first
+     */
+    [[deprecated( "Use GetUncompressed" )]] std::vector<std::uint8_t> X_vect() const
+    {
+        return std::vector<std::uint8_t>( uncompressed.rend() - COORDINATE_SIZE, uncompressed.rend() );
+    }
+    /**
+     * @brief       Vector representation of Y coordinate, LSB first
+     */
+    [[deprecated( "Use GetUncompressed" )]] std::vector<std::uint8_t> Y_vect() const
+    {
+        return std::vector<std::uint8_t>( uncompressed.rbegin(), uncompressed.rbegin() + COORDINATE_SIZE );
+    }
 
     /**
-     * @brief       Overloads the assignment to string. 
+     * @brief       Overloads the assignment to string.
      * @return      The appropriate public key value used for the parent class
      */
-    operator std::string &()
+    operator const std::string &() const
     {
-        if ( pubkey_used_value == "" )
-        {
-            pubkey_used_value = CalcPubkeyUsedValue();
-        }
+        std::call_once( used_value_once, [this]() { pubkey_used_value = CalcPubkeyUsedValue(); } );
         return pubkey_used_value;
     }
 
     [[nodiscard]] std::string GetEntireKey() const
     {
-        return ( X + Y );
+        return ( GetX() + GetY() );
+    }
+
+protected:
+    /**
+     * @brief       Hex encodes big endian bytes
+     * @param[in]   begin First byte
+     * @param[in]   end One past the last byte
+     * @return      Lowercase hex string
+     */
+    template <typename Iterator>
+    static std::string ToHex( Iterator begin, Iterator end )
+    {
+        // util::to_string prints the last byte first
+        return util::to_string( std::vector<std::uint8_t>( std::make_reverse_iterator( end ), std::make_reverse_iterator( begin ) ) );
     }
 
 private:
-    std::string pubkey_used_value; ///< Used value of the public key (compressed, uncompressed..)
+    Uncompressed_t uncompressed; ///< Normalized affine point
+
+    mutable std::once_flag hex_once;          ///< Guards the hex encodings
+    mutable std::string    x_hex;             ///< Cached hex of X
+    mutable std::string    y_hex;             ///< Cached hex of Y
+    mutable std::once_flag compressed_once;   ///< Guards the compressed encoding
+    mutable Compressed_t   compressed{};      ///< Cached compressed encoding
+    mutable std::once_flag used_value_once;   ///< Guards the used value
+    mutable std::string    pubkey_used_value; ///< Used value of the public key (compressed, uncompressed..)
+
+    void MaterializeHex() const
+    {
+        std::call_once( hex_once,
+                        [this]()
+                        {
+                            x_hex = ToHex( uncompressed.begin(), uncompressed.begin() + COORDINATE_SIZE );
+                            y_hex = ToHex( uncompressed.begin() + COORDINATE_SIZE, uncompressed.end() );
+                        } );
+    }
 
     /**
      * @brief       Calculates the single data used key value
@@ -0,0 +1,252 @@
+/**
+ * @file       ECDSAVerifier.hpp
+ * @brief      ECDSA verification with cached tables of the signer keys
+ * @date       2024-03-15
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _ECDSA_VERIFIER_HPP_
+#define _ECDSA_VERIFIER_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include <nil/crypto3/pkpad/algorithms/encode.hpp>
+
+#include "ProofSystem/ECDSATypes.hpp"
+#include "ProofSystem/ECBatchOps.hpp"
+#include "ProofSystem/ECPointCodec.hpp"
+#include "ProofSystem/PublicKeyCache.hpp"
+
+/**
+ * @brief       Counters of an @ref ECDSAVerifier
+ */
+struct ECDSAVerifierStats
+{
+    std::uint64_t verifications; ///< Signatures checked
+    std::uint64_t table_hits;    ///< Verifications that used a signer table
+    std::uint64_t tables_built;  ///< Signer tables computed
+    std::uint64_t evictions;     ///< Signers dropped to respect the capacity
+};
+
+/**
+ * @brief       ECDSA verifier for a small set of long lived signers
+ * @details     Checks r == x( u1 * G + u2 * Q ) like nil::crypto3::verify, with u1 = e / s and u2 = r / s.
+ *              G always uses the shared generator table. Once a signer key Q has been seen
+ *              table_threshold times, a table of its multiples is built and kept in an LRU list, and
+ *              both products are accumulated in a single doubling free pass.
+ * @tparam      PolicyType ECDSA policy, which defines the curve and the message padding
+ */
+template <typename PolicyType>
+class ECDSAVerifier
+{
+public:
+    using public_key_type         = ecdsa_t::pubkey::public_key<PolicyType>;
+    using SignatureType           = typename public_key_type::signature_type;
+    using curve_type              = typename public_key_type::curve_type;
+    using padding_policy          = typename public_key_type::padding_policy;
+    using scalar_field_type       = typename curve_type::scalar_field_type;
+    using scalar_field_value_type = typename scalar_field_type::value_type;
+    using g1_value_type           = typename curve_type::template g1_type<>::value_type;
+    using Table_t                 = ecbatch::FixedBaseTable<g1_value_type>;
+
+    static constexpr std::size_t DEFAULT_MAX_SIGNERS     = 64; ///< Signer tables kept, about 100 KiB each on secp256k1
+    static constexpr std::size_t DEFAULT_TABLE_THRESHOLD = 2;  ///< Verifications of a signer before its table is built
+
+    /**
+     * @brief       Constructs a new ECDSAVerifier
+     * @param[in]   max_signers Number of signers tracked before the least recently used is dropped
+     * @param[in]   table_threshold Number of verifications of a signer that triggers its table, 1 builds it right away
+     */
+    explicit ECDSAVerifier( std::size_t max_signers = DEFAULT_MAX_SIGNERS, std::size_t table_threshold = DEFAULT_TABLE_THRESHOLD ) :
+        max_signers( std::max<std::size_t>( 1, max_signers ) ), //
+        table_threshold( std::max<std::size_t>( 1, table_threshold ) )
+    {
+    }
+
+    /**
+     * @brief       Verifier shared by the KDF of this policy
+     * @return      The instance for PolicyType
+     */
+    static ECDSAVerifier &Instance()
+    {
+        static ECDSAVerifier instance;
+        return instance;
+    }
+
+    /**
+     * @brief       Hashes and pads a message the way the policy signs it
+     * @param[in]   message Signed data
+     * @return      The message representative e
+     */
+    template <typename MessageRange>
+    static scalar_field_value_type EncodeMessage( const MessageRange &message )
+    {
+        nil::crypto3::pubkey::padding::encoding_accumulator_set<padding_policy> accumulator;
+        nil::crypto3::encode<padding_policy>( message, accumulator );
+        return nil::crypto3::pubkey::padding::accumulators::extract::encode<padding_policy>( accumulator );
+    }
+
+    /**
+     * @brief       Verifies a signature
+     * @param[in]   message Signed data
+     * @param[in]   signature ( r, s ) pair
+     * @param[in]   signer Public key of the signer
+     * @return      true if the signature is valid, same outcome as nil::crypto3::verify
+     */
+    template <typename MessageRange>
+    bool Verify( const MessageRange &message, const SignatureType &signature, const public_key_type &signer )
+    {
+        return VerifyEncoded( EncodeMessage( message ), signature, signer.pubkey_data() );
+    }
+
+    /**
+     * @brief       Verifies a signature from a text signer key
+     * @param[in]   message Signed data
+     * @param[in]   signature ( r, s ) pair
+     * @param[in]   signer_hex Public key in any form accepted by ecpoint::PointCodec::FromHex
+     * @return      true if the signature is valid
+     * @warning     Throws std::runtime_error if the key is invalid
+     */
+    template <typename MessageRange>
+    bool Verify( const MessageRange &message, const SignatureType &signature, std::string_view signer_hex )
+    {
+        return VerifyEncoded( EncodeMessage( message ), signature, ecpoint::PublicKeyCache<curve_type>::Instance().Get( signer_hex ) );
+    }
+
+    /**
+     * @brief       Verifies a signature over an already encoded message
+     * @param[in]   encoded_message Message representative e, see @ref EncodeMessage
+     * @param[in]   signature ( r, s ) pair
+     * @param[in]   signer Public key point of the signer
+     * @return      true if the signature is valid
+     */
+    bool VerifyEncoded( const scalar_field_value_type &encoded_message, const SignatureType &signature, const g1_value_type &signer )
+    {
+        verifications.fetch_add( 1, std::memory_order_relaxed );
+        if ( signature.first.is_zero() || signature.second.is_zero() || signer.is_zero() )
+        {
+            return false;
+        }
+        const scalar_field_value_type w  = signature.second.inversed();
+        const scalar_field_value_type u1 = encoded_message * w;
+        const scalar_field_value_type u2 = signature.first * w;
+
+        const auto &generator_table = ecbatch::GeneratorTable<curve_type>();
+
+        g1_value_type check_point;
+        if ( auto signer_table = FindTable( signer ) )
+        {
+            table_hits.fetch_add( 1, std::memory_order_relaxed );
+            check_point = Table_t::DoubleMul( generator_table, u1, *signer_table, u2 );
+        }
+        else
+        {
+            check_point = generator_table.Mul( u1 ) + u2 * signer;
+        }
+        if ( check_point.is_zero() )
+        {
+            return false;
+        }
+        const auto x_coordinate = static_cast<ecbatch::cpp_int>( check_point.to_affine().X.data );
+        return signature.first == scalar_field_value_type( ecbatch::cpp_int( x_coordinate % ScalarModulus() ) );
+    }
+
+    /**
+     * @brief       Reads the counters
+     * @return      Verifications, table hits, tables built and evictions
+     */
+    ECDSAVerifierStats GetStats() const
+    {
+        return ECDSAVerifierStats{ verifications.load( std::memory_order_relaxed ), table_hits.load( std::memory_order_relaxed ),
+                                   tables_built.load( std::memory_order_relaxed ), evictions.load( std::memory_order_relaxed ) };
+    }
+
+private:
+    using Codec  = ecpoint::PointCodec<curve_type>;
+    using Key_t  = std::string;
+    using Slot_t = std::pair<Key_t, std::pair<std::size_t, std::shared_ptr<const Table_t>>>; ///< Key, uses and table
+
+    const std::size_t max_signers;     ///< Capacity of the LRU list
+    const std::size_t table_threshold; ///< Uses of a signer before its table is built
+
+    std::mutex                                                    signers_mutex; ///< Guards the LRU list
+    std::list<Slot_t>                                             signers;       ///< Most recently used first
+    std::unordered_map<Key_t, typename std::list<Slot_t>::iterator> signer_index;  ///< Compressed key to slot
+
+    std::atomic<std::uint64_t> verifications{ 0 }; ///< Signatures checked
+    std::atomic<std::uint64_t> table_hits{ 0 };    ///< Verifications with a signer table
+    std::atomic<std::uint64_t> tables_built{ 0 };  ///< Signer tables computed
+    std::atomic<std::uint64_t> evictions{ 0 };     ///< Signers dropped
+
+    static const ecbatch::cpp_int &ScalarModulus()
+    {
+        static const ecbatch::cpp_int modulus = static_cast<ecbatch::cpp_int>( scalar_field_type::modulus );
+        return modulus;
+    }
+
+    /**
+     * @brief       Counts a use of the signer and returns its table, building it at the threshold
+     * @param[in]   signer Public key point
+     * @return      The table, or nullptr while the signer is below the threshold
+     */
+    std::shared_ptr<const Table_t> FindTable( const g1_value_type &signer )
+    {
+        typename Codec::Compressed_t compressed;
+        Codec::Compress( signer, compressed.data() );
+        Key_t key( compressed.begin(), compressed.end() );
+
+        std::size_t uses = 0;
+        {
+            std::lock_guard<std::mutex> lock( signers_mutex );
+            auto                        found = signer_index.find( key );
+            if ( found == signer_index.end() )
+            {
+                signers.emplace_front( key, std::make_pair( std::size_t{ 0 }, nullptr ) );
+                found = signer_index.emplace( key, signers.begin() ).first;
+                if ( signers.size() > max_signers )
+                {
+                    signer_index.erase( signers.back().first );
+                    signers.pop_back();
+                    evictions.fetch_add( 1, std::memory_order_relaxed );
+                }
+            }
+            else
+            {
+                signers.splice( signers.begin(), signers, found->second );
+            }
+            auto &slot = found->second->second;
+            if ( slot.second )
+            {
+                return slot.second;
+            }
+            uses = ++slot.first;
+        }
+        if ( uses < table_threshold )
+        {
+            return nullptr;
+        }
+
+        // Built outside of the lock, the verification doesn't need to wait for other signers
+        auto table = std::make_shared<const Table_t>( signer, scalar_field_type::number_bits );
+        tables_built.fetch_add( 1, std::memory_order_relaxed );
+
+        std::lock_guard<std::mutex> lock( signers_mutex );
+        auto                        found = signer_index.find( key );
+        if ( found != signer_index.end() && !found->second->second.second )
+        {
+            found->second->second.second = table;
+        }
+        return table;
+    }
+};
+
+#endif
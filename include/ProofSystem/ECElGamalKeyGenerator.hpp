@@ -9,6 +9,7 @@
 
 #include "ECElGamalTypes.hpp"
 #include "ECDSATypes.hpp"
+#include "SecureRandom.hpp"
 
 class ECElGamalKeyGenerator
 {
@@ -34,8 +35,7 @@ public:
 
     std::pair<ECElGamalPoint<ecdsa_t::CurveType>, ECElGamalPoint<ecdsa_t::CurveType>> EncryptData( const cpp_int &data )
     {
-        ecdsa_t::random_generator_type     random_gen;
-        auto                               random_num = random_gen();
+        auto                               random_num = csprng::RandomScalar<ecdsa_t::scalar_field_type>();
         ECElGamalPoint<ecdsa_t::CurveType> C1( random_num * ECElGamalPoint<ecdsa_t::CurveType>::curve_point_type::one() );
 
         ECElGamalPoint<ecdsa_t::CurveType> M( data );
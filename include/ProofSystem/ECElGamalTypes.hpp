@@ -16,6 +16,7 @@
 
 #include "ProofSystem/util.hpp"
 #include "ProofSystem/PrimeNumbers.hpp"
+#include "ProofSystem/PublicKeyCache.hpp"
 
 template <typename CurveType>
 struct ECElGamalPoint
@@ -126,19 +127,8 @@ struct PublicKey
     {
         //std::cout << "pub key " << std::hex << pubkey.to_affine().X.data << std::endl;
     }
-    PublicKey( std::string_view key_string )
+    PublicKey( std::string_view key_string ) : pubkey( ecpoint::PublicKeyCache<curve_type>::Instance().Get( key_string ) )
     {
-        auto z_data_one = g1_value_type::field_type::value_type::one();
-
-        std::vector<std::uint8_t> key_vector = util::HexASCII2NumStr<std::uint8_t>( key_string );
-
-        auto y_data = nil::marshalling::bincode::field<typename curve_type::base_field_type>::template field_element_from_bytes<
-            std::vector<std::uint8_t>::iterator>( key_vector.begin(), key_vector.begin() + key_vector.size() / 2 );
-        auto x_data = nil::marshalling::bincode::field<typename curve_type::base_field_type>::template field_element_from_bytes<
-            std::vector<std::uint8_t>::iterator>( key_vector.begin() + key_vector.size() / 2, key_vector.end() );
-
-        pubkey = public_key_type( x_data.second, y_data.second, z_data_one );
-        //std::cout << "pub key imported " << std::hex << pubkey.to_affine().X.data << std::endl;
     }
 
     inline public_key_type pubkey_data() const
@@ -146,6 +136,15 @@ struct PublicKey
         return pubkey;
     }
 
+    /**
+     * @brief       Exports the key in SEC1 compressed form, accepted back by the string constructor
+     * @return      Parity prefix followed by X, in hex
+     */
+    std::string GetCompressedKey() const
+    {
+        return ecpoint::PointCodec<curve_type>::ToCompressedHex( pubkey );
+    }
+
 protected:
     public_key_type pubkey;
 };
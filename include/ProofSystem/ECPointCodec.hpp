@@ -0,0 +1,279 @@
+/**
+ * @file       ECPointCodec.hpp
+ * @brief      SEC1 compressed and uncompressed encodings of curve points
+ * @date       2024-03-13
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _EC_POINT_CODEC_HPP_
+#define _EC_POINT_CODEC_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ProofSystem/ECBatchOps.hpp"
+#include "ProofSystem/ParallelFor.hpp"
+
+namespace ecpoint
+{
+    /**
+     * @brief       Imports and exports points of a short Weierstrass curve y^2 = x^3 + a*x + b
+     * @details     Text keys are accepted in three forms:
+     *              - 2 * COMPRESSED_SIZE hex digits: SEC1 compressed, 02 or 03 followed by X
+     *              - 2 * UNCOMPRESSED_SIZE hex digits: X followed by Y, the legacy format of this library
+     *              - 2 + 2 * UNCOMPRESSED_SIZE hex digits: SEC1 uncompressed, 04 followed by X and Y
+     * @tparam      CurveType Curve of the points
+     */
+    template <typename CurveType>
+    struct PointCodec
+    {
+        using base_field_type  = typename CurveType::base_field_type;
+        using field_value_type = typename base_field_type::value_type;
+        using integral_type    = typename base_field_type::integral_type;
+        using g1_value_type    = typename CurveType::template g1_type<>::value_type;
+        using params_type      = typename CurveType::template g1_type<>::params_type;
+
+        static constexpr std::size_t COORDINATE_SIZE   = ecbatch::FieldElementSize<base_field_type>(); ///< Bytes of a coordinate
+        static constexpr std::size_t COMPRESSED_SIZE   = 1 + COORDINATE_SIZE;                          ///< Prefix and X
+        static constexpr std::size_t UNCOMPRESSED_SIZE = 2 * COORDINATE_SIZE;                          ///< X and Y, without prefix
+
+        static constexpr std::uint8_t PARITY_EVEN_ID  = 2; ///< SEC1 prefix of a point with even Y
+        static constexpr std::uint8_t PARITY_ODD_ID   = 3; ///< SEC1 prefix of a point with odd Y
+        static constexpr std::uint8_t UNCOMPRESSED_ID = 4; ///< SEC1 prefix of an uncompressed point
+
+        using Compressed_t = std::array<std::uint8_t, COMPRESSED_SIZE>; ///< Binary compressed point
+
+        /**
+         * @brief       Computes a square root in the base field
+         * @param[in]   value Field element
+         * @param[out]  root One of the square roots of @p value, if any
+         * @return      false if @p value is not a quadratic residue
+         * @details     When p = 3 mod 4 (secp256k1) the root is value^((p + 1) / 4), a single exponentiation.
+         *              Other fields fall back on the generic Tonelli-Shanks of the field type.
+         */
+        static bool Sqrt( const field_value_type &value, field_value_type &root )
+        {
+            static const integral_type modulus = base_field_type::modulus;
+            if ( modulus % 4 == 3 )
+            {
+                static const integral_type sqrt_exponent = ( modulus + 1 ) / 4;
+                root = value.pow( sqrt_exponent );
+                return root.squared() == value;
+            }
+            if ( !value.is_square() )
+            {
+                return false;
+            }
+            root = value.sqrt();
+            return true;
+        }
+
+        /**
+         * @brief       Recovers a point from its compressed encoding
+         * @param[in]   compressed COMPRESSED_SIZE bytes, parity prefix then big endian X
+         * @return      The point, with Z = 1
+         * @warning     Throws std::runtime_error on a bad prefix, X >= p or X not on the curve
+         */
+        static g1_value_type Decompress( const std::uint8_t *compressed )
+        {
+            if ( compressed[0] != PARITY_EVEN_ID && compressed[0] != PARITY_ODD_ID )
+            {
+                throw std::runtime_error( "Invalid compressed point prefix" );
+            }
+            field_value_type x;
+            if ( !ecbatch::FieldElementFromBigEndian<base_field_type>( compressed + 1, x ) )
+            {
+                throw std::runtime_error( "Compressed point X is not a field element" );
+            }
+            field_value_type y;
+            if ( !Sqrt( CurveRhs( x ), y ) )
+            {
+                throw std::runtime_error( "Compressed point is not on the curve" );
+            }
+            if ( IsOdd( y ) != ( compressed[0] == PARITY_ODD_ID ) )
+            {
+                y = -y;
+            }
+            return g1_value_type( x, y, field_value_type::one() );
+        }
+
+        /**
+         * @brief       Recovers many compressed points, e.g. a whole peer list
+         * @param[in]   compressed count * COMPRESSED_SIZE contiguous bytes
+         * @param[in]   count Number of points
+         * @param[out]  points Destination of @p count points
+         * @param[in]   num_threads Number of threads, 0 to use the hardware concurrency
+         * @warning     Throws std::runtime_error if any of the points is invalid
+         */
+        static void DecompressBatch( const std::uint8_t *compressed, std::size_t count, g1_value_type *points, std::size_t num_threads = 0 )
+        {
+            util::ParallelFor(
+                count,
+                [&]( std::size_t begin, std::size_t end )
+                {
+                    for ( std::size_t i = begin; i < end; ++i )
+                    {
+                        points[i] = Decompress( compressed + i * COMPRESSED_SIZE );
+                    }
+                },
+                num_threads );
+        }
+
+        /**
+         * @brief       Recovers many compressed points
+         * @param[in]   compressed Compressed points
+         * @param[in]   num_threads Number of threads, 0 to use the hardware concurrency
+         * @return      The points, in the same order
+         */
+        static std::vector<g1_value_type> DecompressBatch( const std::vector<Compressed_t> &compressed, std::size_t num_threads = 0 )
+        {
+            std::vector<g1_value_type> points( compressed.size() );
+            DecompressBatch( compressed.empty() ? nullptr : compressed.front().data(), compressed.size(), points.data(), num_threads );
+            return points;
+        }
+
+        /**
+         * @brief       Writes the compressed encoding of a point
+         * @param[in]   point Point, in any Jacobian representation
+         * @param[out]  compressed Destination of COMPRESSED_SIZE bytes
+         */
+        static void Compress( const g1_value_type &point, std::uint8_t *compressed )
+        {
+            const auto affine = point.to_affine();
+
+            std::array<std::uint8_t, COORDINATE_SIZE> y_bytes;
+            ecbatch::FieldElementToBigEndian<base_field_type>( affine.Y, y_bytes.data() );
+            compressed[0] = ( y_bytes.back() % 2 ) != 0 ? PARITY_ODD_ID : PARITY_EVEN_ID;
+            ecbatch::FieldElementToBigEndian<base_field_type>( affine.X, compressed + 1 );
+        }
+
+        /**
+         * @brief       Returns the compressed encoding of a point as text
+         * @param[in]   point Point, in any Jacobian representation
+         * @return      2 * COMPRESSED_SIZE lowercase hex digits
+         */
+        static std::string ToCompressedHex( const g1_value_type &point )
+        {
+            Compressed_t compressed;
+            Compress( point, compressed.data() );
+            return ToHex( compressed.data(), compressed.size() );
+        }
+
+        /**
+         * @brief       Parses a point in any of the accepted text forms
+         * @param[in]   hex Compressed, legacy or SEC1 uncompressed hex key
+         * @return      The point, with Z = 1
+         * @warning     Throws std::runtime_error on an unknown length, a non hex digit, a bad prefix,
+         *              a coordinate >= p or a point that is not on the curve
+         */
+        static g1_value_type FromHex( std::string_view hex )
+        {
+            if ( hex.size() == 2 * COMPRESSED_SIZE )
+            {
+                const auto bytes = FromHexBytes( hex );
+                return Decompress( bytes.data() );
+            }
+            if ( hex.size() == 2 + 2 * UNCOMPRESSED_SIZE )
+            {
+                if ( FromHexBytes( hex.substr( 0, 2 ) ).front() != UNCOMPRESSED_ID )
+                {
+                    throw std::runtime_error( "Invalid uncompressed point prefix" );
+                }
+                hex.remove_prefix( 2 );
+            }
+            if ( hex.size() != 2 * UNCOMPRESSED_SIZE )
+            {
+                throw std::runtime_error( "Invalid public key length" );
+            }
+            const auto bytes = FromHexBytes( hex );
+
+            field_value_type x;
+            field_value_type y;
+            if ( !ecbatch::FieldElementFromBigEndian<base_field_type>( bytes.data(), x ) )
+            {
+                throw std::runtime_error( "Uncompressed point X is not a field element" );
+            }
+            if ( !ecbatch::FieldElementFromBigEndian<base_field_type>( bytes.data() + COORDINATE_SIZE, y ) )
+            {
+                throw std::runtime_error( "Uncompressed point Y is not a field element" );
+            }
+            g1_value_type point( x, y, field_value_type::one() );
+            if ( !IsOnCurve( point ) )
+            {
+                throw std::runtime_error( "Uncompressed point is not on the curve" );
+            }
+            return point;
+        }
+
+        /**
+         * @brief       Checks the curve equation, e.g. on a key imported in uncompressed form
+         * @param[in]   point Point with Z = 1, as returned by @ref FromHex
+         * @return      true if y^2 = x^3 + a*x + b
+         */
+        static bool IsOnCurve( const g1_value_type &point )
+        {
+            return point.Z == field_value_type::one() && point.Y.squared() == CurveRhs( point.X );
+        }
+
+    private:
+        static field_value_type CurveRhs( const field_value_type &x )
+        {
+            static const field_value_type a_coeff( params_type::a );
+            static const field_value_type b_coeff( params_type::b );
+            return ( x.squared() + a_coeff ) * x + b_coeff;
+        }
+
+        static bool IsOdd( const field_value_type &value )
+        {
+            std::array<std::uint8_t, COORDINATE_SIZE> bytes;
+            ecbatch::FieldElementToBigEndian<base_field_type>( value, bytes.data() );
+            return ( bytes.back() % 2 ) != 0;
+        }
+
+        static std::uint8_t HexDigit( char digit )
+        {
+            if ( digit >= '0' && digit <= '9' )
+            {
+                return static_cast<std::uint8_t>( digit - '0' );
+            }
+            if ( digit >= 'a' && digit <= 'f' )
+            {
+                return static_cast<std::uint8_t>( digit - 'a' + 10 );
+            }
+            if ( digit >= 'A' && digit <= 'F' )
+            {
+                return static_cast<std::uint8_t>( digit - 'A' + 10 );
+            }
+            throw std::runtime_error( "Invalid hex digit in public key" );
+        }
+
+        static std::vector<std::uint8_t> FromHexBytes( std::string_view hex )
+        {
+            std::vector<std::uint8_t> bytes( hex.size() / 2 );
+            for ( std::size_t i = 0; i < bytes.size(); ++i )
+            {
+                bytes[i] = static_cast<std::uint8_t>( ( HexDigit( hex[2 * i] ) << 4 ) | HexDigit( hex[2 * i + 1] ) );
+            }
+            return bytes;
+        }
+
+        static std::string ToHex( const std::uint8_t *bytes, std::size_t size )
+        {
+            static constexpr char DIGITS[] = "0123456789abcdef";
+
+            std::string hex( 2 * size, '0' );
+            for ( std::size_t i = 0; i < size; ++i )
+            {
+                hex[2 * i]     = DIGITS[bytes[i] >> 4];
+                hex[2 * i + 1] = DIGITS[bytes[i] & 0x0f];
+            }
+            return hex;
+        }
+    };
+}
+
+#endif
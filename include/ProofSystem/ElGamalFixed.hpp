@@ -0,0 +1,500 @@
+/**
+ * @file       ElGamalFixed.hpp
+ * @brief      ElGamal specialized at compile time on a fixed prime and generator
+ * @date       2024-03-27
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _EL_GAMAL_FIXED_HPP_
+#define _EL_GAMAL_FIXED_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "ProofSystem/ElGamalKeyGenerator.hpp"
+#include "ProofSystem/SecureRandom.hpp"
+
+namespace KeyGenerator
+{
+    /**
+     * @brief       Constexpr fixed width arithmetic behind @ref ElGamalFixed
+     * @details     Numbers are arrays of 64 bit limbs, least significant first. Every loop runs over a
+     *              compile time number of limbs, so the compiler unrolls them into straight line code.
+     */
+    namespace fixed_width
+    {
+        template <std::size_t N>
+        using Limbs_t = std::array<std::uint64_t, N>;
+
+        constexpr std::size_t WINDOW_BITS = 4;                ///< Exponent bits consumed per table lookup
+        constexpr std::size_t WINDOW_SIZE = 1 << WINDOW_BITS; ///< Entries per window
+
+        constexpr std::size_t HexLength( const char *hex )
+        {
+            std::size_t length = 0;
+            while ( hex[length] != '\0' )
+            {
+                ++length;
+            }
+            return length;
+        }
+
+        constexpr int HexDigit( char digit )
+        {
+            return digit >= '0' && digit <= '9'   ? digit - '0'
+                   : digit >= 'a' && digit <= 'f' ? digit - 'a' + 10
+                   : digit >= 'A' && digit <= 'F' ? digit - 'A' + 10
+                                                  : -1;
+        }
+
+        constexpr bool IsHex( const char *hex )
+        {
+            for ( std::size_t i = 0; hex[i] != '\0'; ++i )
+            {
+                if ( HexDigit( hex[i] ) < 0 )
+                {
+                    return false;
+                }
+            }
+            return hex[0] != '\0';
+        }
+
+        /**
+         * @brief       Parses big endian hex digits, without 0x prefix
+         */
+        template <std::size_t N>
+        constexpr Limbs_t<N> ParseHex( const char *hex )
+        {
+            Limbs_t<N>        value{};
+            const std::size_t length = HexLength( hex );
+            for ( std::size_t i = 0; i < length && i < N * 16; ++i )
+            {
+                const auto digit = static_cast<std::uint64_t>( HexDigit( hex[length - 1 - i] ) );
+                value[i / 16] |= digit << ( 4 * ( i % 16 ) );
+            }
+            return value;
+        }
+
+        /**
+         * @brief       a * b + c + d, which always fits in 128 bits
+         * @param[out]  high Upper 64 bits
+         * @return      Lower 64 bits
+         */
+        constexpr std::uint64_t MulAdd( std::uint64_t a, std::uint64_t b, std::uint64_t c, std::uint64_t d, std::uint64_t &high )
+        {
+#ifdef __SIZEOF_INT128__
+            const unsigned __int128 result = static_cast<unsigned __int128>( a ) * b + c + d;
+            high                           = static_cast<std::uint64_t>( result >> 64 );
+            return static_cast<std::uint64_t>( result );
+#else
+            const std::uint64_t a_lo = a & 0xffffffff, a_hi = a >> 32;
+            const std::uint64_t b_lo = b & 0xffffffff, b_hi = b >> 32;
+
+            const std::uint64_t lo_lo = a_lo * b_lo;
+            const std::uint64_t hi_lo = a_hi * b_lo;
+            const std::uint64_t lo_hi = a_lo * b_hi;
+            const std::uint64_t hi_hi = a_hi * b_hi;
+
+            const std::uint64_t cross = ( lo_lo >> 32 ) + ( hi_lo & 0xffffffff ) + lo_hi;
+            std::uint64_t       low   = ( cross << 32 ) | ( lo_lo & 0xffffffff );
+            high                      = hi_hi + ( hi_lo >> 32 ) + ( cross >> 32 );
+
+            low += c;
+            high += low < c ? 1 : 0;
+            low += d;
+            high += low < d ? 1 : 0;
+            return low;
+#endif
+        }
+
+        template <std::size_t N>
+        constexpr bool LessThan( const Limbs_t<N> &a, const Limbs_t<N> &b )
+        {
+            for ( std::size_t i = N; i-- > 0; )
+            {
+                if ( a[i] != b[i] )
+                {
+                    return a[i] < b[i];
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief       a == b, usable in constant expressions unlike the std::array operator in C++17
+         */
+        template <std::size_t N>
+        constexpr bool Equal( const Limbs_t<N> &a, const Limbs_t<N> &b )
+        {
+            for ( std::size_t i = 0; i < N; ++i )
+            {
+                if ( a[i] != b[i] )
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief       a -= b
+         * @return      The borrow out of the top limb
+         */
+        template <std::size_t N>
+        constexpr std::uint64_t SubInPlace( Limbs_t<N> &a, const Limbs_t<N> &b )
+        {
+            std::uint64_t borrow = 0;
+            for ( std::size_t i = 0; i < N; ++i )
+            {
+                const std::uint64_t difference = a[i] - b[i] - borrow;
+                borrow                         = ( a[i] < b[i] || ( a[i] == b[i] && borrow != 0 ) ) ? 1 : 0;
+                a[i]                           = difference;
+            }
+            return borrow;
+        }
+
+        /**
+         * @brief       a += small, a must not overflow
+         */
+        template <std::size_t N>
+        constexpr void AddSmall( Limbs_t<N> &a, std::uint64_t small )
+        {
+            for ( std::size_t i = 0; i < N && small != 0; ++i )
+            {
+                a[i] += small;
+                small = a[i] < small ? 1 : 0;
+            }
+        }
+
+        /**
+         * @brief       -modulus^-1 mod 2^64, by Newton iteration
+         */
+        constexpr std::uint64_t NegativeInverse( std::uint64_t modulus_low )
+        {
+            std::uint64_t inverse = modulus_low; // Correct to 3 bits for any odd number
+            for ( int i = 0; i < 5; ++i )
+            {
+                inverse *= 2 - modulus_low * inverse;
+            }
+            return ~inverse + 1;
+        }
+
+        /**
+         * @brief       Montgomery product a * b / 2^(64 N) mod modulus (CIOS)
+         */
+        template <std::size_t N>
+        constexpr Limbs_t<N> MontMul( const Limbs_t<N> &a, const Limbs_t<N> &b, const Limbs_t<N> &modulus, std::uint64_t n0 )
+        {
+            std::uint64_t t[N + 2] = {};
+            for ( std::size_t i = 0; i < N; ++i )
+            {
+                std::uint64_t carry = 0;
+                for ( std::size_t j = 0; j < N; ++j )
+                {
+                    t[j] = MulAdd( a[j], b[i], t[j], carry, carry );
+                }
+                t[N] += carry;
+                t[N + 1] = t[N] < carry ? 1 : 0;
+
+                const std::uint64_t m = t[0] * n0;
+                MulAdd( m, modulus[0], t[0], 0, carry );
+                for ( std::size_t j = 1; j < N; ++j )
+                {
+                    t[j - 1] = MulAdd( m, modulus[j], t[j], carry, carry );
+                }
+                t[N - 1] = t[N] + carry;
+                t[N]     = t[N + 1] + ( t[N - 1] < carry ? 1 : 0 );
+            }
+
+            Limbs_t<N> result{};
+            for ( std::size_t i = 0; i < N; ++i )
+            {
+                result[i] = t[i];
+            }
+            if ( t[N] != 0 || !LessThan( result, modulus ) )
+            {
+                SubInPlace( result, modulus );
+            }
+            return result;
+        }
+
+        /**
+         * @brief       2^(128 N) mod modulus, converts into the Montgomery domain
+         */
+        template <std::size_t N>
+        constexpr Limbs_t<N> MontgomerySquare( const Limbs_t<N> &modulus )
+        {
+            Limbs_t<N> value{};
+            value[0] = 1;
+            for ( std::size_t bit = 0; bit < 128 * N; ++bit )
+            {
+                const std::uint64_t top = value[N - 1] >> 63;
+                for ( std::size_t i = N; i-- > 1; )
+                {
+                    value[i] = ( value[i] << 1 ) | ( value[i - 1] >> 63 );
+                }
+                value[0] <<= 1;
+                if ( top != 0 || !LessThan( value, modulus ) )
+                {
+                    SubInPlace( value, modulus );
+                }
+            }
+            return value;
+        }
+
+        template <std::size_t N>
+        constexpr std::size_t Window( const Limbs_t<N> &exponent, std::size_t window )
+        {
+            const std::size_t bit = window * WINDOW_BITS;
+            return static_cast<std::size_t>( ( exponent[bit / 64] >> ( bit % 64 ) ) & ( WINDOW_SIZE - 1 ) );
+        }
+
+        /**
+         * @brief       Montgomery form of base^(d * 16^w) for every window w and digit d
+         */
+        template <std::size_t N>
+        constexpr std::array<Limbs_t<N>, N * 16 * WINDOW_SIZE> FixedBaseTable( const Limbs_t<N> &base, const Limbs_t<N> &modulus,
+                                                                                std::uint64_t n0, const Limbs_t<N> &r_squared )
+        {
+            std::array<Limbs_t<N>, N * 16 * WINDOW_SIZE> table{};
+            Limbs_t<N>                                   one{};
+            one[0] = 1;
+
+            Limbs_t<N> window_base = MontMul( base, r_squared, modulus, n0 );
+            for ( std::size_t w = 0; w < N * 16; ++w )
+            {
+                table[w * WINDOW_SIZE] = MontMul( one, r_squared, modulus, n0 );
+                for ( std::size_t d = 1; d < WINDOW_SIZE; ++d )
+                {
+                    table[w * WINDOW_SIZE + d] = MontMul( table[w * WINDOW_SIZE + d - 1], window_base, modulus, n0 );
+                }
+                window_base = MontMul( table[w * WINDOW_SIZE + WINDOW_SIZE - 1], window_base, modulus, n0 );
+            }
+            return table;
+        }
+    }
+
+    /**
+     * @brief       ElGamal over a prime and generator known at compile time
+     * @details     Same group, key and ciphertext layout as @ref ElGamal, so ciphertexts and keys convert both
+     *              ways with @ref ToCppInt and @ref FromCppInt. The modulus, the Montgomery constants and the
+     *              fixed base table of the generator are constexpr, the hot paths use fixed width Montgomery
+     *              arithmetic with no allocation. Additive decryption, which needs the baby step table,
+     *              stays with @ref ElGamal. Stateless apart from the keys, every member function is thread safe.
+     * @tparam      PRIME_HEX Big endian hex digits of the safe prime, without 0x prefix
+     * @tparam      GENERATOR_HEX Big endian hex digits of the generator
+     */
+    template <const char *PRIME_HEX, const char *GENERATOR_HEX>
+    class ElGamalFixed
+    {
+    public:
+        static constexpr std::size_t LIMBS = ( fixed_width::HexLength( PRIME_HEX ) * 4 + 63 ) / 64; ///< 64 bit limbs of an element
+
+        using Element_t = fixed_width::Limbs_t<LIMBS>; ///< Plain (not Montgomery) value below the prime, least significant limb first
+
+        /**
+         * @brief       Ciphertext ( g^r, m * y^r )
+         */
+        struct CypherText_t
+        {
+            Element_t a; ///< g^r
+            Element_t b; ///< m * y^r
+        };
+
+        static constexpr Element_t PRIME     = fixed_width::ParseHex<LIMBS>( PRIME_HEX );     ///< Group modulus
+        static constexpr Element_t GENERATOR = fixed_width::ParseHex<LIMBS>( GENERATOR_HEX ); ///< Group generator
+
+        static_assert( fixed_width::IsHex( PRIME_HEX ) && fixed_width::IsHex( GENERATOR_HEX ), "Parameters must be hex digits" );
+        static_assert( ( PRIME[0] & 1 ) == 1 && PRIME[LIMBS - 1] != 0, "The prime must be odd and without leading zero limbs" );
+        static_assert( fixed_width::LessThan( GENERATOR, PRIME ), "The generator must be reduced modulo the prime" );
+
+        /**
+         * @brief       Constructs a key pair with a random private key
+         */
+        ElGamalFixed() : ElGamalFixed( RandomExponent() )
+        {
+        }
+
+        /**
+         * @brief       Constructs the key pair of a private key
+         * @param[in]   private_key Private exponent
+         */
+        explicit ElGamalFixed( const Element_t &private_key ) :
+            private_key( private_key ), //
+            public_key( PowGenerator( private_key ) )
+        {
+        }
+
+        [[nodiscard]] const Element_t &GetPrivateKey() const
+        {
+            return private_key;
+        }
+
+        [[nodiscard]] const Element_t &GetPublicKey() const
+        {
+            return public_key;
+        }
+
+        /**
+         * @brief       a * b mod prime
+         */
+        static constexpr Element_t Mul( const Element_t &a, const Element_t &b )
+        {
+            // a * b / R, then times R^2 / R
+            return fixed_width::MontMul( fixed_width::MontMul( a, b, PRIME, N0 ), R_SQUARED, PRIME, N0 );
+        }
+
+        /**
+         * @brief       base^exponent mod prime, with a 4 bit window
+         */
+        static constexpr Element_t Pow( const Element_t &base, const Element_t &exponent )
+        {
+            std::array<Element_t, fixed_width::WINDOW_SIZE> powers{};
+            powers[0] = ONE;
+            powers[1] = fixed_width::MontMul( base, R_SQUARED, PRIME, N0 );
+            for ( std::size_t d = 2; d < fixed_width::WINDOW_SIZE; ++d )
+            {
+                powers[d] = fixed_width::MontMul( powers[d - 1], powers[1], PRIME, N0 );
+            }
+
+            Element_t result = ONE;
+            for ( std::size_t w = NUM_WINDOWS; w-- > 0; )
+            {
+                for ( std::size_t i = 0; i < fixed_width::WINDOW_BITS; ++i )
+                {
+                    result = fixed_width::MontMul( result, result, PRIME, N0 );
+                }
+                result = fixed_width::MontMul( result, powers[fixed_width::Window( exponent, w )], PRIME, N0 );
+            }
+            return FromMontgomery( result );
+        }
+
+        /**
+         * @brief       generator^exponent mod prime, one multiplication per window from the constexpr table
+         */
+        static constexpr Element_t PowGenerator( const Element_t &exponent )
+        {
+            Element_t result = ONE;
+            for ( std::size_t w = 0; w < NUM_WINDOWS; ++w )
+            {
+                result = fixed_width::MontMul( result, GENERATOR_TABLE[w * fixed_width::WINDOW_SIZE + fixed_width::Window( exponent, w )], PRIME, N0 );
+            }
+            return FromMontgomery( result );
+        }
+
+        /**
+         * @brief       Uniform exponent in [2, prime), drawn from the thread generator
+         */
+        static Element_t RandomExponent()
+        {
+            constexpr std::uint64_t TOP_MASK = ~std::uint64_t( 0 ) >> TopZeroBits();
+            Element_t               range    = PRIME;
+            fixed_width::SubInPlace( range, Element_t{ 2 } );
+
+            // Rejection sampling over the bit length of the prime, then shifted up by 2
+            auto &rng = csprng::ThreadRng();
+            while ( true )
+            {
+                Element_t candidate;
+                for ( auto &limb : candidate )
+                {
+                    limb = rng();
+                }
+                candidate[LIMBS - 1] &= TOP_MASK;
+                if ( fixed_width::LessThan( candidate, range ) )
+                {
+                    fixed_width::AddSmall( candidate, 2 );
+                    return candidate;
+                }
+            }
+        }
+
+        /**
+         * @brief       Encrypts a group element
+         * @param[in]   pubkey Public key y = g^x
+         * @param[in]   data Value below the prime
+         * @return      ( g^r, data * y^r )
+         */
+        static CypherText_t EncryptData( const Element_t &pubkey, const Element_t &data )
+        {
+            const Element_t random_value = RandomExponent();
+            return CypherText_t{ PowGenerator( random_value ), Mul( Pow( pubkey, random_value ), data ) };
+        }
+
+        /**
+         * @brief       Encrypts g^value, compatible with @ref ElGamal::DecryptDataAdditive
+         */
+        static CypherText_t EncryptDataAdditive( const Element_t &pubkey, const Element_t &value )
+        {
+            return EncryptData( pubkey, PowGenerator( value ) );
+        }
+
+        /**
+         * @brief       Decrypts with the private key, as b * a^( prime - 1 - x )
+         */
+        static constexpr Element_t DecryptData( const Element_t &prvkey, const CypherText_t &encrypted_data )
+        {
+            Element_t exponent = PRIME;
+            exponent[0] -= 1;
+            fixed_width::SubInPlace( exponent, prvkey );
+            return Mul( Pow( encrypted_data.a, exponent ), encrypted_data.b );
+        }
+
+        static Element_t FromCppInt( const cpp_int &value )
+        {
+            Element_t element{};
+            cpp_int   remaining = value % ToCppInt( PRIME );
+            for ( std::size_t i = 0; i < LIMBS; ++i )
+            {
+                element[i] = static_cast<std::uint64_t>( remaining & std::numeric_limits<std::uint64_t>::max() );
+                remaining >>= 64;
+            }
+            return element;
+        }
+
+        static cpp_int ToCppInt( const Element_t &element )
+        {
+            cpp_int value = 0;
+            for ( std::size_t i = LIMBS; i-- > 0; )
+            {
+                value = ( value << 64 ) | cpp_int( element[i] );
+            }
+            return value;
+        }
+
+    private:
+        static constexpr std::size_t   NUM_WINDOWS = LIMBS * 64 / fixed_width::WINDOW_BITS;                    ///< Windows of a full width exponent
+        static constexpr std::uint64_t N0          = fixed_width::NegativeInverse( PRIME[0] );                  ///< -prime^-1 mod 2^64
+        static constexpr Element_t     R_SQUARED   = fixed_width::MontgomerySquare( PRIME );                   ///< R^2 mod prime, R = 2^(64 LIMBS)
+        static constexpr Element_t     ONE         = fixed_width::MontMul( Element_t{ 1 }, R_SQUARED, PRIME, N0 ); ///< 1 in Montgomery form
+
+        /// Montgomery form of generator^(d * 16^w), computed by the compiler
+        static constexpr auto GENERATOR_TABLE = fixed_width::FixedBaseTable( GENERATOR, PRIME, N0, R_SQUARED );
+
+        Element_t private_key; ///< x
+        Element_t public_key;  ///< y = g^x
+
+        static constexpr Element_t FromMontgomery( const Element_t &value )
+        {
+            return fixed_width::MontMul( value, Element_t{ 1 }, PRIME, N0 );
+        }
+
+        static constexpr unsigned TopZeroBits()
+        {
+            unsigned bits = 0;
+            for ( std::uint64_t top = PRIME[LIMBS - 1]; ( top & ( std::uint64_t( 1 ) << 63 ) ) == 0; top <<= 1 )
+            {
+                ++bits;
+            }
+            return bits;
+        }
+    };
+
+    inline constexpr char ELGAMAL_SAFE_PRIME_HEX[] = "f3760a5583d3509b3f72b16e3c892129fef350406f88c268f503e877e043514f"; ///< @ref ElGamal::SAFE_PRIME
+    inline constexpr char ELGAMAL_GENERATOR_HEX[]  = "1a2c6b6fb9971c4a993069c76258ee18ba80f778fd4d7bc07186c70e73b93004"; ///< @ref ElGamal::GENERATOR
+
+    using ElGamalDefault = ElGamalFixed<ELGAMAL_SAFE_PRIME_HEX, ELGAMAL_GENERATOR_HEX>; ///< The default parameter set of @ref ElGamal
+}
+
+#endif
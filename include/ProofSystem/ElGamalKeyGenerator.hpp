@@ -8,8 +8,10 @@
 #ifndef _EL_GAMAL_KEY_GENERATOR_HPP_
 #define _EL_GAMAL_KEY_GENERATOR_HPP_
 
+#include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "ProofSystem/PrimeNumbers.hpp"
 #include "nil/crypto3/multiprecision/cpp_int.hpp"
@@ -27,11 +29,17 @@ namespace KeyGenerator
     using boost::multiprecision::literals::operator""_cppui256;
 #endif
 
+    /**
+     * @brief       ElGamal key pair over a safe prime group, with multiplicative and additive encryption
+     * @details     Keys and the baby step table never change after construction. Encryption draws its
+     *              randomness from the calling thread's generator, so concurrent encryption and decryption
+     *              through a shared instance need no locking.
+     */
     class ElGamal
     {
-        using CypherTextType = std::pair<cpp_int, cpp_int>;
-
     public:
+        using CypherTextType = std::pair<cpp_int, cpp_int>; ///< Ciphertext pair (a, b)
+
         constexpr static uint256_t SAFE_PRIME = 0xf3760a5583d3509b3f72b16e3c892129fef350406f88c268f503e877e043514f_cppui256;
         constexpr static uint256_t GENERATOR  = 0x1a2c6b6fb9971c4a993069c76258ee18ba80f778fd4d7bc07186c70e73b93004_cppui256;
         /**
@@ -87,7 +95,87 @@ namespace KeyGenerator
             const cpp_int private_key_scalar;
         };
 
-        cpp_int DecryptDataAdditive( const CypherTextType &encrypted_data );
+        /**
+         * @brief       Incremental decryptor of the stream created by @ref EncryptDataChunked
+         * @details     Ciphertext bytes can be fed in pieces of any size, every completed block is decrypted
+         *              and returned right away, so the whole message never needs to be held in memory.
+         */
+        class ChunkedDecryptor
+        {
+        public:
+            /**
+             * @brief       Construct a new decryptor
+             * @param[in]   prvkey: Private key used to decrypt the blocks, must outlive the decryptor
+             */
+            explicit ChunkedDecryptor( const PrivateKey &prvkey );
+
+            /**
+             * @brief       Feeds more ciphertext bytes
+             * @param[in]   data: Pointer to the next ciphertext bytes
+             * @param[in]   size: Number of bytes
+             * @return      The plaintext of the blocks completed by this call
+             * @warning     Throws if the stream is malformed or the data exceeds the announced length
+             */
+            std::vector<uint8_t> Update( const uint8_t *data, std::size_t size );
+
+            /**
+             * @brief       Checks if every announced plaintext byte was recovered
+             * @return      true if the stream was completely decrypted
+             */
+            [[nodiscard]] bool IsFinished() const;
+
+        private:
+            const PrivateKey    &private_key;
+            std::vector<uint8_t> pending;         ///< Bytes of an incomplete header or record
+            bool                 header_parsed;   ///< If the stream header was already consumed
+            uint64_t             plaintext_size;  ///< Announced plaintext size
+            uint64_t             plaintext_done;  ///< Plaintext bytes already returned
+            std::size_t          element_size;    ///< Fixed width of each ciphertext element
+            std::size_t          payload_size;    ///< Plaintext bytes per block
+        };
+
+        static constexpr std::size_t CHUNK_HEADER_SIZE = 12; ///< Plaintext size (8 bytes) and element width (4 bytes), big endian
+
+        /**
+         * @brief       Size in bytes of a ciphertext element for the given parameters
+         * @param[in]   params: ElGamal parameters
+         * @return      Number of bytes needed to hold any value modulo the prime
+         */
+        static std::size_t GetElementSize( const Params &params );
+        /**
+         * @brief       Plaintext bytes carried by each block of the chunked mode
+         * @param[in]   params: ElGamal parameters
+         * @return      Number of bytes that always map to a message smaller than the prime
+         */
+        static std::size_t GetChunkPayloadSize( const Params &params );
+        /**
+         * @brief       Encrypts a buffer of any length by splitting it into blocks smaller than the prime
+         * @details     Every block is prefixed with a 0x01 sentinel byte, so zero blocks and leading zeroes survive.
+         *              The output is the header (see @ref CHUNK_HEADER_SIZE) followed by one (a, b) pair per block,
+         *              each element written big endian with @ref GetElementSize bytes. Blocks are encrypted in
+         *              parallel with fixed base tables of the generator and the public key shared by all workers.
+         * @param[in]   pubkey: Public key to encrypt with
+         * @param[in]   data_vector: Data to be encrypted
+         * @param[in]   num_threads: Number of worker threads, 0 to use the hardware concurrency
+         * @return      The chunked ciphertext stream
+         */
+        static std::vector<uint8_t> EncryptDataChunked( const PublicKey &pubkey, const std::vector<uint8_t> &data_vector, std::size_t num_threads = 0 );
+        /**
+         * @brief       Decrypts a whole stream created by @ref EncryptDataChunked
+         * @param[in]   prvkey: Private key to decrypt with
+         * @param[in]   chunked_data: The chunked ciphertext stream
+         * @param[in]   num_threads: Number of worker threads, 0 to use the hardware concurrency
+         * @return      The original data
+         */
+        static std::vector<uint8_t> DecryptDataChunked( const PrivateKey &prvkey, const std::vector<uint8_t> &chunked_data, std::size_t num_threads = 0 );
+
+        /**
+         * @brief       Decrypts an additive ciphertext with the key and the baby step table of this instance
+         * @param[in]   encrypted_data: Ciphertext created by @ref EncryptDataAdditive
+         * @return      The encrypted value
+         * @details     Thread safe, one instance can serve every worker thread of the process.
+         */
+        cpp_int DecryptDataAdditive( const CypherTextType &encrypted_data ) const;
         /**
      * @brief       Create prime number and generator
      * @return      A new set of prime number and generator @ref GeneratorParamsType 
@@ -98,7 +186,7 @@ namespace KeyGenerator
         static CypherTextType EncryptDataAdditive( PublicKey &pubkey, const cpp_int &data );
         template <typename T>
         static T       DecryptData( const PrivateKey &prvkey, const CypherTextType &encrypted_data );
-        static cpp_int DecryptDataAdditive( const PrivateKey &prvkey, const CypherTextType &encrypted_data, PrimeNumbers::BabyStepGiantStep &bsgs );
+        static cpp_int DecryptDataAdditive( const PrivateKey &prvkey, const CypherTextType &encrypted_data, const PrimeNumbers::BabyStepGiantStep &bsgs );
 
         ElGamal() : ElGamal( Params( SAFE_PRIME, GENERATOR ) )
         {
@@ -126,9 +214,19 @@ namespace KeyGenerator
         }
 
     private:
-        std::shared_ptr<PrivateKey>                      private_key; ///< Private key instance
-        std::shared_ptr<PublicKey>                       public_key;  ///< Public key instance
-        std::shared_ptr<PrimeNumbers::BabyStepGiantStep> bsgs_instance;
+        /**
+         * @brief       Decrypts one block of the chunked mode and strips its sentinel
+         * @param[in]   prvkey: Private key to decrypt with
+         * @param[in]   record: Pointer to the (a, b) pair of the block
+         * @param[in]   element_size: Width of each element of the pair
+         * @param[out]  out: Destination of the plaintext bytes
+         * @param[in]   payload_size: Number of plaintext bytes expected in this block
+         */
+        static void DecryptChunk( const PrivateKey &prvkey, const uint8_t *record, std::size_t element_size, uint8_t *out, std::size_t payload_size );
+
+        std::shared_ptr<PrivateKey>                            private_key; ///< Private key instance
+        std::shared_ptr<PublicKey>                             public_key;  ///< Public key instance
+        std::shared_ptr<const PrimeNumbers::BabyStepGiantStep> bsgs_instance; ///< Read only after construction, shared by all threads
     };
 }
 
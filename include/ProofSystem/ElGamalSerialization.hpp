@@ -0,0 +1,186 @@
+/**
+ * @file       ElGamalSerialization.hpp
+ * @brief      Binary format of the ElGamal parameters, keys and ciphertexts
+ * @date       2024-03-29
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _ELGAMAL_SERIALIZATION_HPP_
+#define _ELGAMAL_SERIALIZATION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ProofSystem/ElGamalKeyGenerator.hpp"
+#include "ProofSystem/MappedFile.hpp"
+
+namespace KeyGenerator
+{
+    /**
+     * @brief       Fixed width little endian encoding of the @ref ElGamal types
+     * @details     Every object starts with a @ref HEADER_SIZE byte header: the magic "PSEG", the format version
+     *              (2 bytes), the @ref Kind (2 bytes), the element width (4 bytes), 4 reserved zero bytes and the
+     *              number of records (8 bytes). The elements follow, each one @ref GetElementWidth bytes long:
+     *              - Params: prime, generator
+     *              - PublicKey: prime, generator, public value
+     *              - PrivateKey: prime, generator, private scalar
+     *              - Ciphertext arrays: prime, generator, then one (a, b) pair per record
+     *              The width is a multiple of 8 and the header is 24 bytes, so in a memory mapped file every
+     *              element sits on a 64 bit boundary.
+     */
+    namespace serialization
+    {
+        constexpr std::uint8_t  MAGIC[4]       = { 'P', 'S', 'E', 'G' };
+        constexpr std::uint16_t FORMAT_VERSION = 1;  ///< Highest version this code reads, and the one it writes
+        constexpr std::size_t   HEADER_SIZE    = 24; ///< Size of the header of every serialized object
+
+        /**
+         * @brief       Type of the serialized object
+         */
+        enum class Kind : std::uint16_t
+        {
+            PARAMS      = 1,
+            PUBLIC_KEY  = 2,
+            PRIVATE_KEY = 3,
+            CYPHER_TEXT = 4,
+        };
+
+        /**
+         * @brief       Decoded header of a serialized object
+         */
+        struct Header
+        {
+            std::uint16_t version;       ///< Format version of the writer
+            Kind          kind;          ///< Type of the payload
+            std::uint32_t element_width; ///< Bytes of every element
+            std::uint64_t count;         ///< Number of records, 1 for everything but ciphertext arrays
+        };
+
+        /**
+         * @brief       Width of the elements written for a set of parameters
+         * @param[in]   params: ElGamal parameters
+         * @return      Bytes needed for any value modulo the prime, rounded up to whole 64 bit words
+         */
+        std::size_t GetElementWidth( const ElGamal::Params &params );
+
+        /**
+         * @brief       Writes the header of a serialized object
+         * @param[in]   kind: Type of the object
+         * @param[in]   element_width: Bytes of every element
+         * @param[in]   count: Number of records
+         * @param[out]  out: Destination with at least @ref HEADER_SIZE bytes
+         */
+        void WriteHeader( Kind kind, std::size_t element_width, std::uint64_t count, std::uint8_t *out );
+
+        /**
+         * @brief       Parses the header of a serialized object without checking the size of the payload
+         * @param[in]   data: Pointer to the serialized bytes
+         * @param[in]   size: Number of bytes available
+         * @param[in]   kind: Expected type of the object
+         * @return      The header
+         * @warning     Throws if the magic, version, kind or element width are invalid
+         */
+        Header PeekHeader( const std::uint8_t *data, std::size_t size, Kind kind );
+
+        /**
+         * @brief       Parses and validates the header of a serialized object
+         * @param[in]   data: Pointer to the serialized bytes
+         * @param[in]   size: Number of bytes available
+         * @param[in]   kind: Expected type of the object
+         * @return      The header, its record count already checked against @p size
+         * @warning     Throws if the magic, version, kind or size don't match
+         */
+        Header ReadHeader( const std::uint8_t *data, std::size_t size, Kind kind );
+
+        std::vector<std::uint8_t> SerializeParams( const ElGamal::Params &params );
+        std::vector<std::uint8_t> SerializePublicKey( const ElGamal::PublicKey &pubkey );
+        std::vector<std::uint8_t> SerializePrivateKey( const ElGamal::PrivateKey &prvkey );
+        /**
+         * @brief       Serializes an array of ciphertexts created under the given parameters
+         * @param[in]   params: Parameters of the key the ciphertexts were created with
+         * @param[in]   cypher_texts: Ciphertexts to write
+         * @return      The serialized array
+         */
+        std::vector<std::uint8_t> SerializeCypherTexts( const ElGamal::Params &params, const std::vector<ElGamal::CypherTextType> &cypher_texts );
+
+        ElGamal::Params     DeserializeParams( const std::vector<std::uint8_t> &data );
+        ElGamal::PublicKey  DeserializePublicKey( const std::vector<std::uint8_t> &data );
+        /**
+         * @brief       Rebuilds a private key, the public value is recomputed from the scalar
+         * @param[in]   data: Bytes created by @ref SerializePrivateKey
+         * @return      The private key
+         */
+        ElGamal::PrivateKey DeserializePrivateKey( const std::vector<std::uint8_t> &data );
+        std::vector<ElGamal::CypherTextType> DeserializeCypherTexts( const std::vector<std::uint8_t> &data );
+
+        /**
+         * @brief       Writes an array of ciphertexts to a file, in the format of @ref SerializeCypherTexts
+         * @param[in]   path: Destination file, replaced if it exists
+         * @param[in]   params: Parameters of the key the ciphertexts were created with
+         * @param[in]   cypher_texts: Ciphertexts to write
+         * @warning     Throws if the file can't be written
+         */
+        void WriteCypherTextFile( const std::string &path, const ElGamal::Params &params, const std::vector<ElGamal::CypherTextType> &cypher_texts );
+
+        /**
+         * @brief       Read only memory mapping of a ciphertext array file
+         * @details     Opening validates the header and maps the whole file, records are only decoded when
+         *              accessed, so a file with millions of ciphertexts is available right away. The mapping is
+         *              immutable and can be read from any number of threads.
+         */
+        class MappedCypherTexts
+        {
+        public:
+            /**
+             * @brief       Maps a file created by @ref WriteCypherTextFile
+             * @param[in]   path: File to map
+             * @warning     Throws if the file can't be mapped or isn't a valid ciphertext array
+             */
+            explicit MappedCypherTexts( const std::string &path );
+
+            [[nodiscard]] std::size_t Size() const
+            {
+                return static_cast<std::size_t>( header.count );
+            }
+
+            [[nodiscard]] std::size_t GetElementWidth() const
+            {
+                return header.element_width;
+            }
+
+            /**
+             * @brief       Parameters stored in the file
+             */
+            [[nodiscard]] ElGamal::Params GetParams() const;
+
+            /**
+             * @brief       Raw little endian bytes of a record, the a element followed by the b element
+             * @param[in]   index: Record index, smaller than @ref Size
+             */
+            [[nodiscard]] const std::uint8_t *GetRecord( std::size_t index ) const
+            {
+                return file.Data() + HEADER_SIZE + ( 2 + 2 * index ) * header.element_width;
+            }
+
+            /**
+             * @brief       Decodes one record
+             * @param[in]   index: Record index, smaller than @ref Size
+             */
+            [[nodiscard]] ElGamal::CypherTextType operator[]( std::size_t index ) const;
+
+            /**
+             * @brief       Decodes every record
+             * @param[in]   num_threads: Number of worker threads, 0 to use the hardware concurrency
+             * @return      The ciphertexts in file order
+             */
+            [[nodiscard]] std::vector<ElGamal::CypherTextType> ReadAll( std::size_t num_threads = 0 ) const;
+
+        private:
+            util::MappedFile file;
+            Header           header{};
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ * @file       EncryptedBalanceStore.hpp
+ * @brief      Memory mapped store of additive ElGamal encrypted balances
+ * @date       2024-03-30
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _ENCRYPTED_BALANCE_STORE_HPP_
+#define _ENCRYPTED_BALANCE_STORE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "ProofSystem/ElGamalKeyGenerator.hpp"
+#include "ProofSystem/ElGamalSerialization.hpp"
+#include "ProofSystem/MappedFile.hpp"
+
+namespace KeyGenerator
+{
+    /**
+     * @brief       Account balances encrypted with @ref ElGamal::EncryptDataAdditive, indexed by account id
+     * @details     The balances live in a memory mapped ciphertext array file (see @ref serialization), the
+     *              account id is the record index. Deltas are added homomorphically, multiplying both elements
+     *              of the ciphertexts modulo the prime, and written in place.
+     *
+     *              Every batch is first appended to a redo journal next to the file, as the resulting balances
+     *              of the accounts it touches, and synced. Only then the mapped records are overwritten, so
+     *              replaying the journal after a crash is idempotent. A torn last journal entry is detected by
+     *              its checksum and dropped, the batch is then lost as a whole. The journal is emptied at every
+     *              checkpoint, after the mapped file is flushed.
+     *
+     *              Balance reads can run concurrently, updates are serialized against them.
+     */
+    class EncryptedBalanceStore
+    {
+    public:
+        using AccountId = std::uint64_t;
+
+        /**
+         * @brief       Encrypted amount to add to an account
+         */
+        struct Delta
+        {
+            AccountId               account; ///< Account receiving the amount
+            ElGamal::CypherTextType amount;  ///< Additive ciphertext under the key of the balances
+        };
+
+        static constexpr std::size_t CHECKPOINT_JOURNAL_SIZE = 64 * 1024 * 1024; ///< Journal size that triggers a checkpoint
+        static constexpr const char *JOURNAL_SUFFIX          = ".journal";       ///< Appended to the store path
+
+        /**
+         * @brief       Opens a store, creating an empty one if the file doesn't exist, and replays its journal
+         * @param[in]   path: Balance file
+         * @param[in]   store_params: ElGamal parameters of the balances, must match the file
+         * @warning     Throws if the file or the journal are invalid or can't be opened
+         */
+        EncryptedBalanceStore( const std::string &path, ElGamal::Params store_params );
+
+        /**
+         * @brief       Checkpoints and closes the store
+         */
+        ~EncryptedBalanceStore();
+
+        EncryptedBalanceStore( const EncryptedBalanceStore & )            = delete;
+        EncryptedBalanceStore &operator=( const EncryptedBalanceStore & ) = delete;
+
+        /**
+         * @brief       Number of accounts
+         */
+        [[nodiscard]] std::size_t Size() const;
+
+        /**
+         * @brief       Adds accounts up to @p new_num_accounts, each with a zero balance
+         * @details     The zero balance is the ciphertext (1, 1), the encryption of 0 with no randomness.
+         *              It becomes indistinguishable from any other balance after the first delta.
+         * @param[in]   new_num_accounts: New number of accounts, not smaller than @ref Size
+         */
+        void Resize( std::size_t new_num_accounts );
+
+        /**
+         * @brief       Current encrypted balance of an account
+         * @param[in]   account: Account id, smaller than @ref Size
+         */
+        [[nodiscard]] ElGamal::CypherTextType GetBalance( AccountId account ) const;
+
+        /**
+         * @brief       Adds a batch of encrypted deltas
+         * @details     Deltas of the same account are folded by one worker, distinct accounts are updated in
+         *              parallel. The batch is durable when the call returns.
+         * @param[in]   deltas: Deltas to apply, accounts may repeat
+         * @param[in]   num_threads: Number of worker threads, 0 to use the hardware concurrency
+         * @warning     Throws, without touching any balance, if an account doesn't exist or an amount isn't in [1, p)
+         */
+        void ApplyDeltas( const std::vector<Delta> &deltas, std::size_t num_threads = 0 );
+
+        /**
+         * @brief       Flushes the mapped balances and empties the journal
+         */
+        void Checkpoint();
+
+    private:
+        /**
+         * @brief       Applies the complete journal entries to the mapped file and drops the torn tail
+         */
+        void ReplayJournal();
+        void CheckpointLocked();
+
+        [[nodiscard]] std::uint8_t *GetRecord( AccountId account ) const
+        {
+            return balances.Data() + serialization::HEADER_SIZE + ( 2 + 2 * account ) * element_width;
+        }
+
+        const ElGamal::Params     params;
+        const std::size_t         element_width; ///< Bytes of each ciphertext element
+        std::size_t               num_accounts;  ///< Records of the mapped file
+        util::MappedFile          balances;      ///< Ciphertext array file
+        util::AppendOnlyFile      journal;       ///< Redo journal of the batches since the last checkpoint
+        mutable std::shared_mutex mutex;         ///< Shared for balance reads, exclusive for updates
+    };
+}
+
+#endif
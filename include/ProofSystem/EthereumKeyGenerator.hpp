@@ -9,7 +9,9 @@
 #ifndef ETHEREUM_KEY_GENERATOR_HPP
 #define ETHEREUM_KEY_GENERATOR_HPP
 
+#include <array>
 #include <string>
+#include <vector>
 
 #include <ProofSystem/EthereumKeyPairParams.hpp>
 #include <ProofSystem/ext_private_key.hpp>
@@ -24,7 +26,19 @@ namespace ethereum
     class EthereumKeyGenerator
     {
     public:
-        using PubKeyPair_t = std::pair<std::vector<std::uint8_t>, std::vector<std::uint8_t>>;
+        using PubKeyPair_t  = std::pair<std::vector<std::uint8_t>, std::vector<std::uint8_t>>;
+        using PubKeyBytes_t = ECDSAPublicKey::Uncompressed_t; ///< Uncompressed public key, X and Y big endian without prefix
+        using Address_t     = std::array<std::uint8_t, 20>; ///< Binary Ethereum address
+
+        /**
+         * @brief       Key pair and address produced by @ref GenerateBatch
+         */
+        struct BatchEntry_t
+        {
+            ethereum::scalar_field_value_type private_key; ///< Private key scalar
+            PubKeyBytes_t                     public_key;  ///< Public key as big endian X and Y
+            Address_t                         address;     ///< Binary address, see @ref ToChecksumAddress
+        };
         /**
          * @brief       Construct a new Ethereum Key Generator
          */
@@ -79,6 +93,14 @@ namespace ethereum
         {
             return pubkey_info->GetEntireKey();
         }
+        /**
+         * @brief       Get the SEC1 compressed public key, accepted by @ref BuildPublicKey and the KDF
+         * @return      02 or 03 followed by X
+         */
+        [[nodiscard]] std::string GetCompressedPubValue() const
+        {
+            return pubkey_info->GetCompressedKey();
+        }
         /**
          * @brief       Extract the key vector data from the ECDSA public key
          * @param[in]   pub_key: Public ECDSA key
@@ -93,17 +115,49 @@ namespace ethereum
          * @warning     The LSB is the 0 index and the MSB is the 63th.
          */
         static std::string DeriveAddress( const std::vector<std::uint8_t> &pub_key_vect );
+        /**
+         * @brief       Derive the binary addresses of many public keys
+         * @param[in]   pub_keys: Public keys as big endian X and Y coordinates
+         * @return      Binary addresses in the same order as the keys
+         * @details     Hashes several keys per Keccak permutation (4 lanes on AVX2, 8 on AVX-512)
+         */
+        static std::vector<Address_t> DeriveAddresses( const std::vector<PubKeyBytes_t> &pub_keys );
+        /**
+         * @brief       Derive the binary addresses of many public keys into caller owned storage
+         * @param[in]   pub_keys: Pointer to the first public key
+         * @param[in]   count: Number of public keys
+         * @param[out]  addresses: Destination with room for @p count addresses
+         */
+        static void DeriveAddresses( const PubKeyBytes_t *pub_keys, std::size_t count, Address_t *addresses );
+        /**
+         * @brief       Formats a binary address as EIP-55 mixed case checksummed text
+         * @param[in]   address: Binary address
+         * @return      Address in string form, with the 0x header
+         */
+        static std::string ToChecksumAddress( const Address_t &address );
+        /**
+         * @brief       Generates many random key pairs with their addresses
+         * @param[in]   count: Number of key pairs
+         * @param[in]   num_threads: Number of threads, 0 to use the hardware concurrency
+         * @return      Contiguous key pairs and binary addresses
+         * @details     Uses a precomputed table of multiples of G, one field inversion per block of keys
+         *              for the affine conversion and multi-lane hashing for the addresses.
+         */
+        static std::vector<BatchEntry_t> GenerateBatch( std::size_t count, std::size_t num_threads = 0 );
         /**
          * @brief       Create the ECDSA key pair
          * @return      Private key pointer
          */
         static std::shared_ptr<pubkey::ext_private_key<ethereum::policy_type>> CreateKeys();
 
+        /**
+         * @brief       Imports a public key from text
+         * @param[in]   pubkey_data: SEC1 compressed (66 digits), X+Y (128 digits) or SEC1 uncompressed (130 digits) hex key
+         * @return      The public key
+         */
         static pubkey::public_key<ethereum::policy_type> BuildPublicKey( const std::string &pubkey_data );
 
     private:
-        static ethereum::random_generator_type key_gen; ///< Ethereum random key generator
-
         std::shared_ptr<pubkey::ext_private_key<ethereum::policy_type>> privkey; ///< Private key pointer
         std::shared_ptr<pubkey::public_key<ethereum::policy_type>>      pubkey;  ///< Public key pointer
 
@@ -120,17 +174,16 @@ namespace ethereum
              */
             [[nodiscard]] std::string CalcPubkeyUsedValue() const override
             {
-                return ( X + Y );
+                return GetEntireKey();
             }
         };
 
         std::shared_ptr<EthereumECDSAPublicKey> pubkey_info; ///< Instance of public key information class
         std::string                             address;     ///< Ethereum address
 
-        static constexpr std::string_view ADDRESS_HEADER       = "0x";                     ///< Ethereum address header
-        static constexpr std::size_t      KECCAK_RES_VALID_POS = 24;                       ///< Start position for address derivation
-        static constexpr std::size_t      ADDRESS_VALID_POS    = KECCAK_RES_VALID_POS - 2; ///< Start position of the address
-        static constexpr std::size_t      ADDRESS_SIZE_CHARS   = 42;                       ///< Size of the address in characters
+        static constexpr std::string_view ADDRESS_HEADER     = "0x"; ///< Ethereum address header
+        static constexpr std::size_t      KECCAK_ADDRESS_POS = 12;   ///< Position of the address inside the Keccak digest
+        static constexpr std::size_t      BATCH_BLOCK_SIZE   = 256;  ///< Keys hashed per intermediate digest buffer
         /**
          * @brief       Derive the Ethereum address from own key
          * @return      Ethereum address in string form
@@ -19,6 +19,9 @@
 
 #include "ProofSystem/ECDSATypes.hpp"
 #include "ProofSystem/ECDHEncryption.hpp"
+#include "ProofSystem/PublicKeyCache.hpp"
+#include "ProofSystem/ECDSAVerifier.hpp"
+#include "ProofSystem/Metrics.hpp"
 #include "ProofSystem/ext_private_key.hpp"
 
 /**
@@ -71,8 +74,9 @@ public:
 
     /**
      * @brief       Builds the public key data type from the data
-     * @param[in]   pubkey_data String representation of X+Y coordinates
-     * @return      The ECDSA public key object 
+     * @param[in]   pubkey_data Hex of the SEC1 compressed point, of X+Y, or of the SEC1 uncompressed point
+     * @return      The ECDSA public key object
+     * @details     Keys are parsed and validated once, then served by the shared ecpoint::PublicKeyCache
      */
     static ecdsa_t::pubkey::public_key<PolicyType> BuildPublicKeyECDSA( const ECDSAPubKey &pubkey_data );
 
@@ -92,6 +96,8 @@ std::string KDFGenerator<PolicyType>::GenerateSharedSecret( const ecdsa_t::pubke
 {
     using namespace ecdsa_t;
 
+    PROOFSYSTEM_SCOPED_TIMER( "kdf_sign_seconds" );
+
     KDFGenerator::SignatureType signed_secret = sign<PolicyType>( other_party_key, own_prvt_key );
     std::vector<std::uint8_t>   signed_vector( 64 );
 
@@ -111,6 +117,8 @@ template <typename PolicyType>
 ecdsa_t::scalar_field_value_type KDFGenerator<PolicyType>::GetNewKeyFromSecret( std::string_view signed_secret, const ECDSAPubKey &signer_pubkey,
                                                                                 const ECDSAPubKey &verifier_pubkey )
 {
+    PROOFSYSTEM_SCOPED_TIMER( "kdf_verify_seconds" );
+
     std::vector<std::uint8_t> key_vector = util::HexASCII2NumStr<std::uint8_t>( verifier_pubkey );
     const auto                signer_key = BuildPublicKeyECDSA( signer_pubkey );
 
@@ -125,8 +133,8 @@ ecdsa_t::scalar_field_value_type KDFGenerator<PolicyType>::GetNewKeyFromSecret(
         nil::marshalling::bincode::field<ecdsa_t::scalar_field_type>::field_element_from_bytes<std::vector<std::uint8_t>::iterator>(
             decoded_vector.begin() + 32, decoded_vector.begin() + 64 );
 
-    bool valid = static_cast<bool>(
-        nil::crypto3::verify<PolicyType>( verifier_pubkey, SignatureType( sign_first_part.second, sign_second_part.second ), signer_key ) );
+    bool valid = ECDSAVerifier<PolicyType>::Instance().Verify( verifier_pubkey, SignatureType( sign_first_part.second, sign_second_part.second ),
+                                                               signer_key );
 
     if ( !valid )
     {
@@ -144,16 +152,7 @@ ecdsa_t::pubkey::public_key<PolicyType> KDFGenerator<PolicyType>::BuildPublicKey
 {
     using namespace ecdsa_t;
 
-    auto z_data_one = pubkey::public_key<PolicyType>::g1_value_type::field_type::value_type::one();
-
-    std::vector<std::uint8_t> key_vector = util::HexASCII2NumStr<std::uint8_t>( pubkey_data );
-
-    auto y_data = nil::marshalling::bincode::field<ecdsa_t::base_field_type>::field_element_from_bytes<std::vector<std::uint8_t>::iterator>(
-        key_vector.begin(), key_vector.begin() + key_vector.size() / 2 );
-    auto x_data = nil::marshalling::bincode::field<ecdsa_t::base_field_type>::field_element_from_bytes<std::vector<std::uint8_t>::iterator>(
-        key_vector.begin() + key_vector.size() / 2, key_vector.end() );
-
-    return typename pubkey::public_key<PolicyType>::public_key_type( x_data.second, y_data.second, z_data_one );
+    return typename pubkey::public_key<PolicyType>::public_key_type( ecpoint::PublicKeyCache<ecdsa_t::CurveType>::Instance().Get( pubkey_data ) );
 }
 
 #endif
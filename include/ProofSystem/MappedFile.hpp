@@ -0,0 +1,134 @@
+/**
+ * @file       MappedFile.hpp
+ * @brief      Memory mapped files and durable append only files
+ * @date       2024-03-30
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _MAPPED_FILE_HPP_
+#define _MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace util
+{
+    /**
+     * @brief       Whole file memory mapping, POSIX mmap or a Windows file mapping
+     * @details     Writes through a read-write mapping go to the file, @ref Flush makes them durable.
+     *              Not thread safe, the owner serializes @ref Resize against every access.
+     */
+    class MappedFile
+    {
+    public:
+        enum class Mode
+        {
+            READ_ONLY,  ///< The file must exist
+            READ_WRITE, ///< The file is created empty if it doesn't exist
+        };
+
+        /**
+         * @brief       Opens and maps a file
+         * @param[in]   path: File to map
+         * @param[in]   mode: Access mode
+         * @warning     Throws if the file can't be opened or mapped
+         */
+        MappedFile( const std::string &path, Mode mode );
+        ~MappedFile();
+
+        MappedFile( const MappedFile & )            = delete;
+        MappedFile &operator=( const MappedFile & ) = delete;
+
+        /**
+         * @brief       First byte of the mapping, nullptr while the file is empty
+         */
+        [[nodiscard]] std::uint8_t *Data() const
+        {
+            return data;
+        }
+
+        [[nodiscard]] std::size_t Size() const
+        {
+            return size;
+        }
+
+        /**
+         * @brief       Grows or shrinks the file and maps it again
+         * @param[in]   new_size: New size in bytes, grown bytes read as zero
+         * @warning     Pointers into the previous mapping are invalidated. Read-write mode only.
+         */
+        void Resize( std::size_t new_size );
+
+        /**
+         * @brief       Writes the dirty pages back and waits for the storage to acknowledge them
+         */
+        void Flush();
+
+    private:
+        void Map();
+        void Unmap() noexcept;
+        void Close() noexcept;
+
+        const std::string path;
+        const Mode        mode;
+        std::uint8_t     *data = nullptr; ///< First byte of the mapping
+        std::size_t       size = 0;       ///< Size of the file and of the mapping
+#ifdef _WIN32
+        void *file_handle    = nullptr;
+        void *mapping_handle = nullptr;
+#else
+        int descriptor = -1;
+#endif
+    };
+
+    /**
+     * @brief       File only ever written at its end, for journals
+     * @details     @ref Append doesn't return before the bytes are handed to the OS, @ref Sync waits for
+     *              them to reach the storage. Not thread safe.
+     */
+    class AppendOnlyFile
+    {
+    public:
+        /**
+         * @brief       Opens a file, creating it empty if it doesn't exist
+         * @param[in]   path: File to open
+         * @warning     Throws if the file can't be opened
+         */
+        explicit AppendOnlyFile( const std::string &path );
+        ~AppendOnlyFile();
+
+        AppendOnlyFile( const AppendOnlyFile & )            = delete;
+        AppendOnlyFile &operator=( const AppendOnlyFile & ) = delete;
+
+        [[nodiscard]] std::size_t Size() const
+        {
+            return size;
+        }
+
+        /**
+         * @brief       Reads the whole file
+         */
+        [[nodiscard]] std::vector<std::uint8_t> ReadAll() const;
+
+        void Append( const std::uint8_t *bytes, std::size_t count );
+        void Sync();
+
+        /**
+         * @brief       Drops everything after @p new_size bytes and syncs
+         * @param[in]   new_size: New size, not bigger than the current one
+         */
+        void Truncate( std::size_t new_size );
+
+    private:
+        const std::string path;
+        std::size_t       size = 0; ///< Current size of the file
+#ifdef _WIN32
+        void *file_handle = nullptr;
+#else
+        int descriptor = -1;
+#endif
+    };
+}
+
+#endif
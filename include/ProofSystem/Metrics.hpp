@@ -0,0 +1,419 @@
+/**
+ * @file       Metrics.hpp
+ * @brief      Counters, histograms and scoped timers of the library hot paths
+ * @date       2024-03-25
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ * @details    The instrumentation macros expand to nothing unless PROOFSYSTEM_ENABLE_METRICS is defined
+ *             (CMake option PROOFSYSTEM_ENABLE_METRICS), so a default build pays nothing for them. When
+ *             enabled, every thread writes to its own slab of cells with relaxed stores, with no locks and no
+ *             shared cache lines; a snapshot sums the slabs of the live threads and the totals of the
+ *             ones that already exited.
+ */
+#ifndef _METRICS_HPP_
+#define _METRICS_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace metrics
+{
+    /**
+     * @brief       Type of a metric
+     */
+    enum class MetricKind
+    {
+        COUNTER,   ///< Monotonic sum
+        HISTOGRAM, ///< Distribution of unitless values
+        TIMER      ///< Distribution of durations, recorded in nanoseconds and exported in seconds
+    };
+
+    constexpr std::size_t MAX_METRICS = 128; ///< Distinct metrics a process can register
+    constexpr std::size_t NUM_BUCKETS = 40;  ///< Bucket i holds values of bit width i, the last one everything above
+
+    /**
+     * @brief       Totals of one metric at the time of the snapshot
+     */
+    struct MetricSnapshot
+    {
+        std::string                              name;    ///< Registered name
+        MetricKind                               kind;    ///< Counter, histogram or timer
+        std::uint64_t                            count;   ///< Number of observations or increments
+        std::uint64_t                            sum;     ///< Sum of the values, nanoseconds for timers
+        std::array<std::uint64_t, NUM_BUCKETS>   buckets; ///< Non cumulative bucket counts, zero for counters
+    };
+
+    /**
+     * @brief       Bucket of a value
+     * @param[in]   value Observed value
+     * @return      Bit width of the value, capped to the last bucket
+     */
+    inline std::size_t BucketIndex( std::uint64_t value )
+    {
+        std::size_t width = 0;
+        while ( value != 0 && width < NUM_BUCKETS - 1 )
+        {
+            value >>= 1;
+            ++width;
+        }
+        return width;
+    }
+
+    /**
+     * @brief       Process wide set of metrics
+     */
+    class Registry
+    {
+    public:
+        /**
+         * @brief       Returns the registry
+         * @return      The instance, never destroyed so threads exiting late can still retire their slabs
+         */
+        static Registry &Instance()
+        {
+            static Registry *instance = new Registry();
+            return *instance;
+        }
+
+        /**
+         * @brief       Registers a metric, or finds the one already registered with that name
+         * @param[in]   name Metric name, [a-zA-Z0-9_]
+         * @param[in]   kind Type of the metric
+         * @return      Identifier to pass to @ref Add and @ref Observe
+         * @warning     Throws std::runtime_error if the name exists with another kind or the registry is full
+         */
+        std::size_t Register( std::string_view name, MetricKind kind )
+        {
+            std::lock_guard<std::mutex> lock( registry_mutex );
+            for ( std::size_t id = 0; id < definitions.size(); ++id )
+            {
+                if ( definitions[id].name == name )
+                {
+                    if ( definitions[id].kind != kind )
+                    {
+                        throw std::runtime_error( "Metric registered with another kind" );
+                    }
+                    return id;
+                }
+            }
+            if ( definitions.size() == MAX_METRICS )
+            {
+                throw std::runtime_error( "Too many metrics" );
+            }
+            definitions.push_back( Definition{ std::string( name ), kind } );
+            return definitions.size() - 1;
+        }
+
+        /**
+         * @brief       Increments a counter
+         * @param[in]   id Counter identifier
+         * @param[in]   value Increment
+         */
+        void Add( std::size_t id, std::uint64_t value )
+        {
+            Cell &cell = LocalSlab().cells[id];
+            Increment( cell.count, 1 );
+            Increment( cell.sum, value );
+        }
+
+        /**
+         * @brief       Records a histogram or timer observation
+         * @param[in]   id Metric identifier
+         * @param[in]   value Observed value, nanoseconds for timers
+         */
+        void Observe( std::size_t id, std::uint64_t value )
+        {
+            Cell &cell = LocalSlab().cells[id];
+            Increment( cell.count, 1 );
+            Increment( cell.sum, value );
+            Increment( cell.buckets[BucketIndex( value )], 1 );
+        }
+
+        /**
+         * @brief       Sums every metric over all the threads
+         * @return      One entry per registered metric, in registration order
+         */
+        std::vector<MetricSnapshot> Snapshot() const
+        {
+            std::lock_guard<std::mutex> lock( registry_mutex );
+
+            std::vector<MetricSnapshot> snapshot;
+            for ( std::size_t id = 0; id < definitions.size(); ++id )
+            {
+                MetricSnapshot metric{ definitions[id].name, definitions[id].kind, 0, 0, {} };
+                Accumulate( retired.cells[id], metric );
+                for ( const auto *slab : live_slabs )
+                {
+                    Accumulate( slab->cells[id], metric );
+                }
+                snapshot.push_back( metric );
+            }
+            return snapshot;
+        }
+
+        /**
+         * @brief       Zeroes every metric, the registrations are kept
+         * @details     Meant for tests and between benchmark runs; increments racing with it may survive.
+         */
+        void Reset()
+        {
+            std::lock_guard<std::mutex> lock( registry_mutex );
+            Clear( retired );
+            for ( auto *slab : live_slabs )
+            {
+                Clear( *slab );
+            }
+        }
+
+        /**
+         * @brief       Exports a snapshot in the Prometheus text exposition format
+         * @return      Text with one family per metric, names prefixed with proofsystem_
+         */
+        std::string ExportPrometheus() const
+        {
+            std::ostringstream out;
+            for ( const auto &metric : Snapshot() )
+            {
+                const std::string name = "proofsystem_" + metric.name;
+                if ( metric.kind == MetricKind::COUNTER )
+                {
+                    out << "# TYPE " << name << "_total counter\n" << name << "_total " << metric.sum << "\n";
+                    continue;
+                }
+                const double scale = metric.kind == MetricKind::TIMER ? 1e-9 : 1.0;
+
+                out << "# TYPE " << name << " histogram\n";
+                std::uint64_t cumulative = 0;
+                for ( std::size_t bucket = 0; bucket + 1 < NUM_BUCKETS; ++bucket )
+                {
+                    cumulative += metric.buckets[bucket];
+                    out << name << "_bucket{le=\"" << static_cast<double>( ( std::uint64_t{ 1 } << bucket ) - 1 ) * scale << "\"} " << cumulative
+                        << "\n";
+                }
+                out << name << "_bucket{le=\"+Inf\"} " << metric.count << "\n";
+                out << name << "_sum " << static_cast<double>( metric.sum ) * scale << "\n";
+                out << name << "_count " << metric.count << "\n";
+            }
+            return out.str();
+        }
+
+        /**
+         * @brief       Exports a snapshot as JSON
+         * @return      Object keyed by metric name with kind, count, sum and the non empty buckets
+         */
+        std::string ExportJson() const
+        {
+            std::ostringstream out;
+            out << "{";
+            bool first_metric = true;
+            for ( const auto &metric : Snapshot() )
+            {
+                out << ( first_metric ? "" : "," ) << "\"" << metric.name << "\":{\"kind\":\""
+                    << ( metric.kind == MetricKind::COUNTER ? "counter" : ( metric.kind == MetricKind::TIMER ? "timer_ns" : "histogram" ) )
+                    << "\",\"count\":" << metric.count << ",\"sum\":" << metric.sum;
+                if ( metric.kind != MetricKind::COUNTER )
+                {
+                    out << ",\"buckets\":{";
+                    bool first_bucket = true;
+                    for ( std::size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket )
+                    {
+                        if ( metric.buckets[bucket] != 0 )
+                        {
+                            out << ( first_bucket ? "" : "," ) << "\"" << bucket << "\":" << metric.buckets[bucket];
+                            first_bucket = false;
+                        }
+                    }
+                    out << "}";
+                }
+                out << "}";
+                first_metric = false;
+            }
+            out << "}";
+            return out.str();
+        }
+
+    private:
+        /**
+         * @brief       Values of one metric on one thread
+         */
+        struct Cell
+        {
+            std::atomic<std::uint64_t>                            count{ 0 };
+            std::atomic<std::uint64_t>                            sum{ 0 };
+            std::array<std::atomic<std::uint64_t>, NUM_BUCKETS> buckets{};
+        };
+
+        /**
+         * @brief       Cells of every metric, written by a single thread
+         */
+        struct Slab
+        {
+            std::array<Cell, MAX_METRICS> cells;
+        };
+
+        /**
+         * @brief       Owns the slab of a thread and retires it when the thread exits
+         */
+        struct SlabOwner
+        {
+            std::unique_ptr<Slab> slab = std::make_unique<Slab>();
+
+            SlabOwner()
+            {
+                Registry::Instance().Attach( slab.get() );
+            }
+
+            ~SlabOwner()
+            {
+                Registry::Instance().Retire( slab.get() );
+            }
+        };
+
+        struct Definition
+        {
+            std::string name;
+            MetricKind  kind;
+        };
+
+        mutable std::mutex      registry_mutex; ///< Guards the definitions and the slab list
+        std::vector<Definition> definitions;    ///< Indexed by metric id
+        std::vector<Slab *>     live_slabs;     ///< Slabs of the running threads
+        Slab                    retired;        ///< Totals of the threads that exited
+
+        Registry() = default;
+
+        static Slab &LocalSlab()
+        {
+            thread_local SlabOwner owner;
+            return *owner.slab;
+        }
+
+        // Only the owning thread writes a cell, so a relaxed load and store is enough and never contends
+        static void Increment( std::atomic<std::uint64_t> &value, std::uint64_t delta )
+        {
+            value.store( value.load( std::memory_order_relaxed ) + delta, std::memory_order_relaxed );
+        }
+
+        static void Accumulate( const Cell &cell, MetricSnapshot &metric )
+        {
+            metric.count += cell.count.load( std::memory_order_relaxed );
+            metric.sum += cell.sum.load( std::memory_order_relaxed );
+            for ( std::size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket )
+            {
+                metric.buckets[bucket] += cell.buckets[bucket].load( std::memory_order_relaxed );
+            }
+        }
+
+        static void Clear( Slab &slab )
+        {
+            for ( auto &cell : slab.cells )
+            {
+                cell.count.store( 0, std::memory_order_relaxed );
+                cell.sum.store( 0, std::memory_order_relaxed );
+                for ( auto &bucket : cell.buckets )
+                {
+                    bucket.store( 0, std::memory_order_relaxed );
+                }
+            }
+        }
+
+        void Attach( Slab *slab )
+        {
+            std::lock_guard<std::mutex> lock( registry_mutex );
+            live_slabs.push_back( slab );
+        }
+
+        void Retire( Slab *slab )
+        {
+            std::lock_guard<std::mutex> lock( registry_mutex );
+            for ( std::size_t id = 0; id < MAX_METRICS; ++id )
+            {
+                Cell &cell = slab->cells[id];
+                retired.cells[id].count.fetch_add( cell.count.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+                retired.cells[id].sum.fetch_add( cell.sum.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+                for ( std::size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket )
+                {
+                    retired.cells[id].buckets[bucket].fetch_add( cell.buckets[bucket].load( std::memory_order_relaxed ), std::memory_order_relaxed );
+                }
+            }
+            for ( auto it = live_slabs.begin(); it != live_slabs.end(); ++it )
+            {
+                if ( *it == slab )
+                {
+                    live_slabs.erase( it );
+                    break;
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief       Records the lifetime of a scope in a timer
+     */
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer( std::size_t id ) : id( id ), start( std::chrono::steady_clock::now() )
+        {
+        }
+
+        ~ScopedTimer()
+        {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start ).count();
+            Registry::Instance().Observe( id, static_cast<std::uint64_t>( elapsed ) );
+        }
+
+        ScopedTimer( const ScopedTimer & )            = delete;
+        ScopedTimer &operator=( const ScopedTimer & ) = delete;
+
+    private:
+        std::size_t                           id;    ///< Timer identifier
+        std::chrono::steady_clock::time_point start; ///< Construction time
+    };
+}
+
+#define PROOFSYSTEM_METRICS_CONCAT_INNER( a, b ) a##b
+#define PROOFSYSTEM_METRICS_CONCAT( a, b )       PROOFSYSTEM_METRICS_CONCAT_INNER( a, b )
+
+#ifdef PROOFSYSTEM_ENABLE_METRICS
+
+/// Times the rest of the enclosing scope
+#define PROOFSYSTEM_SCOPED_TIMER( name )                                                                                                           \
+    static const std::size_t PROOFSYSTEM_METRICS_CONCAT( proofsystem_timer_id_, __LINE__ ) =                                                       \
+        ::metrics::Registry::Instance().Register( name, ::metrics::MetricKind::TIMER );                                                            \
+    ::metrics::ScopedTimer PROOFSYSTEM_METRICS_CONCAT( proofsystem_timer_, __LINE__ )( PROOFSYSTEM_METRICS_CONCAT( proofsystem_timer_id_, __LINE__ ) )
+
+/// Adds a value to a counter
+#define PROOFSYSTEM_COUNTER_ADD( name, value )                                                                                                     \
+    do                                                                                                                                             \
+    {                                                                                                                                              \
+        static const std::size_t proofsystem_counter_id = ::metrics::Registry::Instance().Register( name, ::metrics::MetricKind::COUNTER );       \
+        ::metrics::Registry::Instance().Add( proofsystem_counter_id, static_cast<std::uint64_t>( value ) );                                        \
+    } while ( 0 )
+
+/// Records a value in a histogram
+#define PROOFSYSTEM_HISTOGRAM_OBSERVE( name, value )                                                                                               \
+    do                                                                                                                                             \
+    {                                                                                                                                              \
+        static const std::size_t proofsystem_histogram_id = ::metrics::Registry::Instance().Register( name, ::metrics::MetricKind::HISTOGRAM );   \
+        ::metrics::Registry::Instance().Observe( proofsystem_histogram_id, static_cast<std::uint64_t>( value ) );                                  \
+    } while ( 0 )
+
+#else
+
+#define PROOFSYSTEM_SCOPED_TIMER( name )             static_cast<void>( 0 )
+#define PROOFSYSTEM_COUNTER_ADD( name, value )       static_cast<void>( 0 )
+#define PROOFSYSTEM_HISTOGRAM_OBSERVE( name, value ) static_cast<void>( 0 )
+
+#endif
+
+#endif
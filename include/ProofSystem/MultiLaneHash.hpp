@@ -0,0 +1,99 @@
+/**
+ * @file       MultiLaneHash.hpp
+ * @brief      Multi-buffer hash functions used by the batch address derivation
+ * @date       2024-03-06
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _MULTI_LANE_HASH_HPP_
+#define _MULTI_LANE_HASH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hashing
+{
+    /**
+     * @brief       Instruction set used to hash several buffers at once
+     */
+    enum class SimdLevel
+    {
+        SCALAR, ///< One buffer at a time
+        AVX2,   ///< 4 Keccak lanes (64 bit words), 8 SHA-256/RIPEMD-160 lanes (32 bit words)
+        AVX512  ///< 8 Keccak lanes (64 bit words), 16 SHA-256/RIPEMD-160 lanes (32 bit words)
+    };
+
+    constexpr std::size_t KECCAK256_DIGEST_SIZE = 32; ///< Size of a Keccak-256 digest in bytes
+    constexpr std::size_t SHA256_DIGEST_SIZE    = 32; ///< Size of a SHA-256 digest in bytes
+    constexpr std::size_t RIPEMD160_DIGEST_SIZE = 20; ///< Size of a RIPEMD-160 digest in bytes
+
+    /**
+     * @brief       Returns the widest instruction set supported by the CPU and allowed by @ref SetMaxSimdLevel
+     * @return      The instruction set the batch functions will use
+     */
+    SimdLevel GetSimdLevel();
+
+    /**
+     * @brief       Caps the instruction set used by the batch functions
+     * @param[in]   level Widest instruction set allowed, @ref SimdLevel::SCALAR disables the vector paths
+     */
+    void SetMaxSimdLevel( SimdLevel level );
+
+    /**
+     * @brief       Tells if single buffer SHA-256 runs on the x86 SHA extensions
+     * @return      true if the CPU has them and @ref SetMaxSimdLevel did not restrict to @ref SimdLevel::SCALAR
+     */
+    bool HasShaExtensions();
+
+    /**
+     * @brief       Original Keccak-256 (Ethereum flavour, 0x01 padding) of a single buffer
+     * @param[in]   data Pointer to the data
+     * @param[in]   size Number of bytes
+     * @param[out]  digest Destination of the @ref KECCAK256_DIGEST_SIZE bytes digest
+     */
+    void Keccak256( const std::uint8_t *data, std::size_t size, std::uint8_t *digest );
+
+    /**
+     * @brief       Keccak-256 of many equally sized buffers, several of them per permutation when the CPU allows
+     * @param[in]   data Contiguous buffers, the i-th one starts at data + i * message_size
+     * @param[in]   message_size Size of each buffer in bytes
+     * @param[in]   count Number of buffers
+     * @param[out]  digests Contiguous digests, the i-th one is written at digests + i * @ref KECCAK256_DIGEST_SIZE
+     */
+    void Keccak256Batch( const std::uint8_t *data, std::size_t message_size, std::size_t count, std::uint8_t *digests );
+
+    /**
+     * @brief       SHA-256 of a single buffer, on the SHA extensions when available
+     * @param[in]   data Pointer to the data
+     * @param[in]   size Number of bytes
+     * @param[out]  digest Destination of the @ref SHA256_DIGEST_SIZE bytes digest
+     */
+    void Sha256( const std::uint8_t *data, std::size_t size, std::uint8_t *digest );
+
+    /**
+     * @brief       SHA-256 of many equally sized buffers
+     * @param[in]   data Contiguous buffers, the i-th one starts at data + i * message_size
+     * @param[in]   message_size Size of each buffer in bytes
+     * @param[in]   count Number of buffers
+     * @param[out]  digests Contiguous digests, the i-th one is written at digests + i * @ref SHA256_DIGEST_SIZE
+     */
+    void Sha256Batch( const std::uint8_t *data, std::size_t message_size, std::size_t count, std::uint8_t *digests );
+
+    /**
+     * @brief       RIPEMD-160 of a single buffer
+     * @param[in]   data Pointer to the data
+     * @param[in]   size Number of bytes
+     * @param[out]  digest Destination of the @ref RIPEMD160_DIGEST_SIZE bytes digest
+     */
+    void Ripemd160( const std::uint8_t *data, std::size_t size, std::uint8_t *digest );
+
+    /**
+     * @brief       RIPEMD-160 of many equally sized buffers
+     * @param[in]   data Contiguous buffers, the i-th one starts at data + i * message_size
+     * @param[in]   message_size Size of each buffer in bytes
+     * @param[in]   count Number of buffers
+     * @param[out]  digests Contiguous digests, the i-th one is written at digests + i * @ref RIPEMD160_DIGEST_SIZE
+     */
+    void Ripemd160Batch( const std::uint8_t *data, std::size_t message_size, std::size_t count, std::uint8_t *digests );
+}
+
+#endif
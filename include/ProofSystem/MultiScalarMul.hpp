@@ -0,0 +1,208 @@
+/**
+ * @file       MultiScalarMul.hpp
+ * @brief      Multi-scalar multiplication with Pippenger's bucket method
+ * @date       2024-03-18
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _MULTI_SCALAR_MUL_HPP_
+#define _MULTI_SCALAR_MUL_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "ProofSystem/ECBatchOps.hpp"
+#include "ProofSystem/ParallelFor.hpp"
+
+namespace msm
+{
+    using cpp_int = ecbatch::cpp_int;
+
+    /**
+     * @brief       Picks the bucket window for a number of terms
+     * @param[in]   count Number of points
+     * @return      Window size c in bits, about ln( count ) + 2
+     */
+    inline std::size_t WindowBits( std::size_t count )
+    {
+        if ( count < 32 )
+        {
+            return 3;
+        }
+        std::size_t log2_count = 0;
+        while ( ( count >> ( log2_count + 1 ) ) != 0 )
+        {
+            ++log2_count;
+        }
+        return ( log2_count * 69 ) / 100 + 2;
+    }
+
+    /**
+     * @brief       Scalar split into little endian 64 bit limbs, so window digits are read without big integer math
+     * @tparam      NUM_BITS Maximum size of the scalars
+     */
+    template <std::size_t NUM_BITS>
+    struct ScalarLimbs
+    {
+        static constexpr std::size_t NUM_LIMBS = ( NUM_BITS + 63 ) / 64;
+
+        std::array<std::uint64_t, NUM_LIMBS> limbs{};
+
+        ScalarLimbs() = default;
+
+        template <typename ScalarValue>
+        explicit ScalarLimbs( const ScalarValue &scalar )
+        {
+            cpp_int remaining = static_cast<cpp_int>( scalar.data );
+            for ( std::size_t i = 0; i < NUM_LIMBS && remaining != 0; ++i )
+            {
+                limbs[i] = static_cast<std::uint64_t>( remaining & 0xFFFFFFFFFFFFFFFFULL );
+                remaining >>= 64;
+            }
+        }
+
+        /**
+         * @brief       Reads bits [bit_offset, bit_offset + num_bits) of the scalar
+         * @param[in]   bit_offset First bit
+         * @param[in]   num_bits Width of the digit, less than 64
+         * @return      The digit
+         */
+        std::size_t Digit( std::size_t bit_offset, std::size_t num_bits ) const
+        {
+            const std::size_t limb  = bit_offset / 64;
+            const std::size_t shift = bit_offset % 64;
+            if ( limb >= NUM_LIMBS )
+            {
+                return 0;
+            }
+            std::uint64_t value = limbs[limb] >> shift;
+            if ( shift + num_bits > 64 && limb + 1 < NUM_LIMBS )
+            {
+                value |= limbs[limb + 1] << ( 64 - shift );
+            }
+            return static_cast<std::size_t>( value & ( ( std::uint64_t{ 1 } << num_bits ) - 1 ) );
+        }
+    };
+
+    /**
+     * @brief       Sums the points of one window of the scalars
+     * @param[in]   points Curve points
+     * @param[in]   limbs Scalars, split in limbs
+     * @param[in]   count Number of terms
+     * @param[in]   bit_offset First bit of the window
+     * @param[in]   window_bits Size of the window
+     * @return      sum( digit_i * points[i] ), digit_i being the window bits of scalar i
+     */
+    template <typename G1Value, typename Limbs>
+    G1Value WindowSum( const G1Value *points, const Limbs *limbs, std::size_t count, std::size_t bit_offset, std::size_t window_bits )
+    {
+        std::vector<G1Value> buckets( ( std::size_t{ 1 } << window_bits ) - 1, G1Value::zero() );
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            const std::size_t digit = limbs[i].Digit( bit_offset, window_bits );
+            if ( digit != 0 )
+            {
+                buckets[digit - 1] = buckets[digit - 1] + points[i];
+            }
+        }
+
+        // sum( d * bucket[d] ) as the sum of the running sums from the top bucket down
+        G1Value running_sum = G1Value::zero();
+        G1Value window_sum  = G1Value::zero();
+        for ( std::size_t bucket = buckets.size(); bucket > 0; --bucket )
+        {
+            running_sum = running_sum + buckets[bucket - 1];
+            window_sum  = window_sum + running_sum;
+        }
+        return window_sum;
+    }
+
+    /**
+     * @brief       Computes sum( scalars[i] * points[i] )
+     * @param[in]   points Curve points
+     * @param[in]   scalars Multipliers, one per point
+     * @param[in]   count Number of terms
+     * @param[in]   num_threads Threads sharing the windows, 1 runs on the calling thread, 0 uses the hardware concurrency
+     * @return      The sum, or the point at infinity if count is 0
+     * @details     Pippenger's method: every c bit window of the scalars drops the points into 2^c - 1
+     *              buckets, which are summed with a running sum; the windows are then combined with c
+     *              doublings each. The cost is about ( bits / c ) * ( count + 2^c ) additions instead of
+     *              count full scalar multiplications. The windows are independent, so in parallel mode
+     *              each thread fills the buckets of its own windows and only the final combination is serial.
+     * @tparam      G1Value Curve point type, e.g. pallas or secp256k1 g1_type<>::value_type
+     * @tparam      ScalarValue Scalar field element type
+     */
+    template <typename G1Value, typename ScalarValue>
+    G1Value MultiScalarMul( const G1Value *points, const ScalarValue *scalars, std::size_t count, std::size_t num_threads = 1 )
+    {
+        using Limbs_t = ScalarLimbs<ScalarValue::field_type::number_bits>;
+
+        constexpr std::size_t NUM_BITS = ScalarValue::field_type::number_bits;
+
+        if ( count == 0 )
+        {
+            return G1Value::zero();
+        }
+
+        std::vector<Limbs_t> limbs( count );
+        util::ParallelFor(
+            count,
+            [&]( std::size_t begin, std::size_t end )
+            {
+                for ( std::size_t i = begin; i < end; ++i )
+                {
+                    limbs[i] = Limbs_t( scalars[i] );
+                }
+            },
+            num_threads );
+
+        const std::size_t window_bits = WindowBits( count );
+        const std::size_t num_windows = ( NUM_BITS + window_bits - 1 ) / window_bits;
+
+        std::vector<G1Value> window_sums( num_windows );
+        util::ParallelFor(
+            num_windows,
+            [&]( std::size_t begin, std::size_t end )
+            {
+                for ( std::size_t window = begin; window < end; ++window )
+                {
+                    window_sums[window] = WindowSum( points, limbs.data(), count, window * window_bits, window_bits );
+                }
+            },
+            num_threads );
+
+        G1Value result = G1Value::zero();
+        for ( std::size_t window = num_windows; window > 0; --window )
+        {
+            for ( std::size_t i = 0; i < window_bits; ++i )
+            {
+                result = result.doubled();
+            }
+            result = result + window_sums[window - 1];
+        }
+        return result;
+    }
+
+    /**
+     * @brief       Computes sum( scalars[i] * points[i] )
+     * @param[in]   points Curve points
+     * @param[in]   scalars Multipliers, as many as points
+     * @param[in]   num_threads Threads sharing the windows, 1 runs on the calling thread, 0 uses the hardware concurrency
+     * @return      The sum
+     * @warning     Throws std::runtime_error if the sizes differ
+     */
+    template <typename G1Value, typename ScalarValue>
+    G1Value MultiScalarMul( const std::vector<G1Value> &points, const std::vector<ScalarValue> &scalars, std::size_t num_threads = 1 )
+    {
+        if ( points.size() != scalars.size() )
+        {
+            throw std::runtime_error( "Points and scalars must have the same size" );
+        }
+        return MultiScalarMul( points.data(), scalars.data(), points.size(), num_threads );
+    }
+}
+
+#endif
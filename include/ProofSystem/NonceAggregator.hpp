@@ -0,0 +1,210 @@
+/**
+ * @file       NonceAggregator.hpp
+ * @brief      Streaming aggregation of the per node MPC nonces
+ * @date       2024-03-21
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _NONCE_AGGREGATOR_HPP_
+#define _NONCE_AGGREGATOR_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "ProofSystem/ECBatchOps.hpp"
+
+/**
+ * @brief       Collects the Nonce A and Nonce B values of every node as they arrive
+ * @details     Node i publishes its commitment r_i * G and, for each block b, A_b = G * ( r_i - base - i - b ) and
+ *              B_b = G * ( r_i + base + i + b ), so every pair adds up to twice the commitment. A contribution is
+ *              checked on arrival, on the submitting thread, and folded into the running aggregate; the aggregate
+ *              is final as soon as the last node reports, whatever the order.
+ * @tparam      CurveType Curve of the nonces, pallas for the MPC circuits
+ */
+template <typename CurveType>
+class NonceAggregator
+{
+public:
+    using affine_type   = typename CurveType::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type;
+    using jacobian_type = typename CurveType::template g1_type<>::value_type;
+    using base_type     = typename CurveType::base_field_type::value_type;
+    using scalar_type   = typename CurveType::scalar_field_type::value_type;
+
+    /**
+     * @brief       Nonces of one node
+     */
+    struct Contribution
+    {
+        std::size_t              node_number;       ///< Index of the node, smaller than the number of nodes
+        std::vector<affine_type> nonces_a;          ///< Nonce A of every block
+        std::vector<affine_type> nonces_b;          ///< Nonce B of every block
+        affine_type              random_commitment; ///< r_i * G published by the node beforehand
+    };
+
+    /**
+     * @brief       Outcome of @ref Submit
+     */
+    enum class SubmitResult
+    {
+        ACCEPTED,     ///< Folded into the aggregate, other nodes are still missing
+        COMPLETE,     ///< Folded into the aggregate, which is now final
+        INVALID_NODE, ///< Node number or number of blocks out of range
+        DUPLICATE,    ///< The node already reported
+        INCONSISTENT  ///< The pairs don't all add up to twice the commitment
+    };
+
+    /**
+     * @brief       Aggregate of all the nodes
+     */
+    struct Result
+    {
+        affine_type final_aggregate;  ///< Sum of every Nonce A and Nonce B
+        affine_type total_random_sum; ///< Sum of 2 * blocks * r_i * G, computed from the commitments alone
+    };
+
+    /**
+     * @brief       Constructs a new NonceAggregator
+     * @param[in]   num_nodes Nodes expected
+     * @param[in]   num_blocks_per_node Nonce pairs per node
+     * @param[in]   on_complete Optional callback, called once by the thread that completes the aggregate
+     */
+    NonceAggregator( std::size_t num_nodes, std::size_t num_blocks_per_node, std::function<void( const Result & )> on_complete = nullptr ) :
+        num_nodes( num_nodes ),                     //
+        num_blocks_per_node( num_blocks_per_node ), //
+        received( num_nodes, false ),               //
+        on_complete( std::move( on_complete ) )
+    {
+    }
+
+    /**
+     * @brief       Checks a node contribution and folds it into the aggregate
+     * @param[in]   contribution Nonces of the node
+     * @return      Whether it was accepted, and whether it completed the aggregate
+     * @details     Thread safe. The check and the per node sums run without holding the lock.
+     */
+    SubmitResult Submit( const Contribution &contribution )
+    {
+        if ( contribution.node_number >= num_nodes || contribution.nonces_a.size() != num_blocks_per_node ||
+             contribution.nonces_b.size() != num_blocks_per_node || num_blocks_per_node == 0 )
+        {
+            return SubmitResult::INVALID_NODE;
+        }
+        jacobian_type node_sum;
+        if ( !CheckContribution( contribution, node_sum ) )
+        {
+            return SubmitResult::INCONSISTENT;
+        }
+
+        std::optional<Result> completed;
+        {
+            std::lock_guard<std::mutex> lock( state_mutex );
+            if ( received[contribution.node_number] )
+            {
+                return SubmitResult::DUPLICATE;
+            }
+            received[contribution.node_number] = true;
+            aggregate                          = aggregate + node_sum;
+            commitment_sum                     = commitment_sum + ToJacobian( contribution.random_commitment );
+            if ( ++num_received < num_nodes )
+            {
+                return SubmitResult::ACCEPTED;
+            }
+            const jacobian_type random_sum = commitment_sum * scalar_type( 2 * num_blocks_per_node );
+
+            result    = Result{ aggregate.to_affine(), random_sum.to_affine() };
+            completed = result;
+        }
+        completion_condition.notify_all();
+        if ( on_complete )
+        {
+            on_complete( *completed );
+        }
+        return SubmitResult::COMPLETE;
+    }
+
+    /**
+     * @brief       Returns the number of nodes that reported
+     * @return      Accepted contributions
+     */
+    std::size_t GetReceivedCount() const
+    {
+        std::lock_guard<std::mutex> lock( state_mutex );
+        return num_received;
+    }
+
+    /**
+     * @brief       Returns the aggregate if every node reported
+     * @return      The aggregate, or std::nullopt
+     */
+    std::optional<Result> TryGetResult() const
+    {
+        std::lock_guard<std::mutex> lock( state_mutex );
+        return result;
+    }
+
+    /**
+     * @brief       Waits for the last node
+     * @param[in]   timeout Maximum wait
+     * @return      The aggregate, or std::nullopt on timeout
+     */
+    std::optional<Result> WaitForResult( std::chrono::milliseconds timeout ) const
+    {
+        std::unique_lock<std::mutex> lock( state_mutex );
+        completion_condition.wait_for( lock, timeout, [this]() { return result.has_value(); } );
+        return result;
+    }
+
+private:
+    const std::size_t                     num_nodes;           ///< Nodes expected
+    const std::size_t                     num_blocks_per_node; ///< Nonce pairs per node
+    mutable std::mutex                    state_mutex;         ///< Guards the running sums
+    mutable std::condition_variable       completion_condition;
+    std::vector<bool>                     received;                               ///< Nodes that reported
+    std::size_t                           num_received   = 0;                     ///< Number of nodes that reported
+    jacobian_type                         aggregate      = jacobian_type::zero(); ///< Sum of the accepted nonces
+    jacobian_type                         commitment_sum = jacobian_type::zero(); ///< Sum of the accepted commitments
+    std::optional<Result>                 result;                                 ///< Set once complete
+    std::function<void( const Result & )> on_complete;                            ///< Completion callback
+
+    static jacobian_type ToJacobian( const affine_type &point )
+    {
+        return jacobian_type( point.X, point.Y, base_type::one() );
+    }
+
+    /**
+     * @brief       Checks that every A_b + B_b is twice the commitment of the node
+     * @param[in]   contribution Nonces of the node
+     * @param[out]  node_sum Sum of all the nonces of the node, which is then blocks * 2 * r_i * G
+     * @return      true if consistent
+     */
+    bool CheckContribution( const Contribution &contribution, jacobian_type &node_sum ) const
+    {
+        const std::size_t          num_pairs = num_blocks_per_node;
+        std::vector<jacobian_type> pair_sums( num_pairs + 1 );
+        node_sum = jacobian_type::zero();
+        for ( std::size_t block = 0; block < num_pairs; ++block )
+        {
+            pair_sums[block] = ToJacobian( contribution.nonces_a[block] ) + ToJacobian( contribution.nonces_b[block] );
+            node_sum         = node_sum + pair_sums[block];
+        }
+        pair_sums[num_pairs] = ToJacobian( contribution.random_commitment ).doubled();
+
+        // One field inversion to compare all the sums in affine form
+        std::vector<affine_type> affine_sums( pair_sums.size() );
+        ecbatch::BatchToAffine( pair_sums.data(), pair_sums.size(), affine_sums.data() );
+        for ( const auto &pair_sum : affine_sums )
+        {
+            if ( pair_sum.X != affine_sums[0].X || pair_sum.Y != affine_sums[0].Y )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,149 @@
+/**
+ * @file       ParallelFor.hpp
+ * @brief      Range splitting helper for the batch APIs
+ * @date       2024-03-04
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _PARALLEL_FOR_HPP_
+#define _PARALLEL_FOR_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "ProofSystem/TaskScheduler.hpp"
+
+namespace util
+{
+    /**
+     * @brief       Resolves the number of workers to use for a batch
+     * @param[in]   count Number of items in the batch
+     * @param[in]   num_threads Requested number of threads, 0 to use the concurrency of the executor
+     * @return      Number of workers, never bigger than the number of items
+     */
+    inline std::size_t ResolveThreadCount( std::size_t count, std::size_t num_threads = 0 )
+    {
+        if ( num_threads == 0 )
+        {
+            num_threads = std::max<std::size_t>( 1, GetExecutor()->GetConcurrency() );
+        }
+        return std::max<std::size_t>( 1, std::min( num_threads, count ) );
+    }
+
+    namespace detail
+    {
+        /**
+         * @brief       Bookkeeping of one ParallelFor call, shared with its tasks
+         * @details     A task that starts after the call returned finds no range left and only touches this
+         */
+        struct ParallelForState
+        {
+            ParallelForState( std::size_t num_items, std::size_t ranges ) :
+                count( num_items ),                           //
+                chunk( ( num_items + ranges - 1 ) / ranges ), //
+                num_ranges( ranges ),                         //
+                next( 0 ),                                    //
+                remaining( ranges ),                          //
+                errors( ranges )
+            {
+            }
+
+            const std::size_t               count;
+            const std::size_t               chunk;      ///< Items per range, the last one may be shorter
+            const std::size_t               num_ranges;
+            std::atomic<std::size_t>        next;       ///< Next range to claim
+            std::atomic<std::size_t>        remaining;  ///< Ranges not finished yet
+            std::vector<std::exception_ptr> errors;     ///< Error of each range
+            std::mutex                      mutex;
+            std::condition_variable         done;       ///< Signaled when the last range finishes
+        };
+
+        /**
+         * @brief       Claims and runs ranges until none is left
+         */
+        template <typename Func>
+        void RunRanges( ParallelForState &state, Func &func )
+        {
+            for ( std::size_t range = state.next.fetch_add( 1 ); range < state.num_ranges; range = state.next.fetch_add( 1 ) )
+            {
+                const std::size_t begin = range * state.chunk;
+                const std::size_t end   = std::min( state.count, begin + state.chunk );
+                try
+                {
+                    if ( begin < end )
+                    {
+                        func( begin, end );
+                    }
+                }
+                catch ( ... )
+                {
+                    state.errors[range] = std::current_exception();
+                }
+                if ( state.remaining.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+                {
+                    std::lock_guard<std::mutex> lock( state.mutex );
+                    state.done.notify_all();
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief       Splits [0, count) into contiguous ranges and runs them concurrently
+     * @details     The ranges run on the executor of @ref GetExecutor. The calling thread runs ranges too and
+     *              takes over those no worker has started, so nested calls and a busy executor never deadlock,
+     *              they only lose parallelism. The call returns once every range is finished.
+     * @param[in]   count Number of items to process
+     * @param[in]   func Callable with the signature void( std::size_t begin, std::size_t end )
+     * @param[in]   num_threads Maximum number of ranges running at once, 0 to use the concurrency of the executor
+     * @warning     The first exception thrown by any range is rethrown on the calling thread
+     */
+    template <typename Func>
+    void ParallelFor( std::size_t count, Func &&func, std::size_t num_threads = 0 )
+    {
+        if ( count == 0 )
+        {
+            return;
+        }
+        num_threads = ResolveThreadCount( count, num_threads );
+        if ( num_threads == 1 )
+        {
+            func( std::size_t{ 0 }, count );
+            return;
+        }
+
+        auto  state = std::make_shared<detail::ParallelForState>( count, num_threads );
+        auto *body  = &func;
+        try
+        {
+            auto executor = GetExecutor();
+            for ( std::size_t helper = 1; helper < num_threads; ++helper )
+            {
+                executor->Execute( [state, body]() { detail::RunRanges( *state, *body ); } );
+            }
+        }
+        catch ( ... )
+        {
+            // An executor that refuses tasks leaves their ranges to this thread
+        }
+        detail::RunRanges( *state, func );
+        {
+            std::unique_lock<std::mutex> lock( state->mutex );
+            state->done.wait( lock, [&state]() { return state->remaining.load( std::memory_order_acquire ) == 0; } );
+        }
+        for ( auto &error : state->errors )
+        {
+            if ( error )
+            {
+                std::rethrow_exception( error );
+            }
+        }
+    }
+}
+
+#endif
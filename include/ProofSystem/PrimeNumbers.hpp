@@ -10,7 +10,9 @@
 #define _USE_CRYPTO3_
 
 #include <ctime>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 #ifdef _USE_CRYPTO3_
 #include <nil/crypto3/multiprecision/cpp_int.hpp>
@@ -69,18 +71,74 @@ public:
 
     static cpp_int PowHighPrec( const cpp_int &value, const int64_t &exp );
 
+    /**
+     * @brief       Baby step giant step solver of small discrete logarithms
+     * @details     The baby step table is built by the constructor and never modified afterwards, every
+     *              member function is const. One instance can serve any number of threads concurrently
+     *              without locking, as long as it outlives them.
+     */
     class BabyStepGiantStep
     {
     public:
+        using Table_t = std::unordered_map<cpp_int, cpp_int>; ///< generator^i mod prime to i
+
         BabyStepGiantStep( const cpp_int &prime, const cpp_int &generator );
 
-        cpp_int SolveECDLP( const cpp_int &number );
+        /**
+         * @brief       Looks a value up in the baby step table
+         * @param[in]   value Value modulo the prime
+         * @return      The exponent i < step size with generator^i == value, or std::nullopt
+         */
+        [[nodiscard]] std::optional<cpp_int> Lookup( const cpp_int &value ) const;
+
+        /**
+         * @brief       Finds x with generator^x == number
+         * @param[in]   number Value modulo the prime
+         * @return      The exponent, smaller than the square of the step size
+         * @warning     Throws if the exponent is out of the range covered by the table
+         */
+        [[nodiscard]] cpp_int SolveECDLP( const cpp_int &number ) const;
 
     private:
-        cpp_int                              g_n_inv;
-        cpp_int                              step_size;
-        cpp_int                              prime_number;
-        std::unordered_map<cpp_int, cpp_int> value_table;
+        static Table_t BuildTable( const cpp_int &prime, const cpp_int &generator, const cpp_int &step_size );
+
+        const cpp_int prime_number;
+        const cpp_int step_size;
+        const cpp_int g_n_inv;     ///< generator^-step_size mod prime, one giant step
+        const Table_t value_table; ///< Baby steps, read only after construction
+    };
+
+    /**
+     * @brief       Fixed base modular exponentiation with a precomputed window table
+     * @details     Stores base^(d * 16^w) for every 4 bit window w of the exponent, so each
+     *              exponentiation costs one modular multiplication per non zero window and no squarings.
+     *              Worth it when the same base is raised to many exponents, as in chunked encryption.
+     */
+    class FixedBaseExponentiation
+    {
+    public:
+        /**
+         * @brief       Builds the window table
+         * @param[in]   base The fixed base
+         * @param[in]   prime The modulus
+         * @param[in]   exponent_bits Maximum bit size of the exponents that will be used
+         */
+        FixedBaseExponentiation( const cpp_int &base, const cpp_int &prime, std::size_t exponent_bits );
+
+        /**
+         * @brief       Raises the fixed base to the exponent
+         * @param[in]   exponent Non negative exponent with at most the configured bit size
+         * @return      base^exponent mod prime
+         */
+        [[nodiscard]] cpp_int Pow( const cpp_int &exponent ) const;
+
+    private:
+        static constexpr std::size_t WINDOW_BITS = 4;                 ///< Bits of exponent consumed per table lookup
+        static constexpr std::size_t WINDOW_SIZE = 1 << WINDOW_BITS; ///< Number of entries per window
+
+        cpp_int              prime_number;
+        std::size_t          num_windows;
+        std::vector<cpp_int> table; ///< table[w * WINDOW_SIZE + d] = base^(d * 16^w)
     };
 };
 
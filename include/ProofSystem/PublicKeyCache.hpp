@@ -0,0 +1,184 @@
+/**
+ * @file       PublicKeyCache.hpp
+ * @brief      Bounded, thread safe cache of parsed public keys
+ * @date       2024-03-14
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _PUBLIC_KEY_CACHE_HPP_
+#define _PUBLIC_KEY_CACHE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ProofSystem/ECPointCodec.hpp"
+
+namespace ecpoint
+{
+    /**
+     * @brief       Counters of a @ref PublicKeyCache
+     */
+    struct CacheStats
+    {
+        std::uint64_t hits;      ///< Lookups answered from the cache
+        std::uint64_t misses;    ///< Lookups that parsed and validated the key
+        std::uint64_t evictions; ///< Entries dropped to respect the capacity
+        std::size_t   size;      ///< Entries currently held
+
+        double HitRate() const
+        {
+            const std::uint64_t lookups = hits + misses;
+            return lookups != 0 ? static_cast<double>( hits ) / static_cast<double>( lookups ) : 0.0;
+        }
+    };
+
+    /**
+     * @brief       Interns text public keys into parsed and validated curve points
+     * @details     The same peer keys are parsed over and over by the KDF, the Ethereum key import
+     *              and the ElGamal public keys. The cache parses a key once, checks that it is on the
+     *              curve once and hands out copies of the point afterwards. Entries are spread over
+     *              independently locked shards, each one evicting its least recently used key.
+     * @tparam      CurveType Curve of the keys
+     */
+    template <typename CurveType>
+    class PublicKeyCache
+    {
+    public:
+        using Codec         = PointCodec<CurveType>;
+        using g1_value_type = typename Codec::g1_value_type;
+
+        static constexpr std::size_t DEFAULT_CAPACITY = 4096; ///< Keys held by the shared instance
+        static constexpr std::size_t DEFAULT_SHARDS   = 16;   ///< Locks of the shared instance
+
+        /**
+         * @brief       Constructs a new PublicKeyCache
+         * @param[in]   capacity Maximum number of keys held, at least one per shard is kept
+         * @param[in]   num_shards Number of independently locked partitions
+         */
+        explicit PublicKeyCache( std::size_t capacity = DEFAULT_CAPACITY, std::size_t num_shards = DEFAULT_SHARDS ) :
+            shards( std::max<std::size_t>( 1, num_shards ) ), //
+            shard_capacity( std::max<std::size_t>( 1, capacity / shards.size() ) )
+        {
+        }
+
+        /**
+         * @brief       Cache shared by every key parser of the library
+         * @return      The instance for CurveType
+         */
+        static PublicKeyCache &Instance()
+        {
+            static PublicKeyCache instance;
+            return instance;
+        }
+
+        /**
+         * @brief       Returns the point of a text key, parsing it on the first use
+         * @param[in]   key_hex Any of the text forms accepted by @ref PointCodec::FromHex, case insensitive
+         * @return      The point, with Z = 1
+         * @warning     Throws std::runtime_error if the key can't be parsed or is not on the curve.
+         *              Invalid keys are not cached.
+         */
+        g1_value_type Get( std::string_view key_hex )
+        {
+            std::string key( key_hex );
+            std::transform( key.begin(), key.end(), key.begin(), []( unsigned char c ) { return static_cast<char>( std::tolower( c ) ); } );
+
+            Shard &shard = shards[std::hash<std::string>{}( key ) % shards.size()];
+            {
+                std::lock_guard<std::mutex> lock( shard.mutex );
+                auto                        found = shard.index.find( key );
+                if ( found != shard.index.end() )
+                {
+                    shard.entries.splice( shard.entries.begin(), shard.entries, found->second );
+                    hits.fetch_add( 1, std::memory_order_relaxed );
+                    return found->second->second;
+                }
+            }
+            misses.fetch_add( 1, std::memory_order_relaxed );
+
+            // Parsed outside of the lock, two threads may both parse a new key but only one copy is kept
+            const g1_value_type point = Parse( key );
+
+            std::lock_guard<std::mutex> lock( shard.mutex );
+            if ( shard.index.find( key ) == shard.index.end() )
+            {
+                shard.entries.emplace_front( key, point );
+                shard.index.emplace( std::move( key ), shard.entries.begin() );
+                if ( shard.entries.size() > shard_capacity )
+                {
+                    shard.index.erase( shard.entries.back().first );
+                    shard.entries.pop_back();
+                    evictions.fetch_add( 1, std::memory_order_relaxed );
+                }
+            }
+            return point;
+        }
+
+        /**
+         * @brief       Reads the counters
+         * @return      Hits, misses, evictions and current size
+         */
+        CacheStats GetStats() const
+        {
+            std::size_t size = 0;
+            for ( const auto &shard : shards )
+            {
+                std::lock_guard<std::mutex> lock( shard.mutex );
+                size += shard.entries.size();
+            }
+            return CacheStats{ hits.load( std::memory_order_relaxed ), misses.load( std::memory_order_relaxed ),
+                               evictions.load( std::memory_order_relaxed ), size };
+        }
+
+        /**
+         * @brief       Drops every entry and resets the counters
+         */
+        void Clear()
+        {
+            for ( auto &shard : shards )
+            {
+                std::lock_guard<std::mutex> lock( shard.mutex );
+                shard.index.clear();
+                shard.entries.clear();
+            }
+            hits.store( 0, std::memory_order_relaxed );
+            misses.store( 0, std::memory_order_relaxed );
+            evictions.store( 0, std::memory_order_relaxed );
+        }
+
+    private:
+        using Entry_t = std::pair<std::string, g1_value_type>;
+
+        struct Shard
+        {
+            mutable std::mutex                                                 mutex;   ///< Guards the entries
+            std::list<Entry_t>                                                 entries; ///< Most recently used first
+            std::unordered_map<std::string, typename std::list<Entry_t>::iterator> index;   ///< Key text to entry
+        };
+
+        std::vector<Shard>         shards;         ///< Partitions of the key space
+        std::size_t                shard_capacity; ///< Maximum entries per shard
+        std::atomic<std::uint64_t> hits{ 0 };      ///< Lookups answered from the cache
+        std::atomic<std::uint64_t> misses{ 0 };    ///< Lookups that parsed the key
+        std::atomic<std::uint64_t> evictions{ 0 }; ///< Entries dropped
+
+        static g1_value_type Parse( std::string_view key_hex )
+        {
+            // FromHex already rejects points that are not on the curve
+            return Codec::FromHex( key_hex );
+        }
+    };
+}
+
+#endif
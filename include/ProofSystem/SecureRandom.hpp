@@ -0,0 +1,141 @@
+/**
+ * @file       SecureRandom.hpp
+ * @brief      Per thread ChaCha20 random generator used by the key generators
+ * @date       2024-03-26
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _SECURE_RANDOM_HPP_
+#define _SECURE_RANDOM_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "ProofSystem/ECBatchOps.hpp"
+
+namespace csprng
+{
+    constexpr std::size_t CHACHA20_KEY_SIZE   = 32; ///< Size of a ChaCha20 key in bytes
+    constexpr std::size_t CHACHA20_NONCE_SIZE = 12; ///< Size of a ChaCha20 nonce in bytes (RFC 8439)
+    constexpr std::size_t CHACHA20_BLOCK_SIZE = 64; ///< Size of a ChaCha20 keystream block in bytes
+
+    /**
+     * @brief       ChaCha20 block function of RFC 8439
+     * @param[in]   key @ref CHACHA20_KEY_SIZE bytes key
+     * @param[in]   counter Block counter
+     * @param[in]   nonce @ref CHACHA20_NONCE_SIZE bytes nonce
+     * @param[out]  block Destination of the @ref CHACHA20_BLOCK_SIZE bytes of keystream
+     */
+    void ChaCha20Block( const std::uint8_t *key, std::uint32_t counter, const std::uint8_t *nonce, std::uint8_t *block );
+
+    /**
+     * @brief       Buffered ChaCha20 generator with fast key erasure
+     * @details     Each refill runs @ref BUFFER_BLOCKS blocks under the current key, the first 32 bytes become
+     *              the next key and the rest is handed out, so a leaked state does not expose earlier output.
+     *              Seeded from std::random_device and mixed with fresh OS entropy every @ref RESEED_INTERVAL
+     *              bytes, and again in a forked child before it hands out anything. Not thread safe, every
+     *              thread uses its own instance through @ref ThreadRng.
+     *              Meets the UniformRandomBitGenerator requirements.
+     */
+    class ChaCha20Rng
+    {
+    public:
+        using result_type = std::uint64_t;
+
+        static constexpr std::size_t   BUFFER_BLOCKS   = 16;                                  ///< Blocks computed per refill
+        static constexpr std::size_t   BUFFER_SIZE     = BUFFER_BLOCKS * CHACHA20_BLOCK_SIZE; ///< Bytes computed per refill
+        static constexpr std::uint64_t RESEED_INTERVAL = 1ull << 20;                          ///< Bytes handed out before mixing in OS entropy
+
+        /**
+         * @brief       Constructs a generator seeded from the OS
+         */
+        ChaCha20Rng();
+
+        /**
+         * @brief       Constructs a deterministic generator, which is never reseeded
+         * @param[in]   seed Initial key
+         */
+        explicit ChaCha20Rng( const std::array<std::uint8_t, CHACHA20_KEY_SIZE> &seed );
+
+        ~ChaCha20Rng();
+
+        ChaCha20Rng( const ChaCha20Rng & )            = delete;
+        ChaCha20Rng &operator=( const ChaCha20Rng & ) = delete;
+
+        static constexpr result_type min()
+        {
+            return 0;
+        }
+
+        static constexpr result_type max()
+        {
+            return std::numeric_limits<result_type>::max();
+        }
+
+        /**
+         * @brief       Returns 64 random bits
+         */
+        result_type operator()();
+
+        /**
+         * @brief       Fills a buffer with random bytes
+         * @param[out]  out Destination
+         * @param[in]   size Number of bytes
+         */
+        void Fill( std::uint8_t *out, std::size_t size );
+
+        /**
+         * @brief       Mixes fresh OS entropy into the key and discards the buffered output
+         */
+        void Reseed();
+
+    private:
+        std::array<std::uint8_t, CHACHA20_KEY_SIZE> key;                  ///< Key of the next refill
+        std::array<std::uint8_t, BUFFER_SIZE>       buffer;               ///< Keystream, the part before position is spent
+        std::size_t                                 position;             ///< Next unused byte of the buffer
+        std::uint64_t                               bytes_since_seed = 0; ///< Output since the last reseed
+        bool                                        auto_reseed;          ///< false for the deterministic generators
+        std::uint64_t                               seed_fork_count = 0;  ///< Forks seen when the generator was last seeded
+
+        void Refill();
+    };
+
+    /**
+     * @brief       Returns the generator of the calling thread, created and seeded on first use
+     * @return      Thread local generator
+     */
+    ChaCha20Rng &ThreadRng();
+
+    /**
+     * @brief       Uniform integer in [0, bound) drawn from the thread generator
+     * @param[in]   bound Exclusive upper bound, must be positive
+     * @return      The random integer
+     */
+    ecbatch::cpp_int RandomBelow( const ecbatch::cpp_int &bound );
+
+    /**
+     * @brief       Uniform integer in [low, high] drawn from the thread generator
+     * @param[in]   low Inclusive lower bound
+     * @param[in]   high Inclusive upper bound, not smaller than low
+     * @return      The random integer
+     */
+    inline ecbatch::cpp_int RandomInRange( const ecbatch::cpp_int &low, const ecbatch::cpp_int &high )
+    {
+        return low + RandomBelow( high - low + 1 );
+    }
+
+    /**
+     * @brief       Uniform nonzero field element, a drop in replacement of algebraic_random_device
+     * @tparam      FieldType Field to draw from, usually a curve scalar field
+     * @return      Element in [1, modulus)
+     */
+    template <typename FieldType>
+    typename FieldType::value_type RandomScalar()
+    {
+        static const ecbatch::cpp_int range = static_cast<ecbatch::cpp_int>( FieldType::modulus ) - 1;
+        return typename FieldType::value_type( 1 + RandomBelow( range ) );
+    }
+}
+
+#endif
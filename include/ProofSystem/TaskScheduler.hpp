@@ -0,0 +1,145 @@
+/**
+ * @file       TaskScheduler.hpp
+ * @brief      Work stealing thread pool shared by the parallel paths of the library
+ * @date       2024-04-01
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _TASK_SCHEDULER_HPP_
+#define _TASK_SCHEDULER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+    /**
+     * @brief       Runs the tasks of @ref ParallelFor
+     * @details     Implement it to run the library on the thread pool of the host application, see
+     *              @ref SetExecutor. Tasks never throw and never block on each other, an executor may run
+     *              them in any order, on any thread, including inline in @ref Execute.
+     */
+    class Executor
+    {
+    public:
+        virtual ~Executor() = default;
+
+        /**
+         * @brief       Queues a task
+         * @param[in]   task: Task to run once
+         */
+        virtual void Execute( std::function<void()> task ) = 0;
+
+        /**
+         * @brief       Number of tasks the executor runs at the same time
+         * @details     Used when a batch API is called with 0 threads
+         */
+        [[nodiscard]] virtual std::size_t GetConcurrency() const = 0;
+    };
+
+    /**
+     * @brief       Work stealing pool, the default @ref Executor
+     * @details     Every worker owns a deque. Tasks queued by a worker go to the back of its own deque and it
+     *              takes them back from there, newest first, while idle workers steal from the front of the
+     *              others, oldest first. Tasks queued by other threads are spread round robin.
+     *              With NUMA awareness a thief tries the workers of its own node before crossing nodes. The
+     *              node of a worker is the node of the CPU it's assigned to, which it only stays on if the
+     *              threads are pinned.
+     */
+    class TaskScheduler : public Executor
+    {
+    public:
+        struct Options
+        {
+            std::size_t num_threads = 0;     ///< Number of workers, 0 for one per CPU the process may run on
+            bool        pin_threads = false; ///< Pins each worker to one CPU of the process affinity mask
+            bool        numa_aware  = true;  ///< Steals from the same NUMA node first
+        };
+
+        /**
+         * @brief       Starts the workers with the default options
+         */
+        TaskScheduler();
+
+        /**
+         * @brief       Starts the workers
+         * @param[in]   options: Size and placement of the workers
+         */
+        explicit TaskScheduler( const Options &options );
+
+        /**
+         * @brief       Runs the queued tasks and joins the workers
+         */
+        ~TaskScheduler() override;
+
+        TaskScheduler( const TaskScheduler & )            = delete;
+        TaskScheduler &operator=( const TaskScheduler & ) = delete;
+
+        void Execute( std::function<void()> task ) override;
+
+        [[nodiscard]] std::size_t GetConcurrency() const override
+        {
+            return workers.size();
+        }
+
+        /**
+         * @brief       Number of NUMA nodes the workers are spread over
+         */
+        [[nodiscard]] std::size_t GetNodeCount() const
+        {
+            return num_nodes;
+        }
+
+    private:
+        struct Worker
+        {
+            std::mutex                        mutex;   ///< Protects the deque, owner and thieves alike
+            std::deque<std::function<void()>> tasks;   ///< Back for the owner, front for the thieves
+            std::vector<std::size_t>          victims; ///< Workers to steal from, nearest first
+            std::size_t                       cpu;     ///< CPU assigned to the worker
+            std::size_t                       node;    ///< NUMA node of the CPU
+            std::thread                       thread;
+        };
+
+        /**
+         * @brief       Takes a task from the worker's own deque, or steals one
+         * @param[in]   index: Index of the worker
+         * @param[out]  task: Task found
+         * @return      true if a task was found
+         */
+        bool FindTask( std::size_t index, std::function<void()> &task );
+        void WorkerLoop( std::size_t index );
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::size_t                          num_nodes;  ///< Distinct nodes of the workers
+        std::atomic<std::size_t>             next_queue; ///< Round robin cursor of the external submissions
+        std::atomic<std::size_t>             pending;    ///< Queued tasks, counted under sleep_mutex before the push
+        std::mutex                           sleep_mutex;
+        std::condition_variable              wake;     ///< Signals the idle workers
+        bool                                 stopping; ///< Set by the destructor, under sleep_mutex
+    };
+
+    /**
+     * @brief       Executor of the library parallel paths
+     * @return      The executor set by @ref SetExecutor, or a @ref TaskScheduler with the default options
+     *              created on first use
+     */
+    std::shared_ptr<Executor> GetExecutor();
+
+    /**
+     * @brief       Replaces the executor of the library parallel paths
+     * @details     Pass a @ref TaskScheduler built with other options to resize or pin the pool, or an adapter
+     *              of the host thread pool so the library doesn't compete with it for the cores. Batches
+     *              already running finish on the executor they started on.
+     * @param[in]   executor: New executor, nullptr to go back to the default one
+     */
+    void SetExecutor( std::shared_ptr<Executor> executor );
+}
+
+#endif
@@ -0,0 +1,239 @@
+/**
+ * @file       TransactionBatchValidator.hpp
+ * @brief      Batch validation of the transaction commitment equations
+ * @date       2024-03-22
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _TRANSACTION_BATCH_VALIDATOR_HPP_
+#define _TRANSACTION_BATCH_VALIDATOR_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "ProofSystem/ECBatchOps.hpp"
+#include "ProofSystem/MultiScalarMul.hpp"
+#include "ProofSystem/SecureRandom.hpp"
+
+/**
+ * @brief       Outcome counters of @ref TransactionBatchValidator::Validate
+ */
+struct TransactionBatchStats
+{
+    std::size_t transactions;  ///< Transactions in the batch
+    std::size_t invalid;       ///< Transactions that failed
+    std::size_t batch_checks;  ///< Multi-scalar checks evaluated, including the bisection ones
+    std::size_t single_checks; ///< Transactions checked one by one
+    double      seconds;       ///< Time spent in Validate
+
+    double TransactionsPerSecond() const
+    {
+        return seconds > 0 ? static_cast<double>( transactions ) / seconds : 0.0;
+    }
+};
+
+/**
+ * @brief       Checks the commitments of many transactions with one multi-scalar multiplication
+ * @details     A transaction moving amount a out of balance b is valid when a <= b and
+ *
+ *                  C_b = b * G,    C_a = a * G,    C_n = ( b - a ) * G
+ *
+ *              and, for the MPC flavour, when the final aggregate of the nonces equals the total random
+ *              sum. These are the checks ValidateTransaction and MPCValidateTransaction make one
+ *              transaction at a time. With random 128 bit weights z the equations of all the
+ *              transactions are folded into
+ *
+ *                  sum ( z1 * C_b + z2 * C_a + z3 * C_n + z4 * ( F - T ) ) - ( sum z1 * b + z2 * a + z3 * ( b - a ) ) * G = 0
+ *
+ *              so G is multiplied once for the whole batch and the rest is a single Pippenger sum. A
+ *              failed batch is split in halves until the invalid transactions are isolated.
+ * @tparam      CurveType Curve of the commitments, pallas for the SGProofCircuits verifiers
+ */
+template <typename CurveType>
+class TransactionBatchValidator
+{
+public:
+    using affine_type       = typename CurveType::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type;
+    using jacobian_type     = typename CurveType::template g1_type<>::value_type;
+    using scalar_field_type = typename CurveType::scalar_field_type;
+    using scalar_type       = typename scalar_field_type::value_type;
+    using base_type         = typename CurveType::base_field_type::value_type;
+
+    static constexpr std::size_t SINGLE_CHECK_SIZE = 2; ///< Groups this small are not bisected any further
+
+    /**
+     * @brief       Nonce terms of an MPC transaction
+     */
+    struct MPCTerms_t
+    {
+        affine_type total_random_sum; ///< Sum of 2 * blocks * r_i * G over the nodes
+        affine_type final_aggregate;  ///< Sum of every Nonce A and Nonce B
+    };
+
+    /**
+     * @brief       One transaction to validate
+     */
+    struct Transaction_t
+    {
+        scalar_type               balance;                         ///< Balance before the transaction
+        scalar_type               amount;                          ///< Amount moved
+        affine_type               balance_commitment;              ///< Should be balance * G
+        affine_type               amount_commitment;               ///< Should be amount * G
+        affine_type               expected_new_balance_commitment; ///< Should be ( balance - amount ) * G
+        std::optional<MPCTerms_t> mpc;                             ///< Set for MPC transactions
+    };
+
+    /**
+     * @brief       Validates every transaction
+     * @param[in]   generator Commitment generator G, shared by the batch
+     * @param[in]   transactions Transactions to check
+     * @param[out]  stats Optional counters and throughput
+     * @param[in]   num_threads Threads of the multi-scalar multiplications, 0 uses the hardware concurrency
+     * @return      One flag per transaction, true if it is valid
+     */
+    static std::vector<bool> Validate( const affine_type &generator, const std::vector<Transaction_t> &transactions,
+                                       TransactionBatchStats *stats = nullptr, std::size_t num_threads = 1 )
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        TransactionBatchStats local_stats{ transactions.size(), 0, 0, 0, 0.0 };
+        std::vector<bool>     valid( transactions.size(), false );
+
+        // Overdrawn transactions fail without touching the curve
+        auto                   &rng = csprng::ThreadRng();
+        std::vector<Prepared_t> prepared;
+        for ( std::size_t i = 0; i < transactions.size(); ++i )
+        {
+            if ( static_cast<ecbatch::cpp_int>( transactions[i].amount.data ) > static_cast<ecbatch::cpp_int>( transactions[i].balance.data ) )
+            {
+                continue;
+            }
+            prepared.push_back( Prepared_t{ i, ecbatch::RandomWeight<scalar_field_type>( rng ), ecbatch::RandomWeight<scalar_field_type>( rng ),
+                                            ecbatch::RandomWeight<scalar_field_type>( rng ), ecbatch::RandomWeight<scalar_field_type>( rng ) } );
+        }
+
+        if ( !prepared.empty() )
+        {
+            const Context_t context{ transactions, prepared, ToJacobian( generator ), num_threads };
+            CheckRange( context, 0, prepared.size(), valid, local_stats );
+        }
+
+        for ( bool transaction_valid : valid )
+        {
+            local_stats.invalid += transaction_valid ? 0 : 1;
+        }
+        local_stats.seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+        if ( stats != nullptr )
+        {
+            *stats = local_stats;
+        }
+        return valid;
+    }
+
+private:
+    /**
+     * @brief       Batch path data of a transaction
+     */
+    struct Prepared_t
+    {
+        std::size_t index;          ///< Position in the transactions
+        scalar_type balance_weight; ///< z1
+        scalar_type amount_weight;  ///< z2
+        scalar_type new_weight;     ///< z3
+        scalar_type mpc_weight;     ///< z4, unused unless the transaction is MPC
+    };
+
+    /**
+     * @brief       Data shared by the bisection steps
+     */
+    struct Context_t
+    {
+        const std::vector<Transaction_t> &transactions;
+        const std::vector<Prepared_t>    &prepared;
+        jacobian_type                     generator;
+        std::size_t                       num_threads;
+    };
+
+    static jacobian_type ToJacobian( const affine_type &point )
+    {
+        return point.is_zero() ? jacobian_type::zero() : jacobian_type( point.X, point.Y, base_type::one() );
+    }
+
+    static bool CheckSingle( const Context_t &context, const Transaction_t &transaction )
+    {
+        const scalar_type new_balance = transaction.balance - transaction.amount;
+        if ( ToJacobian( transaction.balance_commitment ) != context.generator * transaction.balance ||
+             ToJacobian( transaction.amount_commitment ) != context.generator * transaction.amount ||
+             ToJacobian( transaction.expected_new_balance_commitment ) != context.generator * new_balance )
+        {
+            return false;
+        }
+        return !transaction.mpc || ToJacobian( transaction.mpc->final_aggregate ) == ToJacobian( transaction.mpc->total_random_sum );
+    }
+
+    static bool BatchEquationHolds( const Context_t &context, std::size_t begin, std::size_t end )
+    {
+        std::vector<jacobian_type> points;
+        std::vector<scalar_type>   scalars;
+        points.reserve( 5 * ( end - begin ) + 1 );
+        scalars.reserve( 5 * ( end - begin ) + 1 );
+
+        points.push_back( context.generator );
+        scalars.push_back( scalar_type::zero() );
+
+        for ( std::size_t i = begin; i < end; ++i )
+        {
+            const Prepared_t    &item        = context.prepared[i];
+            const Transaction_t &transaction = context.transactions[item.index];
+
+            scalars[0] = scalars[0] - item.balance_weight * transaction.balance - item.amount_weight * transaction.amount -
+                         item.new_weight * ( transaction.balance - transaction.amount );
+
+            points.push_back( ToJacobian( transaction.balance_commitment ) );
+            scalars.push_back( item.balance_weight );
+            points.push_back( ToJacobian( transaction.amount_commitment ) );
+            scalars.push_back( item.amount_weight );
+            points.push_back( ToJacobian( transaction.expected_new_balance_commitment ) );
+            scalars.push_back( item.new_weight );
+            if ( transaction.mpc )
+            {
+                points.push_back( ToJacobian( transaction.mpc->final_aggregate ) );
+                scalars.push_back( item.mpc_weight );
+                points.push_back( ToJacobian( transaction.mpc->total_random_sum ) );
+                scalars.push_back( -item.mpc_weight );
+            }
+        }
+        return msm::MultiScalarMul( points, scalars, context.num_threads ).is_zero();
+    }
+
+    static void CheckRange( const Context_t &context, std::size_t begin, std::size_t end, std::vector<bool> &valid,
+                            TransactionBatchStats &stats )
+    {
+        if ( end - begin <= SINGLE_CHECK_SIZE )
+        {
+            for ( std::size_t i = begin; i < end; ++i )
+            {
+                const std::size_t index = context.prepared[i].index;
+                valid[index]            = CheckSingle( context, context.transactions[index] );
+                ++stats.single_checks;
+            }
+            return;
+        }
+
+        ++stats.batch_checks;
+        if ( BatchEquationHolds( context, begin, end ) )
+        {
+            for ( std::size_t i = begin; i < end; ++i )
+            {
+                valid[context.prepared[i].index] = true;
+            }
+            return;
+        }
+        const std::size_t middle = begin + ( end - begin ) / 2;
+        CheckRange( context, begin, middle, valid, stats );
+        CheckRange( context, middle, end, valid, stats );
+    }
+};
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file       VanitySearch.hpp
+ * @brief      Search of keys whose address starts with a given pattern
+ * @date       2024-03-11
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#ifndef _VANITY_SEARCH_HPP_
+#define _VANITY_SEARCH_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "ProofSystem/ECDSATypes.hpp"
+
+namespace vanity
+{
+    using Address_t = std::array<std::uint8_t, 20>; ///< Binary address (Ethereum address or Bitcoin hash160)
+
+    /**
+     * @brief       Address format a pattern applies to
+     */
+    enum class AddressKind
+    {
+        ETHEREUM, ///< Keccak-256 of the uncompressed key
+        BITCOIN   ///< Main network base58check of the compressed key
+    };
+
+    /**
+     * @brief       Prefix to look for, checked on binary addresses
+     */
+    class AddressPattern
+    {
+    public:
+        /**
+         * @brief       Pattern over the hex digits of an Ethereum address
+         * @param[in]   hex_prefix Case insensitive hex digits, with or without the 0x header
+         * @return      Pattern that compares the address against a nibble mask
+         */
+        static AddressPattern EthereumPrefix( std::string_view hex_prefix );
+        /**
+         * @brief       Pattern over the text of a Bitcoin address
+         * @param[in]   base58_prefix Base58 prefix, starting with the main network '1'
+         * @return      Pattern that compares the hash160 against the ranges whose addresses start with the prefix
+         */
+        static AddressPattern BitcoinPrefix( std::string_view base58_prefix );
+
+        /**
+         * @brief       Checks a binary address
+         * @param[in]   address Ethereum address or Bitcoin hash160, depending on @ref GetKind
+         * @return      true if the text form of the address starts with the pattern
+         */
+        bool Matches( const Address_t &address ) const;
+
+        /**
+         * @brief       Returns the address format of the pattern
+         * @return      Ethereum or Bitcoin
+         */
+        AddressKind GetKind() const
+        {
+            return kind;
+        }
+        /**
+         * @brief       Returns the prefix as given by the user
+         * @return      Prefix text
+         */
+        const std::string &GetText() const
+        {
+            return text;
+        }
+
+    private:
+        AddressPattern( AddressKind kind, std::string text );
+
+        AddressKind                                  kind;        ///< Address format
+        std::string                                  text;        ///< Prefix as given by the user
+        Address_t                                    prefix_bits; ///< Ethereum: expected bits under the mask
+        Address_t                                    prefix_mask; ///< Ethereum: bits fixed by the prefix
+        std::vector<std::pair<Address_t, Address_t>> hash_ranges; ///< Bitcoin: inclusive big endian hash160 ranges
+    };
+
+    /**
+     * @brief       Snapshot of a running search
+     */
+    struct SearchProgress
+    {
+        std::uint64_t keys_checked; ///< Keys hashed and compared so far
+        double        seconds;      ///< Time since the search started
+
+        double KeysPerSecond() const
+        {
+            return seconds > 0 ? static_cast<double>( keys_checked ) / seconds : 0.0;
+        }
+    };
+
+    /**
+     * @brief       Tuning of @ref Search
+     */
+    struct SearchOptions
+    {
+        std::size_t                                 num_threads       = 0;    ///< Worker threads, 0 to use the hardware concurrency
+        std::size_t                                 batch_size        = 1024; ///< Consecutive keys per affine conversion and hash batch
+        std::uint64_t                               max_keys          = 0;    ///< Gives up after this many keys, 0 searches until found
+        std::chrono::milliseconds                   progress_interval = std::chrono::milliseconds( 1000 ); ///< Period of the callback
+        std::function<void( const SearchProgress & )> on_progress;             ///< Optional progress callback, called from the calling thread
+    };
+
+    /**
+     * @brief       Outcome of @ref Search, also usable as a throughput measurement
+     */
+    struct SearchResult
+    {
+        bool                             found;       ///< Whether a matching key was found
+        ecdsa_t::scalar_field_value_type private_key; ///< Matching private key, valid if found
+        std::string                      address;     ///< Matching address in text form, valid if found
+        SearchProgress                   stats;       ///< Keys checked and elapsed time
+    };
+
+    /**
+     * @brief       Searches a private key whose address starts with the pattern
+     * @param[in]   pattern Prefix to look for
+     * @param[in]   options Threads, batch size and limits
+     * @return      The first match found, or found == false once max_keys were checked
+     * @details     Every worker starts from a random key k and walks k + 1, k + 2, ... by adding G,
+     *              so each candidate costs a point addition instead of a scalar multiplication.
+     *              The points of a batch share one field inversion and are hashed in SIMD lanes.
+     */
+    SearchResult Search( const AddressPattern &pattern, const SearchOptions &options = SearchOptions() );
+}
+
+#endif
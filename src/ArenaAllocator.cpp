@@ -0,0 +1,59 @@
+/**
+ * @file       ArenaAllocator.cpp
+ * @brief      Per thread arena for the short lived multiprecision temporaries
+ * @date       2024-03-28
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include "ProofSystem/ArenaAllocator.hpp"
+
+#include <algorithm>
+
+namespace arena
+{
+    Arena &Arena::ThreadArena()
+    {
+        thread_local Arena thread_arena;
+        return thread_arena;
+    }
+
+    void *Arena::Allocate( std::size_t size )
+    {
+        size = ( size + ALIGNMENT - 1 ) & ~( ALIGNMENT - 1 );
+        ++stats.allocations;
+        stats.bytes += size;
+
+        if ( current_block < blocks.size() && blocks[current_block].size - offset >= size )
+        {
+            void *pointer = blocks[current_block].data.get() + offset;
+            offset += size;
+            return pointer;
+        }
+
+        // Move on to the next block that fits, growing the arena if none does
+        std::size_t next = blocks.empty() ? 0 : current_block + 1;
+        while ( next < blocks.size() && blocks[next].size < size )
+        {
+            ++next;
+        }
+        if ( next == blocks.size() )
+        {
+            const std::size_t block_size = std::max( BLOCK_SIZE, size );
+            blocks.push_back( Block_t{ std::make_unique<std::byte[]>( block_size ), block_size } );
+            ++stats.blocks;
+        }
+        current_block = next;
+        offset        = size;
+        return blocks[current_block].data.get();
+    }
+
+    void Arena::Deallocate( void *pointer, std::size_t size ) noexcept
+    {
+        size = ( size + ALIGNMENT - 1 ) & ~( ALIGNMENT - 1 );
+        // Only the last allocation can be handed back, the rest waits for the Scope
+        if ( current_block < blocks.size() && offset >= size && pointer == blocks[current_block].data.get() + offset - size )
+        {
+            offset -= size;
+        }
+    }
+}
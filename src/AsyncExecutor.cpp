@@ -0,0 +1,98 @@
+/**
+ * @file       AsyncExecutor.cpp
+ * @brief      Bounded worker pool running the expensive operations off the caller's thread
+ * @date       2024-03-31
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include "ProofSystem/AsyncExecutor.hpp"
+
+#include <algorithm>
+
+namespace async
+{
+    WorkerPool::WorkerPool( std::size_t num_threads, std::size_t queue_capacity ) :
+        capacity( std::max<std::size_t>( 1, queue_capacity ) ), //
+        stopping( false )
+    {
+        if ( num_threads == 0 )
+        {
+            num_threads = std::max<std::size_t>( 1, std::thread::hardware_concurrency() );
+        }
+        workers.reserve( num_threads );
+        for ( std::size_t i = 0; i < num_threads; ++i )
+        {
+            workers.emplace_back( &WorkerPool::WorkerLoop, this );
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            stopping = true;
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+        for ( auto &worker : workers )
+        {
+            worker.join();
+        }
+    }
+
+    WorkerPool &WorkerPool::Instance()
+    {
+        static WorkerPool instance;
+        return instance;
+    }
+
+    std::size_t WorkerPool::GetQueueSize() const
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        return queue.size();
+    }
+
+    bool WorkerPool::Enqueue( Job job, bool wait )
+    {
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            if ( wait )
+            {
+                not_full.wait( lock, [this]() { return stopping || queue.size() < capacity; } );
+            }
+            if ( stopping )
+            {
+                throw std::runtime_error( "Worker pool is shutting down" );
+            }
+            if ( queue.size() >= capacity )
+            {
+                return false;
+            }
+            queue.push_back( std::move( job ) );
+        }
+        not_empty.notify_one();
+        return true;
+    }
+
+    void WorkerPool::WorkerLoop()
+    {
+        while ( true )
+        {
+            std::optional<Job> job;
+            {
+                std::unique_lock<std::mutex> lock( mutex );
+                not_empty.wait( lock, [this]() { return stopping || !queue.empty(); } );
+                if ( queue.empty() )
+                {
+                    // Only reached when stopping, the queue is drained first
+                    return;
+                }
+                job.emplace( std::move( queue.front() ) );
+                queue.pop_front();
+            }
+            not_full.notify_one();
+            // Jobs catch everything themselves, the result goes to their future or awaiting coroutine
+            ( *job )();
+        }
+    }
+}
@@ -8,21 +8,84 @@
 
 #include "ProofSystem/BitcoinKeyGenerator.hpp"
 
-#include <nil/crypto3/hash/algorithm/hash.hpp>
-#include <nil/crypto3/hash/adaptor/hashed.hpp>
-#include <nil/crypto3/hash/ripemd.hpp>
+#include "ProofSystem/MultiLaneHash.hpp"
+#include "ProofSystem/ECBatchOps.hpp"
+#include "ProofSystem/ParallelFor.hpp"
+#include "ProofSystem/Metrics.hpp"
+#include "ProofSystem/SecureRandom.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
 #include <nil/crypto3/algebra/marshalling.hpp>
-#include <nil/crypto3/codec/algorithm/encode.hpp>
-#include <nil/crypto3/codec/base.hpp>
 
 using namespace nil::crypto3::algebra;
-using namespace nil::crypto3::hashes;
 using namespace nil::marshalling::bincode;
 
+namespace
+{
+    constexpr char          BASE58_ALPHABET[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+    constexpr std::uint32_t BASE58_POW5       = 58u * 58u * 58u * 58u * 58u; ///< Five base58 digits fit in one 32 bit limb
+
+    /**
+     * @brief       Base58 of a fixed size big endian buffer
+     * @tparam      SIZE Number of input bytes
+     * @param[in]   data Bytes to encode
+     * @return      Base58 text, one '1' per leading zero byte
+     * @note        Works on 32 bit limbs and peels 5 digits per long division instead of one per pass
+     */
+    template <std::size_t SIZE>
+    std::string EncodeBase58( const std::array<std::uint8_t, SIZE> &data )
+    {
+        constexpr std::size_t NUM_LIMBS  = ( SIZE + 3 ) / 4;
+        constexpr std::size_t MAX_DIGITS = ( SIZE * 138 / 100 ) + 1;
+        constexpr std::size_t NUM_ROUNDS = ( MAX_DIGITS + 4 ) / 5;
+
+        std::array<std::uint32_t, NUM_LIMBS> limbs{};
+        for ( std::size_t i = 0; i < SIZE; ++i )
+        {
+            const std::size_t bit_pos = ( SIZE - 1 - i ) * 8;
+            limbs[NUM_LIMBS - 1 - bit_pos / 32] |= static_cast<std::uint32_t>( data[i] ) << ( bit_pos % 32 );
+        }
+
+        std::array<char, NUM_ROUNDS * 5> digits{};
+        for ( std::size_t round = 0; round < NUM_ROUNDS; ++round )
+        {
+            std::uint64_t remainder = 0;
+            for ( auto &limb : limbs )
+            {
+                const std::uint64_t current = ( remainder << 32 ) | limb;
+                limb                        = static_cast<std::uint32_t>( current / BASE58_POW5 );
+                remainder                   = current % BASE58_POW5;
+            }
+            for ( std::size_t i = 0; i < 5; ++i )
+            {
+                digits[round * 5 + i] = static_cast<char>( remainder % 58 );
+                remainder            /= 58;
+            }
+        }
+
+        std::size_t num_digits = digits.size();
+        while ( num_digits != 0 && digits[num_digits - 1] == 0 )
+        {
+            --num_digits;
+        }
+        const std::size_t leading_zeros = static_cast<std::size_t>(
+            std::find_if( data.begin(), data.end(), []( std::uint8_t byte ) { return byte != 0; } ) - data.begin() );
+
+        std::string encoded( leading_zeros, BASE58_ALPHABET[0] );
+        encoded.reserve( leading_zeros + num_digits );
+        for ( std::size_t i = num_digits; i != 0; --i )
+        {
+            encoded.push_back( BASE58_ALPHABET[static_cast<std::size_t>( digits[i - 1] )] );
+        }
+        return encoded;
+    }
+}
+
 namespace bitcoin
 {
 
-    random_generator_type BitcoinKeyGenerator::key_gen;
 
     BitcoinKeyGenerator::BitcoinKeyGenerator()
     {
@@ -57,18 +120,21 @@ namespace bitcoin
 
     std::shared_ptr<pubkey::ext_private_key<policy_type>> BitcoinKeyGenerator::CreateKeys()
     {
-        return std::make_shared<pubkey::ext_private_key<policy_type>>( BitcoinKeyGenerator::key_gen() );
+        return std::make_shared<pubkey::ext_private_key<policy_type>>( csprng::RandomScalar<scalar_field_type>() );
     }
 
     template <>
     std::vector<std::uint8_t> BitcoinKeyGenerator::ExtractPubKeyFromField<std::vector<std::uint8_t>>( const pubkey::public_key<policy_type> &pub_key )
     {
+        // A single affine conversion, each one costs a field inversion
+        const auto affine = pub_key.pubkey_data().to_affine();
+
         std::vector<std::uint8_t> x_y_ser( ( base_field_type::number_bits / 8 ) * 2 );
 
-        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( pub_key.pubkey_data().to_affine().Y.data,
+        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( affine.Y.data,
                                                                                              x_y_ser.begin(), x_y_ser.begin() + x_y_ser.size() / 2 );
 
-        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( pub_key.pubkey_data().to_affine().X.data,
+        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( affine.X.data,
                                                                                              x_y_ser.begin() + x_y_ser.size() / 2, x_y_ser.end() );
 
         auto middle_pos = x_y_ser.begin() + x_y_ser.size() / 2;
@@ -80,12 +146,15 @@ namespace bitcoin
     BitcoinKeyGenerator::PubKeyPair_t
     BitcoinKeyGenerator::ExtractPubKeyFromField<BitcoinKeyGenerator::PubKeyPair_t>( const pubkey::public_key<policy_type> &pub_key )
     {
+        // A single affine conversion, each one costs a field inversion
+        const auto affine = pub_key.pubkey_data().to_affine();
+
         std::vector<std::uint8_t> x_ser( base_field_type::number_bits / 8 );
         std::vector<std::uint8_t> y_ser( base_field_type::number_bits / 8 );
 
-        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( pub_key.pubkey_data().to_affine().X.data, x_ser.begin(),
+        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( affine.X.data, x_ser.begin(),
                                                                                              x_ser.end() );
-        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( pub_key.pubkey_data().to_affine().Y.data, y_ser.begin(),
+        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( affine.Y.data, y_ser.begin(),
                                                                                              y_ser.end() );
 
         util::AdjustEndianess( x_ser );
@@ -96,28 +165,138 @@ namespace bitcoin
 
     std::string BitcoinKeyGenerator::DeriveAddress( const std::vector<std::uint8_t> &pub_key_vect )
     {
-        std::vector<std::uint8_t> work_vect( pub_key_vect );
-        work_vect.push_back(  ( pub_key_vect.front() % 2 ) == 0 ? PARITY_EVEN_ID : PARITY_ODD_ID );
+        CompressedPubKey_t compressed;
+        compressed[0] = ( pub_key_vect.front() % 2 ) == 0 ? PARITY_EVEN_ID : PARITY_ODD_ID;
+        std::copy( pub_key_vect.rbegin(), pub_key_vect.rend(), compressed.begin() + 1 );
 
-        std::array<uint8_t, 32> derivation_hash = hash<derivation_hash_type>( work_vect.rbegin(), work_vect.rend() );
-        std::array<uint8_t, 20> ripemd_hash     = hash<hashes::ripemd160>( derivation_hash );
+        Hash160_t hash160;
+        DeriveHash160s( &compressed, 1, &hash160 );
+        return EncodeAddress( hash160 );
+    }
 
-        work_vect = std::vector( ripemd_hash.cbegin(), ripemd_hash.cend() );
-        work_vect.insert( work_vect.begin(), MAIN_NETWORK_ID );
+    std::string BitcoinKeyGenerator::DeriveAddress( const std::vector<std::uint8_t> &x_vect, const std::vector<std::uint8_t> &y_vect )
+    {
+        if ( x_vect.size() != ECDSAPublicKey::COORDINATE_SIZE || y_vect.size() != ECDSAPublicKey::COORDINATE_SIZE )
+        {
+            throw std::runtime_error( "Public key coordinates must be 32 bytes each" );
+        }
+        CompressedPubKey_t compressed;
+        compressed[0] = ( y_vect.front() % 2 ) == 0 ? PARITY_EVEN_ID : PARITY_ODD_ID;
+        std::copy( x_vect.rbegin(), x_vect.rend(), compressed.begin() + 1 );
 
-        std::array<std::uint8_t, 32> checksum = hash<derivation_hash_type>( work_vect );
-        checksum                              = hash<derivation_hash_type>( checksum );
+        Hash160_t hash160;
+        DeriveHash160s( &compressed, 1, &hash160 );
+        return EncodeAddress( hash160 );
+    }
 
-        work_vect.insert( work_vect.end(), checksum.begin(), checksum.begin() + CHECKSUM_SIZE_BYTES );
+    std::vector<BitcoinKeyGenerator::Hash160_t> BitcoinKeyGenerator::DeriveHash160s( const std::vector<CompressedPubKey_t> &pub_keys )
+    {
+        std::vector<Hash160_t> hashes( pub_keys.size() );
+        DeriveHash160s( pub_keys.data(), pub_keys.size(), hashes.data() );
+        return hashes;
+    }
 
-        return encode<nil::crypto3::codec::base58>( work_vect );
+    void BitcoinKeyGenerator::DeriveHash160s( const CompressedPubKey_t *pub_keys, std::size_t count, Hash160_t *hashes )
+    {
+        static_assert( sizeof( CompressedPubKey_t ) == 33, "Public keys must be tightly packed" );
+        static_assert( sizeof( Hash160_t ) == hashing::RIPEMD160_DIGEST_SIZE, "Hashes must be tightly packed" );
+
+        PROOFSYSTEM_SCOPED_TIMER( "bitcoin_derive_address_seconds" );
+        PROOFSYSTEM_COUNTER_ADD( "bitcoin_addresses_derived", count );
+
+        std::vector<std::uint8_t> digests( std::min( count, BATCH_BLOCK_SIZE ) * hashing::SHA256_DIGEST_SIZE );
+        for ( std::size_t first = 0; first < count; first += BATCH_BLOCK_SIZE )
+        {
+            const std::size_t block_count = std::min( BATCH_BLOCK_SIZE, count - first );
+            hashing::Sha256Batch( pub_keys[first].data(), sizeof( CompressedPubKey_t ), block_count, digests.data() );
+            hashing::Ripemd160Batch( digests.data(), hashing::SHA256_DIGEST_SIZE, block_count, hashes[first].data() );
+        }
+    }
+
+    std::vector<std::string> BitcoinKeyGenerator::DeriveAddresses( const std::vector<CompressedPubKey_t> &pub_keys )
+    {
+        std::vector<std::string> addresses;
+        addresses.reserve( pub_keys.size() );
+        for ( const auto &hash160 : DeriveHash160s( pub_keys ) )
+        {
+            addresses.push_back( EncodeAddress( hash160 ) );
+        }
+        return addresses;
+    }
+
+    std::vector<BitcoinKeyGenerator::BatchEntry_t> BitcoinKeyGenerator::GenerateBatch( std::size_t count, std::size_t num_threads )
+    {
+        using affine_value_type = CurveType::template g1_type<curves::coordinates::affine>::value_type;
+
+        std::vector<BatchEntry_t> entries( count );
+        util::ParallelFor(
+            count,
+            [&entries]( std::size_t begin, std::size_t end )
+            {
+                std::vector<scalar_field_value_type> private_keys( BATCH_BLOCK_SIZE );
+                std::vector<affine_value_type>       public_keys( BATCH_BLOCK_SIZE );
+                std::vector<CompressedPubKey_t>      key_bytes( BATCH_BLOCK_SIZE );
+                std::vector<Hash160_t>               hashes( BATCH_BLOCK_SIZE );
+
+                for ( std::size_t first = begin; first < end; first += BATCH_BLOCK_SIZE )
+                {
+                    const std::size_t block_count = std::min( BATCH_BLOCK_SIZE, end - first );
+                    // Each worker draws its own keys from its thread generator
+                    for ( std::size_t i = 0; i < block_count; ++i )
+                    {
+                        private_keys[i]                = csprng::RandomScalar<scalar_field_type>();
+                        entries[first + i].private_key = private_keys[i];
+                    }
+                    ecbatch::GeneratorMulBatch<CurveType>( private_keys.data(), block_count, public_keys.data() );
+
+                    ECDSAPublicKey::Coordinate_t y_coord;
+                    for ( std::size_t i = 0; i < block_count; ++i )
+                    {
+                        ecbatch::FieldElementToBigEndian<base_field_type>( public_keys[i].X, key_bytes[i].data() + 1 );
+                        ecbatch::FieldElementToBigEndian<base_field_type>( public_keys[i].Y, y_coord.data() );
+                        key_bytes[i][0] = ( y_coord.back() % 2 ) == 0 ? PARITY_EVEN_ID : PARITY_ODD_ID;
+                    }
+                    DeriveHash160s( key_bytes.data(), block_count, hashes.data() );
+
+                    for ( std::size_t i = 0; i < block_count; ++i )
+                    {
+                        entries[first + i].public_key = key_bytes[i];
+                        entries[first + i].hash160    = hashes[i];
+                    }
+                }
+            },
+            num_threads );
+
+        return entries;
+    }
+
+    std::string BitcoinKeyGenerator::EncodeAddress( const Hash160_t &hash160 )
+    {
+        std::array<std::uint8_t, 1 + sizeof( Hash160_t ) + CHECKSUM_SIZE_BYTES> payload;
+        payload[0] = MAIN_NETWORK_ID;
+        std::copy( hash160.begin(), hash160.end(), payload.begin() + 1 );
+
+        std::array<std::uint8_t, hashing::SHA256_DIGEST_SIZE> first_hash;
+        std::array<std::uint8_t, hashing::SHA256_DIGEST_SIZE> checksum;
+        hashing::Sha256( payload.data(), 1 + sizeof( Hash160_t ), first_hash.data() );
+        hashing::Sha256( first_hash.data(), first_hash.size(), checksum.data() );
+        std::copy( checksum.begin(), checksum.begin() + CHECKSUM_SIZE_BYTES, payload.begin() + 1 + sizeof( Hash160_t ) );
+
+        return EncodeBase58( payload );
     }
 
     std::string BitcoinKeyGenerator::DeriveAddress( void )
     {
-        auto pubkey_data_pair = ExtractPubKeyFromField<PubKeyPair_t>( *pubkey );
+        const auto affine = pubkey->pubkey_data().to_affine();
+
+        ECDSAPublicKey::Coordinate_t x_coord;
+        ECDSAPublicKey::Coordinate_t y_coord;
+        ecbatch::FieldElementToBigEndian<base_field_type>( affine.X, x_coord.data() );
+        ecbatch::FieldElementToBigEndian<base_field_type>( affine.Y, y_coord.data() );
+        pubkey_info = std::make_shared<BitcoinECDSAPublicKey>( x_coord, y_coord );
 
-        pubkey_info = std::make_shared<BitcoinECDSAPublicKey>( std::get<0>(pubkey_data_pair), std::get<1>(pubkey_data_pair) );
-        return DeriveAddress( std::get<0>(pubkey_data_pair) );
+        Hash160_t hash160;
+        DeriveHash160s( &pubkey_info->GetCompressed(), 1, &hash160 );
+        return EncodeAddress( hash160 );
     }
 }
@@ -7,13 +7,51 @@
 
 #include <ProofSystem/ElGamalKeyGenerator.hpp>
 #include <ProofSystem/Crypto3Util.hpp>
+#include <ProofSystem/ParallelFor.hpp>
+#include <ProofSystem/Metrics.hpp>
+#include <ProofSystem/ArenaAllocator.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    constexpr uint8_t CHUNK_SENTINEL = 0x01; ///< Prepended to every block of the chunked mode
+
+    void WriteBigEndian( uint64_t value, uint8_t *out, std::size_t width )
+    {
+        for ( std::size_t i = width; i > 0; --i )
+        {
+            out[i - 1] = static_cast<uint8_t>( value & 0xFF );
+            value >>= 8;
+        }
+    }
+
+    uint64_t ReadBigEndian( const uint8_t *in, std::size_t width )
+    {
+        uint64_t value = 0;
+        for ( std::size_t i = 0; i < width; ++i )
+        {
+            value = ( value << 8 ) | in[i];
+        }
+        return value;
+    }
+
+    /**
+     * @brief       Number of blocks of a chunked plaintext, rounded up without overflowing on forged sizes
+     */
+    uint64_t GetChunkCount( uint64_t plaintext_size, std::size_t payload_size )
+    {
+        return plaintext_size / payload_size + ( plaintext_size % payload_size != 0 ? 1 : 0 );
+    }
+}
 
 using namespace KeyGenerator;
 
 ElGamal::ElGamal( const Params &params, cpp_int private_key_value ) :
     private_key( std::make_shared<PrivateKey>( params, std::move( private_key_value ) ) ), //
     public_key( std::make_shared<PublicKey>( *private_key ) ),
-    bsgs_instance( std::make_shared<PrimeNumbers::BabyStepGiantStep>( params.prime_number, params.generator ) )
+    bsgs_instance( std::make_shared<const PrimeNumbers::BabyStepGiantStep>( params.prime_number, params.generator ) )
 {
 }
 
@@ -28,19 +66,29 @@ ElGamal::CypherTextType ElGamal::EncryptData( PublicKey &pubkey, std::vector<uin
 
 ElGamal::CypherTextType ElGamal::EncryptData( PublicKey &pubkey, const cpp_int &data )
 {
+    PROOFSYSTEM_SCOPED_TIMER( "elgamal_encrypt_seconds" );
+    PROOFSYSTEM_COUNTER_ADD( "elgamal_modular_exponentiations", 2 );
+
     cpp_int random_value = PrimeNumbers::GetRandomNumber( pubkey.params.prime_number );
 
-    cpp_int a = powm( pubkey.params.generator, random_value, pubkey.params.prime_number );
-    cpp_int b = powm( pubkey.public_key_value, random_value, pubkey.params.prime_number );
+    // The exponentiation temporaries live in the thread arena, only the two results reach the heap
+    arena::Scope         scope;
+    const arena::cpp_int prime    = pubkey.params.prime_number;
+    const arena::cpp_int exponent = random_value;
 
-    b *= data;
-    b %= pubkey.params.prime_number;
+    arena::cpp_int a = powm( arena::cpp_int( pubkey.params.generator ), exponent, prime );
+    arena::cpp_int b = powm( arena::cpp_int( pubkey.public_key_value ), exponent, prime );
 
-    return std::make_pair( a, b );
+    b *= arena::cpp_int( data );
+    b %= prime;
+
+    return std::make_pair( cpp_int( a ), cpp_int( b ) );
 }
 
 ElGamal::CypherTextType ElGamal::EncryptDataAdditive( PublicKey &pubkey, const cpp_int &data )
 {
+    PROOFSYSTEM_COUNTER_ADD( "elgamal_modular_exponentiations", 1 );
+
     cpp_int data_to_encrypt = powm( pubkey.params.generator, data, pubkey.params.prime_number );
     return EncryptData( pubkey, data_to_encrypt );
 }
@@ -48,15 +96,21 @@ ElGamal::CypherTextType ElGamal::EncryptDataAdditive( PublicKey &pubkey, const c
 template <>
 cpp_int ElGamal::DecryptData( const PrivateKey &prvkey, const CypherTextType &encrypted_data )
 {
+    PROOFSYSTEM_SCOPED_TIMER( "elgamal_decrypt_seconds" );
+    PROOFSYSTEM_COUNTER_ADD( "elgamal_modular_exponentiations", 1 );
+
     auto pubkey = static_cast<const PublicKey &>( prvkey );
 
     cpp_int mod_inverse = PrimeNumbers::ModInverseEuclideanDivision( encrypted_data.first, pubkey.params.prime_number );
 
-    cpp_int m = powm( mod_inverse, prvkey.GetPrivateKeyScalar(), pubkey.params.prime_number );
-    m *= encrypted_data.second;
-    m %= pubkey.params.prime_number;
+    arena::Scope         scope;
+    const arena::cpp_int prime = pubkey.params.prime_number;
 
-    return m;
+    arena::cpp_int m = powm( arena::cpp_int( mod_inverse ), arena::cpp_int( prvkey.GetPrivateKeyScalar() ), prime );
+    m *= arena::cpp_int( encrypted_data.second );
+    m %= prime;
+
+    return cpp_int( m );
 }
 
 template <>
@@ -68,17 +122,213 @@ std::vector<uint8_t> ElGamal::DecryptData( const PrivateKey &prvkey, const Cyphe
     return retval;
 }
 
-cpp_int ElGamal::DecryptDataAdditive( const CypherTextType &encrypted_data )
+cpp_int ElGamal::DecryptDataAdditive( const CypherTextType &encrypted_data ) const
 {
     return DecryptDataAdditive( *this->private_key, encrypted_data, *this->bsgs_instance );
 }
 
-cpp_int ElGamal::DecryptDataAdditive( const PrivateKey &prvkey, const CypherTextType &encrypted_data, PrimeNumbers::BabyStepGiantStep &bsgs )
+cpp_int ElGamal::DecryptDataAdditive( const PrivateKey &prvkey, const CypherTextType &encrypted_data, const PrimeNumbers::BabyStepGiantStep &bsgs )
 {
     auto m = DecryptData<cpp_int>( prvkey, encrypted_data );
     return bsgs.SolveECDLP( m );
 }
 
+std::size_t ElGamal::GetElementSize( const Params &params )
+{
+    return ( msb( params.prime_number ) + 8 ) / 8;
+}
+
+std::size_t ElGamal::GetChunkPayloadSize( const Params &params )
+{
+    // sentinel + payload must stay strictly below the prime
+    const std::size_t full_bytes = msb( params.prime_number ) / 8;
+    if ( full_bytes < 2 )
+    {
+        throw std::runtime_error( "Prime too small for chunked encryption" );
+    }
+    return full_bytes - 1;
+}
+
+std::vector<uint8_t> ElGamal::EncryptDataChunked( const PublicKey &pubkey, const std::vector<uint8_t> &data_vector, std::size_t num_threads )
+{
+    const auto        &params       = pubkey.params;
+    const std::size_t  element_size = GetElementSize( params );
+    const std::size_t  payload_size = GetChunkPayloadSize( params );
+    const std::size_t  record_size  = 2 * element_size;
+    const std::size_t  num_blocks   = ( data_vector.size() + payload_size - 1 ) / payload_size;
+    const std::size_t  exp_bits     = msb( params.prime_number ) + 1;
+
+    std::vector<uint8_t> retval( CHUNK_HEADER_SIZE + num_blocks * record_size );
+    WriteBigEndian( data_vector.size(), retval.data(), 8 );
+    WriteBigEndian( element_size, retval.data() + 8, 4 );
+
+    if ( num_blocks == 0 )
+    {
+        return retval;
+    }
+
+    const PrimeNumbers::FixedBaseExponentiation generator_table( params.generator, params.prime_number, exp_bits );
+    const PrimeNumbers::FixedBaseExponentiation pubkey_table( pubkey.public_key_value, params.prime_number, exp_bits );
+
+    util::ParallelFor(
+        num_blocks,
+        [&]( std::size_t begin, std::size_t end )
+        {
+            std::vector<uint8_t> block( payload_size + 1 );
+            for ( std::size_t i = begin; i < end; ++i )
+            {
+                const std::size_t offset = i * payload_size;
+                const std::size_t length = std::min( payload_size, data_vector.size() - offset );
+
+                block.resize( length + 1 );
+                block[0] = CHUNK_SENTINEL;
+                std::copy_n( data_vector.begin() + offset, length, block.begin() + 1 );
+
+                cpp_int message      = Crypto3Util::BytesToCppInt( block );
+                cpp_int random_value = PrimeNumbers::GetRandomNumber( params.prime_number );
+
+                cpp_int a = generator_table.Pow( random_value );
+                cpp_int b = ( pubkey_table.Pow( random_value ) * message ) % params.prime_number;
+
+                uint8_t *record = retval.data() + CHUNK_HEADER_SIZE + i * record_size;
+                Crypto3Util::CppIntToFixedBytes( a, record, element_size );
+                Crypto3Util::CppIntToFixedBytes( b, record + element_size, element_size );
+            }
+        },
+        num_threads );
+
+    return retval;
+}
+
+std::vector<uint8_t> ElGamal::DecryptDataChunked( const PrivateKey &prvkey, const std::vector<uint8_t> &chunked_data, std::size_t num_threads )
+{
+    if ( chunked_data.size() < CHUNK_HEADER_SIZE )
+    {
+        throw std::runtime_error( "Chunked stream too short" );
+    }
+    const uint64_t    plaintext_size = ReadBigEndian( chunked_data.data(), 8 );
+    const std::size_t element_size   = ReadBigEndian( chunked_data.data() + 8, 4 );
+    const std::size_t payload_size   = GetChunkPayloadSize( prvkey.params );
+    const std::size_t record_size    = 2 * element_size;
+
+    if ( element_size != GetElementSize( prvkey.params ) )
+    {
+        throw std::runtime_error( "Chunked stream element size doesn't match the key" );
+    }
+    // The header is untrusted, the block count is checked against the input by division so it can't overflow
+    const uint64_t    num_blocks = GetChunkCount( plaintext_size, payload_size );
+    const std::size_t body_size  = chunked_data.size() - CHUNK_HEADER_SIZE;
+    if ( body_size % record_size != 0 || body_size / record_size != num_blocks )
+    {
+        throw std::runtime_error( "Chunked stream size doesn't match its header" );
+    }
+
+    std::vector<uint8_t> retval( plaintext_size );
+    util::ParallelFor(
+        static_cast<std::size_t>( num_blocks ),
+        [&]( std::size_t begin, std::size_t end )
+        {
+            for ( std::size_t i = begin; i < end; ++i )
+            {
+                const std::size_t offset = i * payload_size;
+                DecryptChunk( prvkey, chunked_data.data() + CHUNK_HEADER_SIZE + i * record_size, element_size, retval.data() + offset,
+                              std::min<std::size_t>( payload_size, plaintext_size - offset ) );
+            }
+        },
+        num_threads );
+
+    return retval;
+}
+
+void ElGamal::DecryptChunk( const PrivateKey &prvkey, const uint8_t *record, std::size_t element_size, uint8_t *out, std::size_t payload_size )
+{
+    CypherTextType cypher( Crypto3Util::FixedBytesToCppInt( record, element_size ),
+                           Crypto3Util::FixedBytesToCppInt( record + element_size, element_size ) );
+
+    cpp_int message = DecryptData<cpp_int>( prvkey, cypher );
+
+    std::vector<uint8_t> block( payload_size + 1 );
+    try
+    {
+        Crypto3Util::CppIntToFixedBytes( message, block.data(), block.size() );
+    }
+    catch ( const std::out_of_range & )
+    {
+        throw std::runtime_error( "Corrupted chunk" );
+    }
+    if ( block[0] != CHUNK_SENTINEL )
+    {
+        throw std::runtime_error( "Corrupted chunk" );
+    }
+    std::copy( block.begin() + 1, block.end(), out );
+}
+
+ElGamal::ChunkedDecryptor::ChunkedDecryptor( const PrivateKey &prvkey ) :
+    private_key( prvkey ),       //
+    header_parsed( false ),      //
+    plaintext_size( 0 ),         //
+    plaintext_done( 0 ),         //
+    element_size( GetElementSize( prvkey.params ) ),
+    payload_size( GetChunkPayloadSize( prvkey.params ) )
+{
+}
+
+std::vector<uint8_t> ElGamal::ChunkedDecryptor::Update( const uint8_t *data, std::size_t size )
+{
+    std::vector<uint8_t> retval;
+    const std::size_t    record_size = 2 * element_size;
+
+    pending.insert( pending.end(), data, data + size );
+    std::size_t consumed = 0;
+
+    if ( !header_parsed )
+    {
+        if ( pending.size() < CHUNK_HEADER_SIZE )
+        {
+            return retval;
+        }
+        plaintext_size = ReadBigEndian( pending.data(), 8 );
+        if ( ReadBigEndian( pending.data() + 8, 4 ) != element_size )
+        {
+            throw std::runtime_error( "Chunked stream element size doesn't match the key" );
+        }
+        if ( GetChunkCount( plaintext_size, payload_size ) > std::numeric_limits<uint64_t>::max() / record_size )
+        {
+            throw std::runtime_error( "Chunked stream header announces an impossible size" );
+        }
+        header_parsed = true;
+        consumed      = CHUNK_HEADER_SIZE;
+    }
+
+    while ( pending.size() - consumed >= record_size )
+    {
+        if ( IsFinished() )
+        {
+            throw std::runtime_error( "Chunked stream longer than announced" );
+        }
+        const std::size_t length = std::min<uint64_t>( payload_size, plaintext_size - plaintext_done );
+        const std::size_t offset = retval.size();
+
+        retval.resize( offset + length );
+        DecryptChunk( private_key, pending.data() + consumed, element_size, retval.data() + offset, length );
+
+        plaintext_done += length;
+        consumed += record_size;
+    }
+    if ( IsFinished() && pending.size() != consumed )
+    {
+        throw std::runtime_error( "Chunked stream longer than announced" );
+    }
+    pending.erase( pending.begin(), pending.begin() + consumed );
+
+    return retval;
+}
+
+bool ElGamal::ChunkedDecryptor::IsFinished() const
+{
+    return header_parsed && plaintext_done == plaintext_size;
+}
+
 ElGamal::Params ElGamal::CreateGeneratorParams()
 {
     cpp_int prime_number = 0;
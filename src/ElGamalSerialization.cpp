@@ -0,0 +1,311 @@
+/**
+ * @file       ElGamalSerialization.cpp
+ * @brief      Binary format of the ElGamal parameters, keys and ciphertexts
+ * @date       2024-03-29
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include <ProofSystem/ElGamalSerialization.hpp>
+#include <ProofSystem/Crypto3Util.hpp>
+#include <ProofSystem/ParallelFor.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    constexpr std::size_t RECORDS_PER_WRITE = 4096; ///< Ciphertexts encoded between two writes of @ref WriteCypherTextFile
+
+    void WriteLittleEndian( uint64_t value, uint8_t *out, std::size_t width )
+    {
+        for ( std::size_t i = 0; i < width; ++i )
+        {
+            out[i] = static_cast<uint8_t>( value & 0xFF );
+            value >>= 8;
+        }
+    }
+
+    uint64_t ReadLittleEndian( const uint8_t *in, std::size_t width )
+    {
+        uint64_t value = 0;
+        for ( std::size_t i = width; i > 0; --i )
+        {
+            value = ( value << 8 ) | in[i - 1];
+        }
+        return value;
+    }
+}
+
+namespace KeyGenerator
+{
+    namespace serialization
+    {
+        namespace
+        {
+            /**
+             * @brief       Number of elements of a single record object, ciphertext arrays have 2 per record on top
+             */
+            std::size_t GetFixedElements( Kind kind )
+            {
+                switch ( kind )
+                {
+                    case Kind::PARAMS:
+                    case Kind::CYPHER_TEXT:
+                        return 2;
+                    case Kind::PUBLIC_KEY:
+                    case Kind::PRIVATE_KEY:
+                        return 3;
+                }
+                throw std::runtime_error( "Unknown serialized kind" );
+            }
+
+            /**
+             * @brief       Allocates a buffer with the header and the parameters already written
+             */
+            std::vector<uint8_t> StartObject( Kind kind, const ElGamal::Params &params, std::size_t elements, uint64_t count )
+            {
+                const std::size_t    element_width = GetElementWidth( params );
+                std::vector<uint8_t> retval( HEADER_SIZE + elements * element_width );
+
+                WriteHeader( kind, element_width, count, retval.data() );
+                Crypto3Util::CppIntToFixedBytesLE( params.prime_number, retval.data() + HEADER_SIZE, element_width );
+                Crypto3Util::CppIntToFixedBytesLE( params.generator, retval.data() + HEADER_SIZE + element_width, element_width );
+                return retval;
+            }
+
+            /**
+             * @brief       Reads the element at @p index, counted from the end of the header
+             */
+            cpp_int ReadElement( const uint8_t *data, const Header &header, std::size_t index )
+            {
+                return Crypto3Util::FixedBytesLEToCppInt( data + HEADER_SIZE + index * header.element_width, header.element_width );
+            }
+
+            ElGamal::Params ReadParams( const uint8_t *data, const Header &header )
+            {
+                ElGamal::Params params( ReadElement( data, header, 0 ), ReadElement( data, header, 1 ) );
+                if ( params.prime_number < 3 || params.generator < 2 || params.generator >= params.prime_number )
+                {
+                    throw std::runtime_error( "Serialized ElGamal parameters are invalid" );
+                }
+                if ( GetElementWidth( params ) != header.element_width )
+                {
+                    throw std::runtime_error( "Serialized element width doesn't match the prime" );
+                }
+                return params;
+            }
+
+            void WriteCypherText( const ElGamal::CypherTextType &cypher_text, std::size_t element_width, uint8_t *out )
+            {
+                Crypto3Util::CppIntToFixedBytesLE( cypher_text.first, out, element_width );
+                Crypto3Util::CppIntToFixedBytesLE( cypher_text.second, out + element_width, element_width );
+            }
+
+            ElGamal::CypherTextType ReadCypherText( const uint8_t *record, std::size_t element_width )
+            {
+                return std::make_pair( Crypto3Util::FixedBytesLEToCppInt( record, element_width ),
+                                       Crypto3Util::FixedBytesLEToCppInt( record + element_width, element_width ) );
+            }
+        }
+
+        std::size_t GetElementWidth( const ElGamal::Params &params )
+        {
+            return ( ( msb( params.prime_number ) + 64 ) / 64 ) * 8;
+        }
+
+        void WriteHeader( Kind kind, std::size_t element_width, std::uint64_t count, std::uint8_t *out )
+        {
+            std::copy( std::begin( MAGIC ), std::end( MAGIC ), out );
+            WriteLittleEndian( FORMAT_VERSION, out + 4, 2 );
+            WriteLittleEndian( static_cast<uint16_t>( kind ), out + 6, 2 );
+            WriteLittleEndian( element_width, out + 8, 4 );
+            WriteLittleEndian( 0, out + 12, 4 );
+            WriteLittleEndian( count, out + 16, 8 );
+        }
+
+        Header PeekHeader( const std::uint8_t *data, std::size_t size, Kind kind )
+        {
+            if ( size < HEADER_SIZE || !std::equal( std::begin( MAGIC ), std::end( MAGIC ), data ) )
+            {
+                throw std::runtime_error( "Not a serialized ElGamal object" );
+            }
+            Header header;
+            header.version       = static_cast<uint16_t>( ReadLittleEndian( data + 4, 2 ) );
+            header.kind          = static_cast<Kind>( ReadLittleEndian( data + 6, 2 ) );
+            header.element_width = static_cast<uint32_t>( ReadLittleEndian( data + 8, 4 ) );
+            header.count         = ReadLittleEndian( data + 16, 8 );
+
+            if ( header.version == 0 || header.version > FORMAT_VERSION )
+            {
+                throw std::runtime_error( "Unsupported serialization version" );
+            }
+            if ( header.kind != kind )
+            {
+                throw std::runtime_error( "Unexpected serialized kind" );
+            }
+            if ( header.element_width == 0 || header.element_width % 8 != 0 )
+            {
+                throw std::runtime_error( "Invalid serialized element width" );
+            }
+            return header;
+        }
+
+        Header ReadHeader( const std::uint8_t *data, std::size_t size, Kind kind )
+        {
+            const Header      header     = PeekHeader( data, size, kind );
+            const std::size_t fixed_size = GetFixedElements( kind ) * header.element_width;
+            if ( size - HEADER_SIZE < fixed_size )
+            {
+                throw std::runtime_error( "Serialized object is truncated" );
+            }
+            const std::size_t record_size = 2 * header.element_width;
+            const std::size_t max_records = kind == Kind::CYPHER_TEXT ? ( size - HEADER_SIZE - fixed_size ) / record_size : 1;
+            const std::size_t records     = kind == Kind::CYPHER_TEXT ? static_cast<std::size_t>( header.count ) : 0;
+            if ( header.count > max_records || ( kind != Kind::CYPHER_TEXT && header.count != 1 ) ||
+                 size != HEADER_SIZE + fixed_size + records * record_size )
+            {
+                throw std::runtime_error( "Serialized object size doesn't match its header" );
+            }
+            return header;
+        }
+
+        std::vector<std::uint8_t> SerializeParams( const ElGamal::Params &params )
+        {
+            return StartObject( Kind::PARAMS, params, 2, 1 );
+        }
+
+        std::vector<std::uint8_t> SerializePublicKey( const ElGamal::PublicKey &pubkey )
+        {
+            auto              retval        = StartObject( Kind::PUBLIC_KEY, pubkey.params, 3, 1 );
+            const std::size_t element_width = GetElementWidth( pubkey.params );
+            Crypto3Util::CppIntToFixedBytesLE( pubkey.public_key_value, retval.data() + HEADER_SIZE + 2 * element_width, element_width );
+            return retval;
+        }
+
+        std::vector<std::uint8_t> SerializePrivateKey( const ElGamal::PrivateKey &prvkey )
+        {
+            auto              retval        = StartObject( Kind::PRIVATE_KEY, prvkey.params, 3, 1 );
+            const std::size_t element_width = GetElementWidth( prvkey.params );
+            Crypto3Util::CppIntToFixedBytesLE( prvkey.GetPrivateKeyScalar(), retval.data() + HEADER_SIZE + 2 * element_width, element_width );
+            return retval;
+        }
+
+        std::vector<std::uint8_t> SerializeCypherTexts( const ElGamal::Params &params, const std::vector<ElGamal::CypherTextType> &cypher_texts )
+        {
+            auto              retval        = StartObject( Kind::CYPHER_TEXT, params, 2 + 2 * cypher_texts.size(), cypher_texts.size() );
+            const std::size_t element_width = GetElementWidth( params );
+            for ( std::size_t i = 0; i < cypher_texts.size(); ++i )
+            {
+                WriteCypherText( cypher_texts[i], element_width, retval.data() + HEADER_SIZE + ( 2 + 2 * i ) * element_width );
+            }
+            return retval;
+        }
+
+        ElGamal::Params DeserializeParams( const std::vector<std::uint8_t> &data )
+        {
+            const Header header = ReadHeader( data.data(), data.size(), Kind::PARAMS );
+            return ReadParams( data.data(), header );
+        }
+
+        ElGamal::PublicKey DeserializePublicKey( const std::vector<std::uint8_t> &data )
+        {
+            const Header    header = ReadHeader( data.data(), data.size(), Kind::PUBLIC_KEY );
+            ElGamal::Params params = ReadParams( data.data(), header );
+            cpp_int         value  = ReadElement( data.data(), header, 2 );
+            if ( value == 0 || value >= params.prime_number )
+            {
+                throw std::runtime_error( "Serialized public key is out of range" );
+            }
+            return ElGamal::PublicKey( std::move( params ), std::move( value ) );
+        }
+
+        ElGamal::PrivateKey DeserializePrivateKey( const std::vector<std::uint8_t> &data )
+        {
+            const Header    header = ReadHeader( data.data(), data.size(), Kind::PRIVATE_KEY );
+            ElGamal::Params params = ReadParams( data.data(), header );
+            cpp_int         scalar = ReadElement( data.data(), header, 2 );
+            if ( scalar == 0 || scalar >= params.prime_number )
+            {
+                throw std::runtime_error( "Serialized private key is out of range" );
+            }
+            return ElGamal::PrivateKey( params, std::move( scalar ) );
+        }
+
+        std::vector<ElGamal::CypherTextType> DeserializeCypherTexts( const std::vector<std::uint8_t> &data )
+        {
+            const Header header = ReadHeader( data.data(), data.size(), Kind::CYPHER_TEXT );
+            ReadParams( data.data(), header );
+
+            std::vector<ElGamal::CypherTextType> retval;
+            retval.reserve( static_cast<std::size_t>( header.count ) );
+            for ( std::size_t i = 0; i < header.count; ++i )
+            {
+                retval.push_back( ReadCypherText( data.data() + HEADER_SIZE + ( 2 + 2 * i ) * header.element_width, header.element_width ) );
+            }
+            return retval;
+        }
+
+        void WriteCypherTextFile( const std::string &path, const ElGamal::Params &params, const std::vector<ElGamal::CypherTextType> &cypher_texts )
+        {
+            std::ofstream file( path, std::ios::binary | std::ios::trunc );
+            if ( !file )
+            {
+                throw std::runtime_error( "Can't open " + path + " for writing" );
+            }
+            const std::size_t element_width = GetElementWidth( params );
+            const std::size_t record_size   = 2 * element_width;
+
+            const auto prologue = StartObject( Kind::CYPHER_TEXT, params, 2, cypher_texts.size() );
+            file.write( reinterpret_cast<const char *>( prologue.data() ), static_cast<std::streamsize>( prologue.size() ) );
+
+            // Encoded in slices, the file never needs a second full copy of the array in memory
+            std::vector<uint8_t> buffer( std::min( cypher_texts.size(), RECORDS_PER_WRITE ) * record_size );
+            for ( std::size_t begin = 0; begin < cypher_texts.size(); begin += RECORDS_PER_WRITE )
+            {
+                const std::size_t end = std::min( cypher_texts.size(), begin + RECORDS_PER_WRITE );
+                for ( std::size_t i = begin; i < end; ++i )
+                {
+                    WriteCypherText( cypher_texts[i], element_width, buffer.data() + ( i - begin ) * record_size );
+                }
+                file.write( reinterpret_cast<const char *>( buffer.data() ), static_cast<std::streamsize>( ( end - begin ) * record_size ) );
+            }
+            if ( !file.flush() )
+            {
+                throw std::runtime_error( "Failed to write " + path );
+            }
+        }
+
+        MappedCypherTexts::MappedCypherTexts( const std::string &path ) : file( path, util::MappedFile::Mode::READ_ONLY )
+        {
+            header = ReadHeader( file.Data(), file.Size(), Kind::CYPHER_TEXT );
+            ReadParams( file.Data(), header );
+        }
+
+        ElGamal::Params MappedCypherTexts::GetParams() const
+        {
+            return ReadParams( file.Data(), header );
+        }
+
+        ElGamal::CypherTextType MappedCypherTexts::operator[]( std::size_t index ) const
+        {
+            return ReadCypherText( GetRecord( index ), header.element_width );
+        }
+
+        std::vector<ElGamal::CypherTextType> MappedCypherTexts::ReadAll( std::size_t num_threads ) const
+        {
+            std::vector<ElGamal::CypherTextType> retval( Size() );
+            util::ParallelFor(
+                retval.size(),
+                [&]( std::size_t begin, std::size_t end )
+                {
+                    for ( std::size_t i = begin; i < end; ++i )
+                    {
+                        retval[i] = ( *this )[i];
+                    }
+                },
+                num_threads );
+            return retval;
+        }
+    }
+}
@@ -0,0 +1,299 @@
+/**
+ * @file       EncryptedBalanceStore.cpp
+ * @brief      Memory mapped store of additive ElGamal encrypted balances
+ * @date       2024-03-30
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include <ProofSystem/EncryptedBalanceStore.hpp>
+#include <ProofSystem/Crypto3Util.hpp>
+#include <ProofSystem/ParallelFor.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+
+namespace
+{
+    constexpr uint8_t     JOURNAL_MAGIC[4]          = { 'B', 'J', 'N', 'L' };
+    constexpr std::size_t JOURNAL_ENTRY_HEADER_SIZE = 24; ///< Magic, 4 reserved bytes, record count and checksum
+    constexpr std::size_t ACCOUNT_ID_SIZE           = 8;  ///< Account id in front of every journal record
+
+    void WriteLittleEndian( uint64_t value, uint8_t *out, std::size_t width )
+    {
+        for ( std::size_t i = 0; i < width; ++i )
+        {
+            out[i] = static_cast<uint8_t>( value & 0xFF );
+            value >>= 8;
+        }
+    }
+
+    uint64_t ReadLittleEndian( const uint8_t *in, std::size_t width )
+    {
+        uint64_t value = 0;
+        for ( std::size_t i = width; i > 0; --i )
+        {
+            value = ( value << 8 ) | in[i - 1];
+        }
+        return value;
+    }
+
+    /**
+     * @brief       FNV-1a of the journal records, catches entries torn by a crash
+     */
+    uint64_t Checksum( const uint8_t *data, std::size_t size )
+    {
+        uint64_t hash = 0xcbf29ce484222325;
+        for ( std::size_t i = 0; i < size; ++i )
+        {
+            hash = ( hash ^ data[i] ) * 0x100000001b3;
+        }
+        return hash;
+    }
+}
+
+using namespace KeyGenerator;
+
+EncryptedBalanceStore::EncryptedBalanceStore( const std::string &path, ElGamal::Params store_params ) :
+    params( std::move( store_params ) ),                        //
+    element_width( serialization::GetElementWidth( params ) ),  //
+    num_accounts( 0 ),                                          //
+    balances( path, util::MappedFile::Mode::READ_WRITE ),       //
+    journal( path + JOURNAL_SUFFIX )
+{
+    // An empty array carries the header and the parameters, the file starts with the same bytes
+    const auto prologue = serialization::SerializeCypherTexts( params, {} );
+    if ( balances.Size() == 0 )
+    {
+        balances.Resize( prologue.size() );
+        std::copy( prologue.begin(), prologue.end(), balances.Data() );
+        balances.Flush();
+    }
+
+    const auto header = serialization::PeekHeader( balances.Data(), balances.Size(), serialization::Kind::CYPHER_TEXT );
+    if ( header.element_width != element_width || balances.Size() < prologue.size() ||
+         !std::equal( prologue.begin() + serialization::HEADER_SIZE, prologue.end(), balances.Data() + serialization::HEADER_SIZE ) )
+    {
+        throw std::runtime_error( "Balance file was created with other parameters" );
+    }
+    const std::size_t record_size = 2 * element_width;
+    if ( header.count > ( balances.Size() - prologue.size() ) / record_size )
+    {
+        throw std::runtime_error( "Balance file is truncated" );
+    }
+    num_accounts = static_cast<std::size_t>( header.count );
+
+    // A Resize interrupted before the new count was written leaves records past the end
+    const std::size_t expected_size = prologue.size() + num_accounts * record_size;
+    if ( balances.Size() != expected_size )
+    {
+        balances.Resize( expected_size );
+    }
+
+    ReplayJournal();
+    CheckpointLocked();
+}
+
+EncryptedBalanceStore::~EncryptedBalanceStore()
+{
+    try
+    {
+        CheckpointLocked();
+    }
+    catch ( ... )
+    {
+        // The journal is still there, the next open replays it
+    }
+}
+
+std::size_t EncryptedBalanceStore::Size() const
+{
+    std::shared_lock lock( mutex );
+    return num_accounts;
+}
+
+void EncryptedBalanceStore::Resize( std::size_t new_num_accounts )
+{
+    std::unique_lock lock( mutex );
+    if ( new_num_accounts < num_accounts )
+    {
+        throw std::runtime_error( "Balance store can't shrink" );
+    }
+    if ( new_num_accounts == num_accounts )
+    {
+        return;
+    }
+    // Journal entries must never refer to records the file header doesn't count yet
+    CheckpointLocked();
+
+    balances.Resize( serialization::HEADER_SIZE + ( 2 + 2 * new_num_accounts ) * element_width );
+    for ( std::size_t account = num_accounts; account < new_num_accounts; ++account )
+    {
+        // Grown bytes are zero, so a little endian 1 is a single byte
+        uint8_t *record       = GetRecord( account );
+        record[0]             = 1;
+        record[element_width] = 1;
+    }
+    balances.Flush();
+
+    // The count is written last, a crash before this point leaves the file as it was
+    serialization::WriteHeader( serialization::Kind::CYPHER_TEXT, element_width, new_num_accounts, balances.Data() );
+    balances.Flush();
+    num_accounts = new_num_accounts;
+}
+
+ElGamal::CypherTextType EncryptedBalanceStore::GetBalance( AccountId account ) const
+{
+    std::shared_lock lock( mutex );
+    if ( account >= num_accounts )
+    {
+        throw std::out_of_range( "Unknown account" );
+    }
+    const uint8_t *record = GetRecord( account );
+    return std::make_pair( Crypto3Util::FixedBytesLEToCppInt( record, element_width ),
+                           Crypto3Util::FixedBytesLEToCppInt( record + element_width, element_width ) );
+}
+
+void EncryptedBalanceStore::ApplyDeltas( const std::vector<Delta> &deltas, std::size_t num_threads )
+{
+    std::unique_lock lock( mutex );
+    for ( const auto &delta : deltas )
+    {
+        if ( delta.account >= num_accounts )
+        {
+            throw std::out_of_range( "Unknown account" );
+        }
+        if ( delta.amount.first <= 0 || delta.amount.first >= params.prime_number || delta.amount.second <= 0 ||
+             delta.amount.second >= params.prime_number )
+        {
+            throw std::runtime_error( "Encrypted amount out of range" );
+        }
+    }
+    if ( deltas.empty() )
+    {
+        return;
+    }
+
+    // Deltas of the same account end up next to each other, each group is folded by a single worker
+    std::vector<std::size_t> order( deltas.size() );
+    std::iota( order.begin(), order.end(), 0 );
+    std::stable_sort( order.begin(), order.end(), [&deltas]( std::size_t lhs, std::size_t rhs ) { return deltas[lhs].account < deltas[rhs].account; } );
+
+    std::vector<std::size_t> group_begin;
+    for ( std::size_t i = 0; i < order.size(); ++i )
+    {
+        if ( i == 0 || deltas[order[i]].account != deltas[order[i - 1]].account )
+        {
+            group_begin.push_back( i );
+        }
+    }
+    const std::size_t num_groups = group_begin.size();
+    group_begin.push_back( order.size() );
+
+    // New balances are computed into the journal entry, the mapped file is untouched until the entry is durable
+    const std::size_t    record_size = ACCOUNT_ID_SIZE + 2 * element_width;
+    std::vector<uint8_t> entry( JOURNAL_ENTRY_HEADER_SIZE + num_groups * record_size );
+    util::ParallelFor(
+        num_groups,
+        [&]( std::size_t begin, std::size_t end )
+        {
+            for ( std::size_t group = begin; group < end; ++group )
+            {
+                const AccountId account = deltas[order[group_begin[group]]].account;
+                const uint8_t  *current = GetRecord( account );
+
+                cpp_int a = Crypto3Util::FixedBytesLEToCppInt( current, element_width );
+                cpp_int b = Crypto3Util::FixedBytesLEToCppInt( current + element_width, element_width );
+                for ( std::size_t i = group_begin[group]; i < group_begin[group + 1]; ++i )
+                {
+                    const auto &amount = deltas[order[i]].amount;
+                    a                  = ( a * amount.first ) % params.prime_number;
+                    b                  = ( b * amount.second ) % params.prime_number;
+                }
+
+                uint8_t *record = entry.data() + JOURNAL_ENTRY_HEADER_SIZE + group * record_size;
+                WriteLittleEndian( account, record, ACCOUNT_ID_SIZE );
+                Crypto3Util::CppIntToFixedBytesLE( a, record + ACCOUNT_ID_SIZE, element_width );
+                Crypto3Util::CppIntToFixedBytesLE( b, record + ACCOUNT_ID_SIZE + element_width, element_width );
+            }
+        },
+        num_threads );
+
+    std::copy( std::begin( JOURNAL_MAGIC ), std::end( JOURNAL_MAGIC ), entry.begin() );
+    WriteLittleEndian( 0, entry.data() + 4, 4 );
+    WriteLittleEndian( num_groups, entry.data() + 8, 8 );
+    WriteLittleEndian( Checksum( entry.data() + JOURNAL_ENTRY_HEADER_SIZE, num_groups * record_size ), entry.data() + 16, 8 );
+    journal.Append( entry.data(), entry.size() );
+    journal.Sync();
+
+    util::ParallelFor(
+        num_groups,
+        [&]( std::size_t begin, std::size_t end )
+        {
+            for ( std::size_t group = begin; group < end; ++group )
+            {
+                const uint8_t *record = entry.data() + JOURNAL_ENTRY_HEADER_SIZE + group * record_size;
+                std::copy_n( record + ACCOUNT_ID_SIZE, 2 * element_width, GetRecord( ReadLittleEndian( record, ACCOUNT_ID_SIZE ) ) );
+            }
+        },
+        num_threads );
+
+    if ( journal.Size() >= CHECKPOINT_JOURNAL_SIZE )
+    {
+        CheckpointLocked();
+    }
+}
+
+void EncryptedBalanceStore::Checkpoint()
+{
+    std::unique_lock lock( mutex );
+    CheckpointLocked();
+}
+
+void EncryptedBalanceStore::CheckpointLocked()
+{
+    balances.Flush();
+    if ( journal.Size() != 0 )
+    {
+        journal.Truncate( 0 );
+    }
+}
+
+void EncryptedBalanceStore::ReplayJournal()
+{
+    const std::vector<uint8_t> entries     = journal.ReadAll();
+    const std::size_t          record_size = ACCOUNT_ID_SIZE + 2 * element_width;
+
+    std::size_t offset = 0;
+    while ( entries.size() - offset >= JOURNAL_ENTRY_HEADER_SIZE )
+    {
+        const uint8_t *entry = entries.data() + offset;
+        if ( !std::equal( std::begin( JOURNAL_MAGIC ), std::end( JOURNAL_MAGIC ), entry ) )
+        {
+            break;
+        }
+        const uint64_t count = ReadLittleEndian( entry + 8, 8 );
+        if ( count > ( entries.size() - offset - JOURNAL_ENTRY_HEADER_SIZE ) / record_size )
+        {
+            break;
+        }
+        const std::size_t payload_size = static_cast<std::size_t>( count ) * record_size;
+        if ( Checksum( entry + JOURNAL_ENTRY_HEADER_SIZE, payload_size ) != ReadLittleEndian( entry + 16, 8 ) )
+        {
+            break;
+        }
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            const uint8_t  *record  = entry + JOURNAL_ENTRY_HEADER_SIZE + i * record_size;
+            const AccountId account = ReadLittleEndian( record, ACCOUNT_ID_SIZE );
+            if ( account >= num_accounts )
+            {
+                throw std::runtime_error( "Journal refers to an unknown account" );
+            }
+            std::copy_n( record + ACCOUNT_ID_SIZE, 2 * element_width, GetRecord( account ) );
+        }
+        offset += JOURNAL_ENTRY_HEADER_SIZE + payload_size;
+    }
+    // Whatever follows the last complete entry is a write torn by a crash, the checkpoint drops it
+}
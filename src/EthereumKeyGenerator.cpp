@@ -3,21 +3,23 @@
 //
 #include "ProofSystem/EthereumKeyGenerator.hpp"
 
-#include <nil/crypto3/hash/algorithm/hash.hpp>
-#include <nil/crypto3/hash/adaptor/hashed.hpp>
 #include <nil/crypto3/algebra/marshalling.hpp>
 #include <ProofSystem/util.hpp>
+#include <ProofSystem/MultiLaneHash.hpp>
+#include <ProofSystem/ECBatchOps.hpp>
+#include <ProofSystem/PublicKeyCache.hpp>
+#include <ProofSystem/ParallelFor.hpp>
+#include <ProofSystem/Metrics.hpp>
+#include <ProofSystem/SecureRandom.hpp>
 
+#include <algorithm>
+#include <cctype>
 
 using namespace nil::crypto3::algebra;
-using namespace nil::crypto3::hashes;
 using namespace nil::marshalling::bincode;
 
 namespace ethereum
 {
-    random_generator_type EthereumKeyGenerator::key_gen;
-
-
     EthereumKeyGenerator::EthereumKeyGenerator() :
         privkey( CreateKeys() ), pubkey( std::make_shared<pubkey::public_key<policy_type>>( *privkey ) ), address( DeriveAddress() )
     {
@@ -46,19 +48,22 @@ namespace ethereum
 
     std::shared_ptr<pubkey::ext_private_key<policy_type>> EthereumKeyGenerator::CreateKeys()
     {
-        return std::make_shared<pubkey::ext_private_key<policy_type>>( EthereumKeyGenerator::key_gen() );
+        return std::make_shared<pubkey::ext_private_key<policy_type>>( csprng::RandomScalar<scalar_field_type>() );
     }
 
     template <>
     std::vector<std::uint8_t>
     EthereumKeyGenerator::ExtractPubKeyFromField<std::vector<std::uint8_t>>( const pubkey::public_key<policy_type> &pub_key )
     {
+        // A single affine conversion, each one costs a field inversion
+        const auto affine = pub_key.pubkey_data().to_affine();
+
         std::vector<std::uint8_t> x_y_ser( ( base_field_type::number_bits / 8 ) * 2 );
 
-        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( pub_key.pubkey_data().to_affine().Y.data,
+        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( affine.Y.data,
                                                                                              x_y_ser.begin(), x_y_ser.begin() + x_y_ser.size() / 2 );
 
-        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( pub_key.pubkey_data().to_affine().X.data,
+        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( affine.X.data,
                                                                                              x_y_ser.begin() + x_y_ser.size() / 2, x_y_ser.end() );
 
         auto middle_pos = x_y_ser.begin() + x_y_ser.size() / 2;
@@ -71,12 +76,15 @@ namespace ethereum
     EthereumKeyGenerator::PubKeyPair_t
     EthereumKeyGenerator::ExtractPubKeyFromField<EthereumKeyGenerator::PubKeyPair_t>( const pubkey::public_key<policy_type> &pub_key )
     {
+        // A single affine conversion, each one costs a field inversion
+        const auto affine = pub_key.pubkey_data().to_affine();
+
         std::vector<std::uint8_t> x_ser( base_field_type::number_bits / 8 );
         std::vector<std::uint8_t> y_ser( base_field_type::number_bits / 8 );
 
-        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( pub_key.pubkey_data().to_affine().Y.data, y_ser.begin(),
+        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( affine.Y.data, y_ser.begin(),
                                                                                              y_ser.end() );
-        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( pub_key.pubkey_data().to_affine().X.data, x_ser.begin(),
+        field<base_field_type>::field_element_to_bytes<std::vector<std::uint8_t>::iterator>( affine.X.data, x_ser.begin(),
                                                                                              x_ser.end() );
 
         util::AdjustEndianess( y_ser );
@@ -87,50 +95,133 @@ namespace ethereum
 
     std::string EthereumKeyGenerator::DeriveAddress( const std::vector<std::uint8_t> &pub_key_vect )
     {
-        std::string keccak_hash = hash<derivation_hash_type>( pub_key_vect.rbegin(), pub_key_vect.rend() );
-        std::string checksum    = hash<derivation_hash_type>( keccak_hash.begin() + KECCAK_RES_VALID_POS, keccak_hash.end() );
+        PROOFSYSTEM_SCOPED_TIMER( "ethereum_derive_address_seconds" );
+        PROOFSYSTEM_COUNTER_ADD( "ethereum_addresses_derived", 1 );
+
+        std::vector<std::uint8_t>                                key_data( pub_key_vect.rbegin(), pub_key_vect.rend() );
+        std::array<std::uint8_t, hashing::KECCAK256_DIGEST_SIZE> keccak_hash;
+        hashing::Keccak256( key_data.data(), key_data.size(), keccak_hash.data() );
+
+        Address_t address;
+        std::copy( keccak_hash.begin() + KECCAK_ADDRESS_POS, keccak_hash.end(), address.begin() );
+        return ToChecksumAddress( address );
+    }
+
+    std::vector<EthereumKeyGenerator::Address_t> EthereumKeyGenerator::DeriveAddresses( const std::vector<PubKeyBytes_t> &pub_keys )
+    {
+        std::vector<Address_t> addresses( pub_keys.size() );
+        DeriveAddresses( pub_keys.data(), pub_keys.size(), addresses.data() );
+        return addresses;
+    }
 
-        for ( std::size_t i = 0; i < keccak_hash.size() - KECCAK_RES_VALID_POS; ++i )
+    void EthereumKeyGenerator::DeriveAddresses( const PubKeyBytes_t *pub_keys, std::size_t count, Address_t *addresses )
+    {
+        static_assert( sizeof( PubKeyBytes_t ) == 64, "Public keys must be tightly packed" );
+
+        PROOFSYSTEM_SCOPED_TIMER( "ethereum_derive_address_seconds" );
+        PROOFSYSTEM_COUNTER_ADD( "ethereum_addresses_derived", count );
+
+        std::vector<std::uint8_t> digests( std::min( count, BATCH_BLOCK_SIZE ) * hashing::KECCAK256_DIGEST_SIZE );
+        for ( std::size_t first = 0; first < count; first += BATCH_BLOCK_SIZE )
         {
-            auto *p_char = &keccak_hash[i + KECCAK_RES_VALID_POS];
-            if ( std::isalpha( *p_char ) != 0 )
+            const std::size_t block_count = std::min( BATCH_BLOCK_SIZE, count - first );
+            hashing::Keccak256Batch( pub_keys[first].data(), sizeof( PubKeyBytes_t ), block_count, digests.data() );
+
+            for ( std::size_t i = 0; i < block_count; ++i )
             {
-                if ( util::HexASCII2Num<std::uint8_t>( &checksum[i], 1 ) > 7 )
-                {
-                    *p_char = std::toupper( *p_char );
-                }
-                else
+                const auto *digest = digests.data() + i * hashing::KECCAK256_DIGEST_SIZE;
+                std::copy( digest + KECCAK_ADDRESS_POS, digest + hashing::KECCAK256_DIGEST_SIZE, addresses[first + i].begin() );
+            }
+        }
+    }
+
+    std::vector<EthereumKeyGenerator::BatchEntry_t> EthereumKeyGenerator::GenerateBatch( std::size_t count, std::size_t num_threads )
+    {
+        using affine_value_type = CurveType::template g1_type<curves::coordinates::affine>::value_type;
+
+        std::vector<BatchEntry_t> entries( count );
+        util::ParallelFor(
+            count,
+            [&entries]( std::size_t begin, std::size_t end )
+            {
+                std::vector<scalar_field_value_type> private_keys( BATCH_BLOCK_SIZE );
+                std::vector<affine_value_type>       public_keys( BATCH_BLOCK_SIZE );
+                std::vector<PubKeyBytes_t>           key_bytes( BATCH_BLOCK_SIZE );
+                std::vector<Address_t>               addresses( BATCH_BLOCK_SIZE );
+
+                for ( std::size_t first = begin; first < end; first += BATCH_BLOCK_SIZE )
                 {
-                    *p_char = std::tolower( *p_char );
+                    const std::size_t block_count = std::min( BATCH_BLOCK_SIZE, end - first );
+                    // Each worker draws its own keys from its thread generator
+                    for ( std::size_t i = 0; i < block_count; ++i )
+                    {
+                        private_keys[i]                = csprng::RandomScalar<scalar_field_type>();
+                        entries[first + i].private_key = private_keys[i];
+                    }
+                    ecbatch::GeneratorMulBatch<CurveType>( private_keys.data(), block_count, public_keys.data() );
+
+                    for ( std::size_t i = 0; i < block_count; ++i )
+                    {
+                        ecbatch::FieldElementToBigEndian<base_field_type>( public_keys[i].X, key_bytes[i].data() );
+                        ecbatch::FieldElementToBigEndian<base_field_type>( public_keys[i].Y, key_bytes[i].data() + key_bytes[i].size() / 2 );
+                    }
+                    DeriveAddresses( key_bytes.data(), block_count, addresses.data() );
+
+                    for ( std::size_t i = 0; i < block_count; ++i )
+                    {
+                        entries[first + i].public_key = key_bytes[i];
+                        entries[first + i].address    = addresses[i];
+                    }
                 }
+            },
+            num_threads );
+
+        return entries;
+    }
+
+    std::string EthereumKeyGenerator::ToChecksumAddress( const Address_t &address )
+    {
+        static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+        std::string lower_hex( address.size() * 2, '0' );
+        for ( std::size_t i = 0; i < address.size(); ++i )
+        {
+            lower_hex[2 * i]     = HEX_DIGITS[address[i] >> 4];
+            lower_hex[2 * i + 1] = HEX_DIGITS[address[i] & 0x0F];
+        }
+
+        std::array<std::uint8_t, hashing::KECCAK256_DIGEST_SIZE> checksum;
+        hashing::Keccak256( reinterpret_cast<const std::uint8_t *>( lower_hex.data() ), lower_hex.size(), checksum.data() );
+
+        for ( std::size_t i = 0; i < lower_hex.size(); ++i )
+        {
+            const std::uint8_t nibble = ( i % 2 == 0 ) ? ( checksum[i / 2] >> 4 ) : ( checksum[i / 2] & 0x0F );
+            if ( std::isalpha( lower_hex[i] ) != 0 && nibble > 7 )
+            {
+                lower_hex[i] = static_cast<char>( std::toupper( lower_hex[i] ) );
             }
         }
 
-        keccak_hash.replace( ADDRESS_VALID_POS, 2, ADDRESS_HEADER );
-        return keccak_hash.substr( ADDRESS_VALID_POS, ADDRESS_SIZE_CHARS );
+        return std::string( ADDRESS_HEADER ) + lower_hex;
     }
 
     std::string EthereumKeyGenerator::DeriveAddress()
     {
-        std::vector<std::uint8_t> pubkey_data = ExtractPubKeyFromField<std::vector<std::uint8_t>>( *pubkey );
-        pubkey_info                           = std::make_shared<EthereumECDSAPublicKey>(
-            std::vector<std::uint8_t>( pubkey_data.data() + pubkey_data.size() / 2, pubkey_data.data() + pubkey_data.size() ),
-            std::vector<std::uint8_t>( pubkey_data.data(), pubkey_data.data() + pubkey_data.size() / 2 ) );
-        return DeriveAddress( pubkey_data );
+        const auto affine = pubkey->pubkey_data().to_affine();
+
+        ECDSAPublicKey::Coordinate_t x_coord;
+        ECDSAPublicKey::Coordinate_t y_coord;
+        ecbatch::FieldElementToBigEndian<base_field_type>( affine.X, x_coord.data() );
+        ecbatch::FieldElementToBigEndian<base_field_type>( affine.Y, y_coord.data() );
+        pubkey_info = std::make_shared<EthereumECDSAPublicKey>( x_coord, y_coord );
+
+        Address_t binary_address;
+        DeriveAddresses( &pubkey_info->GetUncompressed(), 1, &binary_address );
+        return ToChecksumAddress( binary_address );
     }
 
     pubkey::public_key<ethereum::policy_type> EthereumKeyGenerator::BuildPublicKey( const std::string &pubkey_data )
     {
-
-        auto z_data_one = pubkey::public_key<ethereum::policy_type>::g1_value_type::field_type::value_type::one();
-    
-        std::vector<std::uint8_t> key_vector = util::HexASCII2NumStr<std::uint8_t>( pubkey_data.data() );
-    
-        auto y_data = field<base_field_type>::field_element_from_bytes<std::vector<std::uint8_t>::iterator>(
-            key_vector.begin(), key_vector.begin() + key_vector.size() / 2 );
-        auto x_data = field<base_field_type>::field_element_from_bytes<std::vector<std::uint8_t>::iterator>(
-            key_vector.begin() + key_vector.size() / 2, key_vector.end() );
-    
-        return typename pubkey::public_key<ethereum::policy_type>::public_key_type( x_data.second, y_data.second, z_data_one );
+        return typename pubkey::public_key<ethereum::policy_type>::public_key_type( ecpoint::PublicKeyCache<CurveType>::Instance().Get( pubkey_data ) );
     }
 }
@@ -0,0 +1,374 @@
+/**
+ * @file       MappedFile.cpp
+ * @brief      Memory mapped files and durable append only files
+ * @date       2024-03-30
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include <ProofSystem/MappedFile.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace util
+{
+#ifdef _WIN32
+    MappedFile::MappedFile( const std::string &path, Mode mode ) : path( path ), mode( mode )
+    {
+        const bool writable = mode == Mode::READ_WRITE;
+        file_handle         = CreateFileA( path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                           writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+        if ( file_handle == INVALID_HANDLE_VALUE )
+        {
+            file_handle = nullptr;
+            throw std::runtime_error( "Can't open " + path );
+        }
+        LARGE_INTEGER file_size;
+        if ( !GetFileSizeEx( file_handle, &file_size ) )
+        {
+            Close();
+            throw std::runtime_error( "Can't read the size of " + path );
+        }
+        size = static_cast<std::size_t>( file_size.QuadPart );
+        try
+        {
+            Map();
+        }
+        catch ( ... )
+        {
+            Close();
+            throw;
+        }
+    }
+
+    void MappedFile::Map()
+    {
+        if ( size == 0 )
+        {
+            return;
+        }
+        const bool writable = mode == Mode::READ_WRITE;
+        mapping_handle      = CreateFileMappingA( file_handle, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr );
+        if ( mapping_handle != nullptr )
+        {
+            data = static_cast<std::uint8_t *>( MapViewOfFile( mapping_handle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0 ) );
+        }
+        if ( data == nullptr )
+        {
+            Unmap();
+            throw std::runtime_error( "Can't map " + path );
+        }
+    }
+
+    void MappedFile::Unmap() noexcept
+    {
+        if ( data != nullptr )
+        {
+            UnmapViewOfFile( data );
+        }
+        if ( mapping_handle != nullptr )
+        {
+            CloseHandle( mapping_handle );
+        }
+        data           = nullptr;
+        mapping_handle = nullptr;
+    }
+
+    void MappedFile::Close() noexcept
+    {
+        Unmap();
+        if ( file_handle != nullptr )
+        {
+            CloseHandle( file_handle );
+        }
+        file_handle = nullptr;
+    }
+
+    void MappedFile::Resize( std::size_t new_size )
+    {
+        if ( mode != Mode::READ_WRITE )
+        {
+            throw std::runtime_error( "Can't resize a read only mapping" );
+        }
+        Unmap();
+        LARGE_INTEGER position;
+        position.QuadPart = static_cast<LONGLONG>( new_size );
+        if ( !SetFilePointerEx( file_handle, position, nullptr, FILE_BEGIN ) || !SetEndOfFile( file_handle ) )
+        {
+            Map();
+            throw std::runtime_error( "Can't resize " + path );
+        }
+        size = new_size;
+        Map();
+    }
+
+    void MappedFile::Flush()
+    {
+        if ( data != nullptr && !FlushViewOfFile( data, 0 ) )
+        {
+            throw std::runtime_error( "Can't flush " + path );
+        }
+        if ( mode == Mode::READ_WRITE && !FlushFileBuffers( file_handle ) )
+        {
+            throw std::runtime_error( "Can't sync " + path );
+        }
+    }
+
+    AppendOnlyFile::AppendOnlyFile( const std::string &path ) : path( path )
+    {
+        file_handle = CreateFileA( path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr );
+        if ( file_handle == INVALID_HANDLE_VALUE )
+        {
+            file_handle = nullptr;
+            throw std::runtime_error( "Can't open " + path );
+        }
+        LARGE_INTEGER file_size;
+        if ( !GetFileSizeEx( file_handle, &file_size ) )
+        {
+            CloseHandle( file_handle );
+            throw std::runtime_error( "Can't read the size of " + path );
+        }
+        size = static_cast<std::size_t>( file_size.QuadPart );
+    }
+
+    AppendOnlyFile::~AppendOnlyFile()
+    {
+        CloseHandle( file_handle );
+    }
+
+    std::vector<std::uint8_t> AppendOnlyFile::ReadAll() const
+    {
+        std::vector<std::uint8_t> retval( size );
+        LARGE_INTEGER             position{};
+        std::size_t               done = 0;
+        if ( !SetFilePointerEx( file_handle, position, nullptr, FILE_BEGIN ) )
+        {
+            throw std::runtime_error( "Can't read " + path );
+        }
+        while ( done < size )
+        {
+            DWORD read = 0;
+            if ( !ReadFile( file_handle, retval.data() + done, static_cast<DWORD>( std::min<std::size_t>( size - done, 1 << 30 ) ), &read, nullptr ) ||
+                 read == 0 )
+            {
+                throw std::runtime_error( "Can't read " + path );
+            }
+            done += read;
+        }
+        return retval;
+    }
+
+    void AppendOnlyFile::Append( const std::uint8_t *bytes, std::size_t count )
+    {
+        LARGE_INTEGER position;
+        position.QuadPart = static_cast<LONGLONG>( size );
+        if ( !SetFilePointerEx( file_handle, position, nullptr, FILE_BEGIN ) )
+        {
+            throw std::runtime_error( "Can't write " + path );
+        }
+        std::size_t done = 0;
+        while ( done < count )
+        {
+            DWORD written = 0;
+            if ( !WriteFile( file_handle, bytes + done, static_cast<DWORD>( std::min<std::size_t>( count - done, 1 << 30 ) ), &written, nullptr ) )
+            {
+                throw std::runtime_error( "Can't write " + path );
+            }
+            done += written;
+        }
+        size += count;
+    }
+
+    void AppendOnlyFile::Sync()
+    {
+        if ( !FlushFileBuffers( file_handle ) )
+        {
+            throw std::runtime_error( "Can't sync " + path );
+        }
+    }
+
+    void AppendOnlyFile::Truncate( std::size_t new_size )
+    {
+        LARGE_INTEGER position;
+        position.QuadPart = static_cast<LONGLONG>( new_size );
+        if ( !SetFilePointerEx( file_handle, position, nullptr, FILE_BEGIN ) || !SetEndOfFile( file_handle ) )
+        {
+            throw std::runtime_error( "Can't truncate " + path );
+        }
+        size = new_size;
+        Sync();
+    }
+#else
+    MappedFile::MappedFile( const std::string &path, Mode mode ) : path( path ), mode( mode )
+    {
+        descriptor = mode == Mode::READ_WRITE ? open( path.c_str(), O_RDWR | O_CREAT, 0644 ) : open( path.c_str(), O_RDONLY );
+        if ( descriptor < 0 )
+        {
+            throw std::runtime_error( "Can't open " + path );
+        }
+        struct stat file_stat;
+        if ( fstat( descriptor, &file_stat ) != 0 )
+        {
+            Close();
+            throw std::runtime_error( "Can't read the size of " + path );
+        }
+        size = static_cast<std::size_t>( file_stat.st_size );
+        try
+        {
+            Map();
+        }
+        catch ( ... )
+        {
+            Close();
+            throw;
+        }
+    }
+
+    void MappedFile::Map()
+    {
+        if ( size == 0 )
+        {
+            return;
+        }
+        const int protection = mode == Mode::READ_WRITE ? PROT_READ | PROT_WRITE : PROT_READ;
+        void     *mapping    = mmap( nullptr, size, protection, MAP_SHARED, descriptor, 0 );
+        if ( mapping == MAP_FAILED )
+        {
+            throw std::runtime_error( "Can't map " + path );
+        }
+        data = static_cast<std::uint8_t *>( mapping );
+    }
+
+    void MappedFile::Unmap() noexcept
+    {
+        if ( data != nullptr )
+        {
+            munmap( data, size );
+        }
+        data = nullptr;
+    }
+
+    void MappedFile::Close() noexcept
+    {
+        Unmap();
+        if ( descriptor >= 0 )
+        {
+            close( descriptor );
+        }
+        descriptor = -1;
+    }
+
+    void MappedFile::Resize( std::size_t new_size )
+    {
+        if ( mode != Mode::READ_WRITE )
+        {
+            throw std::runtime_error( "Can't resize a read only mapping" );
+        }
+        Unmap();
+        if ( ftruncate( descriptor, static_cast<off_t>( new_size ) ) != 0 )
+        {
+            Map();
+            throw std::runtime_error( "Can't resize " + path );
+        }
+        size = new_size;
+        Map();
+    }
+
+    void MappedFile::Flush()
+    {
+        if ( data != nullptr && msync( data, size, MS_SYNC ) != 0 )
+        {
+            throw std::runtime_error( "Can't flush " + path );
+        }
+        if ( mode == Mode::READ_WRITE && fsync( descriptor ) != 0 )
+        {
+            throw std::runtime_error( "Can't sync " + path );
+        }
+    }
+
+    AppendOnlyFile::AppendOnlyFile( const std::string &path ) : path( path )
+    {
+        descriptor = open( path.c_str(), O_RDWR | O_CREAT, 0644 );
+        if ( descriptor < 0 )
+        {
+            throw std::runtime_error( "Can't open " + path );
+        }
+        struct stat file_stat;
+        if ( fstat( descriptor, &file_stat ) != 0 )
+        {
+            close( descriptor );
+            throw std::runtime_error( "Can't read the size of " + path );
+        }
+        size = static_cast<std::size_t>( file_stat.st_size );
+    }
+
+    AppendOnlyFile::~AppendOnlyFile()
+    {
+        close( descriptor );
+    }
+
+    std::vector<std::uint8_t> AppendOnlyFile::ReadAll() const
+    {
+        std::vector<std::uint8_t> retval( size );
+        std::size_t               done = 0;
+        while ( done < size )
+        {
+            const ssize_t read = pread( descriptor, retval.data() + done, size - done, static_cast<off_t>( done ) );
+            if ( read <= 0 )
+            {
+                throw std::runtime_error( "Can't read " + path );
+            }
+            done += static_cast<std::size_t>( read );
+        }
+        return retval;
+    }
+
+    void AppendOnlyFile::Append( const std::uint8_t *bytes, std::size_t count )
+    {
+        std::size_t done = 0;
+        while ( done < count )
+        {
+            const ssize_t written = pwrite( descriptor, bytes + done, count - done, static_cast<off_t>( size + done ) );
+            if ( written < 0 )
+            {
+                throw std::runtime_error( "Can't write " + path );
+            }
+            done += static_cast<std::size_t>( written );
+        }
+        size += count;
+    }
+
+    void AppendOnlyFile::Sync()
+    {
+        if ( fsync( descriptor ) != 0 )
+        {
+            throw std::runtime_error( "Can't sync " + path );
+        }
+    }
+
+    void AppendOnlyFile::Truncate( std::size_t new_size )
+    {
+        if ( ftruncate( descriptor, static_cast<off_t>( new_size ) ) != 0 )
+        {
+            throw std::runtime_error( "Can't truncate " + path );
+        }
+        size = new_size;
+        Sync();
+    }
+#endif
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+}
@@ -0,0 +1,360 @@
+/**
+ * @file       MultiLaneHash.cpp
+ * @brief      Scalar hash kernels and instruction set dispatch
+ * @date       2024-03-06
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include "ProofSystem/MultiLaneHash.hpp"
+#include "MultiLaneHashKernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
+#if defined( PROOFSYSTEM_X86_SIMD ) && defined( _MSC_VER )
+#include <intrin.h>
+#elif defined( PROOFSYSTEM_X86_SIMD )
+#include <cpuid.h>
+#endif
+
+namespace hashing
+{
+    namespace
+    {
+        struct ScalarOps
+        {
+            using vec_type                   = std::uint64_t;
+            static constexpr std::size_t LANES = 1;
+
+            static vec_type Zero()
+            {
+                return 0;
+            }
+            static vec_type Set1( std::uint64_t value )
+            {
+                return value;
+            }
+            static vec_type Load( const std::uint64_t *words )
+            {
+                return words[0];
+            }
+            static void Store( vec_type value, std::uint64_t *words )
+            {
+                words[0] = value;
+            }
+            static vec_type Xor( vec_type a, vec_type b )
+            {
+                return a ^ b;
+            }
+            static vec_type AndNotXor( vec_type a, vec_type b, vec_type c )
+            {
+                return a ^ ( ~b & c );
+            }
+            static vec_type Rotl( vec_type a, unsigned n )
+            {
+                return n == 0 ? a : ( ( a << n ) | ( a >> ( 64 - n ) ) );
+            }
+        };
+
+        struct ScalarOps32
+        {
+            using vec_type                   = std::uint32_t;
+            static constexpr std::size_t LANES = 1;
+
+            static vec_type Set1( std::uint32_t value )
+            {
+                return value;
+            }
+            static vec_type Load( const std::uint32_t *words )
+            {
+                return words[0];
+            }
+            static void Store( vec_type value, std::uint32_t *words )
+            {
+                words[0] = value;
+            }
+            static vec_type Add( vec_type a, vec_type b )
+            {
+                return a + b;
+            }
+            static vec_type Xor( vec_type a, vec_type b )
+            {
+                return a ^ b;
+            }
+            static vec_type And( vec_type a, vec_type b )
+            {
+                return a & b;
+            }
+            static vec_type Or( vec_type a, vec_type b )
+            {
+                return a | b;
+            }
+            static vec_type AndNot( vec_type a, vec_type b )
+            {
+                return ~a & b;
+            }
+            static vec_type Not( vec_type a )
+            {
+                return ~a;
+            }
+            static vec_type Shr( vec_type a, unsigned n )
+            {
+                return a >> n;
+            }
+            static vec_type Rotl( vec_type a, unsigned n )
+            {
+                return n == 0 ? a : ( ( a << n ) | ( a >> ( 32 - n ) ) );
+            }
+            static vec_type Rotr( vec_type a, unsigned n )
+            {
+                return n == 0 ? a : ( ( a >> n ) | ( a << ( 32 - n ) ) );
+            }
+        };
+
+        SimdLevel DetectSimdLevel()
+        {
+#if defined( PROOFSYSTEM_X86_SIMD ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+            __builtin_cpu_init();
+            if ( __builtin_cpu_supports( "avx512f" ) )
+            {
+                return SimdLevel::AVX512;
+            }
+            if ( __builtin_cpu_supports( "avx2" ) )
+            {
+                return SimdLevel::AVX2;
+            }
+#elif defined( PROOFSYSTEM_X86_SIMD ) && defined( _MSC_VER )
+            int info[4];
+            __cpuid( info, 1 );
+            const bool os_avx = ( info[2] & ( 1 << 27 ) ) != 0 && ( info[2] & ( 1 << 28 ) ) != 0;
+            if ( os_avx )
+            {
+                const auto xcr0 = _xgetbv( 0 );
+                __cpuidex( info, 7, 0 );
+                if ( ( info[1] & ( 1 << 16 ) ) != 0 && ( xcr0 & 0xE6 ) == 0xE6 )
+                {
+                    return SimdLevel::AVX512;
+                }
+                if ( ( info[1] & ( 1 << 5 ) ) != 0 && ( xcr0 & 0x6 ) == 0x6 )
+                {
+                    return SimdLevel::AVX2;
+                }
+            }
+#endif
+            return SimdLevel::SCALAR;
+        }
+
+        bool DetectShaExtensions()
+        {
+#if defined( PROOFSYSTEM_X86_SIMD ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+            unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+            if ( __get_cpuid_count( 7, 0, &eax, &ebx, &ecx, &edx ) == 0 )
+            {
+                return false;
+            }
+            return ( ebx & ( 1u << 29 ) ) != 0 && __builtin_cpu_supports( "sse4.1" );
+#elif defined( PROOFSYSTEM_X86_SIMD ) && defined( _MSC_VER )
+            int info[4];
+            __cpuidex( info, 7, 0 );
+            return ( info[1] & ( 1 << 29 ) ) != 0;
+#else
+            return false;
+#endif
+        }
+
+        const SimdLevel        cpu_simd_level = DetectSimdLevel();
+        const bool             cpu_sha_ni     = DetectShaExtensions();
+        std::atomic<SimdLevel> max_simd_level{ SimdLevel::AVX512 };
+    }
+
+    SimdLevel GetSimdLevel()
+    {
+        const auto allowed = max_simd_level.load( std::memory_order_relaxed );
+        return ( static_cast<int>( allowed ) < static_cast<int>( cpu_simd_level ) ) ? allowed : cpu_simd_level;
+    }
+
+    void SetMaxSimdLevel( SimdLevel level )
+    {
+        max_simd_level.store( level, std::memory_order_relaxed );
+    }
+
+    bool HasShaExtensions()
+    {
+        return cpu_sha_ni && max_simd_level.load( std::memory_order_relaxed ) != SimdLevel::SCALAR;
+    }
+
+    void Keccak256( const std::uint8_t *data, std::size_t size, std::uint8_t *digest )
+    {
+        Keccak256Lanes<ScalarOps>( &data, size, &digest );
+    }
+
+    void Keccak256Batch( const std::uint8_t *data, std::size_t message_size, std::size_t count, std::uint8_t *digests )
+    {
+        std::size_t i = 0;
+
+#ifdef PROOFSYSTEM_X86_SIMD
+        const auto level = GetSimdLevel();
+
+        const std::uint8_t *inputs[8];
+        std::uint8_t       *outputs[8];
+        auto                prepare = [&]( std::size_t lanes )
+        {
+            for ( std::size_t l = 0; l < lanes; ++l )
+            {
+                inputs[l]  = data + ( i + l ) * message_size;
+                outputs[l] = digests + ( i + l ) * KECCAK256_DIGEST_SIZE;
+            }
+        };
+
+        if ( level == SimdLevel::AVX512 )
+        {
+            for ( ; i + 8 <= count; i += 8 )
+            {
+                prepare( 8 );
+                detail::Keccak256x8( inputs, message_size, outputs );
+            }
+        }
+        if ( level != SimdLevel::SCALAR )
+        {
+            for ( ; i + 4 <= count; i += 4 )
+            {
+                prepare( 4 );
+                detail::Keccak256x4( inputs, message_size, outputs );
+            }
+        }
+#endif
+
+        for ( ; i < count; ++i )
+        {
+            Keccak256( data + i * message_size, message_size, digests + i * KECCAK256_DIGEST_SIZE );
+        }
+    }
+
+    void Sha256( const std::uint8_t *data, std::size_t size, std::uint8_t *digest )
+    {
+#ifdef PROOFSYSTEM_X86_SIMD
+        if ( HasShaExtensions() )
+        {
+            std::uint32_t state[8];
+            std::copy( std::begin( Sha256Algo::IV ), std::end( Sha256Algo::IV ), state );
+
+            const std::size_t full_blocks = size / MD_BLOCK_SIZE;
+            detail::Sha256CompressShaNi( state, data, full_blocks );
+
+            const std::size_t   remaining  = size - full_blocks * MD_BLOCK_SIZE;
+            const std::size_t   tail_size  = ( remaining + 9 <= MD_BLOCK_SIZE ) ? MD_BLOCK_SIZE : 2 * MD_BLOCK_SIZE;
+            const std::uint64_t bit_length = static_cast<std::uint64_t>( size ) * 8;
+
+            std::uint8_t tail[2 * MD_BLOCK_SIZE] = {};
+            if ( remaining != 0 )
+            {
+                std::memcpy( tail, data + full_blocks * MD_BLOCK_SIZE, remaining );
+            }
+            tail[remaining] = 0x80;
+            for ( std::size_t i = 0; i < 8; ++i )
+            {
+                tail[tail_size - 1 - i] = static_cast<std::uint8_t>( bit_length >> ( 8 * i ) );
+            }
+            detail::Sha256CompressShaNi( state, tail, tail_size / MD_BLOCK_SIZE );
+
+            for ( std::size_t w = 0; w < 8; ++w )
+            {
+                StoreBE32( state[w], digest + 4 * w );
+            }
+            return;
+        }
+#endif
+        MerkleDamgardLanes<ScalarOps32, Sha256Algo>( &data, size, &digest );
+    }
+
+    void Sha256Batch( const std::uint8_t *data, std::size_t message_size, std::size_t count, std::uint8_t *digests )
+    {
+        std::size_t i = 0;
+
+#ifdef PROOFSYSTEM_X86_SIMD
+        const auto level = GetSimdLevel();
+
+        const std::uint8_t *inputs[16];
+        std::uint8_t       *outputs[16];
+        auto                prepare = [&]( std::size_t lanes )
+        {
+            for ( std::size_t l = 0; l < lanes; ++l )
+            {
+                inputs[l]  = data + ( i + l ) * message_size;
+                outputs[l] = digests + ( i + l ) * SHA256_DIGEST_SIZE;
+            }
+        };
+
+        // Full lane groups outrun the SHA extensions, which only take the remainder
+        if ( level == SimdLevel::AVX512 )
+        {
+            for ( ; i + 16 <= count; i += 16 )
+            {
+                prepare( 16 );
+                detail::Sha256x16( inputs, message_size, outputs );
+            }
+        }
+        if ( level != SimdLevel::SCALAR )
+        {
+            for ( ; i + 8 <= count; i += 8 )
+            {
+                prepare( 8 );
+                detail::Sha256x8( inputs, message_size, outputs );
+            }
+        }
+#endif
+
+        for ( ; i < count; ++i )
+        {
+            Sha256( data + i * message_size, message_size, digests + i * SHA256_DIGEST_SIZE );
+        }
+    }
+
+    void Ripemd160( const std::uint8_t *data, std::size_t size, std::uint8_t *digest )
+    {
+        MerkleDamgardLanes<ScalarOps32, Ripemd160Algo>( &data, size, &digest );
+    }
+
+    void Ripemd160Batch( const std::uint8_t *data, std::size_t message_size, std::size_t count, std::uint8_t *digests )
+    {
+        std::size_t i = 0;
+
+#ifdef PROOFSYSTEM_X86_SIMD
+        const auto level = GetSimdLevel();
+
+        const std::uint8_t *inputs[16];
+        std::uint8_t       *outputs[16];
+        auto                prepare = [&]( std::size_t lanes )
+        {
+            for ( std::size_t l = 0; l < lanes; ++l )
+            {
+                inputs[l]  = data + ( i + l ) * message_size;
+                outputs[l] = digests + ( i + l ) * RIPEMD160_DIGEST_SIZE;
+            }
+        };
+
+        if ( level == SimdLevel::AVX512 )
+        {
+            for ( ; i + 16 <= count; i += 16 )
+            {
+                prepare( 16 );
+                detail::Ripemd160x16( inputs, message_size, outputs );
+            }
+        }
+        if ( level != SimdLevel::SCALAR )
+        {
+            for ( ; i + 8 <= count; i += 8 )
+            {
+                prepare( 8 );
+                detail::Ripemd160x8( inputs, message_size, outputs );
+            }
+        }
+#endif
+
+        for ( ; i < count; ++i )
+        {
+            Ripemd160( data + i * message_size, message_size, digests + i * RIPEMD160_DIGEST_SIZE );
+        }
+    }
+}
@@ -0,0 +1,126 @@
+/**
+ * @file       MultiLaneHashAVX2.cpp
+ * @brief      AVX2 hash kernels, built with AVX2 code generation and only called after runtime detection
+ * @date       2024-03-06
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include "MultiLaneHashKernels.hpp"
+
+#include <immintrin.h>
+
+namespace hashing
+{
+    namespace
+    {
+        struct Avx2x64Ops
+        {
+            using vec_type                   = __m256i;
+            static constexpr std::size_t LANES = 4;
+
+            static vec_type Zero()
+            {
+                return _mm256_setzero_si256();
+            }
+            static vec_type Set1( std::uint64_t value )
+            {
+                return _mm256_set1_epi64x( static_cast<long long>( value ) );
+            }
+            static vec_type Load( const std::uint64_t *words )
+            {
+                return _mm256_loadu_si256( reinterpret_cast<const __m256i *>( words ) );
+            }
+            static void Store( vec_type value, std::uint64_t *words )
+            {
+                _mm256_storeu_si256( reinterpret_cast<__m256i *>( words ), value );
+            }
+            static vec_type Xor( vec_type a, vec_type b )
+            {
+                return _mm256_xor_si256( a, b );
+            }
+            static vec_type AndNotXor( vec_type a, vec_type b, vec_type c )
+            {
+                return _mm256_xor_si256( a, _mm256_andnot_si256( b, c ) );
+            }
+            static vec_type Rotl( vec_type a, unsigned n )
+            {
+                return _mm256_or_si256( _mm256_sll_epi64( a, _mm_cvtsi32_si128( static_cast<int>( n ) ) ),
+                                        _mm256_srl_epi64( a, _mm_cvtsi32_si128( static_cast<int>( 64 - n ) ) ) );
+            }
+        };
+
+        struct Avx2x32Ops
+        {
+            using vec_type                   = __m256i;
+            static constexpr std::size_t LANES = 8;
+
+            static vec_type Set1( std::uint32_t value )
+            {
+                return _mm256_set1_epi32( static_cast<int>( value ) );
+            }
+            static vec_type Load( const std::uint32_t *words )
+            {
+                return _mm256_loadu_si256( reinterpret_cast<const __m256i *>( words ) );
+            }
+            static void Store( vec_type value, std::uint32_t *words )
+            {
+                _mm256_storeu_si256( reinterpret_cast<__m256i *>( words ), value );
+            }
+            static vec_type Add( vec_type a, vec_type b )
+            {
+                return _mm256_add_epi32( a, b );
+            }
+            static vec_type Xor( vec_type a, vec_type b )
+            {
+                return _mm256_xor_si256( a, b );
+            }
+            static vec_type And( vec_type a, vec_type b )
+            {
+                return _mm256_and_si256( a, b );
+            }
+            static vec_type Or( vec_type a, vec_type b )
+            {
+                return _mm256_or_si256( a, b );
+            }
+            static vec_type AndNot( vec_type a, vec_type b )
+            {
+                return _mm256_andnot_si256( a, b );
+            }
+            static vec_type Not( vec_type a )
+            {
+                return _mm256_xor_si256( a, _mm256_set1_epi32( -1 ) );
+            }
+            static vec_type Shr( vec_type a, unsigned n )
+            {
+                return _mm256_srl_epi32( a, _mm_cvtsi32_si128( static_cast<int>( n ) ) );
+            }
+            static vec_type Rotl( vec_type a, unsigned n )
+            {
+                return _mm256_or_si256( _mm256_sll_epi32( a, _mm_cvtsi32_si128( static_cast<int>( n ) ) ),
+                                        _mm256_srl_epi32( a, _mm_cvtsi32_si128( static_cast<int>( 32 - n ) ) ) );
+            }
+            static vec_type Rotr( vec_type a, unsigned n )
+            {
+                return Rotl( a, 32 - n );
+            }
+        };
+    }
+
+    namespace detail
+    {
+        void Keccak256x4( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests )
+        {
+            Keccak256Lanes<Avx2x64Ops>( data, size, digests );
+        }
+
+        void Sha256x8( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests )
+        {
+            MerkleDamgardLanes<Avx2x32Ops, Sha256Algo>( data, size, digests );
+        }
+
+        void Ripemd160x8( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests )
+        {
+            MerkleDamgardLanes<Avx2x32Ops, Ripemd160Algo>( data, size, digests );
+        }
+    }
+}
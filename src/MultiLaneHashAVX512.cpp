@@ -0,0 +1,125 @@
+/**
+ * @file       MultiLaneHashAVX512.cpp
+ * @brief      AVX-512 hash kernels, built with AVX-512F code generation and only called after runtime detection
+ * @date       2024-03-06
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include "MultiLaneHashKernels.hpp"
+
+#include <immintrin.h>
+
+namespace hashing
+{
+    namespace
+    {
+        struct Avx512x64Ops
+        {
+            using vec_type                   = __m512i;
+            static constexpr std::size_t LANES = 8;
+
+            static vec_type Zero()
+            {
+                return _mm512_setzero_si512();
+            }
+            static vec_type Set1( std::uint64_t value )
+            {
+                return _mm512_set1_epi64( static_cast<long long>( value ) );
+            }
+            static vec_type Load( const std::uint64_t *words )
+            {
+                return _mm512_loadu_si512( words );
+            }
+            static void Store( vec_type value, std::uint64_t *words )
+            {
+                _mm512_storeu_si512( words, value );
+            }
+            static vec_type Xor( vec_type a, vec_type b )
+            {
+                return _mm512_xor_si512( a, b );
+            }
+            static vec_type AndNotXor( vec_type a, vec_type b, vec_type c )
+            {
+                // a ^ ( ~b & c )
+                return _mm512_ternarylogic_epi64( a, b, c, 0xD2 );
+            }
+            static vec_type Rotl( vec_type a, unsigned n )
+            {
+                return _mm512_rolv_epi64( a, _mm512_set1_epi64( n ) );
+            }
+        };
+
+        struct Avx512x32Ops
+        {
+            using vec_type                   = __m512i;
+            static constexpr std::size_t LANES = 16;
+
+            static vec_type Set1( std::uint32_t value )
+            {
+                return _mm512_set1_epi32( static_cast<int>( value ) );
+            }
+            static vec_type Load( const std::uint32_t *words )
+            {
+                return _mm512_loadu_si512( words );
+            }
+            static void Store( vec_type value, std::uint32_t *words )
+            {
+                _mm512_storeu_si512( words, value );
+            }
+            static vec_type Add( vec_type a, vec_type b )
+            {
+                return _mm512_add_epi32( a, b );
+            }
+            static vec_type Xor( vec_type a, vec_type b )
+            {
+                return _mm512_xor_si512( a, b );
+            }
+            static vec_type And( vec_type a, vec_type b )
+            {
+                return _mm512_and_si512( a, b );
+            }
+            static vec_type Or( vec_type a, vec_type b )
+            {
+                return _mm512_or_si512( a, b );
+            }
+            static vec_type AndNot( vec_type a, vec_type b )
+            {
+                return _mm512_andnot_si512( a, b );
+            }
+            static vec_type Not( vec_type a )
+            {
+                return _mm512_ternarylogic_epi32( a, a, a, 0x55 );
+            }
+            static vec_type Shr( vec_type a, unsigned n )
+            {
+                return _mm512_srlv_epi32( a, _mm512_set1_epi32( static_cast<int>( n ) ) );
+            }
+            static vec_type Rotl( vec_type a, unsigned n )
+            {
+                return _mm512_rolv_epi32( a, _mm512_set1_epi32( static_cast<int>( n ) ) );
+            }
+            static vec_type Rotr( vec_type a, unsigned n )
+            {
+                return _mm512_rorv_epi32( a, _mm512_set1_epi32( static_cast<int>( n ) ) );
+            }
+        };
+    }
+
+    namespace detail
+    {
+        void Keccak256x8( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests )
+        {
+            Keccak256Lanes<Avx512x64Ops>( data, size, digests );
+        }
+
+        void Sha256x16( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests )
+        {
+            MerkleDamgardLanes<Avx512x32Ops, Sha256Algo>( data, size, digests );
+        }
+
+        void Ripemd160x16( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests )
+        {
+            MerkleDamgardLanes<Avx512x32Ops, Ripemd160Algo>( data, size, digests );
+        }
+    }
+}
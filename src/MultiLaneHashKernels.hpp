@@ -0,0 +1,472 @@
+/**
+ * @file       MultiLaneHashKernels.hpp
+ * @brief      Lane generic hash kernels, instantiated once per instruction set
+ * @date       2024-03-06
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ * @warning     Private header. The kernels live in an unnamed namespace on purpose: every translation unit
+ *              compiles its own copy with its own target flags, so no AVX code can leak into the scalar path.
+ */
+#ifndef _MULTI_LANE_HASH_KERNELS_HPP_
+#define _MULTI_LANE_HASH_KERNELS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "ProofSystem/MultiLaneHash.hpp"
+
+namespace hashing
+{
+    namespace detail
+    {
+        void Keccak256x4( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests );
+        void Keccak256x8( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests );
+        void Sha256x8( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests );
+        void Sha256x16( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests );
+        void Ripemd160x8( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests );
+        void Ripemd160x16( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests );
+        /**
+         * @brief       SHA-256 compression of whole blocks with the x86 SHA extensions
+         * @param[in,out] state The eight state words
+         * @param[in]   blocks Pointer to @p num_blocks blocks of 64 bytes
+         * @param[in]   num_blocks Number of blocks
+         */
+        void Sha256CompressShaNi( std::uint32_t *state, const std::uint8_t *blocks, std::size_t num_blocks );
+    }
+
+    namespace
+    {
+        constexpr std::size_t KECCAK256_RATE = 136; ///< Rate of Keccak-256 in bytes
+
+        constexpr std::uint64_t KECCAK_ROUND_CONSTANTS[24] = {
+            0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL, 0x000000000000808bULL,
+            0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL, 0x0000000000000088ULL,
+            0x0000000080008009ULL, 0x000000008000000aULL, 0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+            0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+            0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL };
+
+        /// Rotation offset of lane x + 5 * y
+        constexpr unsigned KECCAK_RHO_OFFSETS[25] = { 0,  1,  62, 28, 27, //
+                                                      36, 44, 6,  55, 20, //
+                                                      3,  10, 43, 25, 39, //
+                                                      41, 45, 15, 21, 8,  //
+                                                      18, 2,  61, 56, 14 };
+
+        /// Destination of lane x + 5 * y after the pi step
+        constexpr unsigned KECCAK_PI_TARGETS[25] = { 0,  10, 20, 5,  15, //
+                                                     16, 1,  11, 21, 6,  //
+                                                     7,  17, 2,  12, 22, //
+                                                     23, 8,  18, 3,  13, //
+                                                     14, 24, 9,  19, 4 };
+
+        inline std::uint64_t LoadLE64( const std::uint8_t *p )
+        {
+            std::uint64_t value = 0;
+            for ( int i = 7; i >= 0; --i )
+            {
+                value = ( value << 8 ) | p[i];
+            }
+            return value;
+        }
+
+        inline void StoreLE64( std::uint64_t value, std::uint8_t *p )
+        {
+            for ( int i = 0; i < 8; ++i )
+            {
+                p[i]    = static_cast<std::uint8_t>( value );
+                value >>= 8;
+            }
+        }
+
+        /**
+         * @brief       Keccak-f[1600] over a state of lane vectors
+         * @tparam      Ops Vector operations (Zero, Set1, Xor, AndNotXor, Rotl) over Ops::vec_type
+         */
+        template <typename Ops>
+        inline void KeccakF1600( typename Ops::vec_type *state )
+        {
+            using V = typename Ops::vec_type;
+
+            for ( std::size_t round = 0; round < 24; ++round )
+            {
+                V column[5];
+                for ( std::size_t x = 0; x < 5; ++x )
+                {
+                    column[x] = Ops::Xor( Ops::Xor( Ops::Xor( state[x], state[x + 5] ), Ops::Xor( state[x + 10], state[x + 15] ) ), state[x + 20] );
+                }
+                for ( std::size_t x = 0; x < 5; ++x )
+                {
+                    V d = Ops::Xor( column[( x + 4 ) % 5], Ops::Rotl( column[( x + 1 ) % 5], 1 ) );
+                    for ( std::size_t y = 0; y < 25; y += 5 )
+                    {
+                        state[x + y] = Ops::Xor( state[x + y], d );
+                    }
+                }
+
+                V permuted[25];
+                for ( std::size_t i = 0; i < 25; ++i )
+                {
+                    permuted[KECCAK_PI_TARGETS[i]] = Ops::Rotl( state[i], KECCAK_RHO_OFFSETS[i] );
+                }
+
+                for ( std::size_t y = 0; y < 25; y += 5 )
+                {
+                    for ( std::size_t x = 0; x < 5; ++x )
+                    {
+                        state[x + y] = Ops::AndNotXor( permuted[x + y], permuted[( x + 1 ) % 5 + y], permuted[( x + 2 ) % 5 + y] );
+                    }
+                }
+
+                state[0] = Ops::Xor( state[0], Ops::Set1( KECCAK_ROUND_CONSTANTS[round] ) );
+            }
+        }
+
+        /**
+         * @brief       Keccak-256 of Ops::LANES equally sized buffers
+         * @param[in]   data One pointer per lane
+         * @param[in]   size Size of every buffer
+         * @param[out]  digests One destination per lane
+         */
+        template <typename Ops>
+        inline void Keccak256Lanes( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests )
+        {
+            using V                      = typename Ops::vec_type;
+            constexpr std::size_t LANES  = Ops::LANES;
+            constexpr std::size_t WORDS  = KECCAK256_RATE / 8;
+
+            V state[25];
+            for ( auto &lane : state )
+            {
+                lane = Ops::Zero();
+            }
+
+            auto absorb = [&]( const std::uint8_t *const *blocks )
+            {
+                std::uint64_t words[LANES];
+                for ( std::size_t w = 0; w < WORDS; ++w )
+                {
+                    for ( std::size_t l = 0; l < LANES; ++l )
+                    {
+                        words[l] = LoadLE64( blocks[l] + w * 8 );
+                    }
+                    state[w] = Ops::Xor( state[w], Ops::Load( words ) );
+                }
+                KeccakF1600<Ops>( state );
+            };
+
+            std::size_t         offset = 0;
+            const std::uint8_t *blocks[LANES];
+            for ( ; size - offset >= KECCAK256_RATE; offset += KECCAK256_RATE )
+            {
+                for ( std::size_t l = 0; l < LANES; ++l )
+                {
+                    blocks[l] = data[l] + offset;
+                }
+                absorb( blocks );
+            }
+
+            std::uint8_t last[LANES][KECCAK256_RATE];
+            for ( std::size_t l = 0; l < LANES; ++l )
+            {
+                std::memset( last[l], 0, KECCAK256_RATE );
+                if ( size != offset )
+                {
+                    std::memcpy( last[l], data[l] + offset, size - offset );
+                }
+                last[l][size - offset] ^= 0x01;
+                last[l][KECCAK256_RATE - 1] ^= 0x80;
+                blocks[l] = last[l];
+            }
+            absorb( blocks );
+
+            std::uint64_t words[LANES];
+            for ( std::size_t w = 0; w < KECCAK256_DIGEST_SIZE / 8; ++w )
+            {
+                Ops::Store( state[w], words );
+                for ( std::size_t l = 0; l < LANES; ++l )
+                {
+                    StoreLE64( words[l], digests[l] + w * 8 );
+                }
+            }
+        }
+
+        constexpr std::size_t MD_BLOCK_SIZE = 64; ///< Block size of SHA-256 and RIPEMD-160
+
+        inline std::uint32_t LoadLE32( const std::uint8_t *p )
+        {
+            return static_cast<std::uint32_t>( p[0] ) | ( static_cast<std::uint32_t>( p[1] ) << 8 ) | ( static_cast<std::uint32_t>( p[2] ) << 16 ) |
+                   ( static_cast<std::uint32_t>( p[3] ) << 24 );
+        }
+
+        inline std::uint32_t LoadBE32( const std::uint8_t *p )
+        {
+            return ( static_cast<std::uint32_t>( p[0] ) << 24 ) | ( static_cast<std::uint32_t>( p[1] ) << 16 ) |
+                   ( static_cast<std::uint32_t>( p[2] ) << 8 ) | static_cast<std::uint32_t>( p[3] );
+        }
+
+        inline void StoreLE32( std::uint32_t value, std::uint8_t *p )
+        {
+            for ( int i = 0; i < 4; ++i )
+            {
+                p[i] = static_cast<std::uint8_t>( value >> ( 8 * i ) );
+            }
+        }
+
+        inline void StoreBE32( std::uint32_t value, std::uint8_t *p )
+        {
+            for ( int i = 0; i < 4; ++i )
+            {
+                p[i] = static_cast<std::uint8_t>( value >> ( 24 - 8 * i ) );
+            }
+        }
+
+        constexpr std::uint32_t SHA256_ROUND_CONSTANTS[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be,
+            0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa,
+            0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85,
+            0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+            0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f,
+            0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
+
+        /**
+         * @brief       SHA-256 description for @ref MerkleDamgardLanes
+         */
+        struct Sha256Algo
+        {
+            static constexpr bool          BIG_ENDIAN_WORDS = true;
+            static constexpr std::size_t   STATE_WORDS      = 8;
+            static constexpr std::size_t   DIGEST_WORDS     = 8;
+            static constexpr std::uint32_t IV[STATE_WORDS]  = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                                                0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+            template <typename Ops>
+            static void Compress( typename Ops::vec_type *state, const typename Ops::vec_type *block )
+            {
+                using V = typename Ops::vec_type;
+
+                V w[64];
+                for ( std::size_t t = 0; t < 16; ++t )
+                {
+                    w[t] = block[t];
+                }
+                for ( std::size_t t = 16; t < 64; ++t )
+                {
+                    V s0 = Ops::Xor( Ops::Xor( Ops::Rotr( w[t - 15], 7 ), Ops::Rotr( w[t - 15], 18 ) ), Ops::Shr( w[t - 15], 3 ) );
+                    V s1 = Ops::Xor( Ops::Xor( Ops::Rotr( w[t - 2], 17 ), Ops::Rotr( w[t - 2], 19 ) ), Ops::Shr( w[t - 2], 10 ) );
+                    w[t] = Ops::Add( Ops::Add( w[t - 16], s0 ), Ops::Add( w[t - 7], s1 ) );
+                }
+
+                V a = state[0], b = state[1], c = state[2], d = state[3];
+                V e = state[4], f = state[5], g = state[6], h = state[7];
+                for ( std::size_t t = 0; t < 64; ++t )
+                {
+                    V big_s1 = Ops::Xor( Ops::Xor( Ops::Rotr( e, 6 ), Ops::Rotr( e, 11 ) ), Ops::Rotr( e, 25 ) );
+                    V ch     = Ops::Xor( Ops::And( e, f ), Ops::AndNot( e, g ) );
+                    V t1     = Ops::Add( Ops::Add( h, big_s1 ), Ops::Add( ch, Ops::Add( Ops::Set1( SHA256_ROUND_CONSTANTS[t] ), w[t] ) ) );
+                    V big_s0 = Ops::Xor( Ops::Xor( Ops::Rotr( a, 2 ), Ops::Rotr( a, 13 ) ), Ops::Rotr( a, 22 ) );
+                    V maj    = Ops::Or( Ops::And( a, b ), Ops::And( c, Ops::Or( a, b ) ) );
+                    h        = g;
+                    g        = f;
+                    f        = e;
+                    e        = Ops::Add( d, t1 );
+                    d        = c;
+                    c        = b;
+                    b        = a;
+                    a        = Ops::Add( t1, Ops::Add( big_s0, maj ) );
+                }
+                state[0] = Ops::Add( state[0], a );
+                state[1] = Ops::Add( state[1], b );
+                state[2] = Ops::Add( state[2], c );
+                state[3] = Ops::Add( state[3], d );
+                state[4] = Ops::Add( state[4], e );
+                state[5] = Ops::Add( state[5], f );
+                state[6] = Ops::Add( state[6], g );
+                state[7] = Ops::Add( state[7], h );
+            }
+        };
+
+        /**
+         * @brief       RIPEMD-160 description for @ref MerkleDamgardLanes
+         */
+        struct Ripemd160Algo
+        {
+            static constexpr bool          BIG_ENDIAN_WORDS = false;
+            static constexpr std::size_t   STATE_WORDS      = 5;
+            static constexpr std::size_t   DIGEST_WORDS     = 5;
+            static constexpr std::uint32_t IV[STATE_WORDS]  = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+            static constexpr std::uint32_t LEFT_CONSTANTS[5]  = { 0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e };
+            static constexpr std::uint32_t RIGHT_CONSTANTS[5] = { 0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000 };
+
+            static constexpr std::uint8_t LEFT_WORDS[80] = { 0, 1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, //
+                                                             7, 4,  13, 1,  10, 6,  15, 3,  12, 0,  9,  5,  2,  14, 11, 8,  //
+                                                             3, 10, 14, 4,  9,  15, 8,  1,  2,  7,  0,  6,  13, 11, 5,  12, //
+                                                             1, 9,  11, 10, 0,  8,  12, 4,  13, 3,  7,  15, 14, 5,  6,  2,  //
+                                                             4, 0,  5,  9,  7,  12, 2,  10, 14, 1,  3,  8,  11, 6,  15, 13 };
+
+            static constexpr std::uint8_t RIGHT_WORDS[80] = { 5,  14, 7,  0, 9, 2,  11, 4,  13, 6,  15, 8,  1,  10, 3,  12, //
+                                                              6,  11, 3,  7, 0, 13, 5,  10, 14, 15, 8,  12, 4,  9,  1,  2,  //
+                                                              15, 5,  1,  3, 7, 14, 6,  9,  11, 8,  12, 2,  10, 0,  4,  13, //
+                                                              8,  6,  4,  1, 3, 11, 15, 0,  5,  12, 2,  13, 9,  7,  10, 14, //
+                                                              12, 15, 10, 4, 1, 5,  8,  7,  6,  2,  13, 14, 0,  3,  9,  11 };
+
+            static constexpr std::uint8_t LEFT_SHIFTS[80] = { 11, 14, 15, 12, 5,  8,  7,  9,  11, 13, 14, 15, 6,  7,  9,  8,  //
+                                                              7,  6,  8,  13, 11, 9,  7,  15, 7,  12, 15, 9,  11, 7,  13, 12, //
+                                                              11, 13, 6,  7,  14, 9,  13, 15, 14, 8,  13, 6,  5,  12, 7,  5,  //
+                                                              11, 12, 14, 15, 14, 15, 9,  8,  9,  14, 5,  6,  8,  6,  5,  12, //
+                                                              9,  15, 5,  11, 6,  8,  13, 12, 5,  12, 13, 14, 11, 8,  5,  6 };
+
+            static constexpr std::uint8_t RIGHT_SHIFTS[80] = { 8,  9,  9,  11, 13, 15, 15, 5,  7,  7,  8,  11, 14, 14, 12, 6,  //
+                                                               9,  13, 15, 7,  12, 8,  9,  11, 7,  7,  12, 7,  6,  15, 13, 11, //
+                                                               9,  7,  15, 11, 8,  6,  6,  14, 12, 13, 5,  14, 13, 13, 7,  5,  //
+                                                               15, 5,  8,  11, 14, 14, 6,  14, 6,  9,  12, 9,  12, 5,  15, 8,  //
+                                                               8,  5,  12, 9,  12, 5,  14, 6,  8,  13, 6,  5,  15, 13, 11, 11 };
+
+            template <typename Ops>
+            static typename Ops::vec_type F( std::size_t round, typename Ops::vec_type x, typename Ops::vec_type y, typename Ops::vec_type z )
+            {
+                switch ( round )
+                {
+                    case 0:
+                        return Ops::Xor( Ops::Xor( x, y ), z );
+                    case 1:
+                        return Ops::Or( Ops::And( x, y ), Ops::AndNot( x, z ) );
+                    case 2:
+                        return Ops::Xor( Ops::Or( x, Ops::Not( y ) ), z );
+                    case 3:
+                        return Ops::Or( Ops::And( x, z ), Ops::AndNot( z, y ) );
+                    default:
+                        return Ops::Xor( x, Ops::Or( y, Ops::Not( z ) ) );
+                }
+            }
+
+            template <typename Ops>
+            static void Compress( typename Ops::vec_type *state, const typename Ops::vec_type *block )
+            {
+                using V = typename Ops::vec_type;
+
+                V al = state[0], bl = state[1], cl = state[2], dl = state[3], el = state[4];
+                V ar = al, br = bl, cr = cl, dr = dl, er = el;
+                for ( std::size_t j = 0; j < 80; ++j )
+                {
+                    const std::size_t round = j / 16;
+
+                    V t = Ops::Add( Ops::Add( al, F<Ops>( round, bl, cl, dl ) ), Ops::Add( block[LEFT_WORDS[j]], Ops::Set1( LEFT_CONSTANTS[round] ) ) );
+                    t   = Ops::Add( Ops::Rotl( t, LEFT_SHIFTS[j] ), el );
+                    al  = el;
+                    el  = dl;
+                    dl  = Ops::Rotl( cl, 10 );
+                    cl  = bl;
+                    bl  = t;
+
+                    t  = Ops::Add( Ops::Add( ar, F<Ops>( 4 - round, br, cr, dr ) ), Ops::Add( block[RIGHT_WORDS[j]], Ops::Set1( RIGHT_CONSTANTS[round] ) ) );
+                    t  = Ops::Add( Ops::Rotl( t, RIGHT_SHIFTS[j] ), er );
+                    ar = er;
+                    er = dr;
+                    dr = Ops::Rotl( cr, 10 );
+                    cr = br;
+                    br = t;
+                }
+                V t      = Ops::Add( state[1], Ops::Add( cl, dr ) );
+                state[1] = Ops::Add( state[2], Ops::Add( dl, er ) );
+                state[2] = Ops::Add( state[3], Ops::Add( el, ar ) );
+                state[3] = Ops::Add( state[4], Ops::Add( al, br ) );
+                state[4] = Ops::Add( state[0], Ops::Add( bl, cr ) );
+                state[0] = t;
+            }
+        };
+
+        /**
+         * @brief       Merkle-Damgard hashing (64 byte blocks, 64 bit length) of Ops::LANES equally sized buffers
+         * @tparam      Ops 32 bit lane operations
+         * @tparam      Algo @ref Sha256Algo or @ref Ripemd160Algo
+         */
+        template <typename Ops, typename Algo>
+        inline void MerkleDamgardLanes( const std::uint8_t *const *data, std::size_t size, std::uint8_t *const *digests )
+        {
+            using V                     = typename Ops::vec_type;
+            constexpr std::size_t LANES = Ops::LANES;
+
+            V state[Algo::STATE_WORDS];
+            for ( std::size_t i = 0; i < Algo::STATE_WORDS; ++i )
+            {
+                state[i] = Ops::Set1( Algo::IV[i] );
+            }
+
+            auto compress = [&]( const std::uint8_t *const *blocks )
+            {
+                V             words[16];
+                std::uint32_t lane_words[LANES];
+                for ( std::size_t w = 0; w < 16; ++w )
+                {
+                    for ( std::size_t l = 0; l < LANES; ++l )
+                    {
+                        lane_words[l] = Algo::BIG_ENDIAN_WORDS ? LoadBE32( blocks[l] + 4 * w ) : LoadLE32( blocks[l] + 4 * w );
+                    }
+                    words[w] = Ops::Load( lane_words );
+                }
+                Algo::template Compress<Ops>( state, words );
+            };
+
+            std::size_t         offset = 0;
+            const std::uint8_t *blocks[LANES];
+            for ( ; size - offset >= MD_BLOCK_SIZE; offset += MD_BLOCK_SIZE )
+            {
+                for ( std::size_t l = 0; l < LANES; ++l )
+                {
+                    blocks[l] = data[l] + offset;
+                }
+                compress( blocks );
+            }
+
+            const std::size_t   remaining  = size - offset;
+            const std::size_t   tail_size  = ( remaining + 9 <= MD_BLOCK_SIZE ) ? MD_BLOCK_SIZE : 2 * MD_BLOCK_SIZE;
+            const std::uint64_t bit_length = static_cast<std::uint64_t>( size ) * 8;
+
+            std::uint8_t tail[LANES][2 * MD_BLOCK_SIZE];
+            for ( std::size_t l = 0; l < LANES; ++l )
+            {
+                std::memset( tail[l], 0, tail_size );
+                if ( remaining != 0 )
+                {
+                    std::memcpy( tail[l], data[l] + offset, remaining );
+                }
+                tail[l][remaining] = 0x80;
+                for ( std::size_t i = 0; i < 8; ++i )
+                {
+                    const std::size_t pos = Algo::BIG_ENDIAN_WORDS ? ( tail_size - 1 - i ) : ( tail_size - 8 + i );
+                    tail[l][pos]          = static_cast<std::uint8_t>( bit_length >> ( 8 * i ) );
+                }
+                blocks[l] = tail[l];
+            }
+            compress( blocks );
+            if ( tail_size > MD_BLOCK_SIZE )
+            {
+                for ( std::size_t l = 0; l < LANES; ++l )
+                {
+                    blocks[l] = tail[l] + MD_BLOCK_SIZE;
+                }
+                compress( blocks );
+            }
+
+            std::uint32_t lane_words[LANES];
+            for ( std::size_t w = 0; w < Algo::DIGEST_WORDS; ++w )
+            {
+                Ops::Store( state[w], lane_words );
+                for ( std::size_t l = 0; l < LANES; ++l )
+                {
+                    if ( Algo::BIG_ENDIAN_WORDS )
+                    {
+                        StoreBE32( lane_words[l], digests[l] + 4 * w );
+                    }
+                    else
+                    {
+                        StoreLE32( lane_words[l], digests[l] + 4 * w );
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file       MultiLaneHashSHANI.cpp
+ * @brief      SHA-256 compression with the x86 SHA extensions, only called after runtime detection
+ * @date       2024-03-07
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include "MultiLaneHashKernels.hpp"
+
+#include <immintrin.h>
+
+namespace hashing
+{
+    namespace detail
+    {
+        void Sha256CompressShaNi( std::uint32_t *state, const std::uint8_t *blocks, std::size_t num_blocks )
+        {
+            const __m128i byte_swap = _mm_set_epi64x( 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL );
+
+            // The instructions work on the ABEF / CDGH halves of the state
+            __m128i tmp    = _mm_shuffle_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i *>( state ) ), 0xB1 );
+            __m128i state1 = _mm_shuffle_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i *>( state + 4 ) ), 0x1B );
+            __m128i state0 = _mm_alignr_epi8( tmp, state1, 8 );
+            state1         = _mm_blend_epi16( state1, tmp, 0xF0 );
+
+            for ( ; num_blocks != 0; --num_blocks, blocks += MD_BLOCK_SIZE )
+            {
+                const __m128i saved0 = state0;
+                const __m128i saved1 = state1;
+
+                __m128i message[4];
+                for ( std::size_t i = 0; i < 4; ++i )
+                {
+                    message[i] = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i *>( blocks + 16 * i ) ), byte_swap );
+                }
+
+                for ( std::size_t group = 0; group < 16; ++group )
+                {
+                    const __m128i &current = message[group % 4];
+
+                    __m128i words = _mm_add_epi32(
+                        current, _mm_loadu_si128( reinterpret_cast<const __m128i *>( SHA256_ROUND_CONSTANTS + 4 * group ) ) );
+                    state1 = _mm_sha256rnds2_epu32( state1, state0, words );
+                    words  = _mm_shuffle_epi32( words, 0x0E );
+                    state0 = _mm_sha256rnds2_epu32( state0, state1, words );
+
+                    __m128i &previous = message[( group + 3 ) % 4];
+                    if ( group >= 3 && group < 15 )
+                    {
+                        // Completes the words of the next group, which already went through msg1
+                        __m128i &next = message[( group + 1 ) % 4];
+                        next          = _mm_add_epi32( next, _mm_alignr_epi8( current, previous, 4 ) );
+                        next          = _mm_sha256msg2_epu32( next, current );
+                    }
+                    if ( group >= 1 && group < 13 )
+                    {
+                        // Starts the words of the group three steps ahead
+                        previous = _mm_sha256msg1_epu32( previous, current );
+                    }
+                }
+
+                state0 = _mm_add_epi32( state0, saved0 );
+                state1 = _mm_add_epi32( state1, saved1 );
+            }
+
+            tmp    = _mm_shuffle_epi32( state0, 0x1B );
+            state1 = _mm_shuffle_epi32( state1, 0xB1 );
+            state0 = _mm_blend_epi16( tmp, state1, 0xF0 );
+            state1 = _mm_alignr_epi8( state1, tmp, 8 );
+
+            _mm_storeu_si128( reinterpret_cast<__m128i *>( state ), state0 );
+            _mm_storeu_si128( reinterpret_cast<__m128i *>( state + 4 ), state1 );
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #include <ProofSystem/PrimeNumbers.hpp>
-
-#include <random>
+#include <ProofSystem/Metrics.hpp>
+#include <ProofSystem/SecureRandom.hpp>
+#include <ProofSystem/ArenaAllocator.hpp>
+#include <ProofSystem/ParallelFor.hpp>
 
 bool PrimeNumbers::GetGeneratorFromPrime( std::size_t max_attempts, cpp_int prime_number, cpp_int &out_val )
 {
@@ -23,45 +25,49 @@ bool PrimeNumbers::GetGeneratorFromPrime( std::size_t max_attempts, cpp_int prim
 
 PrimeNumbers::cpp_int PrimeNumbers::GetRandomNumber( const PrimeNumbers::cpp_int &prime_number )
 {
-    std::random_device                               rd;
-    std::mt19937                                     engine( rd() ); // Seed with hardware entropy
-    boost::random::uniform_int_distribution<cpp_int> dist( 2, prime_number - 1 );
-    return dist( engine );
+    return csprng::RandomInRange( 2, prime_number - 1 );
 }
 
 PrimeNumbers::cpp_int PrimeNumbers::ModInverseEuclideanDivision( cpp_int x, cpp_int prime )
 {
-    cpp_int original_prime = prime;
-    cpp_int r              = 0;
-    cpp_int r_new          = 1;
-
-    if ( gcd( x, prime ) != 1 )
-    {
-        throw std::runtime_error( "x and prime are not co-primes" );
-    }
+    arena::Scope   scope;
+    arena::cpp_int a         = x;
+    arena::cpp_int b         = prime;
+    arena::cpp_int r         = 0;
+    arena::cpp_int r_new     = 1;
+    arena::cpp_int quotient  = 0;
+    arena::cpp_int remainder = 0;
 
-    while ( x != 0 )
+    while ( a != 0 )
     {
-        cpp_int quotient  = prime / x;
-        cpp_int remainder = prime % x;
+        quotient  = b / a;
+        remainder = b % a;
 
         std::swap( r, r_new );
         r_new -= quotient * r;
 
-        prime = x;
-        x     = remainder;
+        std::swap( a, b );
+        std::swap( a, remainder );
     }
 
+    // The loop ends with gcd( x, prime ) in b
+    if ( b != 1 )
+    {
+        throw std::runtime_error( "x and prime are not co-primes" );
+    }
     if ( r < 0 )
     {
-        r += original_prime;
+        r += arena::cpp_int( prime );
     }
 
-    return r;
+    return cpp_int( r );
 }
 
-PrimeNumbers::cpp_int PrimeNumbers::SqrtMod( const PrimeNumbers::cpp_int &number, const PrimeNumbers::cpp_int &prime )
+PrimeNumbers::cpp_int PrimeNumbers::SqrtMod( const PrimeNumbers::cpp_int &number_value, const PrimeNumbers::cpp_int &prime_value )
 {
+    arena::Scope         scope;
+    const arena::cpp_int number = number_value;
+    const arena::cpp_int prime  = prime_value;
 
     if ( powm( number, ( prime - 1 ) / 2, prime ) != 1 )
     {
@@ -72,45 +78,56 @@ PrimeNumbers::cpp_int PrimeNumbers::SqrtMod( const PrimeNumbers::cpp_int &number
     // Special case: prime ≡ 3 (mod 4)
     if ( prime % 4 == 3 )
     {
-        return powm( number, ( prime + 1 ) / 4, prime );
+        return PrimeNumbers::cpp_int( powm( number, ( prime + 1 ) / 4, prime ) );
     }
 
     // Tonelli-Shanks algorithm for general primes
-    PrimeNumbers::cpp_int q = prime - 1;
-    PrimeNumbers::cpp_int s = 0;
+    arena::cpp_int q = prime - 1;
+    arena::cpp_int s = 0;
     while ( q % 2 == 0 )
     {
         s += 1;
         q /= 2;
     }
 
-    PrimeNumbers::cpp_int z = 2;
+    arena::cpp_int z = 2;
     while ( powm( z, ( prime - 1 ) / 2, prime ) == 1 )
     {
         z++;
     }
 
+    // The values carried from one pass to the next stay on the heap, so each pass rewinds its own temporaries.
+    // Reassigning an arena value would free its old limbs out of order, and the arena would grow on every pass
+
     // Find the first quadratic non-residue z by brute-force search
-    PrimeNumbers::cpp_int c = powm( z, q, prime );
-    PrimeNumbers::cpp_int r = powm( number, ( q + 1 ) / 2, prime );
-    PrimeNumbers::cpp_int t = powm( number, q, prime );
-    PrimeNumbers::cpp_int m = s;
+    PrimeNumbers::cpp_int c = PrimeNumbers::cpp_int( powm( z, q, prime ) );
+    PrimeNumbers::cpp_int r = PrimeNumbers::cpp_int( powm( number, ( q + 1 ) / 2, prime ) );
+    PrimeNumbers::cpp_int t = PrimeNumbers::cpp_int( powm( number, q, prime ) );
+    PrimeNumbers::cpp_int m = PrimeNumbers::cpp_int( s );
 
     while ( t != 1 )
     {
-        PrimeNumbers::cpp_int i    = 0;
-        PrimeNumbers::cpp_int temp = t;
-        while ( temp != 1 && i < m )
+        arena::Scope         pass_scope;
+        const arena::cpp_int c_value = c;
+        const arena::cpp_int t_value = t;
+        const arena::cpp_int m_value = m;
+
+        arena::cpp_int i    = 0;
+        arena::cpp_int temp = t_value;
+        while ( temp != 1 && i < m_value )
         {
             temp = powm( temp, 2, prime );
             i++;
         }
 
-        PrimeNumbers::cpp_int b = powm( c, PrimeNumbers::cpp_int( 1 << static_cast<uint64_t>( m - i - 1 ) ), prime );
-        r                       = ( r * b ) % prime;
-        t                       = ( t * b * b ) % prime;
-        c                       = ( b * b ) % prime;
-        m                       = i;
+        const arena::cpp_int b      = powm( c_value, arena::cpp_int( 1 << static_cast<uint64_t>( m_value - i - 1 ) ), prime );
+        const arena::cpp_int next_r = ( arena::cpp_int( r ) * b ) % prime;
+        const arena::cpp_int next_t = ( t_value * b * b ) % prime;
+        const arena::cpp_int next_c = ( b * b ) % prime;
+        r                           = next_r;
+        t                           = next_t;
+        c                           = next_c;
+        m                           = i;
     }
 
     return r;
@@ -127,29 +144,118 @@ PrimeNumbers::cpp_int PrimeNumbers::PowHighPrec( const PrimeNumbers::cpp_int &va
 }
 
 PrimeNumbers::BabyStepGiantStep::BabyStepGiantStep( const PrimeNumbers::cpp_int &prime, const PrimeNumbers::cpp_int &generator ) :
-    prime_number( prime )
+    prime_number( prime ),                                                 //
+    step_size( static_cast<PrimeNumbers::cpp_int>( pow( 2, 16 ) + 1 ) ),   //
+    g_n_inv( powm( generator, step_size * ( prime - 2 ), prime_number ) ), //
+    value_table( BuildTable( prime_number, generator, step_size ) )
 {
-    step_size = static_cast<PrimeNumbers::cpp_int>( pow( 2, 16 ) + 1 );
-    for ( PrimeNumbers::cpp_int i = 0; i < step_size; ++i )
+}
+
+PrimeNumbers::BabyStepGiantStep::Table_t PrimeNumbers::BabyStepGiantStep::BuildTable( const PrimeNumbers::cpp_int &prime,
+                                                                                      const PrimeNumbers::cpp_int &generator,
+                                                                                      const PrimeNumbers::cpp_int &step_size )
+{
+    PROOFSYSTEM_SCOPED_TIMER( "bsgs_build_seconds" );
+
+    // The powers are computed in parallel, each range starting from its own generator^begin
+    const auto                         num_steps = static_cast<std::size_t>( step_size );
+    std::vector<PrimeNumbers::cpp_int> values( num_steps );
+    util::ParallelFor( num_steps,
+                       [&]( std::size_t begin, std::size_t end )
+                       {
+                           PrimeNumbers::cpp_int value = powm( generator, PrimeNumbers::cpp_int( begin ), prime );
+                           for ( std::size_t i = begin; i < end; ++i )
+                           {
+                               values[i] = value;
+                               value     = ( value * generator ) % prime;
+                           }
+                       } );
+
+    // Inserted in order, so a repeated value keeps its smallest exponent
+    Table_t table;
+    table.reserve( num_steps );
+    for ( std::size_t i = 0; i < num_steps; ++i )
     {
-        PrimeNumbers::cpp_int value = powm( generator, i, prime_number );
-        value_table[value]          = i;
+        table.emplace( std::move( values[i] ), i );
     }
+    return table;
+}
 
-    g_n_inv = powm( generator, step_size * ( prime - 2 ), prime_number );
+std::optional<PrimeNumbers::cpp_int> PrimeNumbers::BabyStepGiantStep::Lookup( const PrimeNumbers::cpp_int &value ) const
+{
+    // find, never operator[], which would insert into the shared table
+    const auto entry = value_table.find( value );
+    if ( entry == value_table.end() )
+    {
+        return std::nullopt;
+    }
+    return entry->second;
 }
 
-PrimeNumbers::cpp_int PrimeNumbers::BabyStepGiantStep::SolveECDLP( const PrimeNumbers::cpp_int &number )
+PrimeNumbers::cpp_int PrimeNumbers::BabyStepGiantStep::SolveECDLP( const PrimeNumbers::cpp_int &number ) const
 {
-    for ( PrimeNumbers::cpp_int i = 0, cur = number % prime_number; i <= step_size; ++i )
+    PROOFSYSTEM_SCOPED_TIMER( "bsgs_solve_seconds" );
+
+    // The current value is kept in the heap lookup key, which keeps its capacity from one step to the next.
+    // Each step rewinds its arena temporaries, so the arena stays the same size however many steps run
+    arena::Scope          scope;
+    const arena::cpp_int  prime      = prime_number;
+    const arena::cpp_int  giant_step = g_n_inv;
+    PrimeNumbers::cpp_int lookup_key = number % prime_number;
+
+    for ( PrimeNumbers::cpp_int i = 0; i <= step_size; ++i )
     {
-        if ( value_table.find( cur ) != value_table.end() )
+        if ( const auto baby_step = Lookup( lookup_key ) )
         {
-            return i * step_size + value_table[cur];
+            PROOFSYSTEM_HISTOGRAM_OBSERVE( "bsgs_solve_giant_steps", i );
+            return i * step_size + *baby_step;
         }
-        cur = ( cur * g_n_inv ) % prime_number;
+        arena::Scope         step_scope;
+        const arena::cpp_int cur  = lookup_key;
+        const arena::cpp_int next = ( cur * giant_step ) % prime;
+        lookup_key                = next;
     }
 
     // If no solution was found
     throw std::runtime_error( "No ECDLP solution found" );
 }
+
+PrimeNumbers::FixedBaseExponentiation::FixedBaseExponentiation( const PrimeNumbers::cpp_int &base, const PrimeNumbers::cpp_int &prime,
+                                                                std::size_t exponent_bits ) :
+    prime_number( prime ), num_windows( ( exponent_bits + WINDOW_BITS - 1 ) / WINDOW_BITS )
+{
+    table.resize( num_windows * WINDOW_SIZE );
+
+    PrimeNumbers::cpp_int window_base = base % prime_number;
+    for ( std::size_t w = 0; w < num_windows; ++w )
+    {
+        auto *window = &table[w * WINDOW_SIZE];
+        window[0]    = 1;
+        for ( std::size_t d = 1; d < WINDOW_SIZE; ++d )
+        {
+            window[d] = ( window[d - 1] * window_base ) % prime_number;
+        }
+        window_base = ( window[WINDOW_SIZE - 1] * window_base ) % prime_number;
+    }
+}
+
+PrimeNumbers::cpp_int PrimeNumbers::FixedBaseExponentiation::Pow( const PrimeNumbers::cpp_int &exponent ) const
+{
+    if ( exponent < 0 || ( exponent >> ( num_windows * WINDOW_BITS ) ) != 0 )
+    {
+        throw std::out_of_range( "Exponent bigger than the precomputed table" );
+    }
+
+    PrimeNumbers::cpp_int result    = 1;
+    PrimeNumbers::cpp_int remaining = exponent;
+    for ( std::size_t w = 0; w < num_windows && remaining != 0; ++w )
+    {
+        auto digit = static_cast<std::size_t>( remaining & ( WINDOW_SIZE - 1 ) );
+        if ( digit != 0 )
+        {
+            result = ( result * table[w * WINDOW_SIZE + digit] ) % prime_number;
+        }
+        remaining >>= WINDOW_BITS;
+    }
+    return result;
+}
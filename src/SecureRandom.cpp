@@ -0,0 +1,257 @@
+/**
+ * @file       SecureRandom.cpp
+ * @brief      ChaCha20 block function and the per thread generator
+ * @date       2024-03-26
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include "ProofSystem/SecureRandom.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+namespace csprng
+{
+    namespace
+    {
+        constexpr std::uint32_t CHACHA20_CONSTANTS[4] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 }; ///< "expand 32-byte k"
+
+        inline std::uint32_t RotateLeft( std::uint32_t value, int shift )
+        {
+            return ( value << shift ) | ( value >> ( 32 - shift ) );
+        }
+
+        inline std::uint32_t LoadLE32( const std::uint8_t *bytes )
+        {
+            return static_cast<std::uint32_t>( bytes[0] ) | ( static_cast<std::uint32_t>( bytes[1] ) << 8 ) |
+                   ( static_cast<std::uint32_t>( bytes[2] ) << 16 ) | ( static_cast<std::uint32_t>( bytes[3] ) << 24 );
+        }
+
+        inline void StoreLE32( std::uint32_t value, std::uint8_t *bytes )
+        {
+            bytes[0] = static_cast<std::uint8_t>( value );
+            bytes[1] = static_cast<std::uint8_t>( value >> 8 );
+            bytes[2] = static_cast<std::uint8_t>( value >> 16 );
+            bytes[3] = static_cast<std::uint8_t>( value >> 24 );
+        }
+
+        inline void QuarterRound( std::uint32_t *x, int a, int b, int c, int d )
+        {
+            x[a] += x[b];
+            x[d] = RotateLeft( x[d] ^ x[a], 16 );
+            x[c] += x[d];
+            x[b] = RotateLeft( x[b] ^ x[c], 12 );
+            x[a] += x[b];
+            x[d] = RotateLeft( x[d] ^ x[a], 8 );
+            x[c] += x[d];
+            x[b] = RotateLeft( x[b] ^ x[c], 7 );
+        }
+
+        /**
+         * @brief       Overwrites key material in a way the optimizer can't drop
+         */
+        void SecureWipe( std::uint8_t *data, std::size_t size )
+        {
+            volatile std::uint8_t *bytes = data;
+            for ( std::size_t i = 0; i < size; ++i )
+            {
+                bytes[i] = 0;
+            }
+        }
+
+        void FillFromOS( std::uint8_t *out, std::size_t size )
+        {
+            std::random_device entropy;
+            for ( std::size_t i = 0; i < size; i += sizeof( std::uint32_t ) )
+            {
+                std::uint8_t word[sizeof( std::uint32_t )];
+                StoreLE32( entropy(), word );
+                std::copy( word, word + std::min( sizeof( word ), size - i ), out + i );
+            }
+        }
+
+        std::atomic<std::uint64_t> fork_count{ 0 }; ///< Forks this process came out of, as a child
+
+        void OnForkChild()
+        {
+            fork_count.fetch_add( 1, std::memory_order_relaxed );
+        }
+
+        /**
+         * @brief       Returns how many forks the process came out of
+         * @details     A forked child gets a copy of every generator, key and buffered output included.
+         *              Generators compare this count with the one they were seeded under and reseed
+         *              when it changed, so parent and child never hand out the same bytes.
+         */
+        std::uint64_t ForkCount()
+        {
+#ifndef _WIN32
+            static const bool registered = pthread_atfork( nullptr, nullptr, OnForkChild ) == 0;
+            if ( !registered )
+            {
+                throw std::runtime_error( "Can't register the fork handler of the random generator" );
+            }
+#endif
+            return fork_count.load( std::memory_order_relaxed );
+        }
+    }
+
+    void ChaCha20Block( const std::uint8_t *key, std::uint32_t counter, const std::uint8_t *nonce, std::uint8_t *block )
+    {
+        std::uint32_t input[16];
+        std::copy( std::begin( CHACHA20_CONSTANTS ), std::end( CHACHA20_CONSTANTS ), input );
+        for ( int i = 0; i < 8; ++i )
+        {
+            input[4 + i] = LoadLE32( key + 4 * i );
+        }
+        input[12] = counter;
+        for ( int i = 0; i < 3; ++i )
+        {
+            input[13 + i] = LoadLE32( nonce + 4 * i );
+        }
+
+        std::uint32_t x[16];
+        std::copy( input, input + 16, x );
+        for ( int round = 0; round < 10; ++round )
+        {
+            QuarterRound( x, 0, 4, 8, 12 );
+            QuarterRound( x, 1, 5, 9, 13 );
+            QuarterRound( x, 2, 6, 10, 14 );
+            QuarterRound( x, 3, 7, 11, 15 );
+            QuarterRound( x, 0, 5, 10, 15 );
+            QuarterRound( x, 1, 6, 11, 12 );
+            QuarterRound( x, 2, 7, 8, 13 );
+            QuarterRound( x, 3, 4, 9, 14 );
+        }
+        for ( int i = 0; i < 16; ++i )
+        {
+            StoreLE32( x[i] + input[i], block + 4 * i );
+        }
+    }
+
+    ChaCha20Rng::ChaCha20Rng() : position( BUFFER_SIZE ), auto_reseed( true ), seed_fork_count( ForkCount() )
+    {
+        FillFromOS( key.data(), key.size() );
+    }
+
+    ChaCha20Rng::ChaCha20Rng( const std::array<std::uint8_t, CHACHA20_KEY_SIZE> &seed ) :
+        key( seed ),             //
+        position( BUFFER_SIZE ), //
+        auto_reseed( false )
+    {
+    }
+
+    ChaCha20Rng::~ChaCha20Rng()
+    {
+        SecureWipe( key.data(), key.size() );
+        SecureWipe( buffer.data(), buffer.size() );
+    }
+
+    ChaCha20Rng::result_type ChaCha20Rng::operator()()
+    {
+        std::uint8_t bytes[sizeof( result_type )];
+        Fill( bytes, sizeof( bytes ) );
+
+        result_type value = 0;
+        for ( std::size_t i = 0; i < sizeof( bytes ); ++i )
+        {
+            value |= static_cast<result_type>( bytes[i] ) << ( 8 * i );
+        }
+        return value;
+    }
+
+    void ChaCha20Rng::Fill( std::uint8_t *out, std::size_t size )
+    {
+        if ( auto_reseed && seed_fork_count != ForkCount() )
+        {
+            // Forked child, the key and the buffer are the parent's copy
+            seed_fork_count = ForkCount();
+            Reseed();
+        }
+        while ( size > 0 )
+        {
+            if ( position == BUFFER_SIZE )
+            {
+                Refill();
+            }
+            const std::size_t chunk = std::min( size, BUFFER_SIZE - position );
+            std::copy( buffer.data() + position, buffer.data() + position + chunk, out );
+            // Spent output is erased right away, like the key it came from
+            SecureWipe( buffer.data() + position, chunk );
+            position += chunk;
+            out += chunk;
+            size -= chunk;
+        }
+    }
+
+    void ChaCha20Rng::Reseed()
+    {
+        std::array<std::uint8_t, CHACHA20_KEY_SIZE> fresh;
+        FillFromOS( fresh.data(), fresh.size() );
+        for ( std::size_t i = 0; i < key.size(); ++i )
+        {
+            key[i] ^= fresh[i];
+        }
+        SecureWipe( fresh.data(), fresh.size() );
+        SecureWipe( buffer.data(), buffer.size() );
+        position         = BUFFER_SIZE;
+        bytes_since_seed = 0;
+    }
+
+    void ChaCha20Rng::Refill()
+    {
+        if ( auto_reseed && bytes_since_seed >= RESEED_INTERVAL )
+        {
+            Reseed();
+        }
+        // Every refill runs under a new key, so the counter and nonce can start over
+        const std::uint8_t nonce[CHACHA20_NONCE_SIZE] = {};
+        for ( std::size_t i = 0; i < BUFFER_BLOCKS; ++i )
+        {
+            ChaCha20Block( key.data(), static_cast<std::uint32_t>( i ), nonce, buffer.data() + i * CHACHA20_BLOCK_SIZE );
+        }
+        std::copy( buffer.begin(), buffer.begin() + CHACHA20_KEY_SIZE, key.begin() );
+        SecureWipe( buffer.data(), CHACHA20_KEY_SIZE );
+        position = CHACHA20_KEY_SIZE;
+        bytes_since_seed += BUFFER_SIZE - CHACHA20_KEY_SIZE;
+    }
+
+    ChaCha20Rng &ThreadRng()
+    {
+        thread_local ChaCha20Rng rng;
+        return rng;
+    }
+
+    ecbatch::cpp_int RandomBelow( const ecbatch::cpp_int &bound )
+    {
+        if ( bound <= 0 )
+        {
+            throw std::runtime_error( "Random bound must be positive" );
+        }
+        const std::size_t   bits     = msb( bound ) + 1;
+        const std::size_t   words    = ( bits + 63 ) / 64;
+        const std::size_t   top_bits = bits - ( words - 1 ) * 64;
+        const std::uint64_t top_mask = top_bits == 64 ? ~std::uint64_t( 0 ) : ( std::uint64_t( 1 ) << top_bits ) - 1;
+        ChaCha20Rng        &rng      = ThreadRng();
+
+        // Rejection sampling over the bit length of the bound, less than two draws on average
+        while ( true )
+        {
+            ecbatch::cpp_int value = rng() & top_mask;
+            for ( std::size_t i = 1; i < words; ++i )
+            {
+                value = ( value << 64 ) | ecbatch::cpp_int( rng() );
+            }
+            if ( value < bound )
+            {
+                return value;
+            }
+        }
+    }
+}
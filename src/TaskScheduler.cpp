@@ -0,0 +1,350 @@
+/**
+ * @file       TaskScheduler.cpp
+ * @brief      Work stealing thread pool shared by the parallel paths of the library
+ * @date       2024-04-01
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include <ProofSystem/TaskScheduler.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <string>
+
+#if defined( _WIN32 )
+#define NOMINMAX
+#include <windows.h>
+#elif defined( __linux__ )
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+namespace util
+{
+    namespace
+    {
+        struct Cpu
+        {
+            std::size_t id;
+            std::size_t node;
+        };
+
+        thread_local const TaskScheduler *current_scheduler = nullptr; ///< Scheduler of the calling worker, if any
+        thread_local std::size_t          current_index     = 0;       ///< Index of the calling worker
+
+#if defined( __linux__ )
+        /**
+         * @brief       Parses a sysfs CPU list such as "0-3,8-11"
+         */
+        std::vector<std::size_t> ParseCpuList( const char *text )
+        {
+            std::vector<std::size_t> cpus;
+            const char              *cursor = text;
+            while ( *cursor != '\0' && *cursor != '\n' )
+            {
+                char             *end   = nullptr;
+                const std::size_t first = std::strtoul( cursor, &end, 10 );
+                std::size_t       last  = first;
+                if ( end == cursor )
+                {
+                    break;
+                }
+                if ( *end == '-' )
+                {
+                    cursor = end + 1;
+                    last   = std::strtoul( cursor, &end, 10 );
+                }
+                for ( std::size_t cpu = first; cpu <= last; ++cpu )
+                {
+                    cpus.push_back( cpu );
+                }
+                cursor = *end == ',' ? end + 1 : end;
+            }
+            return cpus;
+        }
+
+        /**
+         * @brief       NUMA node of every CPU, empty if the kernel doesn't expose them
+         */
+        std::vector<std::size_t> ReadCpuNodes()
+        {
+            std::vector<std::size_t> cpu_nodes;
+            DIR                     *nodes_dir = opendir( "/sys/devices/system/node" );
+            if ( nodes_dir == nullptr )
+            {
+                return cpu_nodes;
+            }
+            while ( const dirent *entry = readdir( nodes_dir ) )
+            {
+                unsigned node   = 0;
+                char     suffix = 0;
+                if ( std::sscanf( entry->d_name, "node%u%c", &node, &suffix ) != 1 )
+                {
+                    continue;
+                }
+                const std::string path = std::string( "/sys/devices/system/node/" ) + entry->d_name + "/cpulist";
+                std::FILE        *file = std::fopen( path.c_str(), "r" );
+                if ( file == nullptr )
+                {
+                    continue;
+                }
+                char text[4096] = {};
+                if ( std::fgets( text, sizeof( text ), file ) != nullptr )
+                {
+                    for ( const auto cpu : ParseCpuList( text ) )
+                    {
+                        cpu_nodes.resize( std::max( cpu_nodes.size(), cpu + 1 ), 0 );
+                        cpu_nodes[cpu] = node;
+                    }
+                }
+                std::fclose( file );
+            }
+            closedir( nodes_dir );
+            return cpu_nodes;
+        }
+
+        std::vector<Cpu> GetProcessCpus()
+        {
+            std::vector<Cpu> cpus;
+            cpu_set_t        mask;
+            CPU_ZERO( &mask );
+            if ( sched_getaffinity( 0, sizeof( mask ), &mask ) != 0 )
+            {
+                return cpus;
+            }
+            const auto cpu_nodes = ReadCpuNodes();
+            for ( std::size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu )
+            {
+                if ( CPU_ISSET( cpu, &mask ) )
+                {
+                    cpus.push_back( { cpu, cpu < cpu_nodes.size() ? cpu_nodes[cpu] : 0 } );
+                }
+            }
+            return cpus;
+        }
+
+        void PinCurrentThread( std::size_t cpu )
+        {
+            cpu_set_t mask;
+            CPU_ZERO( &mask );
+            CPU_SET( cpu, &mask );
+            // Best effort, a worker that can't be pinned still runs
+            sched_setaffinity( 0, sizeof( mask ), &mask );
+        }
+#elif defined( _WIN32 )
+        std::vector<Cpu> GetProcessCpus()
+        {
+            std::vector<Cpu> cpus;
+            DWORD_PTR        process_mask = 0;
+            DWORD_PTR        system_mask  = 0;
+            if ( !GetProcessAffinityMask( GetCurrentProcess(), &process_mask, &system_mask ) )
+            {
+                return cpus;
+            }
+            // Only the processor group of the process, up to 64 CPUs
+            for ( std::size_t cpu = 0; cpu < 8 * sizeof( DWORD_PTR ); ++cpu )
+            {
+                if ( process_mask & ( DWORD_PTR( 1 ) << cpu ) )
+                {
+                    UCHAR node = 0;
+                    GetNumaProcessorNode( static_cast<UCHAR>( cpu ), &node );
+                    cpus.push_back( { cpu, node == 0xFF ? 0 : static_cast<std::size_t>( node ) } );
+                }
+            }
+            return cpus;
+        }
+
+        void PinCurrentThread( std::size_t cpu )
+        {
+            SetThreadAffinityMask( GetCurrentThread(), DWORD_PTR( 1 ) << cpu );
+        }
+#else
+        std::vector<Cpu> GetProcessCpus()
+        {
+            return {};
+        }
+
+        void PinCurrentThread( std::size_t )
+        {
+            // No portable affinity API, the workers stay where the OS puts them
+        }
+#endif
+
+        std::mutex                executor_mutex; ///< Protects the executor
+        std::shared_ptr<Executor> executor;       ///< Set by SetExecutor or created on first use
+    }
+
+    TaskScheduler::TaskScheduler() : TaskScheduler( Options{} )
+    {
+    }
+
+    TaskScheduler::TaskScheduler( const Options &options ) :
+        num_nodes( 1 ),  //
+        next_queue( 0 ), //
+        pending( 0 ),    //
+        stopping( false )
+    {
+        auto cpus = GetProcessCpus();
+        if ( cpus.empty() )
+        {
+            for ( std::size_t cpu = 0; cpu < std::max<std::size_t>( 1, std::thread::hardware_concurrency() ); ++cpu )
+            {
+                cpus.push_back( { cpu, 0 } );
+            }
+        }
+        const std::size_t num_threads = options.num_threads != 0 ? options.num_threads : cpus.size();
+
+        std::set<std::size_t> nodes;
+        workers.reserve( num_threads );
+        for ( std::size_t i = 0; i < num_threads; ++i )
+        {
+            auto worker  = std::make_unique<Worker>();
+            worker->cpu  = cpus[i % cpus.size()].id;
+            worker->node = cpus[i % cpus.size()].node;
+            nodes.insert( worker->node );
+            workers.push_back( std::move( worker ) );
+        }
+        num_nodes = nodes.size();
+
+        // Ring order from each worker, the workers of the same node first
+        for ( std::size_t i = 0; i < num_threads; ++i )
+        {
+            auto &victims = workers[i]->victims;
+            for ( std::size_t offset = 1; offset < num_threads; ++offset )
+            {
+                victims.push_back( ( i + offset ) % num_threads );
+            }
+            if ( options.numa_aware )
+            {
+                std::stable_partition( victims.begin(), victims.end(),
+                                       [this, i]( std::size_t victim ) { return workers[victim]->node == workers[i]->node; } );
+            }
+        }
+
+        for ( std::size_t i = 0; i < num_threads; ++i )
+        {
+            workers[i]->thread = std::thread(
+                [this, i, pin = options.pin_threads]()
+                {
+                    if ( pin )
+                    {
+                        PinCurrentThread( workers[i]->cpu );
+                    }
+                    WorkerLoop( i );
+                } );
+        }
+    }
+
+    TaskScheduler::~TaskScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock( sleep_mutex );
+            stopping = true;
+        }
+        wake.notify_all();
+        for ( auto &worker : workers )
+        {
+            worker->thread.join();
+        }
+    }
+
+    void TaskScheduler::Execute( std::function<void()> task )
+    {
+        // Workers keep their own tasks local, the others spread theirs
+        const std::size_t index = current_scheduler == this ? current_index : next_queue.fetch_add( 1, std::memory_order_relaxed ) % workers.size();
+        {
+            // Counted before the push, so the decrement of the worker that pops it can't come first and wrap.
+            // Under the mutex, so a worker checking for work before it sleeps can't miss the increment
+            std::lock_guard<std::mutex> lock( sleep_mutex );
+            pending.fetch_add( 1, std::memory_order_release );
+        }
+        {
+            std::lock_guard<std::mutex> lock( workers[index]->mutex );
+            workers[index]->tasks.push_back( std::move( task ) );
+        }
+        wake.notify_one();
+    }
+
+    bool TaskScheduler::FindTask( std::size_t index, std::function<void()> &task )
+    {
+        {
+            Worker                     &own = *workers[index];
+            std::lock_guard<std::mutex> lock( own.mutex );
+            if ( !own.tasks.empty() )
+            {
+                task = std::move( own.tasks.back() );
+                own.tasks.pop_back();
+                pending.fetch_sub( 1, std::memory_order_acq_rel );
+                return true;
+            }
+        }
+        for ( const auto victim_index : workers[index]->victims )
+        {
+            Worker                     &victim = *workers[victim_index];
+            std::lock_guard<std::mutex> lock( victim.mutex );
+            if ( !victim.tasks.empty() )
+            {
+                task = std::move( victim.tasks.front() );
+                victim.tasks.pop_front();
+                pending.fetch_sub( 1, std::memory_order_acq_rel );
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void TaskScheduler::WorkerLoop( std::size_t index )
+    {
+        current_scheduler = this;
+        current_index     = index;
+
+        std::function<void()> task;
+        while ( true )
+        {
+            if ( FindTask( index, task ) )
+            {
+                try
+                {
+                    task();
+                }
+                catch ( ... )
+                {
+                    // Tasks report their own errors, one that escapes must not take the worker down
+                }
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock( sleep_mutex );
+            wake.wait( lock, [this]() { return stopping || pending.load( std::memory_order_acquire ) != 0; } );
+            if ( stopping && pending.load( std::memory_order_acquire ) == 0 )
+            {
+                // Queued work is drained first, including tasks queued by the last running ones
+                return;
+            }
+        }
+    }
+
+    std::shared_ptr<Executor> GetExecutor()
+    {
+        std::lock_guard<std::mutex> lock( executor_mutex );
+        if ( !executor )
+        {
+            executor = std::make_shared<TaskScheduler>();
+        }
+        return executor;
+    }
+
+    void SetExecutor( std::shared_ptr<Executor> new_executor )
+    {
+        std::shared_ptr<Executor> previous;
+        {
+            std::lock_guard<std::mutex> lock( executor_mutex );
+            previous = std::move( executor );
+            executor = std::move( new_executor );
+        }
+        // A replaced default scheduler joins its workers here, outside the lock
+    }
+}
@@ -0,0 +1,347 @@
+/**
+ * @file       VanitySearch.cpp
+ * @brief      Search of keys whose address starts with a given pattern
+ * @date       2024-03-11
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include "ProofSystem/VanitySearch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "ProofSystem/BitcoinKeyGenerator.hpp"
+#include "ProofSystem/Crypto3Util.hpp"
+#include "ProofSystem/ECBatchOps.hpp"
+#include "ProofSystem/EthereumKeyGenerator.hpp"
+#include "ProofSystem/ParallelFor.hpp"
+#include "ProofSystem/SecureRandom.hpp"
+
+namespace vanity
+{
+    namespace
+    {
+        using cpp_int           = nil::crypto3::multiprecision::cpp_int;
+        using g1_value_type     = ecdsa_t::CurveType::template g1_type<>::value_type;
+        using affine_value_type = ecdsa_t::CurveType::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type;
+
+        constexpr std::string_view BASE58_ALPHABET     = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+        constexpr std::size_t      BITCOIN_ADDRESS_MAX = 34; ///< Longest main network address
+        constexpr std::size_t      PAYLOAD_SIZE        = 25; ///< Version byte, hash160 and checksum
+        constexpr std::size_t      CHECKSUM_BITS       = 32; ///< Bits of checksum after the hash160
+
+        int HexDigitValue( char digit )
+        {
+            if ( digit >= '0' && digit <= '9' )
+            {
+                return digit - '0';
+            }
+            digit = static_cast<char>( std::tolower( static_cast<unsigned char>( digit ) ) );
+            if ( digit >= 'a' && digit <= 'f' )
+            {
+                return digit - 'a' + 10;
+            }
+            return -1;
+        }
+
+        Address_t ToAddressBytes( const cpp_int &value )
+        {
+            Address_t bytes;
+            Crypto3Util::CppIntToFixedBytes( value, bytes.data(), bytes.size() );
+            return bytes;
+        }
+
+        /**
+         * @brief       Fills the binary addresses of a batch of affine points
+         */
+        void HashBatch( AddressKind kind, const affine_value_type *points, std::size_t count, Address_t *addresses,
+                        std::vector<std::uint8_t> &key_buffer )
+        {
+            if ( kind == AddressKind::ETHEREUM )
+            {
+                key_buffer.resize( count * sizeof( ethereum::EthereumKeyGenerator::PubKeyBytes_t ) );
+                auto *keys = reinterpret_cast<ethereum::EthereumKeyGenerator::PubKeyBytes_t *>( key_buffer.data() );
+                for ( std::size_t i = 0; i < count; ++i )
+                {
+                    ecbatch::FieldElementToBigEndian<ecdsa_t::base_field_type>( points[i].X, keys[i].data() );
+                    ecbatch::FieldElementToBigEndian<ecdsa_t::base_field_type>( points[i].Y, keys[i].data() + keys[i].size() / 2 );
+                }
+                ethereum::EthereumKeyGenerator::DeriveAddresses( keys, count, addresses );
+            }
+            else
+            {
+                key_buffer.resize( count * sizeof( bitcoin::BitcoinKeyGenerator::CompressedPubKey_t ) );
+                auto *keys = reinterpret_cast<bitcoin::BitcoinKeyGenerator::CompressedPubKey_t *>( key_buffer.data() );
+                ECDSAPublicKey::Coordinate_t y_coord;
+                for ( std::size_t i = 0; i < count; ++i )
+                {
+                    ecbatch::FieldElementToBigEndian<ecdsa_t::base_field_type>( points[i].X, keys[i].data() + 1 );
+                    ecbatch::FieldElementToBigEndian<ecdsa_t::base_field_type>( points[i].Y, y_coord.data() );
+                    keys[i][0] = ( y_coord.back() % 2 ) == 0 ? ECDSAPublicKey::PARITY_EVEN_ID : ECDSAPublicKey::PARITY_ODD_ID;
+                }
+                bitcoin::BitcoinKeyGenerator::DeriveHash160s( keys, count, addresses );
+            }
+        }
+
+        std::string AddressToText( AddressKind kind, const Address_t &address )
+        {
+            if ( kind == AddressKind::ETHEREUM )
+            {
+                return ethereum::EthereumKeyGenerator::ToChecksumAddress( address );
+            }
+            return bitcoin::BitcoinKeyGenerator::EncodeAddress( address );
+        }
+    }
+
+    AddressPattern::AddressPattern( AddressKind kind, std::string text ) :
+        kind( kind ),              //
+        text( std::move( text ) ), //
+        prefix_bits{},             //
+        prefix_mask{}
+    {
+    }
+
+    AddressPattern AddressPattern::EthereumPrefix( std::string_view hex_prefix )
+    {
+        if ( hex_prefix.substr( 0, 2 ) == "0x" || hex_prefix.substr( 0, 2 ) == "0X" )
+        {
+            hex_prefix.remove_prefix( 2 );
+        }
+        if ( hex_prefix.size() > 2 * sizeof( Address_t ) )
+        {
+            throw std::runtime_error( "Ethereum prefix longer than an address" );
+        }
+
+        AddressPattern pattern( AddressKind::ETHEREUM, std::string( hex_prefix ) );
+        for ( std::size_t i = 0; i < hex_prefix.size(); ++i )
+        {
+            const int value = HexDigitValue( hex_prefix[i] );
+            if ( value < 0 )
+            {
+                throw std::runtime_error( "Ethereum prefix is not hexadecimal" );
+            }
+            const unsigned shift = ( i % 2 == 0 ) ? 4 : 0;
+            pattern.prefix_bits[i / 2] |= static_cast<std::uint8_t>( value << shift );
+            pattern.prefix_mask[i / 2] |= static_cast<std::uint8_t>( 0x0F << shift );
+        }
+        return pattern;
+    }
+
+    AddressPattern AddressPattern::BitcoinPrefix( std::string_view base58_prefix )
+    {
+        if ( base58_prefix.empty() || base58_prefix.front() != BASE58_ALPHABET.front() || base58_prefix.size() > BITCOIN_ADDRESS_MAX )
+        {
+            throw std::runtime_error( "Bitcoin prefix must start with 1 and fit in an address" );
+        }
+        if ( base58_prefix.find_first_not_of( BASE58_ALPHABET ) != std::string_view::npos )
+        {
+            throw std::runtime_error( "Bitcoin prefix is not base58" );
+        }
+
+        AddressPattern pattern( AddressKind::BITCOIN, std::string( base58_prefix ) );
+
+        // Every leading '1' is a leading zero byte of the 25 byte payload, the rest is the base58 number
+        const std::size_t zero_bytes = std::min( base58_prefix.find_first_not_of( BASE58_ALPHABET.front() ), base58_prefix.size() );
+        if ( zero_bytes > 1 + sizeof( Address_t ) )
+        {
+            throw std::runtime_error( "Bitcoin prefix has too many leading ones" );
+        }
+        const std::string_view digits = base58_prefix.substr( zero_bytes );
+
+        const cpp_int payload_end = cpp_int( 1 ) << ( 8 * ( PAYLOAD_SIZE - zero_bytes ) );
+        std::vector<std::pair<cpp_int, cpp_int>> payload_ranges; // [low, high)
+        if ( digits.empty() )
+        {
+            payload_ranges.emplace_back( 0, payload_end );
+        }
+        else
+        {
+            const cpp_int payload_begin = cpp_int( 1 ) << ( 8 * ( PAYLOAD_SIZE - zero_bytes - 1 ) );
+
+            cpp_int prefix_value = 0;
+            for ( char digit : digits )
+            {
+                prefix_value = prefix_value * 58 + static_cast<unsigned>( BASE58_ALPHABET.find( digit ) );
+            }
+            // The number behind the prefix can have any length, each length is one range
+            cpp_int scale = 1;
+            while ( prefix_value * scale < payload_end )
+            {
+                const cpp_int range_low  = prefix_value * scale;
+                const cpp_int range_high = ( prefix_value + 1 ) * scale;
+                const cpp_int low        = std::max( range_low, payload_begin );
+                const cpp_int high       = std::min( range_high, payload_end );
+                if ( low < high )
+                {
+                    payload_ranges.emplace_back( low, high );
+                }
+                scale *= 58;
+            }
+        }
+
+        for ( const auto &[low, high] : payload_ranges )
+        {
+            pattern.hash_ranges.emplace_back( ToAddressBytes( low >> CHECKSUM_BITS ), ToAddressBytes( ( high - 1 ) >> CHECKSUM_BITS ) );
+        }
+        if ( pattern.hash_ranges.empty() )
+        {
+            throw std::runtime_error( "No Bitcoin address can start with this prefix" );
+        }
+        return pattern;
+    }
+
+    bool AddressPattern::Matches( const Address_t &address ) const
+    {
+        if ( kind == AddressKind::ETHEREUM )
+        {
+            for ( std::size_t i = 0; i < address.size(); ++i )
+            {
+                if ( ( address[i] & prefix_mask[i] ) != prefix_bits[i] )
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        for ( const auto &[low, high] : hash_ranges )
+        {
+            if ( std::memcmp( address.data(), low.data(), address.size() ) >= 0 && std::memcmp( address.data(), high.data(), address.size() ) <= 0 )
+            {
+                // The checksum can still move the edges of a range, the text settles it
+                return AddressToText( kind, address ).compare( 0, text.size(), text ) == 0;
+            }
+        }
+        return false;
+    }
+
+    SearchResult Search( const AddressPattern &pattern, const SearchOptions &options )
+    {
+        const std::size_t num_threads = util::ResolveThreadCount( std::numeric_limits<std::size_t>::max(), options.num_threads );
+        const std::size_t batch_size  = std::max<std::size_t>( 1, options.batch_size );
+
+        std::vector<ecdsa_t::scalar_field_value_type> start_keys( num_threads );
+        for ( auto &key : start_keys )
+        {
+            key = csprng::RandomScalar<ecdsa_t::scalar_field_type>();
+        }
+
+        SearchResult               result{};
+        std::mutex                 result_mutex;
+        std::condition_variable    done_signal;
+        std::atomic<bool>          stop{ false };
+        std::atomic<std::uint64_t> keys_checked{ 0 };
+        std::exception_ptr         error;
+        std::size_t                running = num_threads;
+
+        const auto start_time = std::chrono::steady_clock::now();
+        auto       elapsed    = [&start_time]()
+        { return std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count(); };
+
+        auto worker = [&]( std::size_t index )
+        {
+            try
+            {
+                affine_value_type start_point;
+                ecbatch::GeneratorMulBatch<ecdsa_t::CurveType>( &start_keys[index], 1, &start_point );
+
+                const g1_value_type generator = g1_value_type::one();
+                g1_value_type       current( start_point.X, start_point.Y, ecdsa_t::base_field_type::value_type::one() );
+                std::uint64_t       offset = 0;
+
+                std::vector<g1_value_type>     points( batch_size );
+                std::vector<affine_value_type> affine( batch_size );
+                std::vector<Address_t>         addresses( batch_size );
+                std::vector<std::uint8_t>      key_buffer;
+
+                while ( !stop.load( std::memory_order_relaxed ) )
+                {
+                    for ( auto &point : points )
+                    {
+                        point   = current;
+                        current = current + generator;
+                    }
+                    ecbatch::BatchToAffine( points.data(), batch_size, affine.data() );
+                    HashBatch( pattern.GetKind(), affine.data(), batch_size, addresses.data(), key_buffer );
+
+                    for ( std::size_t i = 0; i < batch_size; ++i )
+                    {
+                        if ( !pattern.Matches( addresses[i] ) )
+                        {
+                            continue;
+                        }
+                        std::lock_guard<std::mutex> lock( result_mutex );
+                        if ( !result.found )
+                        {
+                            result.found       = true;
+                            result.private_key = start_keys[index] + ecdsa_t::scalar_field_value_type( offset + i );
+                            result.address     = AddressToText( pattern.GetKind(), addresses[i] );
+                        }
+                        stop = true;
+                        break;
+                    }
+
+                    offset += batch_size;
+                    const auto total = keys_checked.fetch_add( batch_size, std::memory_order_relaxed ) + batch_size;
+                    if ( options.max_keys != 0 && total >= options.max_keys )
+                    {
+                        stop = true;
+                    }
+                }
+            }
+            catch ( ... )
+            {
+                std::lock_guard<std::mutex> lock( result_mutex );
+                if ( !error )
+                {
+                    error = std::current_exception();
+                }
+                stop = true;
+            }
+
+            std::lock_guard<std::mutex> lock( result_mutex );
+            --running;
+            done_signal.notify_all();
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve( num_threads );
+        for ( std::size_t i = 0; i < num_threads; ++i )
+        {
+            workers.emplace_back( worker, i );
+        }
+
+        {
+            std::unique_lock<std::mutex> lock( result_mutex );
+            while ( !done_signal.wait_for( lock, options.progress_interval, [&running]() { return running == 0; } ) )
+            {
+                if ( options.on_progress )
+                {
+                    const SearchProgress progress{ keys_checked.load( std::memory_order_relaxed ), elapsed() };
+                    lock.unlock();
+                    options.on_progress( progress );
+                    lock.lock();
+                }
+            }
+        }
+        for ( auto &thread : workers )
+        {
+            thread.join();
+        }
+        if ( error )
+        {
+            std::rethrow_exception( error );
+        }
+
+        result.stats = SearchProgress{ keys_checked.load(), elapsed() };
+        return result;
+    }
+}
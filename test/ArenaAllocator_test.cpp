@@ -0,0 +1,96 @@
+/**
+ * @file       ArenaAllocator_test.cpp
+ * @brief      Tests of the per thread multiprecision arena
+ * @date       2024-03-28
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#include <gtest/gtest.h>
+#include <thread>
+#include "ProofSystem/ArenaAllocator.hpp"
+#include "ProofSystem/PrimeNumbers.hpp"
+
+TEST( ArenaAllocatorTest, ScopeRewindsAndLastAllocationIsReused )
+{
+    auto &arena = arena::Arena::ThreadArena();
+
+    const auto outer = arena.GetMark();
+    {
+        arena::Scope scope;
+        void        *first = arena.Allocate( 100 );
+        arena.Deallocate( first, 100 );
+        // Freeing the most recent allocation hands its bytes to the next one
+        EXPECT_EQ( arena.Allocate( 100 ), first );
+        arena.Allocate( 2 * arena::Arena::BLOCK_SIZE );
+    }
+    const auto after = arena.GetMark();
+    EXPECT_EQ( after.block, outer.block );
+    EXPECT_EQ( after.offset, outer.offset );
+
+    // Blocks are kept, so the same work again doesn't grow the arena
+    const auto blocks = arena.GetStats().blocks;
+    {
+        arena::Scope scope;
+        arena.Allocate( 100 );
+        arena.Allocate( 2 * arena::Arena::BLOCK_SIZE );
+    }
+    EXPECT_EQ( arena.GetStats().blocks, blocks );
+}
+
+TEST( ArenaAllocatorTest, ArenaIntegersMatchCppInt )
+{
+    using cpp_int = PrimeNumbers::cpp_int;
+
+    const cpp_int prime( "0xf3760a5583d3509b3f72b16e3c892129fef350406f88c268f503e877e043514f" );
+    const cpp_int base( "0x1a2c6b6fb9971c4a993069c76258ee18ba80f778fd4d7bc07186c70e73b93004" );
+
+    cpp_int expected = 1;
+    cpp_int result   = 0;
+    {
+        arena::Scope   scope;
+        arena::cpp_int value = 1;
+        for ( int i = 0; i < 1000; ++i )
+        {
+            value    = ( value * arena::cpp_int( base ) ) % arena::cpp_int( prime );
+            expected = ( expected * base ) % prime;
+        }
+        result = cpp_int( value );
+    }
+    EXPECT_EQ( result, expected );
+
+    // Every thread has its own arena
+    cpp_int thread_result = 0;
+    std::thread( [&]()
+                 {
+                     arena::Scope scope;
+                     thread_result = cpp_int( powm( arena::cpp_int( base ), arena::cpp_int( 1000 ), arena::cpp_int( prime ) ) );
+                 } )
+        .join();
+    EXPECT_EQ( thread_result, expected );
+
+    EXPECT_EQ( cpp_int( ( PrimeNumbers::ModInverseEuclideanDivision( base, prime ) * base ) % prime ), 1 );
+    EXPECT_THROW( PrimeNumbers::ModInverseEuclideanDivision( 6, 9 ), std::runtime_error );
+}
+
+TEST( ArenaAllocatorTest, LongLoopsDontGrowTheArena )
+{
+    const PrimeNumbers::cpp_int prime( "0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F" );
+    const PrimeNumbers::cpp_int tonelli_prime( "0x40000000000000000000000000000000224698fc094cf91b992d30ed00000001" );
+    PrimeNumbers::BabyStepGiantStep bsgs( prime, PrimeNumbers::cpp_int( 3 ) );
+
+    // A fresh thread, so the block count only holds what these loops needed
+    std::uint64_t blocks = 0;
+    std::thread( [&]()
+                 {
+                     // 2 is not a small power of 3, every giant step runs before the solver gives up
+                     EXPECT_THROW( bsgs.SolveECDLP( 2 ), std::runtime_error );
+                     for ( int i = 2; i < 200; ++i )
+                     {
+                         const PrimeNumbers::cpp_int square = ( PrimeNumbers::cpp_int( i ) * i ) % tonelli_prime;
+                         const PrimeNumbers::cpp_int root   = PrimeNumbers::SqrtMod( square, tonelli_prime );
+                         EXPECT_EQ( ( root * root ) % tonelli_prime, square );
+                     }
+                     blocks = arena::Arena::ThreadArena().GetStats().blocks;
+                 } )
+        .join();
+    EXPECT_LE( blocks, 2u );
+}
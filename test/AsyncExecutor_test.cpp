@@ -0,0 +1,180 @@
+/**
+ * @file       AsyncExecutor_test.cpp
+ * @brief      Tests of the bounded worker pool and the asynchronous operations
+ * @date       2024-03-31
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
+#include "ProofSystem/AsyncExecutor.hpp"
+#include "ProofSystem/AsyncOperations.hpp"
+#include "nil/crypto3/multiprecision/cpp_int.hpp"
+
+using namespace nil::crypto3::multiprecision::literals;
+
+TEST( AsyncExecutorTest, FuturesCarryResultsAndErrors )
+{
+    async::WorkerPool pool( 2, 4 );
+
+    auto value = pool.Submit( []() { return 42; } );
+    auto error = pool.Submit( []() -> int { throw std::runtime_error( "task failed" ); } );
+    auto owned = pool.Submit( [number = std::make_unique<int>( 7 )]() { return *number; } );
+
+    EXPECT_EQ( value.get(), 42 );
+    EXPECT_THROW( error.get(), std::runtime_error );
+    EXPECT_EQ( owned.get(), 7 );
+}
+
+TEST( AsyncExecutorTest, FullQueueRejectsWithoutBlocking )
+{
+    async::WorkerPool pool( 1, 1 );
+
+    // The only worker waits on the gate, so one task fills the queue
+    std::promise<void> gate;
+    auto               opened  = gate.get_future().share();
+    auto               blocker = pool.Submit( [opened]() { opened.wait(); } );
+    while ( pool.GetQueueSize() != 0 )
+    {
+        std::this_thread::yield();
+    }
+
+    auto queued = pool.TrySubmit( []() { return 1; } );
+    ASSERT_TRUE( queued.has_value() );
+    EXPECT_FALSE( pool.TrySubmit( []() { return 2; } ).has_value() );
+    EXPECT_THROW( async::ECElGamalEncrypt( nullptr, 1, {}, pool ), async::QueueFull );
+
+    gate.set_value();
+    blocker.get();
+    EXPECT_EQ( queued->get(), 1 );
+}
+
+TEST( AsyncExecutorTest, CancelledTasksDontRun )
+{
+    async::WorkerPool         pool( 1 );
+    async::CancellationSource source;
+    std::atomic<bool>         ran( false );
+
+    source.Cancel();
+    auto skipped = pool.Submit( [&ran]() { ran = true; }, source.GetToken() );
+    EXPECT_THROW( skipped.get(), async::OperationCancelled );
+    EXPECT_FALSE( ran.load() );
+
+    // Cooperative tasks receive the token and can give up halfway
+    async::CancellationSource running;
+    std::promise<void>        started;
+    auto                      polling = pool.Submit(
+        [&started]( const async::CancellationToken &token )
+        {
+            started.set_value();
+            while ( true )
+            {
+                token.ThrowIfCancelled();
+                std::this_thread::yield();
+            }
+        },
+        running.GetToken() );
+    started.get_future().wait();
+    running.Cancel();
+    EXPECT_THROW( polling.get(), async::OperationCancelled );
+}
+
+TEST( AsyncExecutorTest, BabyStepGiantStepBuiltOnWorker )
+{
+    const PrimeNumbers::cpp_int prime = 0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F_cppui256;
+    const PrimeNumbers::cpp_int generator( 3 );
+
+    auto bsgs = async::BuildBabyStepGiantStep( prime, generator ).get();
+    ASSERT_NE( bsgs, nullptr );
+    EXPECT_EQ( bsgs->SolveECDLP( powm( generator, PrimeNumbers::cpp_int( 1000 ), prime ) ), 1000 );
+
+    auto key_generator = std::make_shared<ECElGamalKeyGenerator>( 0x60cf347dbc59d31c1358c8e5cf5e45b822ab85b79cb32a9f3d98184779a9efc2_cppui256 );
+    auto cypher        = async::ECElGamalEncrypt( key_generator, 10000 ).get();
+    EXPECT_EQ( key_generator->DecryptData( cypher ), 10000 );
+}
+
+#ifdef PROOFSYSTEM_ENABLE_COROUTINES
+namespace
+{
+    /**
+     * @brief       Minimal eager coroutine keeping its result until destroyed
+     */
+    struct IntTask
+    {
+        struct promise_type
+        {
+            int                value = 0;
+            std::exception_ptr error;
+            std::atomic<bool>  finished{ false };
+
+            IntTask get_return_object()
+            {
+                return IntTask{ std::coroutine_handle<promise_type>::from_promise( *this ) };
+            }
+
+            std::suspend_never initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                void await_suspend( std::coroutine_handle<promise_type> handle ) const noexcept
+                {
+                    // Set once the frame is suspended, the waiting thread may then read and destroy it
+                    handle.promise().finished.store( true, std::memory_order_release );
+                }
+
+                void await_resume() const noexcept
+                {
+                }
+            };
+
+            FinalAwaiter final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void return_value( int result )
+            {
+                value = result;
+            }
+
+            void unhandled_exception()
+            {
+                error = std::current_exception();
+            }
+        };
+
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    IntTask AddOnPool( async::WorkerPool &pool )
+    {
+        const int first  = co_await pool.Schedule( []() { return 20; } );
+        const int second = co_await pool.Schedule( []( const async::CancellationToken & ) { return 22; } );
+        co_return first + second;
+    }
+}
+
+TEST( AsyncExecutorTest, CoroutineAwaitsPool )
+{
+    async::WorkerPool pool( 2 );
+
+    IntTask task = AddOnPool( pool );
+    while ( !task.handle.promise().finished.load( std::memory_order_acquire ) )
+    {
+        std::this_thread::yield();
+    }
+    EXPECT_FALSE( task.handle.promise().error );
+    EXPECT_EQ( task.handle.promise().value, 42 );
+    task.handle.destroy();
+}
+#endif
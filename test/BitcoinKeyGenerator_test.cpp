@@ -41,11 +41,35 @@ TEST( BitcoinKeyGeneratorTest, BitCoinAddressTest )
     std::vector<std::uint8_t> x_ser = { 0x1e, 0x7b, 0xcc, 0x70, 0xc7, 0x27, 0x70, 0xdb, 0xb7, 0x2f, 0xea, 0x02, 0x2e, 0x8a, 0x6d, 0x07,
                                         0xf8, 0x14, 0xd2, 0xeb, 0xe4, 0xde, 0x9a, 0xe3, 0xf7, 0xaf, 0x75, 0xbf, 0x70, 0x69, 0x02, 0xa7 };
 
+    std::vector<std::uint8_t> y_ser = { 0xb7, 0x3f, 0xf9, 0x19, 0x89, 0x8c, 0x83, 0x63, 0x96, 0xa6, 0xb0, 0xc9, 0x68, 0x12, 0xc3, 0x21,
+                                        0x3b, 0x99, 0x37, 0x20, 0x50, 0x85, 0x3b, 0xd1, 0x67, 0x8d, 0xa0, 0xea, 0xd1, 0x44, 0x87, 0xd7 };
+
     std::reverse( x_ser.begin(), x_ser.end() );
-    std::string address = BitcoinKeyGenerator::DeriveAddress( x_ser );
+    std::reverse( y_ser.begin(), y_ser.end() );
+    std::string address = BitcoinKeyGenerator::DeriveAddress( x_ser, y_ser );
     EXPECT_EQ( address, "17JsmEygbbEUEpvt4PFtYaTeSqfb9ki1F1" );
 }
 
+TEST( BitcoinKeyGeneratorTest, BitCoinAddressOddXEvenY )
+{
+    // 2G has an odd X and an even Y, a prefix taken from X gives 1NjSB7UL4MtdjmPbTUfaHne9R5C2YGxUSA
+    const std::string expected_address = "1cMh228HTCiwS8ZsaakH8A8wze1JR5ZsP";
+
+    BitcoinKeyGenerator key_generator( "0000000000000000000000000000000000000000000000000000000000000002" );
+    EXPECT_EQ( key_generator.GetUsedPubKeyValue(), "02c6047f9441ed7d6d3045406e95c07cd85c778e4b8cef3ca7abac09b95c709ee5" );
+    EXPECT_EQ( key_generator.get_address(), expected_address );
+
+    auto x_y_pair = BitcoinKeyGenerator::ExtractPubKeyFromField<BitcoinKeyGenerator::PubKeyPair_t>( key_generator.get_public_key() );
+    EXPECT_EQ( BitcoinKeyGenerator::DeriveAddress( std::get<0>( x_y_pair ), std::get<1>( x_y_pair ) ), expected_address );
+
+    BitcoinKeyGenerator::CompressedPubKey_t compressed;
+    compressed[0] = 0x02;
+    std::reverse_copy( std::get<0>( x_y_pair ).begin(), std::get<0>( x_y_pair ).end(), compressed.begin() + 1 );
+    EXPECT_EQ( BitcoinKeyGenerator::DeriveAddresses( { compressed } ).front(), expected_address );
+
+    EXPECT_THROW( BitcoinKeyGenerator::DeriveAddress( std::get<0>( x_y_pair ), std::vector<std::uint8_t>( 31 ) ), std::runtime_error );
+}
+
 TEST( BitcoinKeyGeneratorTest, BitCoinKeyImportTest )
 {
     std::string priv_key_data = "60cf347dbc59d31c1358c8e5cf5e45b822ab85b79cb32a9f3d98184779a9efc2";
@@ -57,6 +81,71 @@ TEST( BitcoinKeyGeneratorTest, BitCoinKeyImportTest )
     EXPECT_EQ( key_generator.get_address(), "17JsmEygbbEUEpvt4PFtYaTeSqfb9ki1F1" );
 }
 
+TEST( BitcoinKeyGeneratorTest, BitCoinBatchAddressTest )
+{
+    BitcoinKeyGenerator::CompressedPubKey_t known_key = { 0x03, 0x1e, 0x7b, 0xcc, 0x70, 0xc7, 0x27, 0x70, 0xdb, 0xb7, 0x2f, 0xea, 0x02, 0x2e, 0x8a, 0x6d, 0x07,
+                                                          0xf8, 0x14, 0xd2, 0xeb, 0xe4, 0xde, 0x9a, 0xe3, 0xf7, 0xaf, 0x75, 0xbf, 0x70, 0x69, 0x02, 0xa7 };
+
+    // Enough keys for a full 16 lane group plus a scalar tail
+    std::vector<BitcoinKeyGenerator::CompressedPubKey_t> pub_keys( 21, known_key );
+    std::vector<BitcoinKeyGenerator>                     generators( 10 );
+    for ( size_t i = 0; i < generators.size(); i++ )
+    {
+        auto x_y_pair = BitcoinKeyGenerator::ExtractPubKeyFromField<BitcoinKeyGenerator::PubKeyPair_t>( generators[i].get_public_key() );
+        auto &x_ser   = std::get<0>( x_y_pair );
+        auto &y_ser   = std::get<1>( x_y_pair );
+
+        // Both vectors are least significant byte first, the prefix follows the parity of Y
+        pub_keys[2 * i][0] = ( y_ser.front() % 2 ) == 0 ? 0x02 : 0x03;
+        std::reverse_copy( x_ser.begin(), x_ser.end(), pub_keys[2 * i].begin() + 1 );
+    }
+
+    auto addresses = BitcoinKeyGenerator::DeriveAddresses( pub_keys );
+    ASSERT_EQ( addresses.size(), pub_keys.size() );
+
+    for ( size_t i = 0; i < generators.size(); i++ )
+    {
+        EXPECT_EQ( addresses[2 * i], generators[i].get_address() );
+        EXPECT_EQ( addresses[2 * i + 1], "17JsmEygbbEUEpvt4PFtYaTeSqfb9ki1F1" );
+    }
+    EXPECT_EQ( addresses.back(), "17JsmEygbbEUEpvt4PFtYaTeSqfb9ki1F1" );
+}
+
+TEST( BitcoinKeyGeneratorTest, BitCoinGenerateBatchTest )
+{
+    auto entries = BitcoinKeyGenerator::GenerateBatch( 37, 3 );
+    ASSERT_EQ( entries.size(), 37 );
+
+    for ( const auto &entry : entries )
+    {
+        BitcoinKeyGenerator key_generator( entry.private_key );
+
+        EXPECT_EQ( util::to_string( std::vector<std::uint8_t>( entry.public_key.rbegin(), entry.public_key.rend() ) ),
+                   key_generator.GetUsedPubKeyValue() );
+        EXPECT_EQ( BitcoinKeyGenerator::EncodeAddress( entry.hash160 ), key_generator.get_address() );
+    }
+}
+
+TEST( BitcoinKeyGeneratorTest, BitCoinCompressedPrefixFollowsY )
+{
+    for ( int i = 0; i < 8; i++ )
+    {
+        BitcoinKeyGenerator key_generator;
+
+        auto x_y_pair = BitcoinKeyGenerator::ExtractPubKeyFromField<BitcoinKeyGenerator::PubKeyPair_t>( key_generator.get_public_key() );
+        const std::string expected_prefix = ( std::get<1>( x_y_pair ).front() % 2 ) == 0 ? "02" : "03";
+
+        EXPECT_EQ( key_generator.GetUsedPubKeyValue(), expected_prefix + util::to_string( std::get<0>( x_y_pair ) ) );
+        EXPECT_EQ( key_generator.GetEntirePubValue(), util::to_string( std::get<0>( x_y_pair ) ) + util::to_string( std::get<1>( x_y_pair ) ) );
+    }
+}
+
+TEST( BitcoinKeyGeneratorTest, BitCoinEncodeAddressLeadingZeros )
+{
+    BitcoinKeyGenerator::Hash160_t zero_hash{};
+    EXPECT_EQ( BitcoinKeyGenerator::EncodeAddress( zero_hash ), "1111111111111111111114oLvT2" );
+}
+
 // Address generation functionality is commented out in the provided code
 // Uncomment the following test if the functionality is implemented
 /*
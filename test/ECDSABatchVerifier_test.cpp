@@ -0,0 +1,103 @@
+/**
+ * @file       ECDSABatchVerifier_test.cpp
+ * @brief      Tests of the batch ECDSA verification
+ * @date       2024-03-18
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "ProofSystem/EthereumKeyGenerator.hpp"
+#include "ProofSystem/ECDSABatchVerifier.hpp"
+
+using namespace ethereum;
+
+using BatchVerifier = ECDSABatchVerifier<ethereum::policy_type>;
+
+namespace
+{
+    std::vector<BatchVerifier::Entry_t> SignedEntries( std::size_t count, std::vector<EthereumKeyGenerator> &signers )
+    {
+        std::vector<BatchVerifier::Entry_t> entries;
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            const auto       &signer    = signers[i % signers.size()];
+            const std::string message   = "payload " + std::to_string( i );
+            auto              signature = BatchVerifier::SignRecoverable( message, signer.get_private_key() );
+            entries.push_back( BatchVerifier::MakeEntry( message, signature, signer.get_public_key() ) );
+        }
+        return entries;
+    }
+}
+
+TEST( ECDSABatchVerifierTest, AllValidInOneCheck )
+{
+    std::vector<EthereumKeyGenerator> signers( 5 );
+    auto                              entries = SignedEntries( 40, signers );
+
+    ECDSABatchStats stats;
+    auto            valid = BatchVerifier::Verify( entries, &stats );
+
+    EXPECT_EQ( valid, std::vector<bool>( entries.size(), true ) );
+    EXPECT_EQ( stats.invalid, 0 );
+    EXPECT_EQ( stats.batch_checks, 1 );
+    EXPECT_EQ( stats.single_checks, 0 );
+}
+
+TEST( ECDSABatchVerifierTest, BisectionFindsInvalidSignatures )
+{
+    std::vector<EthereumKeyGenerator> signers( 3 );
+    auto                              entries = SignedEntries( 32, signers );
+
+    // Signed by the wrong key, over the wrong message, and with a tampered s
+    entries[3].signer                      = signers[1].get_public_key().pubkey_data();
+    entries[17].encoded_message            = BatchVerifier::Verifier_t::EncodeMessage( std::string( "forged" ) );
+    entries[30].signature.signature.second = entries[30].signature.signature.second + ethereum::scalar_field_value_type::one();
+
+    ECDSABatchStats stats;
+    auto            valid = BatchVerifier::Verify( entries, &stats );
+
+    for ( std::size_t i = 0; i < entries.size(); ++i )
+    {
+        EXPECT_EQ( valid[i], i != 3 && i != 17 && i != 30 ) << "entry " << i;
+    }
+    EXPECT_EQ( stats.invalid, 3 );
+    EXPECT_GT( stats.batch_checks, 1 );
+}
+
+TEST( ECDSABatchVerifierTest, MissingOrWrongRecoveryId )
+{
+    std::vector<EthereumKeyGenerator> signers( 2 );
+    auto                              entries = SignedEntries( 12, signers );
+
+    entries[0].signature.recovery_id = BatchVerifier::UNKNOWN_RECOVERY_ID;
+    entries[5].signature.recovery_id ^= 1;
+
+    ECDSABatchStats stats;
+    auto            valid = BatchVerifier::Verify( entries, &stats );
+
+    // A wrong recovery id only costs a trip through the single verifier
+    EXPECT_EQ( valid, std::vector<bool>( entries.size(), true ) );
+    EXPECT_GT( stats.single_checks, 0 );
+}
+
+TEST( ECDSABatchVerifierTest, MatchesSinglePath )
+{
+    std::vector<EthereumKeyGenerator> signers( 16 );
+    auto                              entries = SignedEntries( 64, signers );
+
+    // A few bad entries so both outcomes are compared
+    entries[7].signer                      = signers[2].get_public_key().pubkey_data();
+    entries[40].signature.signature.second = entries[40].signature.signature.second + ethereum::scalar_field_value_type::one();
+
+    BatchVerifier::Verifier_t single_verifier( 1, 1000 );
+    std::vector<bool>         single_valid;
+    for ( const auto &entry : entries )
+    {
+        single_valid.push_back( single_verifier.VerifyEncoded( entry.encoded_message, entry.signature.signature, entry.signer ) );
+    }
+
+    EXPECT_EQ( BatchVerifier::Verify( entries ), single_valid );
+    EXPECT_FALSE( single_valid[7] );
+    EXPECT_FALSE( single_valid[40] );
+}
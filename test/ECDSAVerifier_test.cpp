@@ -0,0 +1,102 @@
+/**
+ * @file       ECDSAVerifier_test.cpp
+ * @brief      Tests of the ECDSA verifier with signer tables
+ * @date       2024-03-15
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <nil/crypto3/pubkey/algorithm/sign.hpp>
+#include <nil/crypto3/pubkey/algorithm/verify.hpp>
+#include "ProofSystem/EthereumKeyGenerator.hpp"
+#include "ProofSystem/ECDSAVerifier.hpp"
+
+using namespace ethereum;
+
+using Verifier = ECDSAVerifier<ethereum::policy_type>;
+
+TEST( ECDSAVerifierTest, MatchesCrypto3Verify )
+{
+    EthereumKeyGenerator signer;
+    EthereumKeyGenerator other;
+    Verifier             verifier( 8, 2 );
+
+    for ( int i = 0; i < 6; ++i )
+    {
+        std::string message   = "payload number " + std::to_string( i );
+        auto        signature = nil::crypto3::sign<ethereum::policy_type>( message, signer.get_private_key() );
+
+        EXPECT_TRUE( static_cast<bool>( nil::crypto3::verify<ethereum::policy_type>( message, signature, signer.get_public_key() ) ) );
+        EXPECT_TRUE( verifier.Verify( message, signature, signer.get_public_key() ) );
+        EXPECT_TRUE( verifier.Verify( message, signature, signer.GetCompressedPubValue() ) );
+
+        EXPECT_FALSE( verifier.Verify( message + "!", signature, signer.get_public_key() ) );
+        EXPECT_FALSE( verifier.Verify( message, signature, other.get_public_key() ) );
+    }
+
+    auto stats = verifier.GetStats();
+    EXPECT_EQ( stats.verifications, 24 );
+    EXPECT_EQ( stats.tables_built, 2 );
+    // Only the first verification of each signer runs without its table
+    EXPECT_EQ( stats.table_hits, 22 );
+}
+
+TEST( ECDSAVerifierTest, RejectsZeroSignature )
+{
+    EthereumKeyGenerator signer;
+    Verifier             verifier;
+
+    std::string message   = "zero";
+    auto        signature = nil::crypto3::sign<ethereum::policy_type>( message, signer.get_private_key() );
+
+    Verifier::SignatureType zero_r( ethereum::scalar_field_value_type::zero(), signature.second );
+    Verifier::SignatureType zero_s( signature.first, ethereum::scalar_field_value_type::zero() );
+    EXPECT_FALSE( verifier.Verify( message, zero_r, signer.get_public_key() ) );
+    EXPECT_FALSE( verifier.Verify( message, zero_s, signer.get_public_key() ) );
+}
+
+TEST( ECDSAVerifierTest, LeastRecentlyUsedSignerIsEvicted )
+{
+    std::vector<EthereumKeyGenerator> signers( 3 );
+    Verifier                          verifier( 2, 1 );
+
+    std::string message = "eviction";
+    for ( auto &signer : signers )
+    {
+        auto signature = nil::crypto3::sign<ethereum::policy_type>( message, signer.get_private_key() );
+        EXPECT_TRUE( verifier.Verify( message, signature, signer.get_public_key() ) );
+    }
+    auto stats = verifier.GetStats();
+    EXPECT_EQ( stats.tables_built, 3 );
+    EXPECT_EQ( stats.evictions, 1 );
+
+    // The first signer was dropped, its table has to be rebuilt
+    auto signature = nil::crypto3::sign<ethereum::policy_type>( message, signers[0].get_private_key() );
+    EXPECT_TRUE( verifier.Verify( message, signature, signers[0].get_public_key() ) );
+    EXPECT_EQ( verifier.GetStats().tables_built, 4 );
+}
+
+TEST( ECDSAVerifierTest, FixedBaseTableEdgeScalars )
+{
+    using scalar_value_type = Verifier::scalar_field_value_type;
+    using g1_value_type     = Verifier::g1_value_type;
+
+    const auto         &generator_table = ecbatch::GeneratorTable<Verifier::curve_type>();
+    const g1_value_type other_base      = scalar_value_type( 12345 ) * g1_value_type::one();
+    const Verifier::Table_t other_table( other_base, Verifier::scalar_field_type::number_bits );
+
+    // Zero digits, a zero scalar and the top of the range take the same path as any other scalar
+    const std::vector<scalar_value_type> scalars = { scalar_value_type( 0 ),          scalar_value_type( 1 ),       scalar_value_type( 15 ),
+                                                     scalar_value_type( 16 ),         scalar_value_type( 0x1000001 ), -scalar_value_type( 1 ),
+                                                     scalar_value_type( 0x10 ) * scalar_value_type( 0x100000000 ) };
+    for ( const auto &scalar : scalars )
+    {
+        EXPECT_EQ( generator_table.Mul( scalar ).to_affine(), ( scalar * g1_value_type::one() ).to_affine() );
+        for ( const auto &other_scalar : scalars )
+        {
+            EXPECT_EQ( Verifier::Table_t::DoubleMul( generator_table, scalar, other_table, other_scalar ).to_affine(),
+                       ( scalar * g1_value_type::one() + other_scalar * other_base ).to_affine() );
+        }
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * @file       ElGamalFixed_test.cpp
+ * @brief      Tests of the compile time specialized ElGamal
+ * @date       2024-03-27
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#include <gtest/gtest.h>
+#include "ProofSystem/ElGamalFixed.hpp"
+
+using namespace KeyGenerator;
+
+// The whole fixed base table is available to the compiler
+static_assert( fixed_width::Equal( ElGamalDefault::PowGenerator( ElGamalDefault::Element_t{ 1 } ), ElGamalDefault::GENERATOR ) );
+static_assert( fixed_width::Equal( ElGamalDefault::Pow( ElGamalDefault::GENERATOR, ElGamalDefault::Element_t{ 5 } ),
+                                   ElGamalDefault::PowGenerator( ElGamalDefault::Element_t{ 5 } ) ) );
+
+TEST( ElGamalFixedTest, MatchesRuntimeParameters )
+{
+    EXPECT_EQ( ElGamalDefault::ToCppInt( ElGamalDefault::PRIME ), cpp_int( ElGamal::SAFE_PRIME ) );
+    EXPECT_EQ( ElGamalDefault::ToCppInt( ElGamalDefault::GENERATOR ), cpp_int( ElGamal::GENERATOR ) );
+
+    const cpp_int prime( ElGamal::SAFE_PRIME );
+    const cpp_int generator( ElGamal::GENERATOR );
+    for ( int i = 0; i < 20; ++i )
+    {
+        const auto    exponent       = ElGamalDefault::RandomExponent();
+        const auto    base           = ElGamalDefault::RandomExponent();
+        const cpp_int exponent_value = ElGamalDefault::ToCppInt( exponent );
+        const cpp_int base_value     = ElGamalDefault::ToCppInt( base );
+
+        EXPECT_EQ( ElGamalDefault::ToCppInt( ElGamalDefault::PowGenerator( exponent ) ), powm( generator, exponent_value, prime ) );
+        EXPECT_EQ( ElGamalDefault::ToCppInt( ElGamalDefault::Pow( base, exponent ) ), powm( base_value, exponent_value, prime ) );
+        EXPECT_EQ( ElGamalDefault::ToCppInt( ElGamalDefault::Mul( base, exponent ) ), cpp_int( base_value * exponent_value ) % prime );
+        EXPECT_EQ( ElGamalDefault::FromCppInt( exponent_value ), exponent );
+    }
+}
+
+TEST( ElGamalFixedTest, InteroperatesWithElGamal )
+{
+    ElGamal        key_generator;
+    ElGamalDefault fixed_key( ElGamalDefault::FromCppInt( key_generator.GetPrivateKey().GetPrivateKeyScalar() ) );
+    EXPECT_EQ( ElGamalDefault::ToCppInt( fixed_key.GetPublicKey() ), key_generator.GetPublicKey().public_key_value );
+
+    // Fixed width encryption, runtime additive decryption
+    const auto fixed_cypher = ElGamalDefault::EncryptDataAdditive( fixed_key.GetPublicKey(), ElGamalDefault::Element_t{ 123456 } );
+    const auto result       = key_generator.DecryptDataAdditive(
+        std::make_pair( ElGamalDefault::ToCppInt( fixed_cypher.a ), ElGamalDefault::ToCppInt( fixed_cypher.b ) ) );
+    EXPECT_EQ( result, 123456 );
+
+    // Runtime encryption, fixed width decryption
+    const cpp_int message = 0xbeadfeed;
+    const auto    cypher  = ElGamal::EncryptData( key_generator.GetPublicKey(), message );
+    const auto    decrypted =
+        ElGamalDefault::DecryptData( fixed_key.GetPrivateKey(),
+                                     ElGamalDefault::CypherText_t{ ElGamalDefault::FromCppInt( cypher.first ), ElGamalDefault::FromCppInt( cypher.second ) } );
+    EXPECT_EQ( ElGamalDefault::ToCppInt( decrypted ), message );
+
+    const ElGamalDefault random_key;
+    const auto           data = ElGamalDefault::RandomExponent();
+    EXPECT_EQ( ElGamalDefault::DecryptData( random_key.GetPrivateKey(), ElGamalDefault::EncryptData( random_key.GetPublicKey(), data ) ), data );
+}
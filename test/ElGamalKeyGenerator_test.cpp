@@ -6,7 +6,10 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 #include <random>
+#include <thread>
 #include "ProofSystem/ElGamalKeyGenerator.hpp"
 
 using namespace KeyGenerator;
@@ -112,3 +115,122 @@ TEST( ElGamalKeyGeneratorTest, AdditiveHomomorphism )
     EXPECT_EQ( result_1_800, 1800000 );
     EXPECT_EQ( result_1_800_calc, 1800000 );
 }
+TEST( ElGamalKeyGeneratorTest, ConcurrentAdditiveDecryption )
+{
+    // One key and one baby step table shared by every thread, with no locking
+    const ElGamal key_generator;
+
+    std::atomic<std::size_t> failures{ 0 };
+    std::vector<std::thread> threads;
+    for ( std::uint32_t t = 0; t < 8; ++t )
+    {
+        threads.emplace_back(
+            [&key_generator, &failures, t]()
+            {
+                std::mt19937                            gen( t );
+                std::uniform_int_distribution<uint32_t> values( 0, 1000000 );
+                for ( int i = 0; i < 16; ++i )
+                {
+                    const cpp_int value  = values( gen );
+                    const auto    cypher = ElGamal::EncryptDataAdditive( key_generator.GetPublicKey(), value );
+                    if ( key_generator.DecryptDataAdditive( cypher ) != value )
+                    {
+                        ++failures;
+                    }
+                }
+            } );
+    }
+    for ( auto &thread : threads )
+    {
+        thread.join();
+    }
+    EXPECT_EQ( failures.load(), 0 );
+
+    PrimeNumbers::BabyStepGiantStep bsgs( key_generator.GetPublicKey().params.prime_number, key_generator.GetPublicKey().params.generator );
+    EXPECT_EQ( bsgs.Lookup( 1 ).value_or( -1 ), 0 );
+    EXPECT_EQ( bsgs.Lookup( key_generator.GetPublicKey().params.generator ).value_or( -1 ), 1 );
+    EXPECT_THROW( bsgs.SolveECDLP( 0 ), std::runtime_error );
+}
+
+TEST( ElGamalKeyGeneratorTest, FixedBaseExponentiation )
+{
+    ElGamal key_generator;
+    auto   &params = key_generator.GetPublicKey().params;
+
+    PrimeNumbers::FixedBaseExponentiation table( params.generator, params.prime_number, 256 );
+    for ( size_t i = 0; i < 10; i++ )
+    {
+        cpp_int exponent = PrimeNumbers::GetRandomNumber( params.prime_number );
+        EXPECT_EQ( table.Pow( exponent ), powm( params.generator, exponent, params.prime_number ) );
+    }
+    EXPECT_EQ( table.Pow( 0 ), 1 );
+}
+
+TEST( ElGamalKeyGeneratorTest, ChunkedEncryptionDecryption )
+{
+    ElGamal              key_generator;
+    std::vector<uint8_t> my_vect( 1000 );
+    std::random_device   rd;
+    std::mt19937         gen( rd() );
+    std::generate( my_vect.begin(), my_vect.end(), [&]() { return static_cast<uint8_t>( gen() ); } );
+    // Leading and whole zero blocks must survive the round trip
+    std::fill( my_vect.begin(), my_vect.begin() + 70, 0 );
+
+    auto stream = ElGamal::EncryptDataChunked( key_generator.GetPublicKey(), my_vect );
+
+    const auto payload_size = ElGamal::GetChunkPayloadSize( key_generator.GetPublicKey().params );
+    const auto num_blocks   = ( my_vect.size() + payload_size - 1 ) / payload_size;
+    EXPECT_EQ( stream.size(), ElGamal::CHUNK_HEADER_SIZE + num_blocks * 2 * ElGamal::GetElementSize( key_generator.GetPublicKey().params ) );
+
+    EXPECT_EQ( ElGamal::DecryptDataChunked( key_generator.GetPrivateKey(), stream ), my_vect );
+    EXPECT_EQ( ElGamal::DecryptDataChunked( key_generator.GetPrivateKey(), stream, 1 ), my_vect );
+}
+
+TEST( ElGamalKeyGeneratorTest, ChunkedIncrementalDecryption )
+{
+    ElGamal              key_generator;
+    std::vector<uint8_t> my_vect( 257 );
+    for ( size_t i = 0; i < my_vect.size(); i++ )
+    {
+        my_vect[i] = static_cast<uint8_t>( i );
+    }
+
+    auto stream = ElGamal::EncryptDataChunked( key_generator.GetPublicKey(), my_vect );
+
+    ElGamal::ChunkedDecryptor decryptor( key_generator.GetPrivateKey() );
+    std::vector<uint8_t>      result;
+    for ( size_t offset = 0; offset < stream.size(); offset += 7 )
+    {
+        EXPECT_FALSE( decryptor.IsFinished() );
+        auto piece = decryptor.Update( stream.data() + offset, std::min<size_t>( 7, stream.size() - offset ) );
+        result.insert( result.end(), piece.begin(), piece.end() );
+    }
+
+    EXPECT_TRUE( decryptor.IsFinished() );
+    EXPECT_EQ( result, my_vect );
+
+    uint8_t extra = 0;
+    EXPECT_THROW( decryptor.Update( &extra, 1 ), std::runtime_error );
+}
+
+TEST( ElGamalKeyGeneratorTest, ChunkedEmptyAndTampered )
+{
+    ElGamal key_generator;
+
+    auto empty_stream = ElGamal::EncryptDataChunked( key_generator.GetPublicKey(), {} );
+    EXPECT_EQ( empty_stream.size(), ElGamal::CHUNK_HEADER_SIZE );
+    EXPECT_TRUE( ElGamal::DecryptDataChunked( key_generator.GetPrivateKey(), empty_stream ).empty() );
+
+    std::vector<uint8_t> my_vect( 64, 0xAB );
+    auto                 stream = ElGamal::EncryptDataChunked( key_generator.GetPublicKey(), my_vect );
+    stream.pop_back();
+    EXPECT_THROW( ElGamal::DecryptDataChunked( key_generator.GetPrivateKey(), stream ), std::runtime_error );
+
+    // A plaintext size close to 2^64 must not wrap the block count around to the size of the input
+    auto forged = ElGamal::EncryptDataChunked( key_generator.GetPublicKey(), my_vect );
+    std::fill_n( forged.begin(), 8, 0xFF );
+    EXPECT_THROW( ElGamal::DecryptDataChunked( key_generator.GetPrivateKey(), forged ), std::runtime_error );
+
+    ElGamal::ChunkedDecryptor decryptor( key_generator.GetPrivateKey() );
+    EXPECT_THROW( decryptor.Update( forged.data(), forged.size() ), std::runtime_error );
+}
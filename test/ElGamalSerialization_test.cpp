@@ -0,0 +1,65 @@
+/**
+ * @file       ElGamalSerialization_test.cpp
+ * @brief      Tests of the ElGamal binary format and the mapped ciphertext arrays
+ * @date       2024-03-29
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "ProofSystem/ElGamalSerialization.hpp"
+
+using namespace KeyGenerator;
+
+TEST( ElGamalSerializationTest, KeysAndParamsRoundTrip )
+{
+    ElGamal key_generator;
+
+    const auto params_bytes = serialization::SerializeParams( key_generator.GetPublicKey().params );
+    EXPECT_EQ( params_bytes.size(), serialization::HEADER_SIZE + 2 * 32 );
+    const auto params = serialization::DeserializeParams( params_bytes );
+    EXPECT_EQ( params.prime_number, cpp_int( ElGamal::SAFE_PRIME ) );
+    EXPECT_EQ( params.generator, cpp_int( ElGamal::GENERATOR ) );
+
+    const auto pubkey = serialization::DeserializePublicKey( serialization::SerializePublicKey( key_generator.GetPublicKey() ) );
+    EXPECT_EQ( pubkey.public_key_value, key_generator.GetPublicKey().public_key_value );
+
+    const auto prvkey_bytes = serialization::SerializePrivateKey( key_generator.GetPrivateKey() );
+    const auto prvkey       = serialization::DeserializePrivateKey( prvkey_bytes );
+    EXPECT_EQ( prvkey.GetPrivateKeyScalar(), key_generator.GetPrivateKey().GetPrivateKeyScalar() );
+    EXPECT_EQ( prvkey.public_key_value, key_generator.GetPublicKey().public_key_value );
+
+    // Wrong kind, future version and truncated input are all rejected
+    EXPECT_THROW( serialization::DeserializePublicKey( prvkey_bytes ), std::runtime_error );
+    auto future_version = prvkey_bytes;
+    future_version[4]   = serialization::FORMAT_VERSION + 1;
+    EXPECT_THROW( serialization::DeserializePrivateKey( future_version ), std::runtime_error );
+    auto truncated = prvkey_bytes;
+    truncated.pop_back();
+    EXPECT_THROW( serialization::DeserializePrivateKey( truncated ), std::runtime_error );
+}
+
+TEST( ElGamalSerializationTest, MappedCypherTextFile )
+{
+    ElGamal                              key_generator;
+    std::vector<ElGamal::CypherTextType> balances;
+    for ( int i = 0; i < 1000; ++i )
+    {
+        balances.push_back( ElGamal::EncryptDataAdditive( key_generator.GetPublicKey(), cpp_int( i ) ) );
+    }
+    EXPECT_EQ( serialization::DeserializeCypherTexts( serialization::SerializeCypherTexts( key_generator.GetPublicKey().params, balances ) ), balances );
+
+    const auto path = ( std::filesystem::temp_directory_path() / "ElGamalSerializationTest.bin" ).string();
+    serialization::WriteCypherTextFile( path, key_generator.GetPublicKey().params, balances );
+    {
+        serialization::MappedCypherTexts mapped( path );
+        ASSERT_EQ( mapped.Size(), balances.size() );
+        EXPECT_EQ( mapped.GetElementWidth(), 32u );
+        EXPECT_EQ( mapped.GetParams().prime_number, key_generator.GetPublicKey().params.prime_number );
+        EXPECT_EQ( mapped[123], balances[123] );
+        EXPECT_EQ( key_generator.DecryptDataAdditive( mapped[456] ), 456 );
+        EXPECT_EQ( mapped.ReadAll( 4 ), balances );
+    }
+    std::filesystem::remove( path );
+
+    EXPECT_THROW( serialization::MappedCypherTexts{ path }, std::runtime_error );
+}
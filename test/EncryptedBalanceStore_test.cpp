@@ -0,0 +1,108 @@
+/**
+ * @file       EncryptedBalanceStore_test.cpp
+ * @brief      Tests of the memory mapped encrypted balance store
+ * @date       2024-03-30
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include "ProofSystem/EncryptedBalanceStore.hpp"
+
+using namespace KeyGenerator;
+
+namespace
+{
+    std::string TemporaryStorePath( const std::string &name )
+    {
+        const auto path = ( std::filesystem::temp_directory_path() / name ).string();
+        std::filesystem::remove( path );
+        std::filesystem::remove( path + EncryptedBalanceStore::JOURNAL_SUFFIX );
+        return path;
+    }
+}
+
+TEST( EncryptedBalanceStoreTest, ApplyDeltasAndReopen )
+{
+    ElGamal    key_generator;
+    const auto path = TemporaryStorePath( "EncryptedBalanceStoreTest.bin" );
+
+    std::vector<int> expected( 100, 0 );
+    {
+        EncryptedBalanceStore store( path, key_generator.GetPublicKey().params );
+        EXPECT_EQ( store.Size(), 0u );
+        store.Resize( 100 );
+        EXPECT_EQ( key_generator.DecryptDataAdditive( store.GetBalance( 42 ) ), 0 );
+
+        // Several deltas hit the same accounts within one batch
+        std::vector<EncryptedBalanceStore::Delta> deltas;
+        for ( int i = 0; i < 300; ++i )
+        {
+            const int account = ( i * 7 ) % 100;
+            const int amount  = i % 5 + 1;
+            expected[account] += amount;
+            deltas.push_back( { static_cast<EncryptedBalanceStore::AccountId>( account ),
+                                ElGamal::EncryptDataAdditive( key_generator.GetPublicKey(), cpp_int( amount ) ) } );
+        }
+        store.ApplyDeltas( deltas, 4 );
+
+        EXPECT_THROW( store.ApplyDeltas( { { 100, deltas[0].amount } } ), std::out_of_range );
+        EXPECT_THROW( store.Resize( 10 ), std::runtime_error );
+    }
+
+    EncryptedBalanceStore store( path, key_generator.GetPublicKey().params );
+    ASSERT_EQ( store.Size(), 100u );
+    for ( std::size_t account = 0; account < store.Size(); ++account )
+    {
+        EXPECT_EQ( key_generator.DecryptDataAdditive( store.GetBalance( account ) ), expected[account] );
+    }
+    EXPECT_THROW( EncryptedBalanceStore( path, ElGamal::CreateGeneratorParams() ), std::runtime_error );
+}
+
+TEST( EncryptedBalanceStoreTest, ReplaysJournalAfterCrash )
+{
+    namespace fs = std::filesystem;
+
+    ElGamal    key_generator;
+    const auto path    = TemporaryStorePath( "EncryptedBalanceStoreCrashTest.bin" );
+    const auto journal = path + EncryptedBalanceStore::JOURNAL_SUFFIX;
+    auto      &pubkey  = key_generator.GetPublicKey();
+    {
+        EncryptedBalanceStore store( path, pubkey.params );
+        store.Resize( 10 );
+        store.ApplyDeltas( { { 3, ElGamal::EncryptDataAdditive( pubkey, cpp_int( 100 ) ) } } );
+        store.Checkpoint();
+        fs::copy_file( path, path + ".before", fs::copy_options::overwrite_existing );
+
+        store.ApplyDeltas( { { 3, ElGamal::EncryptDataAdditive( pubkey, cpp_int( 5 ) ) },
+                             { 4, ElGamal::EncryptDataAdditive( pubkey, cpp_int( 7 ) ) },
+                             { 3, ElGamal::EncryptDataAdditive( pubkey, cpp_int( 1 ) ) } } );
+        store.ApplyDeltas( { { 5, ElGamal::EncryptDataAdditive( pubkey, cpp_int( 9 ) ) } } );
+        fs::copy_file( journal, journal + ".before", fs::copy_options::overwrite_existing );
+    }
+
+    // Balances as they were before the last two batches reached the file, and their journal entries
+    fs::copy_file( path + ".before", path, fs::copy_options::overwrite_existing );
+    fs::copy_file( journal + ".before", journal, fs::copy_options::overwrite_existing );
+    {
+        // The last byte belongs to the payload of the second entry, which is complete but fails its checksum
+        std::fstream torn( journal, std::ios::binary | std::ios::in | std::ios::out );
+        torn.seekg( -1, std::ios::end );
+        const char last = static_cast<char>( torn.get() );
+        torn.seekp( -1, std::ios::end );
+        torn.put( static_cast<char>( last ^ 0x01 ) );
+    }
+
+    {
+        EncryptedBalanceStore store( path, pubkey.params );
+        EXPECT_EQ( key_generator.DecryptDataAdditive( store.GetBalance( 3 ) ), 106 );
+        EXPECT_EQ( key_generator.DecryptDataAdditive( store.GetBalance( 4 ) ), 7 );
+        EXPECT_EQ( key_generator.DecryptDataAdditive( store.GetBalance( 5 ) ), 0 );
+        EXPECT_EQ( fs::file_size( journal ), 0u );
+    }
+
+    for ( const auto &file : { path, journal, path + ".before", journal + ".before" } )
+    {
+        fs::remove( file );
+    }
+}
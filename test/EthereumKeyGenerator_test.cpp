@@ -3,6 +3,7 @@
 //
 #include <gtest/gtest.h>
 #include "ProofSystem/EthereumKeyGenerator.hpp"
+#include "ProofSystem/ECPointCodec.hpp"
 
 using namespace ethereum;
 
@@ -41,6 +42,48 @@ TEST( EthereumKeyGeneratorTest, EthereumAddressTest )
     EXPECT_EQ( address, "0xEb01f251BA36f6b96105f9eAEBfA86092756514B" );
 }
 
+TEST( EthereumKeyGeneratorTest, EthereumBatchAddressTest )
+{
+    EthereumKeyGenerator::PubKeyBytes_t known_key = { 0xb8, 0xc6, 0x11, 0xcd, 0xf2, 0xc0, 0xaf, 0xc5, 0x9a, 0xfa, 0xb6, 0x13, 0xb8, 0x9d, 0xa8, 0x34,
+                                                      0x64, 0x28, 0x49, 0x28, 0xb4, 0x82, 0xc0, 0xb6, 0x04, 0xb2, 0xa9, 0x96, 0x42, 0xcb, 0x4d, 0x06,
+                                                      0xb3, 0x32, 0x5e, 0x59, 0x90, 0xb7, 0xfa, 0xbc, 0x60, 0xb7, 0x39, 0xf4, 0x46, 0x57, 0x77, 0x4f,
+                                                      0x96, 0xcd, 0x10, 0x41, 0x75, 0x06, 0xe3, 0x14, 0x30, 0x59, 0xa3, 0x4d, 0xa0, 0x7a, 0xf4, 0x5d };
+
+    // Odd count so the vector lanes and the scalar tail are both exercised
+    std::vector<EthereumKeyGenerator::PubKeyBytes_t> pub_keys( 13, known_key );
+    std::vector<EthereumKeyGenerator>                generators( 6 );
+    for ( size_t i = 0; i < generators.size(); i++ )
+    {
+        auto x_y_ser = EthereumKeyGenerator::ExtractPubKeyFromField<std::vector<std::uint8_t>>( generators[i].get_public_key() );
+        std::reverse_copy( x_y_ser.begin(), x_y_ser.end(), pub_keys[2 * i].begin() );
+    }
+
+    auto addresses = EthereumKeyGenerator::DeriveAddresses( pub_keys );
+    ASSERT_EQ( addresses.size(), pub_keys.size() );
+
+    for ( size_t i = 0; i < generators.size(); i++ )
+    {
+        EXPECT_EQ( EthereumKeyGenerator::ToChecksumAddress( addresses[2 * i] ), generators[i].get_address() );
+        EXPECT_EQ( EthereumKeyGenerator::ToChecksumAddress( addresses[2 * i + 1] ), "0xEb01f251BA36f6b96105f9eAEBfA86092756514B" );
+    }
+    EXPECT_EQ( EthereumKeyGenerator::ToChecksumAddress( addresses.back() ), "0xEb01f251BA36f6b96105f9eAEBfA86092756514B" );
+}
+
+TEST( EthereumKeyGeneratorTest, EthereumGenerateBatchTest )
+{
+    auto entries = EthereumKeyGenerator::GenerateBatch( 37, 3 );
+    ASSERT_EQ( entries.size(), 37 );
+
+    for ( const auto &entry : entries )
+    {
+        EthereumKeyGenerator key_generator( entry.private_key );
+
+        auto x_y_ser = EthereumKeyGenerator::ExtractPubKeyFromField<std::vector<std::uint8_t>>( key_generator.get_public_key() );
+        EXPECT_TRUE( std::equal( x_y_ser.rbegin(), x_y_ser.rend(), entry.public_key.begin() ) );
+        EXPECT_EQ( EthereumKeyGenerator::ToChecksumAddress( entry.address ), key_generator.get_address() );
+    }
+}
+
 TEST( EthereumKeyGeneratorTest, EthereumKeyImportTest )
 {
     std::string          private_key = "4256949314A06D963EBB6B40515E564679C931A6DCB6A3B95D90BB532C6798A5";
@@ -49,6 +92,75 @@ TEST( EthereumKeyGeneratorTest, EthereumKeyImportTest )
     EXPECT_EQ( key_generator.get_address(), "0xEb01f251BA36f6b96105f9eAEBfA86092756514B" );
 }
 
+TEST( EthereumKeyGeneratorTest, EthereumCompressedKeyTest )
+{
+    std::string          private_key = "4256949314A06D963EBB6B40515E564679C931A6DCB6A3B95D90BB532C6798A5";
+    EthereumKeyGenerator key_generator( private_key );
+    EXPECT_EQ( key_generator.GetCompressedPubValue(), "03b8c611cdf2c0afc59afab613b89da83464284928b482c0b604b2a99642cb4d06" );
+
+    auto from_entire       = EthereumKeyGenerator::BuildPublicKey( key_generator.GetEntirePubValue() ).pubkey_data().to_affine();
+    auto from_compressed   = EthereumKeyGenerator::BuildPublicKey( key_generator.GetCompressedPubValue() ).pubkey_data().to_affine();
+    auto from_uncompressed = EthereumKeyGenerator::BuildPublicKey( "04" + key_generator.GetEntirePubValue() ).pubkey_data().to_affine();
+
+    EXPECT_EQ( from_compressed.X, from_entire.X );
+    EXPECT_EQ( from_compressed.Y, from_entire.Y );
+    EXPECT_EQ( from_uncompressed.X, from_entire.X );
+    EXPECT_EQ( from_uncompressed.Y, from_entire.Y );
+}
+
+TEST( EthereumKeyGeneratorTest, EthereumDecompressBatchTest )
+{
+    using Codec = ecpoint::PointCodec<ethereum::CurveType>;
+
+    auto entries = EthereumKeyGenerator::GenerateBatch( 64 );
+
+    std::vector<Codec::Compressed_t> compressed( entries.size() );
+    for ( std::size_t i = 0; i < entries.size(); ++i )
+    {
+        const auto &public_key = entries[i].public_key;
+        compressed[i][0]       = ( public_key.back() % 2 ) != 0 ? Codec::PARITY_ODD_ID : Codec::PARITY_EVEN_ID;
+        std::copy( public_key.begin(), public_key.begin() + Codec::COORDINATE_SIZE, compressed[i].begin() + 1 );
+    }
+
+    auto points = Codec::DecompressBatch( compressed, 4 );
+    ASSERT_EQ( points.size(), entries.size() );
+    for ( std::size_t i = 0; i < entries.size(); ++i )
+    {
+        Codec::Compressed_t round_trip;
+        Codec::Compress( points[i], round_trip.data() );
+        EXPECT_EQ( round_trip, compressed[i] );
+        EXPECT_TRUE( points[i].is_well_formed() );
+    }
+}
+
+TEST( EthereumKeyGeneratorTest, EthereumInvalidCompressedKeyTest )
+{
+    EXPECT_THROW( EthereumKeyGenerator::BuildPublicKey( "05b8c611cdf2c0afc59afab613b89da83464284928b482c0b604b2a99642cb4d06" ), std::runtime_error );
+    EXPECT_THROW( EthereumKeyGenerator::BuildPublicKey( "02ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff" ), std::runtime_error );
+    EXPECT_THROW( EthereumKeyGenerator::BuildPublicKey( "03b8c611cdf2c0afc59afab613b89da8" ), std::runtime_error );
+}
+
+TEST( EthereumKeyGeneratorTest, EthereumInvalidUncompressedKeyTest )
+{
+    using Codec = ecpoint::PointCodec<ethereum::CurveType>;
+
+    const std::string x_hex = "b8c611cdf2c0afc59afab613b89da83464284928b482c0b604b2a99642cb4d06";
+    const std::string y_hex = "b3325e5990b7fabc60b739f44657774f96cd10417506e3143059a34da07af45d";
+    const std::string p_hex = "fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f";
+
+    EXPECT_TRUE( Codec::IsOnCurve( Codec::FromHex( x_hex + y_hex ) ) );
+    EXPECT_TRUE( Codec::IsOnCurve( Codec::FromHex( "04" + x_hex + y_hex ) ) );
+
+    // Off the curve, coordinates equal to p, bad prefix and non hex digits
+    EXPECT_THROW( Codec::FromHex( x_hex + y_hex.substr( 0, 63 ) + "c" ), std::runtime_error );
+    EXPECT_THROW( Codec::FromHex( p_hex + y_hex ), std::runtime_error );
+    EXPECT_THROW( Codec::FromHex( x_hex + p_hex ), std::runtime_error );
+    EXPECT_THROW( Codec::FromHex( "05" + x_hex + y_hex ), std::runtime_error );
+    EXPECT_THROW( Codec::FromHex( "g4" + x_hex + y_hex ), std::runtime_error );
+    EXPECT_THROW( Codec::FromHex( x_hex + y_hex.substr( 0, 62 ) + "x5" ), std::runtime_error );
+    EXPECT_THROW( Codec::FromHex( "03" + x_hex.substr( 0, 63 ) + "z" ), std::runtime_error );
+}
+
 // Address generation functionality is commented out in the provided code
 // Uncomment the following test if the functionality is implemented
 /*
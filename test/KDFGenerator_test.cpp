@@ -76,6 +76,25 @@ TEST( KDFGeneratorTest, KDFGeneratorBTC_ECDHSessionKey )
     delete ( KDFInstance_Intruder );
 }
 
+TEST( KDFGeneratorTest, KDFGeneratorBTC_CompressedKeys )
+{
+
+    BitcoinKeyGenerator prover_instance;
+    BitcoinKeyGenerator sgnus_instance;
+
+    KDFGenerator<bitcoin::policy_type> KDFInstance_Entire( prover_instance.get_private_key(), sgnus_instance.GetEntirePubValue() );
+    KDFGenerator<bitcoin::policy_type> KDFInstance_Compressed( prover_instance.get_private_key(), sgnus_instance.GetUsedPubKeyValue() );
+    KDFGenerator<bitcoin::policy_type> KDFInstance_Revealer( sgnus_instance.get_private_key(), prover_instance.GetUsedPubKeyValue() );
+
+    EXPECT_TRUE( KDFInstance_Entire == KDFInstance_Compressed );
+    EXPECT_TRUE( KDFInstance_Compressed == KDFInstance_Revealer );
+
+    auto shared_secret = KDFInstance_Compressed.GenerateSharedSecret( prover_instance.get_private_key(), sgnus_instance.GetUsedPubKeyValue() );
+    auto derived_scalar_value =
+        KDFInstance_Compressed.GetNewKeyFromSecret( shared_secret, prover_instance.GetUsedPubKeyValue(), sgnus_instance.GetUsedPubKeyValue() );
+    EXPECT_NE( derived_scalar_value, 0 );
+}
+
 TEST( KDFGeneratorTest, KDFGeneratorBTC_ECDHSecurity )
 {
 
@@ -9,6 +9,9 @@
 #include <include/MPCVerifierCircuit.hpp>
 #include "Requestor.hpp"
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <nil/crypto3/algebra/curves/pallas.hpp>
 
 using namespace nil::crypto3::algebra::curves;
@@ -136,4 +139,103 @@ TEST(MPCVerifierCircuitTest, MPCValidateTransactionPassExactBalance) {
     auto expected_new_balance_commitment = generator * 0;
 
     EXPECT_TRUE(MPCValidateTransaction(total_random_sum, balance, amount, balance_commitment, amount_commitment, expected_new_balance_commitment, generator, final_aggregate));
-}
\ No newline at end of file
+}
+
+// The running sums must match a full recomputation after nonces are replaced
+TEST(MPCVerifierCircuitTest, RequestorIncrementalAggregate) {
+    Requestor local_requestor(8, 4, 4);
+
+    EXPECT_EQ(local_requestor.getFinalAggregate(), local_requestor.getTotalRandomSum());
+
+    local_requestor.replaceNodeNonces(3);
+    local_requestor.replaceNodeNonces(7);
+    EXPECT_EQ(local_requestor.getFinalAggregate(), local_requestor.getTotalRandomSum());
+
+    auto generator = local_requestor.getGenerator();
+    auto nonce_a = local_requestor.getNonceA(2, 1);
+    auto nonce_b = local_requestor.getNonceB(2, 1);
+    local_requestor.replaceNonce(2, 1, nonce_a + generator, nonce_b);
+    EXPECT_EQ(local_requestor.getFinalAggregate(), local_requestor.getTotalRandomSum() + generator);
+
+    auto recomputed = typename pallas::template g1_type<coordinates::affine>::value_type();
+    auto all_a = local_requestor.getNonceA();
+    auto all_b = local_requestor.getNonceB();
+    ASSERT_EQ(all_a.size(), 8u * 4u);
+    for (size_t i = 0; i < all_a.size(); ++i) {
+        recomputed = recomputed + all_a[i] + all_b[i];
+    }
+    EXPECT_EQ(recomputed, local_requestor.getFinalAggregate());
+}
+
+// Nodes report out of order from several threads, the aggregate is ready when the last one arrives
+TEST(MPCVerifierCircuitTest, StreamingNonceAggregation) {
+    const size_t num_nodes = 12;
+    const size_t num_blocks = 5;
+    Requestor local_requestor(num_nodes, num_blocks, 4);
+
+    std::atomic<size_t> callbacks{0};
+    NonceAggregator<pallas> aggregator(num_nodes, num_blocks, [&](const NonceAggregator<pallas>::Result&) { ++callbacks; });
+
+    EXPECT_FALSE(aggregator.WaitForResult(std::chrono::milliseconds(1)).has_value());
+
+    std::vector<size_t> order(num_nodes);
+    for (size_t i = 0; i < num_nodes; ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> completions{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (size_t i = next++; i < num_nodes; i = next++) {
+                auto status = aggregator.Submit(local_requestor.getContribution(order[i]));
+                EXPECT_NE(status, NonceAggregator<pallas>::SubmitResult::INCONSISTENT);
+                if (status == NonceAggregator<pallas>::SubmitResult::COMPLETE) {
+                    ++completions;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(completions.load(), 1u);
+    EXPECT_EQ(callbacks.load(), 1u);
+    EXPECT_EQ(aggregator.GetReceivedCount(), num_nodes);
+
+    auto result = aggregator.WaitForResult(std::chrono::milliseconds(0));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->final_aggregate, local_requestor.getFinalAggregate());
+    EXPECT_EQ(result->total_random_sum, local_requestor.getTotalRandomSum());
+
+    EXPECT_EQ(aggregator.Submit(local_requestor.getContribution(0)), NonceAggregator<pallas>::SubmitResult::DUPLICATE);
+}
+
+// Malformed contributions are rejected and leave the aggregate untouched
+TEST(MPCVerifierCircuitTest, StreamingNonceAggregationRejects) {
+    Requestor local_requestor(3, 4);
+    NonceAggregator<pallas> aggregator(3, 4);
+
+    auto out_of_range = local_requestor.getContribution(0);
+    out_of_range.node_number = 3;
+    EXPECT_EQ(aggregator.Submit(out_of_range), NonceAggregator<pallas>::SubmitResult::INVALID_NODE);
+
+    auto short_contribution = local_requestor.getContribution(0);
+    short_contribution.nonces_b.pop_back();
+    EXPECT_EQ(aggregator.Submit(short_contribution), NonceAggregator<pallas>::SubmitResult::INVALID_NODE);
+
+    auto tampered = local_requestor.getContribution(1);
+    tampered.nonces_a[2] = tampered.nonces_a[2] + local_requestor.getGenerator();
+    EXPECT_EQ(aggregator.Submit(tampered), NonceAggregator<pallas>::SubmitResult::INCONSISTENT);
+
+    auto wrong_commitment = local_requestor.getContribution(1);
+    wrong_commitment.random_commitment = local_requestor.getGenerator();
+    EXPECT_EQ(aggregator.Submit(wrong_commitment), NonceAggregator<pallas>::SubmitResult::INCONSISTENT);
+
+    EXPECT_EQ(aggregator.GetReceivedCount(), 0u);
+    EXPECT_EQ(aggregator.Submit(local_requestor.getContribution(1)), NonceAggregator<pallas>::SubmitResult::ACCEPTED);
+    EXPECT_FALSE(aggregator.TryGetResult().has_value());
+}
@@ -0,0 +1,94 @@
+/**
+ * @file       Metrics_test.cpp
+ * @brief      Tests of the metrics registry
+ * @date       2024-03-25
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ProofSystem/Metrics.hpp"
+
+namespace
+{
+    const metrics::MetricSnapshot *FindMetric( const std::vector<metrics::MetricSnapshot> &snapshot, const std::string &name )
+    {
+        for ( const auto &metric : snapshot )
+        {
+            if ( metric.name == name )
+            {
+                return &metric;
+            }
+        }
+        return nullptr;
+    }
+}
+
+TEST( MetricsTest, CountersAndHistogramsAcrossThreads )
+{
+    auto &registry = metrics::Registry::Instance();
+
+    const auto counter   = registry.Register( "test_items", metrics::MetricKind::COUNTER );
+    const auto histogram = registry.Register( "test_sizes", metrics::MetricKind::HISTOGRAM );
+    EXPECT_EQ( registry.Register( "test_items", metrics::MetricKind::COUNTER ), counter );
+    EXPECT_THROW( registry.Register( "test_items", metrics::MetricKind::TIMER ), std::runtime_error );
+    registry.Reset();
+
+    // Threads exit before the snapshot, so their slabs must have been folded into the totals
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < 4; ++t )
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                for ( std::uint64_t i = 0; i < 1000; ++i )
+                {
+                    registry.Add( counter, 3 );
+                    registry.Observe( histogram, i );
+                }
+            } );
+    }
+    for ( auto &thread : threads )
+    {
+        thread.join();
+    }
+    registry.Add( counter, 1 );
+
+    const auto  snapshot = registry.Snapshot();
+    const auto *items    = FindMetric( snapshot, "test_items" );
+    const auto *sizes    = FindMetric( snapshot, "test_sizes" );
+    ASSERT_NE( items, nullptr );
+    ASSERT_NE( sizes, nullptr );
+    EXPECT_EQ( items->count, 4001u );
+    EXPECT_EQ( items->sum, 12001u );
+    EXPECT_EQ( sizes->count, 4000u );
+    EXPECT_EQ( sizes->sum, 4u * 999u * 1000u / 2u );
+    EXPECT_EQ( sizes->buckets[0], 4u );                                  // 0
+    EXPECT_EQ( sizes->buckets[metrics::BucketIndex( 512 )], 4u * 488u ); // 512 to 999
+
+    const std::string prometheus = registry.ExportPrometheus();
+    EXPECT_NE( prometheus.find( "proofsystem_test_items_total 12001" ), std::string::npos );
+    EXPECT_NE( prometheus.find( "proofsystem_test_sizes_count 4000" ), std::string::npos );
+    EXPECT_NE( prometheus.find( "proofsystem_test_sizes_bucket{le=\"+Inf\"} 4000" ), std::string::npos );
+    EXPECT_NE( registry.ExportJson().find( "\"test_items\":{\"kind\":\"counter\",\"count\":4001,\"sum\":12001}" ), std::string::npos );
+}
+
+TEST( MetricsTest, InstrumentationMacros )
+{
+    for ( int i = 0; i < 3; ++i )
+    {
+        PROOFSYSTEM_SCOPED_TIMER( "test_macro_seconds" );
+        PROOFSYSTEM_COUNTER_ADD( "test_macro_items", 2 );
+    }
+
+    const auto  snapshot = metrics::Registry::Instance().Snapshot();
+    const auto *timer    = FindMetric( snapshot, "test_macro_seconds" );
+#ifdef PROOFSYSTEM_ENABLE_METRICS
+    ASSERT_NE( timer, nullptr );
+    EXPECT_EQ( timer->kind, metrics::MetricKind::TIMER );
+    EXPECT_GE( timer->count, 3u );
+#else
+    EXPECT_EQ( timer, nullptr );
+#endif
+}
@@ -0,0 +1,116 @@
+/**
+ * @file       MultiLaneHash_test.cpp
+ * @brief      Tests of the multi-buffer hash kernels
+ * @date       2024-03-06
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+#include <random>
+#include "ProofSystem/MultiLaneHash.hpp"
+#include "ProofSystem/util.hpp"
+
+using namespace hashing;
+
+namespace
+{
+    std::string DigestToString( const std::vector<std::uint8_t> &digest )
+    {
+        // util::to_string prints the last byte first
+        return util::to_string( std::vector<std::uint8_t>( digest.rbegin(), digest.rend() ) );
+    }
+}
+
+TEST( MultiLaneHashTest, Keccak256KnownVectors )
+{
+    std::vector<std::uint8_t> digest( KECCAK256_DIGEST_SIZE );
+
+    Keccak256( nullptr, 0, digest.data() );
+    EXPECT_EQ( DigestToString( digest ), "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470" );
+
+    const std::string abc = "abc";
+    Keccak256( reinterpret_cast<const std::uint8_t *>( abc.data() ), abc.size(), digest.data() );
+    EXPECT_EQ( DigestToString( digest ), "4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45" );
+}
+
+TEST( MultiLaneHashTest, Keccak256BatchMatchesScalar )
+{
+    std::mt19937 gen( 42 );
+
+    // Sizes around the 136 byte rate boundary
+    for ( std::size_t message_size : { 0, 1, 64, 135, 136, 137, 300 } )
+    {
+        const std::size_t         count = 19;
+        std::vector<std::uint8_t> messages( count * message_size );
+        std::generate( messages.begin(), messages.end(), [&]() { return static_cast<std::uint8_t>( gen() ); } );
+
+        std::vector<std::uint8_t> expected( count * KECCAK256_DIGEST_SIZE );
+        for ( std::size_t i = 0; i < count; i++ )
+        {
+            Keccak256( messages.data() + i * message_size, message_size, expected.data() + i * KECCAK256_DIGEST_SIZE );
+        }
+
+        for ( auto level : { SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512 } )
+        {
+            SetMaxSimdLevel( level );
+            std::vector<std::uint8_t> digests( count * KECCAK256_DIGEST_SIZE );
+            Keccak256Batch( messages.data(), message_size, count, digests.data() );
+            EXPECT_EQ( digests, expected ) << "message size " << message_size << " level " << static_cast<int>( level );
+        }
+    }
+    SetMaxSimdLevel( SimdLevel::AVX512 );
+}
+
+TEST( MultiLaneHashTest, Sha256AndRipemd160KnownVectors )
+{
+    const std::string abc = "abc";
+
+    std::vector<std::uint8_t> sha_digest( SHA256_DIGEST_SIZE );
+    for ( auto level : { SimdLevel::SCALAR, SimdLevel::AVX512 } )
+    {
+        // SCALAR also turns off the SHA extensions
+        SetMaxSimdLevel( level );
+        Sha256( reinterpret_cast<const std::uint8_t *>( abc.data() ), abc.size(), sha_digest.data() );
+        EXPECT_EQ( DigestToString( sha_digest ), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" );
+    }
+
+    std::vector<std::uint8_t> ripemd_digest( RIPEMD160_DIGEST_SIZE );
+    Ripemd160( nullptr, 0, ripemd_digest.data() );
+    EXPECT_EQ( DigestToString( ripemd_digest ), "9c1185a5c5e9fc54612808977ee8f548b2258d31" );
+    Ripemd160( reinterpret_cast<const std::uint8_t *>( abc.data() ), abc.size(), ripemd_digest.data() );
+    EXPECT_EQ( DigestToString( ripemd_digest ), "8eb208f7e05d987a9b044a8e98c6b087f15a0bfc" );
+}
+
+TEST( MultiLaneHashTest, Sha256AndRipemd160BatchMatchesScalar )
+{
+    std::mt19937 gen( 42 );
+
+    // Sizes around the 56 byte padding limit and the 64 byte block
+    for ( std::size_t message_size : { 0, 20, 32, 33, 55, 56, 64, 65, 200 } )
+    {
+        const std::size_t         count = 37;
+        std::vector<std::uint8_t> messages( count * message_size );
+        std::generate( messages.begin(), messages.end(), [&]() { return static_cast<std::uint8_t>( gen() ); } );
+
+        SetMaxSimdLevel( SimdLevel::SCALAR );
+        std::vector<std::uint8_t> expected_sha( count * SHA256_DIGEST_SIZE );
+        std::vector<std::uint8_t> expected_ripemd( count * RIPEMD160_DIGEST_SIZE );
+        for ( std::size_t i = 0; i < count; i++ )
+        {
+            Sha256( messages.data() + i * message_size, message_size, expected_sha.data() + i * SHA256_DIGEST_SIZE );
+            Ripemd160( messages.data() + i * message_size, message_size, expected_ripemd.data() + i * RIPEMD160_DIGEST_SIZE );
+        }
+
+        for ( auto level : { SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512 } )
+        {
+            SetMaxSimdLevel( level );
+            std::vector<std::uint8_t> sha_digests( count * SHA256_DIGEST_SIZE );
+            std::vector<std::uint8_t> ripemd_digests( count * RIPEMD160_DIGEST_SIZE );
+            Sha256Batch( messages.data(), message_size, count, sha_digests.data() );
+            Ripemd160Batch( messages.data(), message_size, count, ripemd_digests.data() );
+            EXPECT_EQ( sha_digests, expected_sha ) << "message size " << message_size << " level " << static_cast<int>( level );
+            EXPECT_EQ( ripemd_digests, expected_ripemd ) << "message size " << message_size << " level " << static_cast<int>( level );
+        }
+    }
+    SetMaxSimdLevel( SimdLevel::AVX512 );
+}
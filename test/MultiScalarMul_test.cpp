@@ -0,0 +1,82 @@
+/**
+ * @file       MultiScalarMul_test.cpp
+ * @brief      Tests of the Pippenger multi-scalar multiplication
+ * @date       2024-03-19
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#include <gtest/gtest.h>
+#include <vector>
+#include <nil/crypto3/algebra/curves/pallas.hpp>
+#include <nil/crypto3/algebra/curves/secp_k1.hpp>
+#include <nil/crypto3/algebra/random_element.hpp>
+#include "ProofSystem/MultiScalarMul.hpp"
+
+using namespace nil::crypto3::algebra;
+
+namespace
+{
+    template <typename CurveType>
+    void CheckAgainstNaive( std::size_t count, std::size_t num_threads )
+    {
+        using g1_value_type     = typename CurveType::template g1_type<>::value_type;
+        using scalar_value_type = typename CurveType::scalar_field_type::value_type;
+
+        std::vector<g1_value_type>     points;
+        std::vector<scalar_value_type> scalars;
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            points.push_back( random_element<typename CurveType::template g1_type<>>() );
+            scalars.push_back( random_element<typename CurveType::scalar_field_type>() );
+        }
+        // Zero and one leave most buckets empty
+        if ( count > 2 )
+        {
+            scalars[0] = scalar_value_type::zero();
+            scalars[1] = scalar_value_type::one();
+        }
+
+        g1_value_type expected = g1_value_type::zero();
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            expected = expected + scalars[i] * points[i];
+        }
+
+        auto result = msm::MultiScalarMul( points, scalars, num_threads );
+        EXPECT_EQ( result.is_zero(), expected.is_zero() );
+        if ( !expected.is_zero() )
+        {
+            EXPECT_EQ( result.to_affine(), expected.to_affine() );
+        }
+    }
+}
+
+TEST( MultiScalarMulTest, Secp256k1MatchesNaive )
+{
+    for ( std::size_t count : { 0, 1, 3, 31, 100 } )
+    {
+        CheckAgainstNaive<curves::secp256k1>( count, 1 );
+    }
+}
+
+TEST( MultiScalarMulTest, PallasMatchesNaive )
+{
+    for ( std::size_t count : { 0, 1, 3, 31, 100 } )
+    {
+        CheckAgainstNaive<curves::pallas>( count, 1 );
+    }
+}
+
+TEST( MultiScalarMulTest, ParallelBucketsMatchNaive )
+{
+    CheckAgainstNaive<curves::secp256k1>( 257, 4 );
+    CheckAgainstNaive<curves::pallas>( 257, 0 );
+}
+
+TEST( MultiScalarMulTest, MismatchedSizesThrow )
+{
+    using g1_value_type = curves::pallas::g1_type<>::value_type;
+
+    std::vector<g1_value_type>                                 points( 2, g1_value_type::one() );
+    std::vector<curves::pallas::scalar_field_type::value_type> scalars( 1 );
+    EXPECT_THROW( msm::MultiScalarMul( points, scalars ), std::runtime_error );
+}
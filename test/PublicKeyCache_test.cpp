@@ -0,0 +1,110 @@
+/**
+ * @file       PublicKeyCache_test.cpp
+ * @brief      Tests of the shared public key cache
+ * @date       2024-03-14
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cctype>
+#include <thread>
+#include <vector>
+#include "ProofSystem/EthereumKeyGenerator.hpp"
+#include "ProofSystem/PublicKeyCache.hpp"
+
+using namespace ethereum;
+
+using KeyCache = ecpoint::PublicKeyCache<ethereum::CurveType>;
+
+TEST( PublicKeyCacheTest, RepeatedKeysHitTheCache )
+{
+    EthereumKeyGenerator key_generator;
+    KeyCache             cache( 64, 4 );
+
+    auto first  = cache.Get( key_generator.GetEntirePubValue() ).to_affine();
+    auto second = cache.Get( key_generator.GetEntirePubValue() ).to_affine();
+    auto upper  = key_generator.GetEntirePubValue();
+    std::transform( upper.begin(), upper.end(), upper.begin(), []( unsigned char c ) { return static_cast<char>( std::toupper( c ) ); } );
+    auto third = cache.Get( upper ).to_affine();
+
+    EXPECT_EQ( first.X, second.X );
+    EXPECT_EQ( first.Y, third.Y );
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ( stats.misses, 1 );
+    EXPECT_EQ( stats.hits, 2 );
+    EXPECT_EQ( stats.size, 1 );
+    EXPECT_DOUBLE_EQ( stats.HitRate(), 2.0 / 3.0 );
+}
+
+TEST( PublicKeyCacheTest, InvalidKeysAreRejectedAndNotCached )
+{
+    EthereumKeyGenerator key_generator;
+    KeyCache             cache( 64, 4 );
+
+    // Flipping the last digit of Y moves the point off the curve
+    auto bad_key   = key_generator.GetEntirePubValue();
+    bad_key.back() = bad_key.back() == '0' ? '1' : '0';
+
+    EXPECT_THROW( cache.Get( bad_key ), std::runtime_error );
+    EXPECT_THROW( cache.Get( bad_key ), std::runtime_error );
+    EXPECT_EQ( cache.GetStats().size, 0 );
+    EXPECT_EQ( cache.GetStats().misses, 2 );
+}
+
+TEST( PublicKeyCacheTest, CapacityIsBounded )
+{
+    KeyCache cache( 8, 1 );
+
+    auto entries = EthereumKeyGenerator::GenerateBatch( 20 );
+    for ( const auto &entry : entries )
+    {
+        std::string key_hex;
+        for ( auto byte : entry.public_key )
+        {
+            static constexpr char DIGITS[] = "0123456789abcdef";
+            key_hex.push_back( DIGITS[byte >> 4] );
+            key_hex.push_back( DIGITS[byte & 0x0f] );
+        }
+        cache.Get( key_hex );
+    }
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ( stats.size, 8 );
+    EXPECT_EQ( stats.evictions, 12 );
+}
+
+TEST( PublicKeyCacheTest, ConcurrentLookups )
+{
+    std::vector<std::string> keys;
+    for ( int i = 0; i < 8; ++i )
+    {
+        keys.push_back( EthereumKeyGenerator().GetCompressedPubValue() );
+    }
+    KeyCache cache( 64, 4 );
+
+    std::vector<std::thread> workers;
+    for ( int worker = 0; worker < 4; ++worker )
+    {
+        workers.emplace_back(
+            [&]()
+            {
+                for ( int round = 0; round < 16; ++round )
+                {
+                    for ( const auto &key : keys )
+                    {
+                        EXPECT_TRUE( cache.Get( key ).is_well_formed() );
+                    }
+                }
+            } );
+    }
+    for ( auto &worker : workers )
+    {
+        worker.join();
+    }
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ( stats.size, keys.size() );
+    EXPECT_EQ( stats.hits + stats.misses, 4 * 16 * keys.size() );
+    EXPECT_GE( stats.hits, 4 * 16 * keys.size() - 4 * keys.size() );
+}
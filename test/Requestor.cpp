@@ -1,105 +1,213 @@
 #include "Requestor.hpp"
 #include <cstdio>
-// Constructor
-Requestor::Requestor( size_t num_nodes, size_t num_blocks_per_node ) : num_nodes( num_nodes ), num_blocks_per_node( num_blocks_per_node )
+#include "ProofSystem/ParallelFor.hpp"
+
+// Constructor, the generator uses example coordinates (replace with the actual generator point if known)
+Requestor::Requestor( size_t num_nodes, size_t num_blocks_per_node, size_t num_threads ) :
+    num_nodes( num_nodes ),                     //
+    num_blocks_per_node( num_blocks_per_node ), //
+    num_threads( num_threads ),                 //
+    gen( std::random_device{}() ),              //
+    generator( 1, 2 ),                          //
+    generator_table( jacobian_type( generator.X, generator.Y, base_type::one() ), pallas::scalar_field_type::number_bits )
 {
-    // Initialize the generator point (replace with the actual generator point if known)
-    generator = typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type(
-        1, 2 ); // Example coordinates for the generator
     setupNodes();
 }
 
 // Setup node Nonce A and Nonce B values
 void Requestor::setupNodes()
 {
-    std::random_device                           rd;
-    std::mt19937                                 gen( rd() );
     std::uniform_int_distribution<std::uint64_t> dis( 0, 100000 ); // Random number generation
     std::uint64_t                                base_random = dis( gen );
-    base_nonce                                               = typename pallas::scalar_field_type::value_type( base_random );
-    std::uniform_int_distribution<std::uint64_t> dist2( base_random + num_blocks_per_node + num_nodes, base_random + 100000 );
+    base_nonce                                               = scalar_type( base_random );
+    node_distribution = std::uniform_int_distribution<std::uint64_t>( base_random + num_blocks_per_node + num_nodes, base_random + 100000 );
+
+    // The random numbers are drawn up front, so the nonces of all the nodes can be generated concurrently
+    random_numbers.clear();
+    random_sum = scalar_type::zero();
     for ( size_t i = 0; i < num_nodes; ++i )
     {
-        std::uint64_t random_number = dist2( gen ); // Generate a random number
-
-        // Store the random number as a base field element
-        random_numbers.push_back( typename pallas::scalar_field_type::value_type( random_number ) );
+        random_numbers.push_back( scalar_type( node_distribution( gen ) ) );
+        random_sum = random_sum + random_numbers.back();
+    }
+    nonces_a.resize( num_nodes * num_blocks_per_node );
+    nonces_b.resize( num_nodes * num_blocks_per_node );
 
-        // Generate Nonce A and Nonce B for each block in the node
-        generateNoncesForNode( i );
+    std::vector<jacobian_type> node_sums( num_nodes );
+    util::ParallelFor(
+        num_nodes,
+        [&]( size_t begin, size_t end )
+        {
+            for ( size_t node_number = begin; node_number < end; ++node_number )
+            {
+                node_sums[node_number] = generateNoncesForNode( node_number );
+            }
+        },
+        num_threads );
+
+    final_aggregate = jacobian_type::zero();
+    for ( const auto &node_sum : node_sums )
+    {
+        final_aggregate = final_aggregate + node_sum;
     }
+    updateTotalRandomSum();
 }
 
 // Generate Nonces for a specific node
-void Requestor::generateNoncesForNode( size_t node_number )
+Requestor::jacobian_type Requestor::generateNoncesForNode( size_t node_number )
 {
-
+    std::vector<jacobian_type> points( 2 * num_blocks_per_node );
     for ( size_t block_index = 0; block_index < num_blocks_per_node; ++block_index )
     {
         // Retrieve positive and negative nonces
         auto positive_nonce = random_numbers[node_number] + base_nonce;
         auto negative_nonce = random_numbers[node_number] - base_nonce;
+        auto offset         = scalar_type( node_number + block_index );
 
-        // Create Nonce A and Nonce B as base field types
-        nonces_a.push_back( generator * typename pallas::scalar_field_type::value_type( negative_nonce - node_number - block_index ) );
-        nonces_b.push_back( generator * typename pallas::scalar_field_type::value_type( positive_nonce + node_number + block_index ) );
+        // Nonce A at even positions, Nonce B at odd ones
+        points[2 * block_index]     = generator_table.Mul( negative_nonce - offset );
+        points[2 * block_index + 1] = generator_table.Mul( positive_nonce + offset );
     }
+
+    // A single field inversion for all the nonces of the node
+    std::vector<affine_type> affine( points.size() );
+    ecbatch::BatchToAffine( points.data(), points.size(), affine.data() );
+
+    jacobian_type node_sum = jacobian_type::zero();
+    for ( size_t block_index = 0; block_index < num_blocks_per_node; ++block_index )
+    {
+        nonces_a.store( nonceIndex( node_number, block_index ), affine[2 * block_index] );
+        nonces_b.store( nonceIndex( node_number, block_index ), affine[2 * block_index + 1] );
+        node_sum = node_sum + points[2 * block_index] + points[2 * block_index + 1];
+    }
+    return node_sum;
 }
 
-// Calculate the total random sum as a G1 point
-typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type Requestor::getTotalRandomSum() const
+void Requestor::replaceNodeNonces( size_t node_number )
 {
-    // Start with the identity point for the curve
-    typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type total_sum =
-        typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type(); // Identity point
-
-    for ( const auto &num : random_numbers )
+    jacobian_type old_node_sum = jacobian_type::zero();
+    for ( size_t block_index = 0; block_index < num_blocks_per_node; ++block_index )
     {
-        // Accumulate the total random sum as G1 points
-        total_sum = total_sum + ( generator * num * 2 * num_blocks_per_node ); // Convert each number to a curve point using the generator
+        const auto index = nonceIndex( node_number, block_index );
+        const auto a     = nonces_a.at( index );
+        const auto b     = nonces_b.at( index );
+        old_node_sum     = old_node_sum + jacobian_type( a.X, a.Y, base_type::one() ) + jacobian_type( b.X, b.Y, base_type::one() );
     }
+    random_sum                  = random_sum - random_numbers[node_number];
+    random_numbers[node_number] = scalar_type( node_distribution( gen ) );
+    random_sum                  = random_sum + random_numbers[node_number];
+
+    final_aggregate = final_aggregate - old_node_sum + generateNoncesForNode( node_number );
+    updateTotalRandomSum();
+}
+
+void Requestor::replaceNonce( size_t node_number, size_t block_index, const affine_type &nonce_a, const affine_type &nonce_b )
+{
+    const auto index = nonceIndex( node_number, block_index );
+    const auto old_a = nonces_a.at( index );
+    const auto old_b = nonces_b.at( index );
+
+    final_aggregate = final_aggregate - jacobian_type( old_a.X, old_a.Y, base_type::one() ) - jacobian_type( old_b.X, old_b.Y, base_type::one() ) +
+                      jacobian_type( nonce_a.X, nonce_a.Y, base_type::one() ) + jacobian_type( nonce_b.X, nonce_b.Y, base_type::one() );
+    nonces_a.store( index, nonce_a );
+    nonces_b.store( index, nonce_b );
+}
+
+// Every term shares the generator, so the scalars are summed first and multiplied once
+void Requestor::updateTotalRandomSum()
+{
+    total_random_sum = generator_table.Mul( random_sum * scalar_type( 2 * num_blocks_per_node ) );
+}
+
+size_t Requestor::nonceIndex( size_t node_number, size_t block_index ) const
+{
+    return node_number * num_blocks_per_node + block_index;
+}
 
-    return total_sum; // Return the total sum as a G1 point
+// Calculate the total random sum as a G1 point, kept up to date as nodes are replaced
+Requestor::affine_type Requestor::getTotalRandomSum() const
+{
+    return total_random_sum.to_affine();
 }
 
-// Calculate the final aggregate
-typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type Requestor::getFinalAggregate() const
+// Calculate the final aggregate, kept up to date as nonces are replaced
+Requestor::affine_type Requestor::getFinalAggregate() const
 {
-    // Initialize aggregate as the identity point
-    typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type aggregate =
-        typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type();
+    return final_aggregate.to_affine();
+}
 
-    for ( size_t i = 0; i < nonces_a.size(); i += num_blocks_per_node )
+// Getters for Nonces
+std::vector<Requestor::affine_type> Requestor::getNonceA() const
+{
+    std::vector<affine_type> nonces;
+    nonces.reserve( nonces_a.x.size() );
+    for ( size_t i = 0; i < nonces_a.x.size(); ++i )
     {
-        // Aggregate Nonce A and Nonce B values in the context of the curve
+        nonces.push_back( nonces_a.at( i ) );
+    }
+    return nonces;
+}
 
-        for ( size_t block_index = 0; block_index < num_blocks_per_node; ++block_index )
-        {
-            aggregate = aggregate + nonces_a[i + block_index] + nonces_b[i + block_index];
-        }
+std::vector<Requestor::affine_type> Requestor::getNonceB() const
+{
+    std::vector<affine_type> nonces;
+    nonces.reserve( nonces_b.x.size() );
+    for ( size_t i = 0; i < nonces_b.x.size(); ++i )
+    {
+        nonces.push_back( nonces_b.at( i ) );
     }
+    return nonces;
+}
 
-    return aggregate; // Return the computed final aggregate
+Requestor::affine_type Requestor::getNonceA( size_t node_number, size_t block_index ) const
+{
+    return nonces_a.at( nonceIndex( node_number, block_index ) );
 }
 
-// Getters for Nonces
-const std::vector<typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type> &Requestor::getNonceA() const
+Requestor::affine_type Requestor::getNonceB( size_t node_number, size_t block_index ) const
 {
-    return nonces_a;
+    return nonces_b.at( nonceIndex( node_number, block_index ) );
 }
 
-const std::vector<typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type> &Requestor::getNonceB() const
+NonceAggregator<pallas>::Contribution Requestor::getContribution( size_t node_number ) const
 {
-    return nonces_b;
+    NonceAggregator<pallas>::Contribution contribution;
+    contribution.node_number       = node_number;
+    contribution.random_commitment = generator_table.Mul( random_numbers[node_number] ).to_affine();
+    contribution.nonces_a.reserve( num_blocks_per_node );
+    contribution.nonces_b.reserve( num_blocks_per_node );
+    for ( size_t block_index = 0; block_index < num_blocks_per_node; ++block_index )
+    {
+        contribution.nonces_a.push_back( getNonceA( node_number, block_index ) );
+        contribution.nonces_b.push_back( getNonceB( node_number, block_index ) );
+    }
+    return contribution;
 }
 
-const typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type Requestor::getAggregateBaseNonce() const
+const Requestor::affine_type Requestor::getAggregateBaseNonce() const
 {
     // A & B nonce sum registers
     return generator * ( base_nonce * 2 * num_nodes * num_blocks_per_node );
 }
 
-const typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type &Requestor::getGenerator() const
+const Requestor::affine_type &Requestor::getGenerator() const
 {
     return generator;
 }
+
+void Requestor::NonceColumns::resize( size_t size )
+{
+    x.resize( size );
+    y.resize( size );
+}
+
+Requestor::affine_type Requestor::NonceColumns::at( size_t index ) const
+{
+    return affine_type( x[index], y[index] );
+}
+
+void Requestor::NonceColumns::store( size_t index, const affine_type &point )
+{
+    x[index] = point.X;
+    y[index] = point.Y;
+}
@@ -5,40 +5,79 @@
 #include <vector>
 #include <random>
 
+#include "ProofSystem/ECBatchOps.hpp"
+#include "ProofSystem/NonceAggregator.hpp"
+
 using namespace nil::crypto3::algebra::curves;
 
 class Requestor {
 public:
-    Requestor(size_t num_nodes, size_t num_blocks_per_node);
+    using affine_type   = typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type;
+    using jacobian_type = typename pallas::template g1_type<>::value_type;
+    using scalar_type   = typename pallas::scalar_field_type::value_type;
+    using base_type     = typename pallas::base_field_type::value_type;
+
+    Requestor(size_t num_nodes, size_t num_blocks_per_node, size_t num_threads = 0);
 
     void setupNodes();
 
     // Updated return type for total random sum (now returns a G1 point)
-    typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type getTotalRandomSum() const;
-    typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type getFinalAggregate() const;
+    affine_type getTotalRandomSum() const;
+    affine_type getFinalAggregate() const;
 
-    // Getters for Nonce A and B values
-    const std::vector<typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type>& getNonceA() const;
-    const std::vector<typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type>& getNonceB() const;
+    // Getters for Nonce A and B values, built from the coordinate columns
+    std::vector<affine_type> getNonceA() const;
+    std::vector<affine_type> getNonceB() const;
+    affine_type getNonceA(size_t node_number, size_t block_index) const;
+    affine_type getNonceB(size_t node_number, size_t block_index) const;
+
+    // Nonces of a single node, as the node would submit them to a NonceAggregator
+    NonceAggregator<pallas>::Contribution getContribution(size_t node_number) const;
 
     // get the sum of all the base nonce random values
-    const typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type getAggregateBaseNonce() const;
+    const affine_type getAggregateBaseNonce() const;
 
     // get the final public generator
-    const typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type& getGenerator() const;
+    const affine_type& getGenerator() const;
+
+    // Draws a new random number for a node and regenerates its nonces, the sums are updated in place
+    void replaceNodeNonces(size_t node_number);
+
+    // Replaces the nonce pair of a single block, the final aggregate is updated in place
+    void replaceNonce(size_t node_number, size_t block_index, const affine_type& nonce_a, const affine_type& nonce_b);
 
 private:
+    // Structure of arrays: the affine coordinates of every (node, block) nonce, node major
+    struct NonceColumns {
+        std::vector<base_type> x;
+        std::vector<base_type> y;
+
+        void resize(size_t size);
+        affine_type at(size_t index) const;
+        void store(size_t index, const affine_type& point);
+    };
+
     size_t num_nodes;
     size_t num_blocks_per_node;
-    std::vector<typename pallas::scalar_field_type::value_type> random_numbers;
-    std::vector<typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type> nonces_a;
-    std::vector<typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type> nonces_b;
-    typename pallas::scalar_field_type::value_type base_nonce;
+    size_t num_threads;
+    std::vector<scalar_type> random_numbers;
+    NonceColumns nonces_a;
+    NonceColumns nonces_b;
+    scalar_type base_nonce;
+
+    std::mt19937 gen;
+    std::uniform_int_distribution<std::uint64_t> node_distribution;
 
-    typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type final_aggregate;
-    typename pallas::template g1_type<nil::crypto3::algebra::curves::coordinates::affine>::value_type generator; // Generator point
+    jacobian_type final_aggregate;  // Running sum of every Nonce A and Nonce B
+    scalar_type random_sum;         // Sum of the random numbers of every node, modulo the group order
+    jacobian_type total_random_sum; // generator * random_sum * 2 * num_blocks_per_node
+    affine_type generator; // Generator point
+    ecbatch::FixedBaseTable<jacobian_type> generator_table; // Multiples of the generator, shared by all nonces
 
-    void generateNoncesForNode(size_t node_number);
+    // Generates the nonces of a node into the columns and returns their sum
+    jacobian_type generateNoncesForNode(size_t node_number);
+    void updateTotalRandomSum();
+    size_t nonceIndex(size_t node_number, size_t block_index) const;
 };
 
 #endif // REQUESTOR_HPP
\ No newline at end of file
@@ -0,0 +1,160 @@
+/**
+ * @file       SecureRandom_test.cpp
+ * @brief      Tests of the ChaCha20 random generator
+ * @date       2024-03-26
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <set>
+#include <thread>
+#include <vector>
+#include "ProofSystem/SecureRandom.hpp"
+#include "ProofSystem/ECDSATypes.hpp"
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+TEST( SecureRandomTest, ChaCha20BlockTestVectors )
+{
+    // RFC 8439 section 2.3.2
+    std::array<std::uint8_t, csprng::CHACHA20_KEY_SIZE> key;
+    for ( std::size_t i = 0; i < key.size(); ++i )
+    {
+        key[i] = static_cast<std::uint8_t>( i );
+    }
+    const std::uint8_t nonce[csprng::CHACHA20_NONCE_SIZE] = { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x4a, 0x00, 0x00, 0x00, 0x00 };
+    const std::uint8_t expected[csprng::CHACHA20_BLOCK_SIZE] = {
+        0x10, 0xf1, 0xe7, 0xe4, 0xd1, 0x3b, 0x59, 0x15, 0x50, 0x0f, 0xdd, 0x1f, 0xa3, 0x20, 0x71, 0xc4, //
+        0xc7, 0xd1, 0xf4, 0xc7, 0x33, 0xc0, 0x68, 0x03, 0x04, 0x22, 0xaa, 0x9a, 0xc3, 0xd4, 0x6c, 0x4e, //
+        0xd2, 0x82, 0x64, 0x46, 0x07, 0x9f, 0xaa, 0x09, 0x14, 0xc2, 0xd7, 0x05, 0xd9, 0x8b, 0x02, 0xa2, //
+        0xb5, 0x12, 0x9c, 0xd1, 0xde, 0x16, 0x4e, 0xb9, 0xcb, 0xd0, 0x83, 0xe8, 0xa2, 0x50, 0x3c, 0x4e };
+
+    std::uint8_t block[csprng::CHACHA20_BLOCK_SIZE];
+    csprng::ChaCha20Block( key.data(), 1, nonce, block );
+    EXPECT_TRUE( std::equal( block, block + sizeof( block ), expected ) );
+
+    // RFC 8439 appendix A.1, test vector 1
+    const std::uint8_t zeros[csprng::CHACHA20_KEY_SIZE] = {};
+    const std::uint8_t expected_zero[16] = { 0x76, 0xb8, 0xe0, 0xad, 0xa0, 0xf1, 0x3d, 0x90, 0x40, 0x5d, 0x6a, 0xe5, 0x53, 0x86, 0xbd, 0x28 };
+    csprng::ChaCha20Block( zeros, 0, zeros, block );
+    EXPECT_TRUE( std::equal( expected_zero, expected_zero + sizeof( expected_zero ), block ) );
+}
+
+TEST( SecureRandomTest, SeededGeneratorIsDeterministic )
+{
+    std::array<std::uint8_t, csprng::CHACHA20_KEY_SIZE> seed{};
+    seed[0] = 42;
+    csprng::ChaCha20Rng first( seed );
+    csprng::ChaCha20Rng second( seed );
+
+    // Cross several refills, Fill and operator() must walk the same stream
+    std::vector<std::uint8_t> bytes( 3 * csprng::ChaCha20Rng::BUFFER_SIZE );
+    first.Fill( bytes.data(), bytes.size() );
+    for ( std::size_t i = 0; i < bytes.size(); i += sizeof( std::uint64_t ) )
+    {
+        std::uint64_t word = 0;
+        for ( std::size_t j = 0; j < sizeof( word ); ++j )
+        {
+            word |= static_cast<std::uint64_t>( bytes[i + j] ) << ( 8 * j );
+        }
+        ASSERT_EQ( word, second() );
+    }
+}
+
+TEST( SecureRandomTest, ThreadGeneratorsAreIndependent )
+{
+    constexpr std::size_t NUM_THREADS = 4;
+    constexpr std::size_t NUM_DRAWS   = 1000;
+
+    std::vector<std::vector<std::uint64_t>> draws( NUM_THREADS );
+    std::vector<std::thread>                threads;
+    for ( std::size_t t = 0; t < NUM_THREADS; ++t )
+    {
+        threads.emplace_back(
+            [&draws, t]()
+            {
+                for ( std::size_t i = 0; i < NUM_DRAWS; ++i )
+                {
+                    draws[t].push_back( csprng::ThreadRng()() );
+                }
+            } );
+    }
+    for ( auto &thread : threads )
+    {
+        thread.join();
+    }
+
+    std::set<std::uint64_t> unique;
+    for ( const auto &thread_draws : draws )
+    {
+        unique.insert( thread_draws.begin(), thread_draws.end() );
+    }
+    EXPECT_EQ( unique.size(), NUM_THREADS * NUM_DRAWS );
+}
+
+#ifndef _WIN32
+TEST( SecureRandomTest, ForkedChildGetsItsOwnStream )
+{
+    // Draw once so the parent has a key and buffered output for the child to inherit
+    csprng::ThreadRng()();
+
+    int pipe_fds[2];
+    ASSERT_EQ( pipe( pipe_fds ), 0 );
+    const pid_t child = fork();
+    ASSERT_GE( child, 0 );
+    if ( child == 0 )
+    {
+        std::array<std::uint8_t, 64> child_bytes;
+        csprng::ThreadRng().Fill( child_bytes.data(), child_bytes.size() );
+        const bool written = write( pipe_fds[1], child_bytes.data(), child_bytes.size() ) == static_cast<ssize_t>( child_bytes.size() );
+        _exit( written ? 0 : 1 );
+    }
+    close( pipe_fds[1] );
+
+    std::array<std::uint8_t, 64> parent_bytes;
+    csprng::ThreadRng().Fill( parent_bytes.data(), parent_bytes.size() );
+
+    std::array<std::uint8_t, 64> child_bytes{};
+    std::size_t                  received = 0;
+    while ( received < child_bytes.size() )
+    {
+        const ssize_t count = read( pipe_fds[0], child_bytes.data() + received, child_bytes.size() - received );
+        if ( count <= 0 )
+        {
+            break;
+        }
+        received += static_cast<std::size_t>( count );
+    }
+    close( pipe_fds[0] );
+
+    int status = 0;
+    ASSERT_EQ( waitpid( child, &status, 0 ), child );
+    ASSERT_TRUE( WIFEXITED( status ) && WEXITSTATUS( status ) == 0 );
+    ASSERT_EQ( received, child_bytes.size() );
+    EXPECT_NE( parent_bytes, child_bytes );
+}
+#endif
+
+TEST( SecureRandomTest, RangesAndScalars )
+{
+    for ( int i = 0; i < 1000; ++i )
+    {
+        const auto value = csprng::RandomInRange( 2, 6 );
+        EXPECT_GE( value, 2 );
+        EXPECT_LE( value, 6 );
+    }
+    EXPECT_EQ( csprng::RandomBelow( 1 ), 0 );
+    EXPECT_THROW( csprng::RandomBelow( 0 ), std::runtime_error );
+
+    const ecbatch::cpp_int modulus = static_cast<ecbatch::cpp_int>( ecdsa_t::scalar_field_type::modulus );
+    for ( int i = 0; i < 100; ++i )
+    {
+        const auto scalar = csprng::RandomScalar<ecdsa_t::scalar_field_type>();
+        EXPECT_FALSE( scalar.is_zero() );
+        EXPECT_LT( static_cast<ecbatch::cpp_int>( scalar.data ), modulus );
+    }
+}
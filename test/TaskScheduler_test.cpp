@@ -0,0 +1,136 @@
+/**
+ * @file       TaskScheduler_test.cpp
+ * @brief      Tests of the work stealing scheduler and the pluggable executor of ParallelFor
+ * @date       2024-04-01
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include "ProofSystem/ParallelFor.hpp"
+#include "ProofSystem/TaskScheduler.hpp"
+
+TEST( TaskSchedulerTest, IdleWorkersStealQueuedTasks )
+{
+    // Declared before the scheduler, so they outlive the workers it joins on destruction
+    constexpr int           NUM_TASKS = 64;
+    std::mutex              mutex;
+    std::condition_variable done;
+    int                     finished = 0;
+
+    util::TaskScheduler scheduler( { 4, false, true } );
+    EXPECT_EQ( scheduler.GetConcurrency(), 4 );
+    EXPECT_GE( scheduler.GetNodeCount(), 1 );
+
+    // The tasks go to the deque of the worker queuing them, which then blocks until all of them ran
+    scheduler.Execute(
+        [&]()
+        {
+            for ( int i = 0; i < NUM_TASKS; ++i )
+            {
+                scheduler.Execute(
+                    [&]()
+                    {
+                        std::lock_guard<std::mutex> lock( mutex );
+                        ++finished;
+                        done.notify_all();
+                    } );
+            }
+            std::unique_lock<std::mutex> lock( mutex );
+            done.wait( lock, [&]() { return finished == NUM_TASKS; } );
+        } );
+
+    std::unique_lock<std::mutex> lock( mutex );
+    done.wait( lock, [&]() { return finished == NUM_TASKS; } );
+    EXPECT_EQ( finished, NUM_TASKS );
+}
+
+TEST( TaskSchedulerTest, ParallelForCoversEveryItem )
+{
+    util::SetExecutor( std::make_shared<util::TaskScheduler>( util::TaskScheduler::Options{ 4, false, true } ) );
+    EXPECT_EQ( util::ResolveThreadCount( 100 ), 4 );
+
+    std::vector<int> hits( 10007, 0 );
+    util::ParallelFor( hits.size(),
+                       [&hits]( std::size_t begin, std::size_t end )
+                       {
+                           for ( std::size_t i = begin; i < end; ++i )
+                           {
+                               ++hits[i];
+                           }
+                       } );
+    EXPECT_EQ( std::accumulate( hits.begin(), hits.end(), 0 ), 10007 );
+
+    // Nested calls run on the same workers without deadlocking
+    std::atomic<std::size_t> total( 0 );
+    util::ParallelFor(
+        8,
+        [&total]( std::size_t begin, std::size_t end )
+        {
+            for ( std::size_t i = begin; i < end; ++i )
+            {
+                util::ParallelFor( 100, [&total]( std::size_t inner_begin, std::size_t inner_end ) { total += inner_end - inner_begin; }, 4 );
+            }
+        },
+        8 );
+    EXPECT_EQ( total.load(), 800 );
+
+    EXPECT_THROW( util::ParallelFor(
+                      10,
+                      []( std::size_t begin, std::size_t )
+                      {
+                          if ( begin >= 5 )
+                          {
+                              throw std::runtime_error( "range failed" );
+                          }
+                      },
+                      4 ),
+                  std::runtime_error );
+
+    util::SetExecutor( nullptr );
+}
+
+TEST( TaskSchedulerTest, HostExecutorReplacesThePool )
+{
+    class InlineExecutor : public util::Executor
+    {
+    public:
+        void Execute( std::function<void()> task ) override
+        {
+            ++num_tasks;
+            task();
+        }
+
+        std::size_t GetConcurrency() const override
+        {
+            return 3;
+        }
+
+        std::size_t num_tasks = 0;
+    };
+
+    auto host = std::make_shared<InlineExecutor>();
+    util::SetExecutor( host );
+    EXPECT_EQ( util::GetExecutor(), host );
+
+    std::vector<int> hits( 100, 0 );
+    util::ParallelFor( hits.size(),
+                       [&hits]( std::size_t begin, std::size_t end )
+                       {
+                           for ( std::size_t i = begin; i < end; ++i )
+                           {
+                               ++hits[i];
+                           }
+                       } );
+    // The calling thread takes one of the three ranges
+    EXPECT_EQ( host->num_tasks, 2 );
+    EXPECT_EQ( std::accumulate( hits.begin(), hits.end(), 0 ), 100 );
+
+    util::SetExecutor( nullptr );
+    EXPECT_NE( util::GetExecutor(), host );
+}
@@ -0,0 +1,109 @@
+/**
+ * @file       TransactionBatchValidator_test.cpp
+ * @brief      Tests of the batch transaction validation
+ * @date       2024-03-22
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include <nil/crypto3/algebra/curves/pallas.hpp>
+#include <nil/crypto3/algebra/random_element.hpp>
+#include "ProofSystem/TransactionBatchValidator.hpp"
+
+using namespace nil::crypto3::algebra;
+
+namespace
+{
+    using Validator_t   = TransactionBatchValidator<curves::pallas>;
+    using Transaction_t = Validator_t::Transaction_t;
+
+    Validator_t::affine_type Generator()
+    {
+        return Validator_t::jacobian_type::one().to_affine();
+    }
+
+    Transaction_t MakeTransaction( std::uint64_t balance, std::uint64_t amount, bool mpc )
+    {
+        const auto generator = Validator_t::jacobian_type::one();
+
+        Transaction_t transaction;
+        transaction.balance                         = Validator_t::scalar_type( balance );
+        transaction.amount                          = Validator_t::scalar_type( amount );
+        transaction.balance_commitment              = ( generator * transaction.balance ).to_affine();
+        transaction.amount_commitment               = ( generator * transaction.amount ).to_affine();
+        transaction.expected_new_balance_commitment = ( generator * ( transaction.balance - transaction.amount ) ).to_affine();
+        if ( mpc )
+        {
+            const auto random_sum = random_element<curves::pallas::g1_type<>>().to_affine();
+            transaction.mpc        = Validator_t::MPCTerms_t{ random_sum, random_sum };
+        }
+        return transaction;
+    }
+
+    std::vector<Transaction_t> MakeBatch( std::size_t count )
+    {
+        std::vector<Transaction_t> transactions;
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            // Includes zero amounts and exact balances
+            transactions.push_back( MakeTransaction( 1000 + i, ( i % 5 == 0 ) ? 0 : ( i % 7 == 0 ? 1000 + i : 500 + i ), i % 2 == 0 ) );
+        }
+        return transactions;
+    }
+}
+
+TEST( TransactionBatchValidatorTest, AllValid )
+{
+    const auto transactions = MakeBatch( 64 );
+
+    TransactionBatchStats stats;
+    const auto            valid = Validator_t::Validate( Generator(), transactions, &stats );
+
+    ASSERT_EQ( valid.size(), transactions.size() );
+    for ( std::size_t i = 0; i < valid.size(); ++i )
+    {
+        EXPECT_TRUE( valid[i] ) << "Transaction " << i;
+    }
+    EXPECT_EQ( stats.invalid, 0u );
+    EXPECT_EQ( stats.batch_checks, 1u );
+    EXPECT_EQ( stats.single_checks, 0u );
+}
+
+TEST( TransactionBatchValidatorTest, IsolatesInvalidTransactions )
+{
+    auto       transactions = MakeBatch( 40 );
+    const auto generator    = Validator_t::jacobian_type::one();
+
+    // Wrong new balance commitment
+    transactions[3].expected_new_balance_commitment = ( generator * ( transactions[3].balance - transactions[3].amount + 1 ) ).to_affine();
+    // Overdrawn, with commitments that are otherwise consistent
+    transactions[17] = MakeTransaction( 500, 1000, false );
+    // Aggregate that doesn't match the random sum
+    transactions[22].mpc->final_aggregate = ( generator + generator ).to_affine();
+    // Commitment of another amount
+    transactions[39].amount_commitment = transactions[38].amount_commitment;
+
+    TransactionBatchStats stats;
+    const auto            valid = Validator_t::Validate( Generator(), transactions, &stats, 4 );
+
+    for ( std::size_t i = 0; i < valid.size(); ++i )
+    {
+        const bool expected = ( i != 3 && i != 17 && i != 22 && i != 39 );
+        EXPECT_EQ( valid[i], expected ) << "Transaction " << i;
+    }
+    EXPECT_EQ( stats.invalid, 4u );
+    EXPECT_GT( stats.batch_checks, 1u );
+}
+
+TEST( TransactionBatchValidatorTest, SmallAndEmptyBatches )
+{
+    EXPECT_TRUE( Validator_t::Validate( Generator(), {} ).empty() );
+
+    std::vector<Transaction_t> transactions{ MakeTransaction( 1000, 1000, true ) };
+    EXPECT_TRUE( Validator_t::Validate( Generator(), transactions ).at( 0 ) );
+
+    // Exact balance, so the new balance commitment must be the point at infinity
+    transactions[0].expected_new_balance_commitment = transactions[0].balance_commitment;
+    EXPECT_FALSE( Validator_t::Validate( Generator(), transactions ).at( 0 ) );
+}
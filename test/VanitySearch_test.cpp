@@ -0,0 +1,98 @@
+/**
+ * @file       VanitySearch_test.cpp
+ * @brief      Tests of the vanity address search
+ * @date       2024-03-11
+ * @author     Henrique A. Klein (henryaklein@gmail.com)
+ */
+
+#include <gtest/gtest.h>
+#include <cctype>
+#include <cstdint>
+#include "ProofSystem/VanitySearch.hpp"
+#include "ProofSystem/BitcoinKeyGenerator.hpp"
+#include "ProofSystem/EthereumKeyGenerator.hpp"
+
+using namespace vanity;
+
+TEST( VanitySearchTest, EthereumPrefixMask )
+{
+    auto pattern = AddressPattern::EthereumPrefix( "0xAb1" );
+
+    Address_t address{ 0xab, 0x1f };
+    EXPECT_TRUE( pattern.Matches( address ) );
+    address[1] = 0x2f;
+    EXPECT_FALSE( pattern.Matches( address ) );
+
+    EXPECT_THROW( AddressPattern::EthereumPrefix( "0xg0" ), std::runtime_error );
+}
+
+TEST( VanitySearchTest, BitcoinPrefixValidation )
+{
+    EXPECT_THROW( AddressPattern::BitcoinPrefix( "3abc" ), std::runtime_error );
+    EXPECT_THROW( AddressPattern::BitcoinPrefix( "1O" ), std::runtime_error );
+
+    Address_t zero_hash{};
+    EXPECT_TRUE( AddressPattern::BitcoinPrefix( "1111111111111111111114" ).Matches( zero_hash ) );
+    EXPECT_FALSE( AddressPattern::BitcoinPrefix( "12" ).Matches( zero_hash ) );
+}
+
+TEST( VanitySearchTest, EthereumSearch )
+{
+    SearchOptions options;
+    options.num_threads = 2;
+    options.batch_size  = 64;
+    options.max_keys    = 1 << 20;
+
+    auto result = Search( AddressPattern::EthereumPrefix( "0x5a" ), options );
+    ASSERT_TRUE( result.found );
+    EXPECT_GT( result.stats.keys_checked, 0 );
+
+    ethereum::EthereumKeyGenerator key_generator( result.private_key );
+    EXPECT_EQ( key_generator.get_address(), result.address );
+    EXPECT_EQ( std::tolower( result.address[2] ), '5' );
+    EXPECT_EQ( std::tolower( result.address[3] ), 'a' );
+}
+
+TEST( VanitySearchTest, BitcoinSearch )
+{
+    SearchOptions options;
+    options.num_threads = 2;
+    options.batch_size  = 64;
+    options.max_keys    = 1 << 20;
+
+    auto result = Search( AddressPattern::BitcoinPrefix( "1A" ), options );
+    ASSERT_TRUE( result.found );
+
+    bitcoin::BitcoinKeyGenerator key_generator( result.private_key );
+    EXPECT_EQ( key_generator.get_address(), result.address );
+    EXPECT_EQ( result.address.substr( 0, 2 ), "1A" );
+}
+
+TEST( VanitySearchTest, GivesUpAfterMaxKeys )
+{
+    SearchOptions options;
+    options.num_threads       = 1;
+    options.batch_size        = 32;
+    options.max_keys          = 1 << 14;
+    options.progress_interval = std::chrono::milliseconds( 1 );
+
+    // Enough keys to outlast several progress intervals
+    std::size_t   progress_calls = 0;
+    std::uint64_t last_checked   = 0;
+    bool          monotonic      = true;
+    options.on_progress          = [&]( const SearchProgress &progress )
+    {
+        ++progress_calls;
+        monotonic    = monotonic && progress.keys_checked >= last_checked;
+        last_checked = progress.keys_checked;
+    };
+
+    // 40 fixed nibbles, never found in 2^14 tries
+    auto result = Search( AddressPattern::EthereumPrefix( "0x0000000000000000000000000000000000000000" ), options );
+    EXPECT_FALSE( result.found );
+    EXPECT_GE( result.stats.keys_checked, options.max_keys );
+
+    EXPECT_GT( progress_calls, 0u );
+    EXPECT_TRUE( monotonic );
+    EXPECT_LE( last_checked, result.stats.keys_checked );
+}